@@ -49,6 +49,16 @@ AntennaModel::GetTypeId ()
   return tid;
 }
 
+void
+AntennaModel::GetGainsDb (const std::vector<Angles> &angles, std::vector<double> &gainsDb)
+{
+  gainsDb.resize (angles.size ());
+  for (size_t i = 0; i < angles.size (); ++i)
+    {
+      gainsDb[i] = GetGainDb (angles[i]);
+    }
+}
+
 
 
 }
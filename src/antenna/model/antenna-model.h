@@ -24,6 +24,7 @@
 
 #include <ns3/object.h>
 #include <ns3/angles.h>
+#include <vector>
 
 namespace ns3 {
 
@@ -66,6 +67,18 @@ public:
    */
   virtual double GetGainDb (Angles a) = 0;
 
+  /**
+   * Evaluate the radiation pattern at many angles at once.  The default
+   * implementation calls GetGainDb for each angle; the antenna models
+   * may re-implement it to compute the gains in a single pass.
+   *
+   * \param angles the spherical angles at which the radiation pattern
+   * should be evaluated
+   * \param gainsDb the power gains in dBi at the specified angles, resized
+   * to the number of angles
+   */
+  virtual void GetGainsDb (const std::vector<Angles> &angles, std::vector<double> &gainsDb);
+
 };
 
 
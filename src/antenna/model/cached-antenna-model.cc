@@ -0,0 +1,222 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+
+#include <ns3/log.h>
+#include <ns3/double.h>
+#include <ns3/pointer.h>
+#include <ns3/abort.h>
+#include <cmath>
+#include <algorithm>
+
+#include "antenna-model.h"
+#include "cached-antenna-model.h"
+
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("CachedAntennaModel");
+
+NS_OBJECT_ENSURE_REGISTERED (CachedAntennaModel);
+
+/// lowest gain of the table (dBi)
+static const double MIN_GAIN_DB = -300;
+
+
+CachedAntennaModel::CachedAntennaModel ()
+  : m_nAzimuths (0),
+    m_nInclinations (0),
+    m_azimuthStep (0),
+    m_inclinationStep (0)
+{
+}
+
+CachedAntennaModel::~CachedAntennaModel ()
+{
+}
+
+TypeId
+CachedAntennaModel::GetTypeId ()
+{
+  static TypeId tid = TypeId ("ns3::CachedAntennaModel")
+    .SetParent<AntennaModel> ()
+    .SetGroupName("Antenna")
+    .AddConstructor<CachedAntennaModel> ()
+    .AddAttribute ("Model",
+                   "The antenna model whose radiation pattern is tabulated",
+                   PointerValue (),
+                   MakePointerAccessor (&CachedAntennaModel::SetModel,
+                                        &CachedAntennaModel::GetModel),
+                   MakePointerChecker<AntennaModel> ())
+    .AddAttribute ("AzimuthResolution",
+                   "The azimuth step (degrees) of the table; rounded down to divide 360 degrees",
+                   DoubleValue (1.0),
+                   MakeDoubleAccessor (&CachedAntennaModel::SetAzimuthResolution,
+                                       &CachedAntennaModel::GetAzimuthResolution),
+                   MakeDoubleChecker<double> (0.01, 360))
+    .AddAttribute ("InclinationResolution",
+                   "The inclination step (degrees) of the table; rounded down to divide 180 degrees",
+                   DoubleValue (5.0),
+                   MakeDoubleAccessor (&CachedAntennaModel::SetInclinationResolution,
+                                       &CachedAntennaModel::GetInclinationResolution),
+                   MakeDoubleChecker<double> (0.01, 180))
+  ;
+  return tid;
+}
+
+void
+CachedAntennaModel::DoDispose ()
+{
+  m_model = 0;
+  m_gainsDb.clear ();
+  AntennaModel::DoDispose ();
+}
+
+void
+CachedAntennaModel::SetModel (Ptr<AntennaModel> model)
+{
+  NS_LOG_FUNCTION (this << model);
+  m_model = model;
+  m_gainsDb.clear ();
+}
+
+Ptr<AntennaModel>
+CachedAntennaModel::GetModel () const
+{
+  return m_model;
+}
+
+void
+CachedAntennaModel::Update ()
+{
+  NS_LOG_FUNCTION (this);
+  m_gainsDb.clear ();
+}
+
+void
+CachedAntennaModel::SetAzimuthResolution (double resolutionDegrees)
+{
+  NS_LOG_FUNCTION (this << resolutionDegrees);
+  m_azimuthResolution = resolutionDegrees;
+  m_gainsDb.clear ();
+}
+
+double
+CachedAntennaModel::GetAzimuthResolution () const
+{
+  return m_azimuthResolution;
+}
+
+void
+CachedAntennaModel::SetInclinationResolution (double resolutionDegrees)
+{
+  NS_LOG_FUNCTION (this << resolutionDegrees);
+  m_inclinationResolution = resolutionDegrees;
+  m_gainsDb.clear ();
+}
+
+double
+CachedAntennaModel::GetInclinationResolution () const
+{
+  return m_inclinationResolution;
+}
+
+void
+CachedAntennaModel::ComputeTable ()
+{
+  NS_LOG_FUNCTION (this);
+  NS_ABORT_MSG_IF (m_model == 0, "CachedAntennaModel needs a Model");
+  m_nAzimuths = static_cast<uint32_t> (std::ceil (360.0 / m_azimuthResolution - 1e-9));
+  m_nInclinations = static_cast<uint32_t> (std::ceil (180.0 / m_inclinationResolution - 1e-9)) + 1;
+  m_azimuthStep = 2 * M_PI / m_nAzimuths;
+  m_inclinationStep = M_PI / (m_nInclinations - 1);
+
+  std::vector<Angles> angles;
+  angles.reserve (m_nAzimuths * m_nInclinations);
+  for (uint32_t j = 0; j < m_nInclinations; ++j)
+    {
+      for (uint32_t i = 0; i < m_nAzimuths; ++i)
+        {
+          angles.push_back (Angles (-M_PI + i * m_azimuthStep, j * m_inclinationStep));
+        }
+    }
+  m_model->GetGainsDb (angles, m_gainsDb);
+  for (std::vector<double>::iterator it = m_gainsDb.begin (); it != m_gainsDb.end (); ++it)
+    {
+      // also replaces the NaN of -inf - -inf in the wrapped models
+      if (!(*it >= MIN_GAIN_DB))
+        {
+          *it = MIN_GAIN_DB;
+        }
+    }
+  NS_LOG_LOGIC (this << " tabulated " << m_nAzimuths << " x " << m_nInclinations << " gains");
+}
+
+double
+CachedAntennaModel::Interpolate (const Angles &a) const
+{
+  // azimuth index, modulo the number of azimuths
+  double u = (a.phi + M_PI) / m_azimuthStep;
+  u -= std::floor (u / m_nAzimuths) * m_nAzimuths;
+  uint32_t i0 = static_cast<uint32_t> (u);
+  if (i0 >= m_nAzimuths)
+    {
+      i0 = 0;
+      u = 0;
+    }
+  double fu = u - i0;
+  uint32_t i1 = (i0 + 1 == m_nAzimuths) ? 0 : i0 + 1;
+
+  // inclination index, clamped to [0, pi]
+  double v = std::min (std::max (a.theta, 0.0), M_PI) / m_inclinationStep;
+  uint32_t j0 = std::min (static_cast<uint32_t> (v), m_nInclinations - 2);
+  double fv = v - j0;
+
+  const double *row0 = &m_gainsDb[j0 * m_nAzimuths];
+  const double *row1 = row0 + m_nAzimuths;
+  double g0 = row0[i0] + (row0[i1] - row0[i0]) * fu;
+  double g1 = row1[i0] + (row1[i1] - row1[i0]) * fu;
+  return g0 + (g1 - g0) * fv;
+}
+
+double
+CachedAntennaModel::GetGainDb (Angles a)
+{
+  NS_LOG_FUNCTION (this << a);
+  if (m_gainsDb.empty ())
+    {
+      ComputeTable ();
+    }
+  return Interpolate (a);
+}
+
+void
+CachedAntennaModel::GetGainsDb (const std::vector<Angles> &angles, std::vector<double> &gainsDb)
+{
+  NS_LOG_FUNCTION (this << angles.size ());
+  if (m_gainsDb.empty ())
+    {
+      ComputeTable ();
+    }
+  gainsDb.resize (angles.size ());
+  for (size_t i = 0; i < angles.size (); ++i)
+    {
+      gainsDb[i] = Interpolate (angles[i]);
+    }
+}
+
+
+} // namespace ns3
@@ -0,0 +1,109 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef CACHED_ANTENNA_MODEL_H
+#define CACHED_ANTENNA_MODEL_H
+
+
+#include <ns3/object.h>
+#include <ns3/antenna-model.h>
+#include <vector>
+
+namespace ns3 {
+
+/**
+ * \ingroup antenna
+ *
+ * \brief Antenna model which tabulates the radiation pattern of another
+ * antenna model
+ *
+ * The gains of the wrapped model are computed once, on a grid of
+ * azimuth and inclination angles with the configured resolutions, using
+ * the batch method AntennaModel::GetGainsDb.  The gain at any direction
+ * is then interpolated bilinearly between the four nearest grid points,
+ * which replaces the trigonometric functions of the wrapped model with a
+ * few multiplications.  The inclination angle is clamped to [0, pi].
+ *
+ * Gains below -300 dBi, such as the nulls of CosineAntennaModel, are
+ * tabulated as -300 dBi.
+ *
+ * The table is computed when the gain is first requested, and again after
+ * the model or the resolutions are set.  Changes to the attributes of the
+ * wrapped model are only taken into account after calling Update.
+ */
+class CachedAntennaModel : public AntennaModel
+{
+public:
+  CachedAntennaModel ();
+  virtual ~CachedAntennaModel ();
+
+  // inherited from Object
+  static TypeId GetTypeId ();
+
+  // inherited from AntennaModel
+  virtual double GetGainDb (Angles a);
+  virtual void GetGainsDb (const std::vector<Angles> &angles, std::vector<double> &gainsDb);
+
+  /**
+   * \param model the antenna model whose radiation pattern is tabulated
+   */
+  void SetModel (Ptr<AntennaModel> model);
+  /**
+   * \return the antenna model whose radiation pattern is tabulated
+   */
+  Ptr<AntennaModel> GetModel () const;
+  /**
+   * Compute the table again, to take into account the changes to the
+   * attributes of the wrapped model.
+   */
+  void Update ();
+
+  // attribute getters/setters
+  void SetAzimuthResolution (double resolutionDegrees);
+  double GetAzimuthResolution () const;
+  void SetInclinationResolution (double resolutionDegrees);
+  double GetInclinationResolution () const;
+
+protected:
+  virtual void DoDispose ();
+
+private:
+  /**
+   * Compute the gains of the wrapped model on the grid
+   */
+  void ComputeTable ();
+  /**
+   * \param a the spherical angles
+   * \return the gain interpolated in the table
+   */
+  double Interpolate (const Angles &a) const;
+
+  Ptr<AntennaModel> m_model;     //!< the tabulated antenna model
+  double m_azimuthResolution;    //!< requested azimuth resolution (degrees)
+  double m_inclinationResolution; //!< requested inclination resolution (degrees)
+  uint32_t m_nAzimuths;          //!< number of azimuths of the grid, which covers [-pi, pi)
+  uint32_t m_nInclinations;      //!< number of inclinations of the grid, which covers [0, pi]
+  double m_azimuthStep;          //!< azimuth step of the grid (radians)
+  double m_inclinationStep;      //!< inclination step of the grid (radians)
+  std::vector<double> m_gainsDb; //!< gains on the grid, by inclination then azimuth; empty if not computed
+};
+
+
+
+} // namespace ns3
+
+
+#endif // CACHED_ANTENNA_MODEL_H
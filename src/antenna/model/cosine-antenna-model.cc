@@ -123,6 +123,28 @@ CosineAntennaModel::GetGainDb (Angles a)
   return gainDb + m_maxGain;
 }
 
+void
+CosineAntennaModel::GetGainsDb (const std::vector<Angles> &angles, std::vector<double> &gainsDb)
+{
+  NS_LOG_FUNCTION (this << angles.size ());
+  gainsDb.resize (angles.size ());
+  // 20 log10 (cos (phi / 2) ^ n) = 20 n log10 (cos (phi / 2)), without pow
+  double factor = 20 * m_exponent;
+  for (size_t i = 0; i < angles.size (); ++i)
+    {
+      double phi = angles[i].phi - m_orientationRadians;
+      while (phi <= -M_PI)
+        {
+          phi += M_PI+M_PI;
+        }
+      while (phi > M_PI)
+        {
+          phi -= M_PI+M_PI;
+        }
+      gainsDb[i] = factor * std::log10 (std::cos (phi / 2.0)) + m_maxGain;
+    }
+}
+
 
 }
 
@@ -113,6 +113,27 @@ ParabolicAntennaModel::GetGainDb (Angles a)
   return gainDb;
 }
 
+void
+ParabolicAntennaModel::GetGainsDb (const std::vector<Angles> &angles, std::vector<double> &gainsDb)
+{
+  NS_LOG_FUNCTION (this << angles.size ());
+  gainsDb.resize (angles.size ());
+  double factor = 12 / (m_beamwidthRadians * m_beamwidthRadians);
+  for (size_t i = 0; i < angles.size (); ++i)
+    {
+      double phi = angles[i].phi - m_orientationRadians;
+      while (phi <= -M_PI)
+        {
+          phi += M_PI+M_PI;
+        }
+      while (phi > M_PI)
+        {
+          phi -= M_PI+M_PI;
+        }
+      gainsDb[i] = -std::min (factor * phi * phi, m_maxAttenuation);
+    }
+}
+
 
 }
 
@@ -51,6 +51,7 @@ public:
 
   // inherited from AntennaModel
   virtual double GetGainDb (Angles a);
+  virtual void GetGainsDb (const std::vector<Angles> &angles, std::vector<double> &gainsDb);
 
 
   // attribute getters/setters
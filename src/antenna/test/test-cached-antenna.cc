@@ -0,0 +1,195 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <ns3/log.h>
+#include <ns3/test.h>
+#include <ns3/double.h>
+#include <ns3/pointer.h>
+#include <ns3/isotropic-antenna-model.h>
+#include <ns3/cosine-antenna-model.h>
+#include <ns3/parabolic-antenna-model.h>
+#include <ns3/cached-antenna-model.h>
+#include <ns3/random-variable-stream.h>
+#include <cmath>
+#include <string>
+#include <vector>
+
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("TestCachedAntennaModel");
+
+/**
+ * \ingroup antenna
+ * \ingroup tests
+ *
+ * \brief Check that AntennaModel::GetGainsDb returns the gains of
+ * AntennaModel::GetGainDb
+ */
+class AntennaModelGainsTestCase : public TestCase
+{
+public:
+  /**
+   * \param model the antenna model
+   * \param name the name of the antenna model
+   */
+  AntennaModelGainsTestCase (Ptr<AntennaModel> model, std::string name);
+
+private:
+  virtual void DoRun (void);
+
+  Ptr<AntennaModel> m_model; //!< the antenna model
+};
+
+AntennaModelGainsTestCase::AntennaModelGainsTestCase (Ptr<AntennaModel> model, std::string name)
+  : TestCase ("batch gains of " + name),
+    m_model (model)
+{
+}
+
+void
+AntennaModelGainsTestCase::DoRun ()
+{
+  Ptr<UniformRandomVariable> random = CreateObject<UniformRandomVariable> ();
+  random->SetStream (1);
+  std::vector<Angles> angles;
+  for (uint32_t i = 0; i < 1000; ++i)
+    {
+      angles.push_back (Angles (random->GetValue (-2 * M_PI, 2 * M_PI), random->GetValue (0, M_PI)));
+    }
+  std::vector<double> gainsDb;
+  m_model->GetGainsDb (angles, gainsDb);
+  NS_TEST_ASSERT_MSG_EQ (gainsDb.size (), angles.size (), "wrong number of gains");
+  for (uint32_t i = 0; i < angles.size (); ++i)
+    {
+      NS_TEST_EXPECT_MSG_EQ_TOL (gainsDb[i], m_model->GetGainDb (angles[i]), 1e-9, "wrong gain at " << angles[i]);
+    }
+  m_model = 0;
+}
+
+
+/**
+ * \ingroup antenna
+ * \ingroup tests
+ *
+ * \brief Check that CachedAntennaModel interpolates the radiation pattern
+ * of the wrapped model
+ */
+class CachedAntennaModelTestCase : public TestCase
+{
+public:
+  /**
+   * \param model the wrapped antenna model
+   * \param name the name of the wrapped antenna model
+   * \param tolerance the largest difference (dB) with the wrapped model
+   */
+  CachedAntennaModelTestCase (Ptr<AntennaModel> model, std::string name, double tolerance);
+
+private:
+  virtual void DoRun (void);
+
+  Ptr<AntennaModel> m_model; //!< the wrapped antenna model
+  double m_tolerance;        //!< the largest difference (dB) with the wrapped model
+};
+
+CachedAntennaModelTestCase::CachedAntennaModelTestCase (Ptr<AntennaModel> model, std::string name, double tolerance)
+  : TestCase ("cached " + name),
+    m_model (model),
+    m_tolerance (tolerance)
+{
+}
+
+void
+CachedAntennaModelTestCase::DoRun ()
+{
+  Ptr<CachedAntennaModel> cached = CreateObject<CachedAntennaModel> ();
+  cached->SetAttribute ("Model", PointerValue (m_model));
+  cached->SetAttribute ("AzimuthResolution", DoubleValue (0.5));
+
+  // on the grid, the gains are those of the wrapped model
+  for (int32_t degrees = -180; degrees < 180; degrees += 15)
+    {
+      Angles a (DegreesToRadians (degrees), DegreesToRadians (90));
+      double expected = std::max (m_model->GetGainDb (a), -300.0);
+      NS_TEST_EXPECT_MSG_EQ_TOL (cached->GetGainDb (a), expected, 1e-9, "wrong gain on the grid at " << a);
+    }
+
+  // between the grid points, in the main lobe, the gains are interpolated
+  Ptr<UniformRandomVariable> random = CreateObject<UniformRandomVariable> ();
+  random->SetStream (1);
+  std::vector<Angles> angles;
+  for (uint32_t i = 0; i < 1000; ++i)
+    {
+      angles.push_back (Angles (random->GetValue (-2 * M_PI, 2 * M_PI), random->GetValue (-1, 4)));
+    }
+  std::vector<double> gainsDb;
+  cached->GetGainsDb (angles, gainsDb);
+  for (uint32_t i = 0; i < angles.size (); ++i)
+    {
+      double expected = m_model->GetGainDb (angles[i]);
+      NS_TEST_EXPECT_MSG_EQ_TOL (gainsDb[i], cached->GetGainDb (angles[i]), 1e-9, "wrong batch gain at " << angles[i]);
+      if (expected > -20)
+        {
+          NS_TEST_EXPECT_MSG_EQ_TOL (gainsDb[i], expected, m_tolerance, "wrong interpolated gain at " << angles[i]);
+        }
+    }
+
+  // the changes of the wrapped model are taken into account by Update
+  Angles boresight (0, M_PI / 2);
+  double gain = cached->GetGainDb (boresight);
+  m_model->SetAttribute ("Orientation", DoubleValue (90));
+  NS_TEST_EXPECT_MSG_EQ_TOL (cached->GetGainDb (boresight), gain, 1e-9, "the table should not change before Update");
+  cached->Update ();
+  NS_TEST_EXPECT_MSG_EQ_TOL (cached->GetGainDb (boresight), m_model->GetGainDb (boresight), m_tolerance,
+                             "the table should change after Update");
+  cached->Dispose ();
+  m_model = 0;
+}
+
+
+/**
+ * \ingroup antenna
+ * \ingroup tests
+ *
+ * \brief CachedAntennaModel Test Suite
+ */
+class CachedAntennaModelTestSuite : public TestSuite
+{
+public:
+  CachedAntennaModelTestSuite ();
+};
+
+CachedAntennaModelTestSuite::CachedAntennaModelTestSuite ()
+  : TestSuite ("cached-antenna-model", UNIT)
+{
+  Ptr<CosineAntennaModel> cosine = CreateObject<CosineAntennaModel> ();
+  cosine->SetAttribute ("Beamwidth", DoubleValue (65));
+  cosine->SetAttribute ("Orientation", DoubleValue (30));
+  cosine->SetAttribute ("MaxGain", DoubleValue (10));
+  Ptr<ParabolicAntennaModel> parabolic = CreateObject<ParabolicAntennaModel> ();
+  parabolic->SetAttribute ("Beamwidth", DoubleValue (70));
+  parabolic->SetAttribute ("Orientation", DoubleValue (-120));
+
+  AddTestCase (new AntennaModelGainsTestCase (CreateObject<IsotropicAntennaModel> (), "IsotropicAntennaModel"), TestCase::QUICK);
+  AddTestCase (new AntennaModelGainsTestCase (cosine, "CosineAntennaModel"), TestCase::QUICK);
+  AddTestCase (new AntennaModelGainsTestCase (parabolic, "ParabolicAntennaModel"), TestCase::QUICK);
+  // the error of the linear interpolation is the largest at the kink of
+  // the parabolic model, where the maximum attenuation is reached
+  AddTestCase (new CachedAntennaModelTestCase (cosine, "CosineAntennaModel", 0.01), TestCase::QUICK);
+  AddTestCase (new CachedAntennaModelTestCase (parabolic, "ParabolicAntennaModel", 0.1), TestCase::QUICK);
+}
+
+static CachedAntennaModelTestSuite staticCachedAntennaModelTestSuiteInstance; //!< the test suite
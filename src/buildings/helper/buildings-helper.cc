@@ -27,6 +27,9 @@
 #include <ns3/mobility-building-info.h>
 #include <ns3/abort.h>
 #include <ns3/log.h>
+#include <ns3/string.h>
+#include <fstream>
+#include <sstream>
 
 
 namespace ns3 {
@@ -79,28 +82,54 @@ void
 BuildingsHelper::MakeConsistent (Ptr<MobilityModel> mm)
 {
   Ptr<MobilityBuildingInfo> bmm = mm->GetObject<MobilityBuildingInfo> ();
-  bool found = false;
-  for (BuildingList::Iterator bit = BuildingList::Begin (); bit != BuildingList::End (); ++bit)
+  bmm->MakeConsistent (mm);
+}
+
+BuildingContainer
+BuildingsHelper::LoadBuildings (std::string filename)
+{
+  NS_LOG_FUNCTION (filename);
+  std::ifstream ifs (filename.c_str ());
+  NS_ABORT_MSG_UNLESS (ifs.is_open (), "Could not open " << filename);
+  BuildingContainer buildings;
+  std::string line;
+  uint32_t lineNumber = 0;
+  while (std::getline (ifs, line))
     {
-      NS_LOG_LOGIC ("checking building " << (*bit)->GetId () << " with boundaries " << (*bit)->GetBoundaries ());
-      Vector pos = mm->GetPosition ();
-      if ((*bit)->IsInside (pos))
+      lineNumber++;
+      std::istringstream iss (line);
+      std::string first;
+      if (!(iss >> first) || first[0] == '#')
         {
-          NS_LOG_LOGIC ("MobilityBuildingInfo " << bmm << " pos " << mm->GetPosition () << " falls inside building " << (*bit)->GetId ());
-          NS_ABORT_MSG_UNLESS (found == false, " MobilityBuildingInfo already inside another building!");		
-          found = true;
-          uint16_t floor = (*bit)->GetFloor (pos);
-          uint16_t roomX = (*bit)->GetRoomX (pos);
-          uint16_t roomY = (*bit)->GetRoomY (pos);	   
-          bmm->SetIndoor (*bit, floor, roomX, roomY);	      
-        }		    	  
-    }
-  if (!found)
-    {
-      NS_LOG_LOGIC ("MobilityBuildingInfo " << bmm << " pos " << mm->GetPosition ()  << " is outdoor");
-      bmm->SetOutdoor ();
+          continue;
+        }
+      iss.clear ();
+      iss.seekg (0);
+      Box box;
+      iss >> box.xMin >> box.xMax >> box.yMin >> box.yMax >> box.zMin >> box.zMax;
+      NS_ABORT_MSG_IF (iss.fail (), filename << ":" << lineNumber << ": expected the boundaries of a building");
+      Ptr<Building> building = CreateObject<Building> ();
+      building->SetBoundaries (box);
+      std::string type;
+      std::string extWalls;
+      uint16_t nFloors;
+      uint16_t nRoomsX;
+      uint16_t nRoomsY;
+      if (iss >> type)
+        {
+          iss >> extWalls >> nFloors >> nRoomsX >> nRoomsY;
+          NS_ABORT_MSG_IF (iss.fail (), filename << ":" << lineNumber << ": expected the type, the external walls type, "
+                           "the number of floors and the numbers of rooms of a building");
+          building->SetAttribute ("Type", StringValue (type));
+          building->SetAttribute ("ExternalWallsType", StringValue (extWalls));
+          building->SetNFloors (nFloors);
+          building->SetNRoomsX (nRoomsX);
+          building->SetNRoomsY (nRoomsY);
+        }
+      buildings.Add (building);
     }
-
+  NS_LOG_INFO ("Loaded " << buildings.GetN () << " buildings from " << filename);
+  return buildings;
 }
 
 } // namespace ns3
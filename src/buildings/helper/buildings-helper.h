@@ -26,6 +26,7 @@
 #include <ns3/object-factory.h>
 #include <ns3/node-container.h>
 #include <ns3/ptr.h>
+#include <ns3/building-container.h>
 
 
 namespace ns3 {
@@ -63,6 +64,25 @@ public:
   * \param bmm the mobility model to be made consistent
   */
   static void MakeConsistent (Ptr<MobilityModel> bmm);
+
+  /**
+  * Create the buildings described in a text file, with one building per
+  * line, given by its boundaries and optionally by its type, its external
+  * walls type, its number of floors and its numbers of rooms along x and y:
+  *
+  * \verbatim
+    # xMin xMax yMin yMax zMin zMax [type extWallsType nFloors nRoomsX nRoomsY]
+    0 10 0 20 0 9
+    20 40 0 20 0 30 Office ConcreteWithWindows 10 2 4
+    \endverbatim
+  *
+  * The types are the values of the Type and ExternalWallsType attributes
+  * of Building.  Empty lines and lines starting with # are ignored.
+  *
+  * \param filename the name of the file
+  * \return the buildings created
+  */
+  static BuildingContainer LoadBuildings (std::string filename);
   
 };
 
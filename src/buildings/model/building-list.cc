@@ -27,6 +27,8 @@
 #include "ns3/assert.h"
 #include "building-list.h"
 #include "building.h"
+#include <algorithm>
+#include <cmath>
 
 namespace ns3 {
 
@@ -47,6 +49,8 @@ public:
   BuildingList::Iterator End (void) const;
   Ptr<Building> GetBuilding (uint32_t n);
   uint32_t GetNBuildings (void);
+  std::vector<Ptr<Building> > GetBuildingsAt (const Vector &position);
+  void InvalidateIndex (void);
 
   static Ptr<BuildingListPriv> Get (void);
 
@@ -54,7 +58,25 @@ private:
   virtual void DoDispose (void);
   static Ptr<BuildingListPriv> *DoGet (void);
   static void Delete (void);
+  /**
+   * Build the grid of the buildings
+   */
+  void BuildIndex (void);
+  /**
+   * \param value a coordinate
+   * \param min the lowest coordinate of the grid
+   * \param n the number of cells of the grid along the coordinate
+   * \returns the index of the cell of the coordinate, clamped to the grid
+   */
+  uint32_t GetCell (double value, double min, uint32_t n) const;
   std::vector<Ptr<Building> > m_buildings;
+  bool m_indexValid;                          //!< whether the grid is up to date
+  double m_indexMinX;                         //!< lowest x coordinate of the grid
+  double m_indexMinY;                         //!< lowest y coordinate of the grid
+  double m_indexCellSize;                     //!< size of the cells of the grid
+  uint32_t m_indexNx;                         //!< number of cells along x
+  uint32_t m_indexNy;                         //!< number of cells along y
+  std::vector<std::vector<uint32_t> > m_indexCells; //!< indexes of the buildings overlapping each cell
 };
 
 NS_OBJECT_ENSURE_REGISTERED (BuildingListPriv);
@@ -100,6 +122,12 @@ BuildingListPriv::Delete (void)
 
 
 BuildingListPriv::BuildingListPriv ()
+  : m_indexValid (false),
+    m_indexMinX (0),
+    m_indexMinY (0),
+    m_indexCellSize (1),
+    m_indexNx (0),
+    m_indexNy (0)
 {
   NS_LOG_FUNCTION_NOARGS ();
 }
@@ -118,6 +146,8 @@ BuildingListPriv::DoDispose (void)
       *i = 0;
     }
   m_buildings.erase (m_buildings.begin (), m_buildings.end ());
+  m_indexCells.clear ();
+  m_indexValid = false;
   Object::DoDispose ();
 }
 
@@ -127,6 +157,7 @@ BuildingListPriv::Add (Ptr<Building> building)
 {
   uint32_t index = m_buildings.size ();
   m_buildings.push_back (building);
+  m_indexValid = false;
   Simulator::ScheduleWithContext (index, TimeStep (0), &Building::Initialize, building);
   return index;
 
@@ -155,6 +186,108 @@ BuildingListPriv::GetBuilding (uint32_t n)
   return m_buildings.at (n);
 }
 
+void
+BuildingListPriv::InvalidateIndex (void)
+{
+  m_indexValid = false;
+}
+
+uint32_t
+BuildingListPriv::GetCell (double value, double min, uint32_t n) const
+{
+  double cell = std::floor ((value - min) / m_indexCellSize);
+  if (cell <= 0)
+    {
+      return 0;
+    }
+  return std::min (static_cast<uint32_t> (cell), n - 1);
+}
+
+void
+BuildingListPriv::BuildIndex (void)
+{
+  NS_LOG_FUNCTION (this << m_buildings.size ());
+  m_indexCells.clear ();
+  m_indexNx = 0;
+  m_indexNy = 0;
+  m_indexValid = true;
+  if (m_buildings.empty ())
+    {
+      return;
+    }
+  double minX = m_buildings.front ()->GetBoundaries ().xMin;
+  double maxX = m_buildings.front ()->GetBoundaries ().xMax;
+  double minY = m_buildings.front ()->GetBoundaries ().yMin;
+  double maxY = m_buildings.front ()->GetBoundaries ().yMax;
+  double sumExtent = 0;
+  for (std::vector<Ptr<Building> >::const_iterator it = m_buildings.begin (); it != m_buildings.end (); ++it)
+    {
+      Box box = (*it)->GetBoundaries ();
+      minX = std::min (minX, box.xMin);
+      maxX = std::max (maxX, box.xMax);
+      minY = std::min (minY, box.yMin);
+      maxY = std::max (maxY, box.yMax);
+      sumExtent += std::max (box.xMax - box.xMin, box.yMax - box.yMin);
+    }
+  // cells of the size of an average building, but no more than about four
+  // cells per building
+  double n = m_buildings.size ();
+  double cellSize = std::max (sumExtent / n, std::sqrt ((maxX - minX) * (maxY - minY) / (4 * n)));
+  if (!(cellSize > 0))
+    {
+      cellSize = 1;
+    }
+  m_indexMinX = minX;
+  m_indexMinY = minY;
+  m_indexCellSize = cellSize;
+  m_indexNx = static_cast<uint32_t> (std::floor ((maxX - minX) / cellSize)) + 1;
+  m_indexNy = static_cast<uint32_t> (std::floor ((maxY - minY) / cellSize)) + 1;
+  m_indexCells.resize (static_cast<std::size_t> (m_indexNx) * m_indexNy);
+  for (uint32_t i = 0; i < m_buildings.size (); i++)
+    {
+      Box box = m_buildings[i]->GetBoundaries ();
+      uint32_t x0 = GetCell (box.xMin, minX, m_indexNx);
+      uint32_t x1 = GetCell (box.xMax, minX, m_indexNx);
+      uint32_t y0 = GetCell (box.yMin, minY, m_indexNy);
+      uint32_t y1 = GetCell (box.yMax, minY, m_indexNy);
+      for (uint32_t x = x0; x <= x1; x++)
+        {
+          for (uint32_t y = y0; y <= y1; y++)
+            {
+              m_indexCells[static_cast<std::size_t> (y) * m_indexNx + x].push_back (i);
+            }
+        }
+    }
+  NS_LOG_DEBUG ("Grid of " << m_indexNx << "x" << m_indexNy << " cells of " << cellSize << " m");
+}
+
+std::vector<Ptr<Building> >
+BuildingListPriv::GetBuildingsAt (const Vector &position)
+{
+  if (!m_indexValid)
+    {
+      BuildIndex ();
+    }
+  std::vector<Ptr<Building> > buildings;
+  if (m_indexCells.empty ()
+      || position.x < m_indexMinX || position.x > m_indexMinX + m_indexNx * m_indexCellSize
+      || position.y < m_indexMinY || position.y > m_indexMinY + m_indexNy * m_indexCellSize)
+    {
+      return buildings;
+    }
+  uint32_t x = GetCell (position.x, m_indexMinX, m_indexNx);
+  uint32_t y = GetCell (position.y, m_indexMinY, m_indexNy);
+  const std::vector<uint32_t> &cell = m_indexCells[static_cast<std::size_t> (y) * m_indexNx + x];
+  for (std::vector<uint32_t>::const_iterator it = cell.begin (); it != cell.end (); ++it)
+    {
+      if (m_buildings[*it]->IsInside (position))
+        {
+          buildings.push_back (m_buildings[*it]);
+        }
+    }
+  return buildings;
+}
+
 }
 
 /**
@@ -189,5 +322,15 @@ BuildingList::GetNBuildings (void)
 {
   return BuildingListPriv::Get ()->GetNBuildings ();
 }
+std::vector<Ptr<Building> >
+BuildingList::GetBuildingsAt (const Vector &position)
+{
+  return BuildingListPriv::Get ()->GetBuildingsAt (position);
+}
+void
+BuildingList::NotifyBoundariesChanged (void)
+{
+  BuildingListPriv::Get ()->InvalidateIndex ();
+}
 
 } // namespace ns3
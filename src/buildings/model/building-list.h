@@ -25,6 +25,7 @@
 
 #include <vector>
 #include "ns3/ptr.h"
+#include "ns3/vector.h"
 
 namespace ns3 {
 
@@ -62,6 +63,23 @@ public:
    * \returns the number of buildings currently in the list.
    */
   static uint32_t GetNBuildings (void);
+  /**
+   * \param position a position
+   * \returns the buildings whose boundaries contain the position
+   *
+   * The buildings are looked up in a uniform grid over their boundaries,
+   * which is built on first use after a building is added or its
+   * boundaries are changed, so that the cost of a lookup does not depend
+   * on the number of buildings.
+   */
+  static std::vector<Ptr<Building> > GetBuildingsAt (const Vector &position);
+  /**
+   * Notify the list that the boundaries of a building changed.
+   *
+   * This method is called automatically from Building::SetBoundaries so
+   * the user has little reason to call it himself.
+   */
+  static void NotifyBoundariesChanged (void);
 };
 
 } // namespace ns3
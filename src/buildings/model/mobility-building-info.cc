@@ -22,6 +22,9 @@
 #include <ns3/simulator.h>
 #include <ns3/position-allocator.h>
 #include <ns3/mobility-building-info.h>
+#include <ns3/mobility-model.h>
+#include <ns3/building-list.h>
+#include <ns3/abort.h>
 #include <ns3/pointer.h>
 #include <ns3/log.h>
 #include <ns3/assert.h>
@@ -155,5 +158,23 @@ MobilityBuildingInfo::GetBuilding ()
   return (m_myBuilding);
 }
 
+void
+MobilityBuildingInfo::MakeConsistent (Ptr<MobilityModel> mm)
+{
+  NS_LOG_FUNCTION (this << mm);
+  Vector pos = mm->GetPosition ();
+  std::vector<Ptr<Building> > buildings = BuildingList::GetBuildingsAt (pos);
+  NS_ABORT_MSG_IF (buildings.size () > 1, "MobilityBuildingInfo " << this << " pos " << pos << " is inside several buildings!");
+  if (buildings.empty ())
+    {
+      NS_LOG_LOGIC ("MobilityBuildingInfo " << this << " pos " << pos << " is outdoor");
+      SetOutdoor ();
+      return;
+    }
+  Ptr<Building> building = buildings.front ();
+  NS_LOG_LOGIC ("MobilityBuildingInfo " << this << " pos " << pos << " falls inside building " << building->GetId ());
+  SetIndoor (building, building->GetFloor (pos), building->GetRoomX (pos), building->GetRoomY (pos));
+}
+
   
 } // namespace
@@ -35,6 +35,8 @@
 
 namespace ns3 {
 
+class MobilityModel;
+
 
 /**
  * \ingroup buildings
@@ -106,7 +108,14 @@ public:
    * \return 
    */
   Ptr<Building> GetBuilding ();
-
+  /**
+   * Make this MobilityBuildingInfo instance consistent with the position of
+   * the given mobility model, by looking up the building containing it, if
+   * any, in the BuildingList
+   *
+   * \param mm the mobility model this MobilityBuildingInfo instance is aggregated to
+   */
+  void MakeConsistent (Ptr<MobilityModel> mm);
 
 
 private:
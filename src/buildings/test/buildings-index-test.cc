@@ -0,0 +1,212 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/test.h"
+#include <ns3/building.h>
+#include <ns3/building-list.h>
+#include <ns3/buildings-helper.h>
+#include <ns3/mobility-building-info.h>
+#include <ns3/constant-position-mobility-model.h>
+#include <ns3/random-variable-stream.h>
+#include <ns3/simulator.h>
+#include <fstream>
+#include <algorithm>
+
+using namespace ns3;
+
+/**
+ * \ingroup buildings
+ * \ingroup tests
+ *
+ * \brief Check BuildingList::GetBuildingsAt against a linear search over
+ * all the buildings
+ */
+class BuildingsIndexTestCase : public TestCase
+{
+public:
+  BuildingsIndexTestCase ();
+  virtual ~BuildingsIndexTestCase ();
+
+private:
+  virtual void DoRun (void);
+  /**
+   * Compare the buildings found by BuildingList::GetBuildingsAt at random
+   * positions with those found by a linear search
+   * \param random the random variable used to draw the positions
+   */
+  void CheckRandomPositions (Ptr<UniformRandomVariable> random);
+};
+
+BuildingsIndexTestCase::BuildingsIndexTestCase ()
+  : TestCase ("Check the spatial index of BuildingList")
+{
+}
+
+BuildingsIndexTestCase::~BuildingsIndexTestCase ()
+{
+}
+
+void
+BuildingsIndexTestCase::CheckRandomPositions (Ptr<UniformRandomVariable> random)
+{
+  for (uint32_t i = 0; i < 5000; i++)
+    {
+      Vector position (random->GetValue (-100, 1100), random->GetValue (-100, 1100), random->GetValue (0, 40));
+      std::vector<uint32_t> expected;
+      for (BuildingList::Iterator it = BuildingList::Begin (); it != BuildingList::End (); ++it)
+        {
+          if ((*it)->IsInside (position))
+            {
+              expected.push_back ((*it)->GetId ());
+            }
+        }
+      std::vector<Ptr<Building> > buildings = BuildingList::GetBuildingsAt (position);
+      std::vector<uint32_t> found;
+      for (std::vector<Ptr<Building> >::const_iterator it = buildings.begin (); it != buildings.end (); ++it)
+        {
+          found.push_back ((*it)->GetId ());
+        }
+      std::sort (found.begin (), found.end ());
+      NS_TEST_ASSERT_MSG_EQ ((found == expected), true, "Unexpected buildings at " << position);
+    }
+  // positions on the boundaries of a building
+  Ptr<Building> building = BuildingList::GetBuilding (0);
+  Box box = building->GetBoundaries ();
+  std::vector<Ptr<Building> > buildings = BuildingList::GetBuildingsAt (Vector (box.xMax, box.yMax, box.zMax));
+  NS_TEST_ASSERT_MSG_EQ ((std::find (buildings.begin (), buildings.end (), building) != buildings.end ()), true,
+                         "The corner of a building should be inside it");
+  buildings = BuildingList::GetBuildingsAt (Vector (box.xMin, box.yMin, box.zMin));
+  NS_TEST_ASSERT_MSG_EQ ((std::find (buildings.begin (), buildings.end (), building) != buildings.end ()), true,
+                         "The corner of a building should be inside it");
+}
+
+void
+BuildingsIndexTestCase::DoRun (void)
+{
+  Ptr<UniformRandomVariable> random = CreateObject<UniformRandomVariable> ();
+  random->SetStream (1);
+  for (uint32_t i = 0; i < 1000; i++)
+    {
+      double x = random->GetValue (0, 1000);
+      double y = random->GetValue (0, 1000);
+      // a few large buildings
+      double size = (i % 100 == 0) ? 200 : random->GetValue (5, 30);
+      Ptr<Building> building = CreateObject<Building> ();
+      building->SetBoundaries (Box (x, x + size, y, y + size / 2, 0, random->GetValue (3, 30)));
+    }
+  CheckRandomPositions (random);
+
+  // the index follows the changes of the boundaries and new buildings
+  for (uint32_t i = 0; i < 1000; i += 7)
+    {
+      double x = random->GetValue (0, 1000);
+      double y = random->GetValue (0, 1000);
+      BuildingList::GetBuilding (i)->SetBoundaries (Box (x, x + 10, y, y + 10, 0, 10));
+    }
+  Ptr<Building> building = CreateObject<Building> ();
+  building->SetBoundaries (Box (-50, -40, -50, -40, 0, 10));
+  CheckRandomPositions (random);
+  NS_TEST_ASSERT_MSG_EQ (BuildingList::GetBuildingsAt (Vector (-45, -45, 5)).size (), 1, "The new building should be found");
+
+  Simulator::Destroy ();
+}
+
+/**
+ * \ingroup buildings
+ * \ingroup tests
+ *
+ * \brief Check BuildingsHelper::LoadBuildings and the consistency of the
+ * mobility models with the loaded buildings
+ */
+class BuildingsLoaderTestCase : public TestCase
+{
+public:
+  BuildingsLoaderTestCase ();
+  virtual ~BuildingsLoaderTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+BuildingsLoaderTestCase::BuildingsLoaderTestCase ()
+  : TestCase ("Check the loading of buildings from a file")
+{
+}
+
+BuildingsLoaderTestCase::~BuildingsLoaderTestCase ()
+{
+}
+
+void
+BuildingsLoaderTestCase::DoRun (void)
+{
+  std::string filename = CreateTempDirFilename ("buildings.txt");
+  std::ofstream ofs (filename.c_str ());
+  ofs << "# xMin xMax yMin yMax zMin zMax [type extWallsType nFloors nRoomsX nRoomsY]" << std::endl
+      << "0 10 0 20 0 9" << std::endl
+      << std::endl
+      << "20 40 0 20 0 30 Office StoneBlocks 10 2 4" << std::endl;
+  ofs.close ();
+
+  BuildingContainer buildings = BuildingsHelper::LoadBuildings (filename);
+  NS_TEST_ASSERT_MSG_EQ (buildings.GetN (), 2, "Unexpected number of buildings");
+  NS_TEST_ASSERT_MSG_EQ (BuildingList::GetNBuildings (), 2, "Unexpected number of buildings");
+  Ptr<Building> office = buildings.Get (1);
+  NS_TEST_ASSERT_MSG_EQ (office->GetBoundaries ().xMax, 40, "Unexpected boundaries");
+  NS_TEST_ASSERT_MSG_EQ (office->GetBoundaries ().zMax, 30, "Unexpected boundaries");
+  NS_TEST_ASSERT_MSG_EQ (office->GetBuildingType (), Building::Office, "Unexpected building type");
+  NS_TEST_ASSERT_MSG_EQ (office->GetExtWallsType (), Building::StoneBlocks, "Unexpected external walls type");
+  NS_TEST_ASSERT_MSG_EQ (office->GetNFloors (), 10, "Unexpected number of floors");
+  NS_TEST_ASSERT_MSG_EQ (office->GetNRoomsX (), 2, "Unexpected number of rooms");
+  NS_TEST_ASSERT_MSG_EQ (office->GetNRoomsY (), 4, "Unexpected number of rooms");
+
+  Ptr<MobilityModel> mobility = CreateObject<ConstantPositionMobilityModel> ();
+  Ptr<MobilityBuildingInfo> buildingInfo = CreateObject<MobilityBuildingInfo> ();
+  mobility->AggregateObject (buildingInfo);
+  mobility->SetPosition (Vector (35, 15, 10));
+  BuildingsHelper::MakeConsistent (mobility);
+  NS_TEST_ASSERT_MSG_EQ (buildingInfo->IsIndoor (), true, "The node should be indoor");
+  NS_TEST_ASSERT_MSG_EQ (buildingInfo->GetBuilding (), office, "The node should be in the office building");
+  NS_TEST_ASSERT_MSG_EQ ((uint16_t) buildingInfo->GetFloorNumber (), 4, "Unexpected floor");
+  NS_TEST_ASSERT_MSG_EQ ((uint16_t) buildingInfo->GetRoomNumberX (), 2, "Unexpected room");
+  NS_TEST_ASSERT_MSG_EQ ((uint16_t) buildingInfo->GetRoomNumberY (), 4, "Unexpected room");
+  mobility->SetPosition (Vector (15, 15, 1));
+  BuildingsHelper::MakeConsistent (mobility);
+  NS_TEST_ASSERT_MSG_EQ (buildingInfo->IsOutdoor (), true, "The node should be outdoor");
+
+  Simulator::Destroy ();
+}
+
+/**
+ * \ingroup buildings
+ * \ingroup tests
+ *
+ * \brief Buildings index Test Suite
+ */
+class BuildingsIndexTestSuite : public TestSuite
+{
+public:
+  BuildingsIndexTestSuite ();
+};
+
+BuildingsIndexTestSuite::BuildingsIndexTestSuite ()
+  : TestSuite ("buildings-index", UNIT)
+{
+  AddTestCase (new BuildingsIndexTestCase, TestCase::QUICK);
+  AddTestCase (new BuildingsLoaderTestCase, TestCase::QUICK);
+}
+
+static BuildingsIndexTestSuite g_buildingsIndexTestSuite; //!< the test suite
@@ -0,0 +1,320 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// Benchmark of the LTE MAC schedulers with many UEs per cell.
+//
+// The program drives a single FF MAC scheduler directly through its SAPs,
+// without PHY, MAC or RRC, so that it measures the cost of the scheduler
+// alone.  The LTE protocol stack cannot attach more than a few hundred UEs
+// to a cell (its SRS configuration indexes are exhausted first), while the
+// scheduler state scales with the number of RNTIs: here nUes UEs with
+// RNTIs 1..nUes are configured with a full-buffer data radio bearer each.
+//
+// Every TTI, the program reports the DL wideband CQIs of 1 UE out of
+// cqiPeriod, the UL PUSCH SINRs of the last UL allocation, and refreshes
+// the BSRs of 1 UE out of bsrPeriod, then triggers the DL and UL
+// scheduling.  HARQ is disabled, so that no feedback is needed.
+//
+// Several command line arguments can change the following options:
+// --scheduler (the TypeId of the scheduler, or "all")
+// --nUes (number of UEs in the cell), --ttis (number of scheduled TTIs)
+// --bandwidth (number of RBs in DL and UL)
+//
+// The program reports, for each scheduler, the wall clock time per TTI
+// and the number of DL and UL bytes which were allocated.  The allocated
+// bytes are deterministic, and can be compared across versions of the
+// schedulers.
+
+#include <iostream>
+#include <iomanip>
+#include "ns3/core-module.h"
+#include "ns3/ff-mac-scheduler.h"
+#include "ns3/ff-mac-csched-sap.h"
+#include "ns3/ff-mac-sched-sap.h"
+#include "ns3/lte-fr-no-op-algorithm.h"
+#include "ns3/lte-common.h"
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("LenaSchedulerBench");
+
+/**
+ * The MAC side of the scheduler SAPs: records the allocations of the
+ * scheduler.
+ */
+class BenchMac : public FfMacSchedSapUser,
+                 public FfMacCschedSapUser
+{
+public:
+  BenchMac ()
+    : m_dlBytes (0),
+      m_ulBytes (0),
+      m_dlUes (0),
+      m_ulUes (0),
+      m_ulAllocation (false)
+  {
+  }
+
+  // FfMacSchedSapUser
+  virtual void SchedDlConfigInd (const struct SchedDlConfigIndParameters& params)
+  {
+    for (uint32_t i = 0; i < params.m_buildDataList.size (); i++)
+      {
+        const std::vector<uint16_t> &tbs = params.m_buildDataList.at (i).m_dci.m_tbsSize;
+        for (uint32_t j = 0; j < tbs.size (); j++)
+          {
+            m_dlBytes += tbs.at (j);
+          }
+      }
+    m_dlUes += params.m_buildDataList.size ();
+  }
+  virtual void SchedUlConfigInd (const struct SchedUlConfigIndParameters& params)
+  {
+    for (uint32_t i = 0; i < params.m_dciList.size (); i++)
+      {
+        m_ulBytes += params.m_dciList.at (i).m_tbSize;
+      }
+    m_ulUes += params.m_dciList.size ();
+    m_ulAllocation = !params.m_dciList.empty ();
+  }
+
+  // FfMacCschedSapUser
+  virtual void CschedCellConfigCnf (const struct CschedCellConfigCnfParameters& params)
+  {
+  }
+  virtual void CschedUeConfigCnf (const struct CschedUeConfigCnfParameters& params)
+  {
+  }
+  virtual void CschedLcConfigCnf (const struct CschedLcConfigCnfParameters& params)
+  {
+  }
+  virtual void CschedLcReleaseCnf (const struct CschedLcReleaseCnfParameters& params)
+  {
+  }
+  virtual void CschedUeReleaseCnf (const struct CschedUeReleaseCnfParameters& params)
+  {
+  }
+  virtual void CschedUeConfigUpdateInd (const struct CschedUeConfigUpdateIndParameters& params)
+  {
+  }
+  virtual void CschedCellConfigUpdateInd (const struct CschedCellConfigUpdateIndParameters& params)
+  {
+  }
+
+  uint64_t m_dlBytes;   ///< allocated DL bytes
+  uint64_t m_ulBytes;   ///< allocated UL bytes
+  uint64_t m_dlUes;     ///< number of DL allocations
+  uint64_t m_ulUes;     ///< number of UL allocations
+  bool m_ulAllocation;  ///< whether the last UL scheduling allocated RBs
+};
+
+/**
+ * Configure a scheduler with nUes UEs and run it for a number of TTIs
+ *
+ * \param schedulerType the TypeId of the scheduler
+ * \param nUes the number of UEs
+ * \param ttis the number of TTIs
+ * \param bandwidth the number of RBs
+ * \param cqiPeriod the period of the DL CQI reports of each UE, in TTIs
+ * \param bsrPeriod the period of the BSRs of each UE, in TTIs
+ */
+static void
+RunScheduler (std::string schedulerType, uint16_t nUes, uint32_t ttis, uint8_t bandwidth,
+              uint32_t cqiPeriod, uint32_t bsrPeriod)
+{
+  ObjectFactory factory;
+  factory.SetTypeId (schedulerType);
+  factory.Set ("HarqEnabled", BooleanValue (false));
+  factory.Set ("UlCqiFilter", EnumValue (FfMacScheduler::PUSCH_UL_CQI));
+  Ptr<FfMacScheduler> scheduler = factory.Create<FfMacScheduler> ();
+  Ptr<LteFfrAlgorithm> ffr = CreateObject<LteFrNoOpAlgorithm> ();
+  ffr->SetDlBandwidth (bandwidth);
+  ffr->SetUlBandwidth (bandwidth);
+  scheduler->SetLteFfrSapProvider (ffr->GetLteFfrSapProvider ());
+  ffr->SetLteFfrSapUser (scheduler->GetLteFfrSapUser ());
+  BenchMac mac;
+  scheduler->SetFfMacSchedSapUser (&mac);
+  scheduler->SetFfMacCschedSapUser (&mac);
+  scheduler->Initialize ();
+  ffr->Initialize ();
+  FfMacSchedSapProvider *sched = scheduler->GetFfMacSchedSapProvider ();
+  FfMacCschedSapProvider *csched = scheduler->GetFfMacCschedSapProvider ();
+
+  SystemWallClockMs setupClock;
+  setupClock.Start ();
+  FfMacCschedSapProvider::CschedCellConfigReqParameters cellConfig;
+  cellConfig.m_ulBandwidth = bandwidth;
+  cellConfig.m_dlBandwidth = bandwidth;
+  csched->CschedCellConfigReq (cellConfig);
+  for (uint16_t rnti = 1; rnti <= nUes; rnti++)
+    {
+      FfMacCschedSapProvider::CschedUeConfigReqParameters ueConfig;
+      ueConfig.m_rnti = rnti;
+      ueConfig.m_reconfigureFlag = false;
+      ueConfig.m_transmissionMode = 0;
+      csched->CschedUeConfigReq (ueConfig);
+
+      LogicalChannelConfigListElement_s lc;
+      lc.m_logicalChannelIdentity = 3;
+      lc.m_logicalChannelGroup = 1;
+      lc.m_direction = LogicalChannelConfigListElement_s::DIR_BOTH;
+      lc.m_qosBearerType = LogicalChannelConfigListElement_s::QBT_NON_GBR;
+      lc.m_qci = 9;
+      lc.m_eRabMaximulBitrateUl = 0;
+      lc.m_eRabMaximulBitrateDl = 0;
+      lc.m_eRabGuaranteedBitrateUl = 0;
+      lc.m_eRabGuaranteedBitrateDl = 0;
+      FfMacCschedSapProvider::CschedLcConfigReqParameters lcConfig;
+      lcConfig.m_rnti = rnti;
+      lcConfig.m_reconfigureFlag = false;
+      lcConfig.m_logicalChannelConfigList.push_back (lc);
+      csched->CschedLcConfigReq (lcConfig);
+
+      FfMacSchedSapProvider::SchedDlRlcBufferReqParameters rlc;
+      rlc.m_rnti = rnti;
+      rlc.m_logicalChannelIdentity = 3;
+      rlc.m_rlcTransmissionQueueSize = 100000000;
+      rlc.m_rlcTransmissionQueueHolDelay = 10;
+      rlc.m_rlcRetransmissionQueueSize = 0;
+      rlc.m_rlcRetransmissionHolDelay = 0;
+      rlc.m_rlcStatusPduSize = 0;
+      sched->SchedDlRlcBufferReq (rlc);
+    }
+  setupClock.End ();
+
+  SystemWallClockMs runClock;
+  runClock.Start ();
+  uint16_t lastUlSfnSf = 0;
+  for (uint32_t tti = 0; tti < ttis; tti++)
+    {
+      uint32_t frameNo = 1 + (tti / 10) % 1023;
+      uint32_t subframeNo = 1 + tti % 10;
+      uint16_t sfnSf = ((0x3FF & frameNo) << 4) | (0xF & subframeNo);
+
+      FfMacSchedSapProvider::SchedDlCqiInfoReqParameters dlCqi;
+      dlCqi.m_sfnSf = sfnSf;
+      for (uint16_t rnti = 1 + tti % cqiPeriod; rnti <= nUes; rnti += cqiPeriod)
+        {
+          CqiListElement_s cqi;
+          cqi.m_rnti = rnti;
+          cqi.m_ri = 1;
+          cqi.m_cqiType = CqiListElement_s::P10;
+          cqi.m_wbCqi.push_back (1 + (rnti * 7 + tti / cqiPeriod) % 15);
+          cqi.m_wbPmi = 0;
+          dlCqi.m_cqiList.push_back (cqi);
+        }
+      sched->SchedDlCqiInfoReq (dlCqi);
+
+      FfMacSchedSapProvider::SchedDlTriggerReqParameters dlTrigger;
+      dlTrigger.m_sfnSf = sfnSf;
+      sched->SchedDlTriggerReq (dlTrigger);
+
+      if (mac.m_ulAllocation)
+        {
+          // SINRs of the RBs allocated by the last UL scheduling
+          FfMacSchedSapProvider::SchedUlCqiInfoReqParameters ulCqi;
+          ulCqi.m_sfnSf = lastUlSfnSf;
+          ulCqi.m_ulCqi.m_type = UlCqi_s::PUSCH;
+          for (uint32_t rb = 0; rb < bandwidth; rb++)
+            {
+              ulCqi.m_ulCqi.m_sinr.push_back (LteFfConverter::double2fpS11dot3 (5.0 + (tti + rb) % 20));
+            }
+          sched->SchedUlCqiInfoReq (ulCqi);
+        }
+
+      FfMacSchedSapProvider::SchedUlMacCtrlInfoReqParameters bsr;
+      bsr.m_sfnSf = sfnSf;
+      for (uint16_t rnti = 1 + tti % bsrPeriod; rnti <= nUes; rnti += bsrPeriod)
+        {
+          MacCeListElement_s ce;
+          ce.m_rnti = rnti;
+          ce.m_macCeType = MacCeListElement_s::BSR;
+          ce.m_macCeValue.m_bufferStatus.resize (4, 0);
+          ce.m_macCeValue.m_bufferStatus.at (0) = 40;
+          bsr.m_macCeList.push_back (ce);
+        }
+      sched->SchedUlMacCtrlInfoReq (bsr);
+
+      FfMacSchedSapProvider::SchedUlTriggerReqParameters ulTrigger;
+      ulTrigger.m_sfnSf = sfnSf;
+      lastUlSfnSf = sfnSf;
+      sched->SchedUlTriggerReq (ulTrigger);
+    }
+  int64_t runMs = runClock.End ();
+
+  std::cout << std::left << std::setw (28) << schedulerType
+            << " setup " << std::setw (6) << setupClock.GetElapsedReal () << " ms"
+            << "  run " << std::setw (7) << runMs << " ms"
+            << "  " << std::setw (8) << std::fixed << std::setprecision (2) << (1000.0 * runMs / ttis) << " us/TTI"
+            << "  DL " << mac.m_dlBytes << " bytes, " << mac.m_dlUes << " allocations"
+            << "  UL " << mac.m_ulBytes << " bytes, " << mac.m_ulUes << " allocations"
+            << std::endl;
+
+  scheduler->Dispose ();
+  ffr->Dispose ();
+}
+
+int
+main (int argc, char *argv[])
+{
+  std::string schedulerType ("all");
+  uint32_t nUes = 1000;
+  uint32_t ttis = 1000;
+  uint32_t bandwidth = 100;
+  uint32_t cqiPeriod = 10;
+  uint32_t bsrPeriod = 20;
+
+  CommandLine cmd;
+  cmd.AddValue ("scheduler", "TypeId of the scheduler, or all", schedulerType);
+  cmd.AddValue ("nUes", "Number of UEs in the cell", nUes);
+  cmd.AddValue ("ttis", "Number of scheduled TTIs", ttis);
+  cmd.AddValue ("bandwidth", "Number of RBs in DL and UL", bandwidth);
+  cmd.AddValue ("cqiPeriod", "Period of the DL CQI reports of each UE (TTIs)", cqiPeriod);
+  cmd.AddValue ("bsrPeriod", "Period of the BSRs of each UE (TTIs)", bsrPeriod);
+  cmd.Parse (argc, argv);
+
+  NS_ABORT_MSG_IF (nUes == 0 || nUes > 65000, "The number of UEs must be in 1..65000");
+  NS_ABORT_MSG_IF (bandwidth < 6 || bandwidth > 100, "The bandwidth must be in 6..100 RBs");
+  NS_ABORT_MSG_IF (cqiPeriod == 0 || bsrPeriod == 0, "The report periods must be positive");
+
+  std::vector<std::string> schedulers;
+  if (schedulerType == "all")
+    {
+      schedulers.push_back ("ns3::RrFfMacScheduler");
+      schedulers.push_back ("ns3::PfFfMacScheduler");
+      schedulers.push_back ("ns3::FdMtFfMacScheduler");
+      schedulers.push_back ("ns3::TdMtFfMacScheduler");
+      schedulers.push_back ("ns3::TtaFfMacScheduler");
+      schedulers.push_back ("ns3::FdBetFfMacScheduler");
+      schedulers.push_back ("ns3::TdBetFfMacScheduler");
+      schedulers.push_back ("ns3::FdTbfqFfMacScheduler");
+      schedulers.push_back ("ns3::TdTbfqFfMacScheduler");
+      schedulers.push_back ("ns3::PssFfMacScheduler");
+      schedulers.push_back ("ns3::CqaFfMacScheduler");
+    }
+  else
+    {
+      schedulers.push_back (schedulerType);
+    }
+
+  std::cout << nUes << " UEs, " << bandwidth << " RBs, " << ttis << " TTIs" << std::endl;
+  for (uint32_t i = 0; i < schedulers.size (); i++)
+    {
+      RunScheduler (schedulers[i], nUes, ttis, bandwidth, cqiPeriod, bsrPeriod);
+    }
+  Simulator::Destroy ();
+  return 0;
+}
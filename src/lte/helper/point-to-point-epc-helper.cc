@@ -26,6 +26,8 @@
 #include <ns3/mac48-address.h>
 #include <ns3/string.h>
 #include <ns3/boolean.h>
+#include <ns3/uinteger.h>
+#include <ns3/abort.h>
 #include <ns3/eps-bearer.h>
 #include <ns3/ipv4-address.h>
 #include <ns3/internet-stack-helper.h>
@@ -34,6 +36,8 @@
 #include <ns3/packet-socket-address.h>
 #include <ns3/epc-enb-application.h>
 #include <ns3/epc-sgw-pgw-application.h>
+#include "ns3/ipv4-static-routing.h"
+#include "ns3/ipv4-static-routing-helper.h"
 #include "ns3/ipv6-static-routing.h"
 #include "ns3/ipv6-static-routing-helper.h"
 #include <ns3/lte-enb-rrc.h>
@@ -73,64 +77,90 @@ PointToPointEpcHelper::PointToPointEpcHelper ()
   // we use a /64 IPv6 net all UEs
   m_uePgwAddressHelper6.SetBase ("7777:f00d::", Ipv6Prefix (64));
 
-  // create SgwPgwNode
-  m_sgwPgw = CreateObject<Node> ();
-  InternetStackHelper internet;
-  internet.Install (m_sgwPgw);
+  // UEs are sharded over the SGW/PGW nodes by the low bits of their
+  // IPv4 address, hence a power of two
+  NS_ABORT_MSG_IF (m_numberOfSgwPgwShards == 0 || (m_numberOfSgwPgwShards & (m_numberOfSgwPgwShards - 1)) != 0,
+                   "NumberOfSgwPgwShards must be a power of two");
 
-  // The Tun device resides in different 64 bit subnet.
-  // We must create an unique route to tun device for all the packets destined
-  // to all 64 bit IPv6 prefixes of UEs, based by the unique 48 bit network prefix of this EPC network
+  InternetStackHelper internet;
   Ipv6StaticRoutingHelper ipv6RoutingHelper;
-  Ptr<Ipv6StaticRouting> pgwStaticRouting = ipv6RoutingHelper.GetStaticRouting (m_sgwPgw->GetObject<Ipv6> ());
-  pgwStaticRouting->AddNetworkRouteTo ("7777:f00d::", Ipv6Prefix (64), Ipv6Address ("::"), 1, 0);
-  
-  // create S1-U socket
-  Ptr<Socket> sgwPgwS1uSocket = Socket::CreateSocket (m_sgwPgw, TypeId::LookupByName ("ns3::UdpSocketFactory"));
-  int retval = sgwPgwS1uSocket->Bind (InetSocketAddress (Ipv4Address::GetAny (), m_gtpuUdpPort));
-  NS_ASSERT (retval == 0);
+  for (uint16_t shard = 0; shard < m_numberOfSgwPgwShards; ++shard)
+    {
+      // create SgwPgwNode
+      Ptr<Node> sgwPgw = CreateObject<Node> ();
+      internet.Install (sgwPgw);
 
-  // create TUN device implementing tunneling of user data over GTP-U/UDP/IP 
-  m_tunDevice = CreateObject<VirtualNetDevice> ();
+      // The Tun device resides in different 64 bit subnet.
+      // We must create an unique route to tun device for all the packets destined
+      // to all 64 bit IPv6 prefixes of UEs, based by the unique 48 bit network prefix of this EPC network
+      Ptr<Ipv6StaticRouting> pgwStaticRouting = ipv6RoutingHelper.GetStaticRouting (sgwPgw->GetObject<Ipv6> ());
+      pgwStaticRouting->AddNetworkRouteTo ("7777:f00d::", Ipv6Prefix (64), Ipv6Address ("::"), 1, 0);
 
-  // allow jumbo packets
-  m_tunDevice->SetAttribute ("Mtu", UintegerValue (30000));
+      // create S1-U socket
+      Ptr<Socket> sgwPgwS1uSocket = Socket::CreateSocket (sgwPgw, TypeId::LookupByName ("ns3::UdpSocketFactory"));
+      int retval = sgwPgwS1uSocket->Bind (InetSocketAddress (Ipv4Address::GetAny (), m_gtpuUdpPort));
+      NS_ASSERT (retval == 0);
 
-  // yes we need this
-  m_tunDevice->SetAddress (Mac48Address::Allocate ());
+      // create TUN device implementing tunneling of user data over GTP-U/UDP/IP 
+      Ptr<VirtualNetDevice> tunDevice = CreateObject<VirtualNetDevice> ();
 
-  m_sgwPgw->AddDevice (m_tunDevice);
-  NetDeviceContainer tunDeviceContainer;
-  tunDeviceContainer.Add (m_tunDevice);
-  
-  // the TUN device is on the same subnet as the UEs, so when a packet
-  // addressed to an UE arrives at the intenet to the WAN interface of
-  // the PGW it will be forwarded to the TUN device. 
-  Ipv4InterfaceContainer tunDeviceIpv4IfContainer = AssignUeIpv4Address (tunDeviceContainer);  
+      // allow jumbo packets
+      tunDevice->SetAttribute ("Mtu", UintegerValue (30000));
 
+      // yes we need this
+      tunDevice->SetAddress (Mac48Address::Allocate ());
 
-  // the TUN device for IPv6 address is on the different subnet as the
-  // UEs, it will forward the UE packets as we have inserted the route
-  // for all UEs at the time of assigning UE addresses
-  Ipv6InterfaceContainer tunDeviceIpv6IfContainer = AssignUeIpv6Address (tunDeviceContainer);
+      sgwPgw->AddDevice (tunDevice);
+      NetDeviceContainer tunDeviceContainer;
+      tunDeviceContainer.Add (tunDevice);
 
+      // the TUN device is on the same subnet as the UEs, so when a packet
+      // addressed to an UE arrives at the intenet to the WAN interface of
+      // the PGW it will be forwarded to the TUN device. 
+      Ipv4InterfaceContainer tunDeviceIpv4IfContainer = AssignUeIpv4Address (tunDeviceContainer);  
 
-  //Set Forwarding of the IPv6 interface
-  tunDeviceIpv6IfContainer.SetForwarding (0,true);
-  tunDeviceIpv6IfContainer.SetDefaultRouteInAllNodes (0);
 
-  // create EpcSgwPgwApplication
-  m_sgwPgwApp = CreateObject<EpcSgwPgwApplication> (m_tunDevice, sgwPgwS1uSocket);
-  m_sgwPgw->AddApplication (m_sgwPgwApp);
-  
-  // connect SgwPgwApplication and virtual net device for tunneling
-  m_tunDevice->SetSendCallback (MakeCallback (&EpcSgwPgwApplication::RecvFromTunDevice, m_sgwPgwApp));
+      // the TUN device for IPv6 address is on the different subnet as the
+      // UEs, it will forward the UE packets as we have inserted the route
+      // for all UEs at the time of assigning UE addresses
+      Ipv6InterfaceContainer tunDeviceIpv6IfContainer = AssignUeIpv6Address (tunDeviceContainer);
 
 
+      //Set Forwarding of the IPv6 interface
+      tunDeviceIpv6IfContainer.SetForwarding (0,true);
+      tunDeviceIpv6IfContainer.SetDefaultRouteInAllNodes (0);
+
+      // create EpcSgwPgwApplication; shard k allocates the TEIDs t with
+      // (t - 1) modulo the number of shards equal to k, which tells the
+      // eNBs where to send the uplink packets
+      Ptr<EpcSgwPgwApplication> sgwPgwApp = CreateObject<EpcSgwPgwApplication> (tunDevice, sgwPgwS1uSocket);
+      sgwPgwApp->SetTeidAllocation (shard + 1, m_numberOfSgwPgwShards);
+      sgwPgw->AddApplication (sgwPgwApp);
+
+      // connect SgwPgwApplication and virtual net device for tunneling
+      tunDevice->SetSendCallback (MakeCallback (&EpcSgwPgwApplication::RecvFromTunDevice, sgwPgwApp));
+
+      m_sgwPgwShards.push_back (sgwPgw);
+      m_sgwPgwApps.push_back (sgwPgwApp);
+      m_tunDevices.push_back (tunDevice);
+    }
+
+  if (m_numberOfSgwPgwShards == 1)
+    {
+      m_sgwPgw = m_sgwPgwShards[0];
+    }
+  else
+    {
+      CreateGiRouter ();
+    }
+
   // Create MME and connect with SGW via S11 interface
   m_mme = CreateObject<EpcMme> ();
-  m_mme->SetS11SapSgw (m_sgwPgwApp->GetS11SapSgw ());
-  m_sgwPgwApp->SetS11SapMme (m_mme->GetS11SapMme ());
+  m_mme->SetS11SapSgw (m_sgwPgwApps[0]->GetS11SapSgw ());
+  for (uint16_t shard = 0; shard < m_numberOfSgwPgwShards; ++shard)
+    {
+      m_sgwPgwApps[shard]->SetS11SapMme (m_mme->GetS11SapMme ());
+    }
 }
 
 PointToPointEpcHelper::~PointToPointEpcHelper ()
@@ -195,6 +225,33 @@ PointToPointEpcHelper::GetTypeId (void)
                    BooleanValue (false),
                    MakeBooleanAccessor (&PointToPointEpcHelper::m_enablePcapOverS1U),
                    MakeBooleanChecker ())
+    .AddAttribute ("NumberOfSgwPgwShards",
+                   "The number of SGW/PGW nodes, a power of two.  With more than one, "
+                   "each UE is served by the SGW/PGW selected by the low bits of its "
+                   "IPv4 address, and the PGW node is a router which forwards the "
+                   "packets of the UEs to their SGW/PGW.  The SGW/PGW nodes are "
+                   "created by the constructor, hence this attribute is to be set "
+                   "with Config::SetDefault.",
+                   TypeId::ATTR_GET | TypeId::ATTR_CONSTRUCT,
+                   UintegerValue (1),
+                   MakeUintegerAccessor (&PointToPointEpcHelper::m_numberOfSgwPgwShards),
+                   MakeUintegerChecker<uint16_t> (1))
+    .AddAttribute ("GiLinkDataRate",
+                   "The data rate of the links between the PGW router and the "
+                   "SGW/PGW nodes, with more than one SGW/PGW; to be set with "
+                   "Config::SetDefault",
+                   TypeId::ATTR_GET | TypeId::ATTR_CONSTRUCT,
+                   DataRateValue (DataRate ("100Gb/s")),
+                   MakeDataRateAccessor (&PointToPointEpcHelper::m_giLinkDataRate),
+                   MakeDataRateChecker ())
+    .AddAttribute ("GiLinkDelay",
+                   "The delay of the links between the PGW router and the "
+                   "SGW/PGW nodes, with more than one SGW/PGW; to be set with "
+                   "Config::SetDefault",
+                   TypeId::ATTR_GET | TypeId::ATTR_CONSTRUCT,
+                   TimeValue (Seconds (0)),
+                   MakeTimeAccessor (&PointToPointEpcHelper::m_giLinkDelay),
+                   MakeTimeChecker ())
   ;
   return tid;
 }
@@ -209,10 +266,73 @@ void
 PointToPointEpcHelper::DoDispose ()
 {
   NS_LOG_FUNCTION (this);
-  m_tunDevice->SetSendCallback (MakeNullCallback<bool, Ptr<Packet>, const Address&, const Address&, uint16_t> ());
-  m_tunDevice = 0;
-  m_sgwPgwApp = 0;  
-  m_sgwPgw->Dispose ();
+  for (uint16_t shard = 0; shard < m_sgwPgwShards.size (); ++shard)
+    {
+      m_tunDevices[shard]->SetSendCallback (MakeNullCallback<bool, Ptr<Packet>, const Address&, const Address&, uint16_t> ());
+      m_sgwPgwShards[shard]->Dispose ();
+    }
+  if (m_sgwPgwShards.size () > 1)
+    {
+      m_sgwPgw->Dispose ();
+    }
+  m_tunDevices.clear ();
+  m_sgwPgwApps.clear ();
+  m_sgwPgwShards.clear ();
+}
+
+void
+PointToPointEpcHelper::CreateGiRouter ()
+{
+  NS_LOG_FUNCTION (this);
+  uint16_t numberOfShards = m_sgwPgwShards.size ();
+
+  m_sgwPgw = CreateObject<Node> ();
+  InternetStackHelper internet;
+  internet.Install (m_sgwPgw);
+
+  // the links carry the IP packets of the UEs, whose size is bounded by
+  // the MTU of the TUN devices
+  PointToPointHelper p2ph;
+  p2ph.SetDeviceAttribute ("DataRate", DataRateValue (m_giLinkDataRate));
+  p2ph.SetDeviceAttribute ("Mtu", UintegerValue (30000));
+  p2ph.SetChannelAttribute ("Delay", TimeValue (m_giLinkDelay));
+  m_giIpv4AddressHelper.SetBase ("11.0.0.0", "255.255.255.252");
+
+  // shard k serves the UEs whose address is 7.0.0.k modulo the number of
+  // shards; the masks are not contiguous, but the static routing matches
+  // them bitwise and prefers them to the /8 route of the TUN devices
+  Ipv4Mask shardMask (0xff000000 | (numberOfShards - 1));
+  uint32_t ueNetwork = Ipv4Address ("7.0.0.0").Get ();
+  Ipv4StaticRoutingHelper ipv4RoutingHelper;
+  Ptr<Ipv4StaticRouting> routerStaticRouting = ipv4RoutingHelper.GetStaticRouting (m_sgwPgw->GetObject<Ipv4> ());
+  std::vector<Ipv4Address> routerAddresses;
+  for (uint16_t shard = 0; shard < numberOfShards; ++shard)
+    {
+      NetDeviceContainer giDevices = p2ph.Install (m_sgwPgw, m_sgwPgwShards[shard]);
+      Ipv4InterfaceContainer giIpIfaces = m_giIpv4AddressHelper.Assign (giDevices);
+      m_giIpv4AddressHelper.NewNetwork ();
+      routerAddresses.push_back (giIpIfaces.GetAddress (0));
+      routerStaticRouting->AddNetworkRouteTo (Ipv4Address (ueNetwork | shard), shardMask,
+                                              giIpIfaces.GetAddress (1), giIpIfaces.Get (0).second);
+    }
+
+  for (uint16_t shard = 0; shard < numberOfShards; ++shard)
+    {
+      // packets to the internet and to the UEs of the other shards go
+      // through the router
+      Ptr<Ipv4> sgwPgwIpv4 = m_sgwPgwShards[shard]->GetObject<Ipv4> ();
+      Ptr<Ipv4StaticRouting> sgwPgwStaticRouting = ipv4RoutingHelper.GetStaticRouting (sgwPgwIpv4);
+      uint32_t giInterface = sgwPgwIpv4->GetNInterfaces () - 1;
+      sgwPgwStaticRouting->SetDefaultRoute (routerAddresses[shard], giInterface);
+      for (uint16_t other = 0; other < numberOfShards; ++other)
+        {
+          if (other != shard)
+            {
+              sgwPgwStaticRouting->AddNetworkRouteTo (Ipv4Address (ueNetwork | other), shardMask,
+                                                      routerAddresses[shard], giInterface);
+            }
+        }
+    }
 }
 
 
@@ -222,41 +342,48 @@ PointToPointEpcHelper::AddEnb (Ptr<Node> enb, Ptr<NetDevice> lteEnbNetDevice, ui
   NS_LOG_FUNCTION (this << enb << lteEnbNetDevice << cellId);
 
   NS_ASSERT (enb == lteEnbNetDevice->GetNode ());
+  NS_ABORT_MSG_IF (m_numberOfSgwPgwShards != m_sgwPgwShards.size (),
+                   "NumberOfSgwPgwShards was set after the SGW/PGW nodes were created; use Config::SetDefault");
 
   // add an IPv4 stack to the previously created eNB
   InternetStackHelper internet;
   internet.Install (enb);
   NS_LOG_LOGIC ("number of Ipv4 ifaces of the eNB after node creation: " << enb->GetObject<Ipv4> ()->GetNInterfaces ());
 
-  // create a point to point link between the new eNB and the SGW with
+  // create a point to point link between the new eNB and each SGW with
   // the corresponding new NetDevices on each side  
-  NodeContainer enbSgwNodes;
-  enbSgwNodes.Add (m_sgwPgw);
-  enbSgwNodes.Add (enb);
   PointToPointHelper p2ph;
   p2ph.SetDeviceAttribute ("DataRate", DataRateValue (m_s1uLinkDataRate));
   p2ph.SetDeviceAttribute ("Mtu", UintegerValue (m_s1uLinkMtu));
   p2ph.SetChannelAttribute ("Delay", TimeValue (m_s1uLinkDelay));
-  NetDeviceContainer enbSgwDevices = p2ph.Install (enb, m_sgwPgw);
-  NS_LOG_LOGIC ("number of Ipv4 ifaces of the eNB after installing p2p dev: " << enb->GetObject<Ipv4> ()->GetNInterfaces ());  
-  Ptr<NetDevice> enbDev = enbSgwDevices.Get (0);
-  Ptr<NetDevice> sgwDev = enbSgwDevices.Get (1);
+  std::vector<Ipv4Address> enbAddresses;
+  std::vector<Ipv4Address> sgwAddresses;
+  for (uint16_t shard = 0; shard < m_sgwPgwShards.size (); ++shard)
+    {
+      NetDeviceContainer enbSgwDevices = p2ph.Install (enb, m_sgwPgwShards[shard]);
+      NS_LOG_LOGIC ("number of Ipv4 ifaces of the eNB after installing p2p dev: " << enb->GetObject<Ipv4> ()->GetNInterfaces ());  
+
+      m_s1uIpv4AddressHelper.NewNetwork ();
+      Ipv4InterfaceContainer enbSgwIpIfaces = m_s1uIpv4AddressHelper.Assign (enbSgwDevices);
+      NS_LOG_LOGIC ("number of Ipv4 ifaces of the eNB after assigning Ipv4 addr to S1 dev: " << enb->GetObject<Ipv4> ()->GetNInterfaces ());
+
+      enbAddresses.push_back (enbSgwIpIfaces.GetAddress (0));
+      sgwAddresses.push_back (enbSgwIpIfaces.GetAddress (1));
+    }
 
   if (m_enablePcapOverS1U)
     {
       p2ph.EnablePcapAll(m_s1uLinkPcapPrefix);
     }
 
-  m_s1uIpv4AddressHelper.NewNetwork ();
-  Ipv4InterfaceContainer enbSgwIpIfaces = m_s1uIpv4AddressHelper.Assign (enbSgwDevices);
-  NS_LOG_LOGIC ("number of Ipv4 ifaces of the eNB after assigning Ipv4 addr to S1 dev: " << enb->GetObject<Ipv4> ()->GetNInterfaces ());
-  
-  Ipv4Address enbAddress = enbSgwIpIfaces.GetAddress (0);
-  Ipv4Address sgwAddress = enbSgwIpIfaces.GetAddress (1);
+  Ipv4Address enbAddress = enbAddresses[0];
+  Ipv4Address sgwAddress = sgwAddresses[0];
 
-  // create S1-U socket for the ENB
+  // create S1-U socket for the ENB; with several SGWs, it receives the
+  // packets on all the S1-U links
   Ptr<Socket> enbS1uSocket = Socket::CreateSocket (enb, TypeId::LookupByName ("ns3::UdpSocketFactory"));
-  int retval = enbS1uSocket->Bind (InetSocketAddress (enbAddress, m_gtpuUdpPort));
+  Ipv4Address enbS1uBindAddress = (m_sgwPgwShards.size () == 1) ? enbAddress : Ipv4Address::GetAny ();
+  int retval = enbS1uSocket->Bind (InetSocketAddress (enbS1uBindAddress, m_gtpuUdpPort));
   NS_ASSERT (retval == 0);
 
   // create LTE socket for the ENB 
@@ -289,6 +416,10 @@ PointToPointEpcHelper::AddEnb (Ptr<Node> enb, Ptr<NetDevice> lteEnbNetDevice, ui
 
   NS_LOG_INFO ("create EpcEnbApplication");
   Ptr<EpcEnbApplication> enbApp = CreateObject<EpcEnbApplication> (enbLteSocket, enbLteSocket6, enbS1uSocket, enbAddress, sgwAddress, cellId);
+  for (uint16_t shard = 1; shard < m_sgwPgwShards.size (); ++shard)
+    {
+      enbApp->AddSgw (sgwAddresses[shard]);
+    }
   enb->AddApplication (enbApp);
   NS_ASSERT (enb->GetNApplications () == 1);
   NS_ASSERT_MSG (enb->GetApplication (0)->GetObject<EpcEnbApplication> () != 0, "cannot retrieve EpcEnbApplication");
@@ -301,7 +432,10 @@ PointToPointEpcHelper::AddEnb (Ptr<Node> enb, Ptr<NetDevice> lteEnbNetDevice, ui
 
   NS_LOG_INFO ("connect S1-AP interface");
   m_mme->AddEnb (cellId, enbAddress, enbApp->GetS1apSapEnb ());
-  m_sgwPgwApp->AddEnb (cellId, enbAddress, sgwAddress);
+  for (uint16_t shard = 0; shard < m_sgwPgwShards.size (); ++shard)
+    {
+      m_sgwPgwApps[shard]->AddEnb (cellId, enbAddresses[shard], sgwAddresses[shard]);
+    }
   enbApp->SetS1apSapMme (m_mme->GetS1apSapMme ());
 }
 
@@ -364,9 +498,12 @@ PointToPointEpcHelper::AddUe (Ptr<NetDevice> ueDevice, uint64_t imsi)
   NS_LOG_FUNCTION (this << imsi << ueDevice );
   
   m_mme->AddUe (imsi);
-  m_sgwPgwApp->AddUe (imsi);
-  
-
+  if (m_sgwPgwApps.size () == 1)
+    {
+      m_sgwPgwApps[0]->AddUe (imsi);
+    }
+  // otherwise the UE is added to its SGW/PGW when its first bearer is
+  // activated, once its IPv4 address is known
 }
 
 uint8_t
@@ -382,26 +519,55 @@ PointToPointEpcHelper::ActivateEpsBearer (Ptr<NetDevice> ueDevice, uint64_t imsi
   Ptr<Ipv6> ueIpv6 = ueNode->GetObject<Ipv6> ();
   NS_ASSERT_MSG (ueIpv4 != 0 || ueIpv6 != 0, "UEs need to have IPv4/IPv6 installed before EPS bearers can be activated");
 
+  bool hasUeAddr = false;
+  Ipv4Address ueAddr;
   if (ueIpv4)
     {
       int32_t interface =  ueIpv4->GetInterfaceForDevice (ueDevice);
       if (interface >= 0 && ueIpv4->GetNAddresses (interface) == 1)
         {
-          Ipv4Address ueAddr = ueIpv4->GetAddress (interface, 0).GetLocal ();
+          ueAddr = ueIpv4->GetAddress (interface, 0).GetLocal ();
           NS_LOG_LOGIC (" UE IPv4 address: " << ueAddr);
-          m_sgwPgwApp->SetUeAddress (imsi, ueAddr);
+          hasUeAddr = true;
         }
     }
+  bool hasUeAddr6 = false;
+  Ipv6Address ueAddr6;
   if (ueIpv6)
     {
       int32_t interface6 =  ueIpv6->GetInterfaceForDevice (ueDevice);
       if (interface6 >= 0 && ueIpv6->GetNAddresses (interface6) == 2)
         {
-          Ipv6Address ueAddr6 = ueIpv6->GetAddress (interface6, 1).GetAddress ();
+          ueAddr6 = ueIpv6->GetAddress (interface6, 1).GetAddress ();
           NS_LOG_LOGIC (" UE IPv6 address: " << ueAddr6);
-          m_sgwPgwApp->SetUeAddress6 (imsi, ueAddr6);
+          hasUeAddr6 = true;
         }
     }
+
+  Ptr<EpcSgwPgwApplication> sgwPgwApp = m_sgwPgwApps[0];
+  if (m_sgwPgwApps.size () > 1)
+    {
+      NS_ABORT_MSG_IF (hasUeAddr6, "IPv6 UEs are not supported with several SGW/PGW shards");
+      std::map<uint64_t, uint16_t>::iterator it = m_shardByImsi.find (imsi);
+      if (it == m_shardByImsi.end ())
+        {
+          NS_ABORT_MSG_UNLESS (hasUeAddr, "with several SGW/PGW shards, UEs need an IPv4 address before EPS bearers can be activated");
+          uint16_t shard = ueAddr.Get () & (m_sgwPgwApps.size () - 1);
+          NS_LOG_LOGIC (" UE IMSI " << imsi << " served by SGW/PGW shard " << shard);
+          it = m_shardByImsi.insert (std::make_pair (imsi, shard)).first;
+          m_sgwPgwApps[shard]->AddUe (imsi);
+          m_mme->SetS11SapSgw (imsi, m_sgwPgwApps[shard]->GetS11SapSgw ());
+        }
+      sgwPgwApp = m_sgwPgwApps[it->second];
+    }
+  if (hasUeAddr)
+    {
+      sgwPgwApp->SetUeAddress (imsi, ueAddr);
+    }
+  if (hasUeAddr6)
+    {
+      sgwPgwApp->SetUeAddress6 (imsi, ueAddr6);
+    }
   uint8_t bearerId = m_mme->AddBearer (imsi, tft, bearer);
   Ptr<LteUeNetDevice> ueLteDevice = ueDevice->GetObject<LteUeNetDevice> ();
   if (ueLteDevice)
@@ -440,14 +606,14 @@ Ipv4Address
 PointToPointEpcHelper::GetUeDefaultGatewayAddress ()
 {
   // return the address of the tun device
-  return m_sgwPgw->GetObject<Ipv4> ()->GetAddress (1, 0).GetLocal ();
+  return m_sgwPgwShards[0]->GetObject<Ipv4> ()->GetAddress (1, 0).GetLocal ();
 }
 
 Ipv6Address
 PointToPointEpcHelper::GetUeDefaultGatewayAddress6 ()
 {
   // return the address of the tun device
-  return m_sgwPgw->GetObject<Ipv6> ()->GetAddress (1, 1).GetAddress ();
+  return m_sgwPgwShards[0]->GetObject<Ipv6> ()->GetAddress (1, 1).GetAddress ();
 }
 
 } // namespace ns3
@@ -30,6 +30,8 @@
 #include <ns3/epc-tft.h>
 #include <ns3/eps-bearer.h>
 #include <ns3/epc-helper.h>
+#include <map>
+#include <vector>
 
 namespace ns3 {
 
@@ -48,6 +50,14 @@ class EpcMme;
  * single node that implements both the SGW and PGW functionality, and
  * an MME node. The S1-U, X2-U and X2-C interfaces are realized over
  * PointToPoint links. 
+ *
+ * With the NumberOfSgwPgwShards attribute set to N > 1, the UEs are
+ * shared among N SGW/PGW nodes, each UE being served by the node given by
+ * its IPv4 address modulo N.  Each eNB has an S1-U link with each
+ * SGW/PGW node, and the PGW node returned by GetPgwNode is a router,
+ * connected to the SGW/PGW nodes, which forwards the packets from the
+ * internet to the SGW/PGW of their UE.  IPv6 UEs are not supported in
+ * this configuration.
  */
 class PointToPointEpcHelper : public EpcHelper
 {
@@ -85,6 +95,11 @@ public:
 
 
 private:
+  /**
+   * Create the PGW router which connects the SGW/PGW shards to the
+   * internet, and the routes to the UEs of each shard
+   */
+  void CreateGiRouter ();
 
   /** 
    * helper to assign IPv4 addresses to UE devices as well as to the TUN device of the SGW/PGW
@@ -96,19 +111,52 @@ private:
   Ipv6AddressHelper m_uePgwAddressHelper6;
   
   /**
-   * SGW-PGW network element
+   * SGW-PGW network element, or the router in front of the SGW-PGW
+   * shards if there are several
    */
   Ptr<Node> m_sgwPgw; 
 
   /**
-   * SGW-PGW application
+   * number of SGW-PGW shards
+   */
+  uint16_t m_numberOfSgwPgwShards;
+
+  /**
+   * SGW-PGW network elements, one per shard
+   */
+  std::vector<Ptr<Node> > m_sgwPgwShards;
+
+  /**
+   * SGW-PGW applications, one per shard
+   */
+  std::vector<Ptr<EpcSgwPgwApplication> > m_sgwPgwApps;
+
+  /**
+   * TUN devices implementing tunneling of user data over GTP-U/UDP/IP,
+   * one per shard
+   */
+  std::vector<Ptr<VirtualNetDevice> > m_tunDevices;
+
+  /**
+   * shard serving each UE, with several shards
+   */
+  std::map<uint64_t, uint16_t> m_shardByImsi;
+
+  /**
+   * helper to assign addresses to the links between the PGW router and
+   * the SGW-PGW shards
+   */
+  Ipv4AddressHelper m_giIpv4AddressHelper;
+
+  /**
+   * The data rate of the links between the PGW router and the SGW-PGW shards
    */
-  Ptr<EpcSgwPgwApplication> m_sgwPgwApp;
+  DataRate m_giLinkDataRate;
 
   /**
-   * TUN device implementing tunneling of user data over GTP-U/UDP/IP
+   * The delay of the links between the PGW router and the SGW-PGW shards
    */
-  Ptr<VirtualNetDevice> m_tunDevice;
+  Time m_giLinkDelay;
 
   /**
    * MME network element
@@ -37,9 +37,24 @@
 #include <ns3/node.h>
 #include <ns3/buildings-helper.h>
 #include <ns3/lte-spectrum-value-helper.h>
+#include <ns3/lte-spectrum-signal-parameters.h>
+#include <ns3/spectrum-converter.h>
+#include <ns3/spectrum-propagation-loss-model.h>
+#include <ns3/propagation-loss-model.h>
+#include <ns3/jakes-propagation-loss-model.h>
+#include <ns3/buildings-propagation-loss-model.h>
+#include <ns3/antenna-model.h>
+#include <ns3/angles.h>
+#include <ns3/pointer.h>
+#include <ns3/core-config.h>
+#ifdef HAVE_PTHREAD_H
+#include <ns3/system-thread.h>
+#endif
 
 #include <fstream>
 #include <limits>
+#include <algorithm>
+#include <cmath>
 
 namespace ns3 {
 
@@ -47,7 +62,16 @@ NS_LOG_COMPONENT_DEFINE ("RadioEnvironmentMapHelper");
 
 NS_OBJECT_ENSURE_REGISTERED (RadioEnvironmentMapHelper);
 
+/// The first word of the binary output files
+static const std::string RADIO_ENVIRONMENT_MAP_FILE_MAGIC = "ns3-rem-1";
+
 RadioEnvironmentMapHelper::RadioEnvironmentMapHelper ()
+  : m_recording (false),
+    m_xTiles (0),
+    m_yTiles (0),
+    m_maxLossDb (0),
+    m_minRxPowerW (0),
+    m_maxRange (0)
 {
 }
 
@@ -62,6 +86,11 @@ void
 RadioEnvironmentMapHelper::DoDispose ()
 {
   NS_LOG_FUNCTION (this);
+  m_signals.clear ();
+  m_workerRxMobilities.clear ();
+  m_workerTxMobilities.clear ();
+  m_propagationLoss = 0;
+  m_spectrumPropagationLoss = 0;
 }
 
 TypeId
@@ -144,6 +173,39 @@ RadioEnvironmentMapHelper::GetTypeId (void)
                    IntegerValue (-1),
                    MakeIntegerAccessor (&RadioEnvironmentMapHelper::m_rbId),
                    MakeIntegerChecker<int32_t> ())
+    .AddAttribute ("DirectComputation",
+                   "If true, the signals transmitted during one subframe are recorded, "
+                   "and the map is computed from the antenna and propagation loss "
+                   "models of the channel, instead of being measured by listeners "
+                   "over many subframes",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&RadioEnvironmentMapHelper::m_directComputation),
+                   MakeBooleanChecker ())
+    .AddAttribute ("Threads",
+                   "The number of threads computing the map with DirectComputation. "
+                   "More than one thread can only be used if the antenna and propagation "
+                   "loss models of the channel are thread-safe, which is the case of the "
+                   "models computing the loss from the positions only (e.g., Friis, "
+                   "LogDistance, Okumura-Hata), but not of the buildings models. "
+                   "A single thread is used if the channel has a spectrum propagation "
+                   "loss model, or if a buildings or random propagation loss model "
+                   "is chained to its propagation loss model.",
+                   UintegerValue (1),
+                   MakeUintegerAccessor (&RadioEnvironmentMapHelper::m_threads),
+                   MakeUintegerChecker<uint32_t> (1))
+    .AddAttribute ("TileSize",
+                   "The number of points along each side of the square tiles of a map "
+                   "computed with DirectComputation, which are the units of work of the "
+                   "threads and of the updates",
+                   UintegerValue (32),
+                   MakeUintegerAccessor (&RadioEnvironmentMapHelper::m_tileSize),
+                   MakeUintegerChecker<uint16_t> (1))
+    .AddAttribute ("BinaryOutputFile",
+                   "If not empty, the file to which a map computed with DirectComputation "
+                   "is also saved, in binary form",
+                   StringValue (""),
+                   MakeStringAccessor (&RadioEnvironmentMapHelper::m_binaryOutputFile),
+                   MakeStringChecker ())
   ;
   return tid;
 }
@@ -181,7 +243,7 @@ void
 RadioEnvironmentMapHelper::Install ()
 {
   NS_LOG_FUNCTION (this);
-  if (!m_rem.empty ())
+  if (!m_rem.empty () || !m_sinrMap.empty ())
     {
       NS_FATAL_ERROR ("only one REM supported per instance of RadioEnvironmentMapHelper");
     }
@@ -220,6 +282,18 @@ RadioEnvironmentMapHelper::DelayedInstall ()
   NS_LOG_FUNCTION (this);
   m_xStep = (m_xMax - m_xMin)/(m_xRes-1);
   m_yStep = (m_yMax - m_yMin)/(m_yRes-1);
+
+  if (m_directComputation)
+    {
+      // record the signals received by the listeners of the other method
+      m_recording = true;
+      m_channel->TraceConnectWithoutContext ("TxSigParams",
+                                             MakeCallback (&RadioEnvironmentMapHelper::RecordSignal, this));
+      Simulator::Schedule (Seconds (0.0006),
+                           &RadioEnvironmentMapHelper::ComputeDirect,
+                           this);
+      return;
+    }
   
   if ((double)m_xRes * (double) m_yRes < (double) m_maxPointsPerIteration)
     {
@@ -344,12 +418,388 @@ void
 RadioEnvironmentMapHelper::Finalize ()
 {
   NS_LOG_FUNCTION (this);
-  m_outFile.close ();
+  if (m_outFile.is_open ())
+    {
+      m_outFile.close ();
+    }
   if (m_stopWhenDone)
     {
       Simulator::Stop ();
     }
 }
 
+void
+RadioEnvironmentMapHelper::RecordSignal (Ptr<SpectrumSignalParameters> params)
+{
+  NS_LOG_FUNCTION (this << params);
+  if (!m_recording)
+    {
+      return;
+    }
+  // the same signals as the ones measured by RemSpectrumPhy
+  if (m_useDataChannel)
+    {
+      if (DynamicCast<LteSpectrumSignalParametersDataFrame> (params) == 0)
+        {
+          return;
+        }
+    }
+  else if (DynamicCast<LteSpectrumSignalParametersDlCtrlFrame> (params) == 0)
+    {
+      return;
+    }
+  Ptr<const SpectrumModel> rxSpectrumModel = LteSpectrumValueHelper::GetSpectrumModel (m_earfcn, m_bandwidth);
+  Ptr<const SpectrumValue> psd = params->psd;
+  if (psd->GetSpectrumModelUid () != rxSpectrumModel->GetUid ())
+    {
+      SpectrumConverter converter (psd->GetSpectrumModel (), rxSpectrumModel);
+      psd = converter.Convert (psd);
+    }
+  RemSignal signal;
+  signal.psd = psd;
+  signal.txPowerW = Integral (*psd);
+  signal.power = (m_rbId >= 0) ? (*psd)[m_rbId] * 180000 : signal.txPowerW;
+  signal.txMobility = params->txPhy->GetMobility ();
+  signal.txAntenna = params->txAntenna;
+  m_signals.push_back (signal);
+}
+
+void
+RadioEnvironmentMapHelper::ComputeDirect ()
+{
+  NS_LOG_FUNCTION (this);
+  m_recording = false;
+  m_channel->TraceDisconnectWithoutContext ("TxSigParams",
+                                            MakeCallback (&RadioEnvironmentMapHelper::RecordSignal, this));
+  NS_LOG_LOGIC (m_signals.size () << " signals recorded");
+
+  PointerValue propagationLoss;
+  m_channel->GetAttribute ("PropagationLossModel", propagationLoss);
+  m_propagationLoss = propagationLoss.Get<PropagationLossModel> ();
+  m_spectrumPropagationLoss = m_channel->GetSpectrumPropagationLossModel ();
+  DoubleValue value;
+  m_channel->GetAttribute ("MaxLossDb", value);
+  m_maxLossDb = value.Get ();
+  m_channel->GetAttribute ("MinRxPowerDbm", value);
+  m_minRxPowerW = std::pow (10.0, (value.Get () - 30) / 10.0);
+  m_channel->GetAttribute ("MaxRange", value);
+  m_maxRange = value.Get ();
+
+  // the same points as the ones of the other method
+  for (double x = m_xMin; x < m_xMax + 0.5*m_xStep; x += m_xStep)
+    {
+      m_xCoords.push_back (x);
+    }
+  for (double y = m_yMin; y < m_yMax + 0.5*m_yStep; y += m_yStep)
+    {
+      m_yCoords.push_back (y);
+    }
+  m_sinrMap.assign (m_xCoords.size () * m_yCoords.size (), 0.0);
+  m_xTiles = (m_xCoords.size () + m_tileSize - 1) / m_tileSize;
+  m_yTiles = (m_yCoords.size () + m_tileSize - 1) / m_tileSize;
+
+  for (std::vector<RemSignal>::iterator it = m_signals.begin (); it != m_signals.end (); ++it)
+    {
+      if (it->txMobility != 0)
+        {
+          it->position = it->txMobility->GetPosition ();
+        }
+    }
+  m_tilesToCompute.clear ();
+  for (uint32_t tile = 0; tile < m_xTiles * m_yTiles; ++tile)
+    {
+      m_tilesToCompute.push_back (tile);
+    }
+  ComputeTiles ();
+  WriteDirect ();
+  Finalize ();
+}
+
+uint32_t
+RadioEnvironmentMapHelper::Update ()
+{
+  NS_LOG_FUNCTION (this);
+  NS_ABORT_MSG_IF (m_sinrMap.empty (), "no map was generated with DirectComputation");
+  std::vector<bool> tilesToCompute (m_xTiles * m_yTiles, false);
+  bool computeAll = false;
+  for (std::vector<RemSignal>::iterator it = m_signals.begin (); it != m_signals.end (); ++it)
+    {
+      if (it->txMobility == 0)
+        {
+          continue;
+        }
+      Vector position = it->txMobility->GetPosition ();
+      if (position.x == it->position.x && position.y == it->position.y && position.z == it->position.z)
+        {
+          continue;
+        }
+      NS_LOG_LOGIC ("transmitter moved from " << it->position << " to " << position);
+      if (m_maxRange > 0)
+        {
+          // the points out of range of both positions do not receive the signal
+          for (uint32_t tile = 0; tile < tilesToCompute.size (); ++tile)
+            {
+              if (IsTileInRange (tile, it->position) || IsTileInRange (tile, position))
+                {
+                  tilesToCompute[tile] = true;
+                }
+            }
+        }
+      else
+        {
+          computeAll = true;
+        }
+      it->position = position;
+    }
+  m_tilesToCompute.clear ();
+  for (uint32_t tile = 0; tile < tilesToCompute.size (); ++tile)
+    {
+      if (computeAll || tilesToCompute[tile])
+        {
+          m_tilesToCompute.push_back (tile);
+        }
+    }
+  NS_LOG_LOGIC ("recomputing " << m_tilesToCompute.size () << " tiles out of " << tilesToCompute.size ());
+  if (!m_tilesToCompute.empty ())
+    {
+      ComputeTiles ();
+      WriteDirect ();
+    }
+  return m_tilesToCompute.size ();
+}
+
+double
+RadioEnvironmentMapHelper::GetSinr (uint16_t xIndex, uint16_t yIndex) const
+{
+  NS_ASSERT (xIndex < m_xCoords.size () && yIndex < m_yCoords.size ());
+  return m_sinrMap[static_cast<std::size_t> (xIndex) * m_yCoords.size () + yIndex];
+}
+
+void
+RadioEnvironmentMapHelper::ComputeTiles ()
+{
+  NS_LOG_FUNCTION (this << m_tilesToCompute.size ());
+  uint32_t nThreads = 1;
+#ifdef HAVE_PTHREAD_H
+  if (m_threads > 1 && m_spectrumPropagationLoss == 0)
+    {
+      nThreads = std::max<uint32_t> (1, std::min<uint32_t> (m_threads, m_tilesToCompute.size ()));
+      // the buildings models need the MobilityBuildingInfo made consistent
+      // with the position and cache the shadowing, and the random models
+      // draw from streams, none of which can be done concurrently
+      for (Ptr<PropagationLossModel> model = m_propagationLoss; model != 0; model = model->GetNext ())
+        {
+          if (DynamicCast<BuildingsPropagationLossModel> (model) != 0
+              || DynamicCast<RandomPropagationLossModel> (model) != 0
+              || DynamicCast<NakagamiPropagationLossModel> (model) != 0
+              || DynamicCast<JakesPropagationLossModel> (model) != 0)
+            {
+              NS_LOG_WARN ("the propagation loss model " << model->GetInstanceTypeId ().GetName ()
+                           << " is not thread-safe, computing the map with a single thread");
+              nThreads = 1;
+              break;
+            }
+        }
+    }
+#endif
+
+  // the mobility models are created here, and each worker only uses its
+  // own ones, since the reference counts are not thread-safe
+  uint32_t pointsPerTile = static_cast<uint32_t> (m_tileSize) * m_tileSize;
+  m_workerRxMobilities.resize (nThreads);
+  m_workerTxMobilities.resize (nThreads);
+  for (uint32_t worker = 0; worker < nThreads; ++worker)
+    {
+      while (m_workerRxMobilities[worker].size () < pointsPerTile)
+        {
+          Ptr<MobilityModel> mobility = CreateObject<ConstantPositionMobilityModel> ();
+          Ptr<MobilityBuildingInfo> buildingInfo = CreateObject<MobilityBuildingInfo> ();
+          mobility->AggregateObject (buildingInfo); // operation usually done by BuildingsHelper::Install
+          m_workerRxMobilities[worker].push_back (mobility);
+        }
+      m_workerTxMobilities[worker].clear ();
+      for (std::vector<RemSignal>::const_iterator it = m_signals.begin (); it != m_signals.end (); ++it)
+        {
+          Ptr<MobilityModel> txMobility = it->txMobility;
+          if (nThreads > 1 && txMobility != 0)
+            {
+              txMobility = CreateObject<ConstantPositionMobilityModel> ();
+              txMobility->SetPosition (it->position);
+            }
+          m_workerTxMobilities[worker].push_back (txMobility);
+        }
+    }
+
+#ifdef HAVE_PTHREAD_H
+  if (nThreads > 1)
+    {
+      // some antenna models, like CachedAntennaModel, build a table on the
+      // first evaluation, which must not be done concurrently
+      for (std::vector<RemSignal>::const_iterator it = m_signals.begin (); it != m_signals.end (); ++it)
+        {
+          if (it->txAntenna != 0)
+            {
+              it->txAntenna->GetGainDb (Angles (0.0, 0.0));
+            }
+        }
+      std::vector<Ptr<SystemThread> > threads;
+      for (uint32_t worker = 0; worker < nThreads; ++worker)
+        {
+          Ptr<SystemThread> thread = Create<SystemThread> (MakeCallback (&RadioEnvironmentMapHelper::ComputeWorkerTiles, this).Bind (worker));
+          thread->Start ();
+          threads.push_back (thread);
+        }
+      for (std::vector<Ptr<SystemThread> >::iterator it = threads.begin (); it != threads.end (); ++it)
+        {
+          (*it)->Join ();
+        }
+      return;
+    }
+#endif
+  ComputeWorkerTiles (0);
+}
+
+void
+RadioEnvironmentMapHelper::ComputeWorkerTiles (uint32_t worker)
+{
+  uint32_t nWorkers = m_workerRxMobilities.size ();
+  std::vector<Ptr<MobilityModel> > &rxMobilities = m_workerRxMobilities[worker];
+  uint32_t nx = m_xCoords.size ();
+  uint32_t ny = m_yCoords.size ();
+  for (uint32_t i = worker; i < m_tilesToCompute.size (); i += nWorkers)
+    {
+      uint32_t tile = m_tilesToCompute[i];
+      uint32_t xFirst = (tile / m_yTiles) * m_tileSize;
+      uint32_t yFirst = (tile % m_yTiles) * m_tileSize;
+      uint32_t xEnd = std::min<uint32_t> (nx, xFirst + m_tileSize);
+      uint32_t yEnd = std::min<uint32_t> (ny, yFirst + m_tileSize);
+      for (uint32_t ix = xFirst; ix < xEnd; ++ix)
+        {
+          for (uint32_t iy = yFirst; iy < yEnd; ++iy)
+            {
+              Ptr<MobilityModel> &rxMobility = rxMobilities[(ix - xFirst) * m_tileSize + (iy - yFirst)];
+              rxMobility->SetPosition (Vector (m_xCoords[ix], m_yCoords[iy], m_z));
+              if (nWorkers == 1)
+                {
+                  // the buildings are not thread-safe
+                  BuildingsHelper::MakeConsistent (rxMobility);
+                }
+              m_sinrMap[static_cast<std::size_t> (ix) * ny + iy] = ComputeSinr (worker, rxMobility);
+            }
+        }
+    }
+}
+
+double
+RadioEnvironmentMapHelper::ComputeSinr (uint32_t worker, Ptr<MobilityModel> rxMobility) const
+{
+  // see MultiModelSpectrumChannel::StartTxToRx and RemSpectrumPhy::StartRx
+  const std::vector<Ptr<MobilityModel> > &txMobilities = m_workerTxMobilities[worker];
+  Vector rxPosition = rxMobility->GetPosition ();
+  double sumPower = 0;
+  double referenceSignalPower = 0;
+  for (uint32_t i = 0; i < m_signals.size (); ++i)
+    {
+      const RemSignal &signal = m_signals[i];
+      double power = signal.power;
+      if (txMobilities[i] != 0)
+        {
+          if (m_maxRange > 0 && CalculateDistance (signal.position, rxPosition) > m_maxRange)
+            {
+              continue;
+            }
+          double pathLossDb = 0;
+          if (signal.txAntenna != 0)
+            {
+              pathLossDb -= signal.txAntenna->GetGainDb (Angles (rxPosition, signal.position));
+            }
+          if (m_propagationLoss != 0)
+            {
+              pathLossDb -= m_propagationLoss->CalcRxPower (0, txMobilities[i], rxMobility);
+            }
+          if (pathLossDb > m_maxLossDb)
+            {
+              continue;
+            }
+          double pathGainLinear = std::pow (10.0, (-pathLossDb) / 10.0);
+          if (signal.txPowerW * pathGainLinear < m_minRxPowerW)
+            {
+              continue;
+            }
+          if (m_spectrumPropagationLoss != 0)
+            {
+              Ptr<SpectrumValue> psd = Copy<SpectrumValue> (signal.psd);
+              *psd *= pathGainLinear;
+              psd = m_spectrumPropagationLoss->CalcRxPowerSpectralDensity (psd, txMobilities[i], rxMobility);
+              power = (m_rbId >= 0) ? (*psd)[m_rbId] * 180000 : Integral (*psd);
+            }
+          else
+            {
+              power *= pathGainLinear;
+            }
+        }
+      sumPower += power;
+      if (power > referenceSignalPower)
+        {
+          referenceSignalPower = power;
+        }
+    }
+  return referenceSignalPower / (sumPower - referenceSignalPower + m_noisePower);
+}
+
+bool
+RadioEnvironmentMapHelper::IsTileInRange (uint32_t tile, const Vector &position) const
+{
+  uint32_t xFirst = (tile / m_yTiles) * m_tileSize;
+  uint32_t yFirst = (tile % m_yTiles) * m_tileSize;
+  uint32_t xLast = std::min<uint32_t> (m_xCoords.size (), xFirst + m_tileSize) - 1;
+  uint32_t yLast = std::min<uint32_t> (m_yCoords.size (), yFirst + m_tileSize) - 1;
+  // distance from the position to the rectangle of the points of the tile
+  double dx = std::max (0.0, std::max (m_xCoords[xFirst] - position.x, position.x - m_xCoords[xLast]));
+  double dy = std::max (0.0, std::max (m_yCoords[yFirst] - position.y, position.y - m_yCoords[yLast]));
+  double dz = m_z - position.z;
+  return std::sqrt (dx * dx + dy * dy + dz * dz) <= m_maxRange;
+}
+
+void
+RadioEnvironmentMapHelper::WriteDirect ()
+{
+  NS_LOG_FUNCTION (this);
+  if (!m_outFile.is_open ())
+    {
+      m_outFile.open (m_outputFile.c_str ());
+      NS_ABORT_MSG_UNLESS (m_outFile.is_open (), "Can't open file " << m_outputFile);
+    }
+  for (uint32_t ix = 0; ix < m_xCoords.size (); ++ix)
+    {
+      for (uint32_t iy = 0; iy < m_yCoords.size (); ++iy)
+        {
+          m_outFile << m_xCoords[ix] << "\t"
+                    << m_yCoords[iy] << "\t"
+                    << m_z << "\t"
+                    << m_sinrMap[static_cast<std::size_t> (ix) * m_yCoords.size () + iy]
+                    << "\n";
+        }
+    }
+  m_outFile.close ();
+
+  if (!m_binaryOutputFile.empty ())
+    {
+      // a text header, the coordinates as doubles, and the SINR as floats
+      std::ofstream ofs (m_binaryOutputFile.c_str (), std::ios::out | std::ios::binary);
+      NS_ABORT_MSG_UNLESS (ofs.is_open (), "Can't open file " << m_binaryOutputFile);
+      ofs.precision (17);
+      ofs << RADIO_ENVIRONMENT_MAP_FILE_MAGIC << " " << m_xCoords.size () << " " << m_yCoords.size () << " " << m_z << "\n";
+      ofs.write (reinterpret_cast<const char *> (m_xCoords.data ()), m_xCoords.size () * sizeof (double));
+      ofs.write (reinterpret_cast<const char *> (m_yCoords.data ()), m_yCoords.size () * sizeof (double));
+      for (std::vector<double>::const_iterator it = m_sinrMap.begin (); it != m_sinrMap.end (); ++it)
+        {
+          float sinr = *it;
+          ofs.write (reinterpret_cast<const char *> (&sinr), sizeof (sinr));
+        }
+      NS_ABORT_MSG_IF (ofs.fail (), "Could not write " << m_binaryOutputFile);
+    }
+}
+
 
 } // namespace ns3
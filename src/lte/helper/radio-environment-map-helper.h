@@ -24,7 +24,9 @@
 
 
 #include <ns3/object.h>
+#include <ns3/vector.h>
 #include <fstream>
+#include <vector>
 
 
 namespace ns3 {
@@ -35,6 +37,11 @@ class NetDevice;
 class SpectrumChannel;
 //class BuildingsMobilityModel;
 class MobilityModel;
+class AntennaModel;
+class SpectrumValue;
+class PropagationLossModel;
+class SpectrumPropagationLossModel;
+class SpectrumSignalParameters;
 
 /** 
  * \ingroup lte
@@ -42,6 +49,16 @@ class MobilityModel;
  * Generates a 2D map of the SINR from the strongest transmitter in the
  * downlink of an LTE FDD system. For instructions on usage, please refer to
  * the User Documentation.
+ *
+ * By default, the map is generated by placing listeners in the channel,
+ * which receive the signals of a subframe at a batch of points of the map,
+ * and by running a subframe for each batch.  With the DirectComputation
+ * attribute, the signals transmitted in a single subframe are recorded, and
+ * the power received at each point is computed from the antenna and
+ * propagation loss models of the channel, as the channel would do, by one or
+ * more threads.  The map is then divided in square tiles, and Update only
+ * recomputes the tiles within the MaxRange of the channel of the
+ * transmitters which moved.
  */
 class RadioEnvironmentMapHelper : public Object
 {
@@ -75,6 +92,27 @@ public:
    */
   void Install ();
 
+  /**
+   * Recompute the parts of a map generated with the DirectComputation
+   * attribute which are affected by the transmitters which moved since the
+   * map was computed, and write the map again.  If the MaxRange attribute of
+   * the channel is set, only the tiles within this range of the old or new
+   * position of a transmitter which moved are recomputed; otherwise the
+   * whole map is recomputed if a transmitter moved.  The transmitted signals
+   * are the ones recorded when the map was generated.
+   *
+   * \return the number of tiles recomputed
+   */
+  uint32_t Update ();
+
+  /**
+   * \param xIndex the index of the point along the x axis
+   * \param yIndex the index of the point along the y axis
+   * \return the SINR at a point of a map generated with the
+   * DirectComputation attribute
+   */
+  double GetSinr (uint16_t xIndex, uint16_t yIndex) const;
+
 private:
 
   /**
@@ -108,6 +146,50 @@ private:
   /// Called when the map generation procedure has been completed.
   void Finalize ();
 
+  /**
+   * Record a signal transmitted in the channel, if it is of the kind of
+   * signal the map is generated for.
+   * \param params the parameters of the signal
+   */
+  void RecordSignal (Ptr<SpectrumSignalParameters> params);
+
+  /**
+   * Scheduled by DelayedInstall() with the DirectComputation attribute,
+   * once the signals of a subframe are recorded, to compute and write the
+   * whole map.
+   */
+  void ComputeDirect ();
+
+  /**
+   * Compute the tiles of m_tilesToCompute, with one or more threads.
+   */
+  void ComputeTiles ();
+
+  /**
+   * Compute the tiles of m_tilesToCompute assigned to a worker.
+   * \param worker the index of the worker
+   */
+  void ComputeWorkerTiles (uint32_t worker);
+
+  /**
+   * Compute the SINR at a point of the map.
+   * \param worker the index of the worker computing the point
+   * \param rxMobility the mobility model placed at the point
+   * \return the SINR
+   */
+  double ComputeSinr (uint32_t worker, Ptr<MobilityModel> rxMobility) const;
+
+  /**
+   * \param tile the index of a tile
+   * \param position a position
+   * \return whether the tile has points within the MaxRange of the
+   * channel of the position
+   */
+  bool IsTileInRange (uint32_t tile, const Vector &position) const;
+
+  /// Write the map computed with the DirectComputation attribute.
+  void WriteDirect ();
+
   /// A complete Radio Environment Map is composed of many of this structure.
   struct RemPoint 
   {
@@ -152,6 +234,43 @@ private:
   bool m_useDataChannel;  ///< The `UseDataChannel` attribute.
   int32_t m_rbId;         ///< The `RbId` attribute.
 
+  bool m_directComputation;        ///< The `DirectComputation` attribute.
+  uint32_t m_threads;              ///< The `Threads` attribute.
+  uint16_t m_tileSize;             ///< The `TileSize` attribute.
+  std::string m_binaryOutputFile;  ///< The `BinaryOutputFile` attribute.
+
+  /// A signal recorded for the direct computation of the map.
+  struct RemSignal
+  {
+    double power;                      ///< the power received without loss (W), over the RbId RB or the whole band
+    double txPowerW;                   ///< the power over the whole band (W), compared with the MinRxPowerDbm attribute of the channel
+    Ptr<const SpectrumValue> psd;      ///< the PSD in the spectrum model of the map
+    Ptr<MobilityModel> txMobility;     ///< the mobility model of the transmitter
+    Ptr<AntennaModel> txAntenna;       ///< the antenna of the transmitter, if any
+    Vector position;                   ///< the position of the transmitter when the map was computed
+  };
+
+  std::vector<RemSignal> m_signals;  ///< The signals recorded for the direct computation.
+  bool m_recording;                  ///< Whether the signals are being recorded.
+
+  std::vector<double> m_xCoords;  ///< The x coordinates of the points of the map.
+  std::vector<double> m_yCoords;  ///< The y coordinates of the points of the map.
+  std::vector<double> m_sinrMap;  ///< The SINR of the points, indexed by x index * number of y coordinates + y index.
+  uint32_t m_xTiles;              ///< The number of tiles along the x axis.
+  uint32_t m_yTiles;              ///< The number of tiles along the y axis.
+  std::vector<uint32_t> m_tilesToCompute;  ///< The tiles computed by ComputeTiles.
+
+  /// The mobility models of the points of a tile, for each worker.
+  std::vector<std::vector<Ptr<MobilityModel> > > m_workerRxMobilities;
+  /// The mobility models of the transmitters of m_signals, for each worker.
+  std::vector<std::vector<Ptr<MobilityModel> > > m_workerTxMobilities;
+
+  Ptr<PropagationLossModel> m_propagationLoss;                  ///< The propagation loss model of the channel.
+  Ptr<SpectrumPropagationLossModel> m_spectrumPropagationLoss;  ///< The spectrum propagation loss model of the channel.
+  double m_maxLossDb;    ///< The `MaxLossDb` attribute of the channel.
+  double m_minRxPowerW;  ///< The `MinRxPowerDbm` attribute of the channel, in W.
+  double m_maxRange;     ///< The `MaxRange` attribute of the channel.
+
 }; // end of `class RadioEnvironmentMapHelper`
 
 
@@ -92,7 +92,7 @@ EpcEnbApplication::EpcEnbApplication (Ptr<Socket> lteSocket, Ptr<Socket> lteSock
     m_lteSocket6 (lteSocket6),
     m_s1uSocket (s1uSocket),    
     m_enbS1uAddress (enbS1uAddress),
-    m_sgwS1uAddress (sgwS1uAddress),
+    m_sgwS1uAddresses (1, sgwS1uAddress),
     m_gtpuUdpPort (2152), // fixed by the standard
     m_s1SapUser (0),
     m_s1apSapMme (0),
@@ -113,6 +113,13 @@ EpcEnbApplication::~EpcEnbApplication (void)
 }
 
 
+void
+EpcEnbApplication::AddSgw (Ipv4Address sgwS1uAddress)
+{
+  NS_LOG_FUNCTION (this << sgwS1uAddress);
+  m_sgwS1uAddresses.push_back (sgwS1uAddress);
+}
+
 void 
 EpcEnbApplication::SetS1SapUser (EpcEnbS1SapUser * s)
 {
@@ -291,7 +298,7 @@ EpcEnbApplication::RecvFromS1uSocket (Ptr<Socket> socket)
   GtpuHeader gtpu;
   packet->RemoveHeader (gtpu);
   uint32_t teid = gtpu.GetTeid ();
-  std::map<uint32_t, EpsFlowId_t>::iterator it = m_teidRbidMap.find (teid);
+  std::unordered_map<uint32_t, EpsFlowId_t>::iterator it = m_teidRbidMap.find (teid);
   NS_ASSERT (it != m_teidRbidMap.end ());
 
   m_rxS1uSocketPktTrace (packet->Copy ());
@@ -338,7 +345,8 @@ EpcEnbApplication::SendToS1uSocket (Ptr<Packet> packet, uint32_t teid)
   gtpu.SetLength (packet->GetSize () + gtpu.GetSerializedSize () - 8);  
   packet->AddHeader (gtpu);
   uint32_t flags = 0;
-  m_s1uSocket->SendTo (packet, flags, InetSocketAddress (m_sgwS1uAddress, m_gtpuUdpPort));
+  Ipv4Address sgwS1uAddress = m_sgwS1uAddresses[(teid - 1) % m_sgwS1uAddresses.size ()];
+  m_s1uSocket->SendTo (packet, flags, InetSocketAddress (sgwS1uAddress, m_gtpuUdpPort));
 }
 
 void
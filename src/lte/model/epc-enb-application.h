@@ -35,6 +35,8 @@
 #include <ns3/epc-enb-s1-sap.h>
 #include <ns3/epc-s1ap-sap.h>
 #include <map>
+#include <unordered_map>
+#include <vector>
 
 namespace ns3 {
 class EpcEnbS1SapUser;
@@ -87,6 +89,18 @@ public:
   virtual ~EpcEnbApplication (void);
 
 
+  /**
+   * Add an SGW for S1-U communications, when the bearers of the UEs are
+   * shared among several SGWs which allocate disjoint TEID sequences (see
+   * EpcSgwPgwApplication::SetTeidAllocation).  The SGWs are numbered in
+   * the order they are added, the SGW passed to the constructor being SGW
+   * 0: the uplink packets of the bearer with TEID t are sent to SGW (t -
+   * 1) modulo the number of SGWs.
+   *
+   * \param sgwS1uAddress the IPv4 address at which this eNB will be able to reach the SGW
+   */
+  void AddSgw (Ipv4Address sgwS1uAddress);
+
   /** 
    * Set the S1 SAP User
    * 
@@ -269,9 +283,10 @@ private:
   Ipv4Address m_enbS1uAddress;
 
   /**
-   * address of the SGW which terminates all S1-U tunnels
+   * addresses of the SGWs which terminate the S1-U tunnels, indexed by
+   * (TEID - 1) modulo the number of SGWs
    */
-  Ipv4Address m_sgwS1uAddress;
+  std::vector<Ipv4Address> m_sgwS1uAddresses;
 
   /**
    * map of maps telling for each RNTI and BID the corresponding  S1-U TEID
@@ -283,7 +298,7 @@ private:
    * map telling for each S1-U TEID the corresponding RNTI,BID
    * 
    */
-  std::map<uint32_t, EpsFlowId_t> m_teidRbidMap;
+  std::unordered_map<uint32_t, EpsFlowId_t> m_teidRbidMap;
  
   /**
    * UDP port to be used for GTP
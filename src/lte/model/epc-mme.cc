@@ -77,6 +77,15 @@ EpcMme::SetS11SapSgw (EpcS11SapSgw * s)
   m_s11SapSgw = s;
 }
 
+void
+EpcMme::SetS11SapSgw (uint64_t imsi, EpcS11SapSgw * s)
+{
+  NS_LOG_FUNCTION (this << imsi << s);
+  std::map<uint64_t, Ptr<UeInfo> >::iterator it = m_ueInfoMap.find (imsi);
+  NS_ASSERT_MSG (it != m_ueInfoMap.end (), "could not find any UE with IMSI " << imsi);
+  it->second->s11SapSgw = s;
+}
+
 EpcS11SapMme* 
 EpcMme::GetS11SapMme ()
 {
@@ -103,6 +112,7 @@ EpcMme::AddUe (uint64_t imsi)
   ueInfo->mmeUeS1Id = imsi;
   m_ueInfoMap[imsi] = ueInfo;
   ueInfo->bearerCounter = 0;
+  ueInfo->s11SapSgw = 0;
 }
 
 uint8_t
@@ -144,7 +154,7 @@ EpcMme::DoInitialUeMessage (uint64_t mmeUeS1Id, uint16_t enbUeS1Id, uint64_t ims
       bearerContext.tft = bit->tft;
       msg.bearerContextsToBeCreated.push_back (bearerContext);
     }
-  m_s11SapSgw->CreateSessionRequest (msg);
+  GetUeS11SapSgw (it->second)->CreateSessionRequest (msg);
 }
 
 void 
@@ -170,7 +180,7 @@ EpcMme::DoPathSwitchRequest (uint64_t enbUeS1Id, uint64_t mmeUeS1Id, uint16_t gc
   msg.teid = imsi; // trick to avoid the need for allocating TEIDs on the S11 interface
   msg.uli.gci = gci;
   // bearer modification is not supported for now
-  m_s11SapSgw->ModifyBearerRequest (msg);
+  GetUeS11SapSgw (it->second)->ModifyBearerRequest (msg);
 }
 
 
@@ -240,7 +250,7 @@ EpcMme::DoErabReleaseIndication (uint64_t mmeUeS1Id, uint16_t enbUeS1Id, std::li
       msg.bearerContextsToBeRemoved.push_back (bearerContext);
     }
   //Delete Bearer command towards epc-sgw-pgw-application
-  m_s11SapSgw->DeleteBearerCommand (msg);
+  GetUeS11SapSgw (it->second)->DeleteBearerCommand (msg);
 }
 
 void
@@ -265,7 +275,17 @@ EpcMme::DoDeleteBearerRequest (EpcS11SapMme::DeleteBearerRequestMessage msg)
       RemoveBearer (it->second, bearerContext.epsBearerId); //schedules function to erase, context of de-activated bearer
     }
   //schedules Delete Bearer Response towards epc-sgw-pgw-application
-  m_s11SapSgw->DeleteBearerResponse (res);
+  GetUeS11SapSgw (it->second)->DeleteBearerResponse (res);
+}
+
+EpcS11SapSgw*
+EpcMme::GetUeS11SapSgw (Ptr<UeInfo> ueInfo) const
+{
+  if (ueInfo->s11SapSgw != 0)
+    {
+      return ueInfo->s11SapSgw;
+    }
+  return m_s11SapSgw;
 }
 
 void EpcMme::RemoveBearer (Ptr<UeInfo> ueInfo, uint8_t epsBearerId)
@@ -81,6 +81,16 @@ public:
    */
   void SetS11SapSgw (EpcS11SapSgw * s);
 
+  /**
+   * Set the SGW side of the S11 SAP used for the bearers of a UE, when
+   * the UEs are shared among several SGWs.  The UEs for which this
+   * method is not called use the SAP set by SetS11SapSgw (s).
+   *
+   * \param imsi the unique identifier of the UE, previously added with AddUe
+   * \param s the SGW side of the S11 SAP of the SGW serving the UE
+   */
+  void SetS11SapSgw (uint64_t imsi, EpcS11SapSgw * s);
+
   /** 
    * 
    * \return the MME side of the S11 SAP 
@@ -191,6 +201,7 @@ private:
     uint16_t cellId; ///< cell ID
     std::list<BearerInfo> bearersToBeActivated; ///< list of bearers to be activated
     uint16_t bearerCounter; ///< bearer counter
+    EpcS11SapSgw* s11SapSgw; ///< SGW side of the S11 SAP of the SGW serving the UE, 0 for the default one
   };
 
   /**
@@ -206,6 +217,12 @@ private:
    */
   void RemoveBearer (Ptr<UeInfo> ueInfo, uint8_t epsBearerId);
 
+  /**
+   * \param ueInfo UE information pointer
+   * \return the SGW side of the S11 SAP of the SGW serving the UE
+   */
+  EpcS11SapSgw* GetUeS11SapSgw (Ptr<UeInfo> ueInfo) const;
+
   /**
    * Hold info on a ENB
    * 
@@ -36,7 +36,10 @@
 #include <ns3/application.h>
 #include <ns3/epc-s1ap-sap.h>
 #include <ns3/epc-s11-sap.h>
+#include <ns3/ipv4-address.h>
+#include <ns3/ipv6-address.h>
 #include <map>
+#include <unordered_map>
 
 namespace ns3 {
 
@@ -132,6 +135,18 @@ public:
   EpcS11SapSgw* GetS11SapSgw ();
 
 
+  /**
+   * Set the TEIDs allocated to the bearers: firstTeid, firstTeid +
+   * teidStep, firstTeid + 2 * teidStep, and so on.  By default the TEIDs
+   * are 1, 2, 3, ...; several SGWs which share the eNBs use disjoint
+   * sequences, so that an eNB can tell from the TEID which SGW serves a
+   * bearer.  To be called before any bearer is created.
+   *
+   * \param firstTeid the first TEID, at least 1
+   * \param teidStep the difference between two consecutive TEIDs
+   */
+  void SetTeidAllocation (uint32_t firstTeid, uint32_t teidStep);
+
   /** 
    * Let the SGW be aware of a new eNB 
    * 
@@ -288,20 +303,27 @@ public:
    */
   Ptr<VirtualNetDevice> m_tunDevice;
 
+  /// UE info by UE IPv4 address, looked up for each downlink packet
+  typedef std::unordered_map<Ipv4Address, Ptr<UeInfo>, Ipv4AddressHash> UeInfoByAddrMap;
+  /// UE info by UE IPv6 address, looked up for each downlink packet
+  typedef std::unordered_map<Ipv6Address, Ptr<UeInfo>, Ipv6AddressHash> UeInfoByAddrMap6;
+  /// UE info by IMSI
+  typedef std::unordered_map<uint64_t, Ptr<UeInfo> > UeInfoByImsiMap;
+
   /**
    * Map telling for each UE IPv4 address the corresponding UE info 
    */
-  std::map<Ipv4Address, Ptr<UeInfo> > m_ueInfoByAddrMap;
+  UeInfoByAddrMap m_ueInfoByAddrMap;
 
   /**
    * Map telling for each UE IPv6 address the corresponding UE info 
    */
-  std::map<Ipv6Address, Ptr<UeInfo> > m_ueInfoByAddrMap6;
+  UeInfoByAddrMap6 m_ueInfoByAddrMap6;
 
   /**
    * Map telling for each IMSI the corresponding UE info 
    */
-  std::map<uint64_t, Ptr<UeInfo> > m_ueInfoByImsiMap;
+  UeInfoByImsiMap m_ueInfoByImsiMap;
 
   /**
    * UDP port to be used for GTP
@@ -309,9 +331,14 @@ public:
   uint16_t m_gtpuUdpPort;
 
   /**
-   * TEID count
+   * TEID of the next bearer
+   */
+  uint32_t m_nextTeid;
+
+  /**
+   * difference between two consecutive TEIDs
    */
-  uint32_t m_teidCount;
+  uint32_t m_teidStep;
 
   /**
    * MME side of the S11 SAP
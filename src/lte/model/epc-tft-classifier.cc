@@ -29,8 +29,6 @@
 #include "ns3/packet.h"
 #include "ns3/ipv4-header.h"
 #include "ns3/ipv6-header.h"
-#include "ns3/udp-header.h"
-#include "ns3/tcp-header.h"
 #include "ns3/ipv4-l3-protocol.h"
 #include "ns3/icmpv4-l4-protocol.h"
 #include "ns3/udp-l4-protocol.h"
@@ -42,7 +40,61 @@ namespace ns3 {
 
 NS_LOG_COMPONENT_DEFINE ("EpcTftClassifier");
 
+/// The maximum number of flows whose classification is cached
+static const uint32_t MAX_CACHED_FLOWS = 4096;
+
+/**
+ * Read the ports of the UDP or TCP header which follows the IP header of a
+ * packet.  The ports are the first four bytes of both headers, hence the
+ * transport header does not need to be deserialized.
+ *
+ * \param p the IP packet
+ * \param ipHeaderSize the size of the IP header
+ * \param sourcePort the source port
+ * \param destinationPort the destination port
+ * \return false if the packet is too short
+ */
+static bool
+PeekPorts (Ptr<const Packet> p, uint32_t ipHeaderSize, uint16_t &sourcePort, uint16_t &destinationPort)
+{
+  // the IPv4 header is at most 60 bytes long, the IPv6 header 40 bytes
+  uint8_t buffer[64];
+  uint32_t size = ipHeaderSize + 4;
+  NS_ASSERT (size <= sizeof (buffer));
+  if (p->CopyData (buffer, size) < size)
+    {
+      return false;
+    }
+  sourcePort = (buffer[ipHeaderSize] << 8) | buffer[ipHeaderSize + 1];
+  destinationPort = (buffer[ipHeaderSize + 2] << 8) | buffer[ipHeaderSize + 3];
+  return true;
+}
+
+bool
+EpcTftClassifier::FlowKey::operator== (const FlowKey &other) const
+{
+  return remoteAddress == other.remoteAddress
+         && localAddress == other.localAddress
+         && remotePort == other.remotePort
+         && localPort == other.localPort
+         && tos == other.tos
+         && direction == other.direction
+         && ipv6 == other.ipv6;
+}
+
+std::size_t
+EpcTftClassifier::FlowKeyHash::operator () (const FlowKey &key) const
+{
+  std::hash<uint32_t> hasher;
+  std::size_t h = hasher (key.remoteAddress);
+  h ^= hasher (key.localAddress) + 0x9e3779b9 + (h << 6) + (h >> 2);
+  h ^= hasher ((static_cast<uint32_t> (key.remotePort) << 16) | key.localPort) + 0x9e3779b9 + (h << 6) + (h >> 2);
+  h ^= hasher ((static_cast<uint32_t> (key.tos) << 16) | (key.direction << 8) | key.ipv6) + 0x9e3779b9 + (h << 6) + (h >> 2);
+  return h;
+}
+
 EpcTftClassifier::EpcTftClassifier ()
+  : m_compiled (false)
 {
   NS_LOG_FUNCTION (this);
 }
@@ -52,6 +104,7 @@ EpcTftClassifier::Add (Ptr<EpcTft> tft, uint32_t id)
 {
   NS_LOG_FUNCTION (this << tft << id);
   m_tftMap[id] = tft;
+  m_compiled = false;
 
   // simple sanity check: there shouldn't be more than 16 bearers (hence TFTs) per UE
   NS_ASSERT (m_tftMap.size () <= 16);
@@ -62,6 +115,7 @@ EpcTftClassifier::Delete (uint32_t id)
 {
   NS_LOG_FUNCTION (this << id);
   m_tftMap.erase (id);
+  m_compiled = false;
 }
 
 uint32_t 
@@ -69,8 +123,6 @@ EpcTftClassifier::Classify (Ptr<Packet> p, EpcTft::Direction direction, uint16_t
 {
   NS_LOG_FUNCTION (this << p << p->GetSize () << direction);
 
-  Ptr<Packet> pCopy = p->Copy ();
-
   Ipv4Address localAddressIpv4;
   Ipv4Address remoteAddressIpv4;
 
@@ -86,7 +138,7 @@ EpcTftClassifier::Classify (Ptr<Packet> p, EpcTft::Direction direction, uint16_t
   if (protocolNumber == Ipv4L3Protocol::PROT_NUMBER)
     {
       Ipv4Header ipv4Header;
-      pCopy->RemoveHeader (ipv4Header);
+      uint32_t ipv4HeaderSize = p->PeekHeader (ipv4Header);
 
       if (direction ==  EpcTft::UPLINK)
         {
@@ -117,44 +169,21 @@ EpcTftClassifier::Classify (Ptr<Packet> p, EpcTft::Direction direction, uint16_t
       // i.e. it is the first one but it is not the last one
       if (fragmentOffset == 0)
         {
-          if (protocol == UdpL4Protocol::PROT_NUMBER && payloadSize >= 8)
-            {
-              UdpHeader udpHeader;
-              pCopy->RemoveHeader (udpHeader);
-              if (direction ==  EpcTft::UPLINK)
-                {
-                  localPort = udpHeader.GetSourcePort ();
-                  remotePort = udpHeader.GetDestinationPort ();
-                }
-              else
-                {
-                  remotePort = udpHeader.GetSourcePort ();
-                  localPort = udpHeader.GetDestinationPort ();
-                }
-              if (!isLastFragment)
-                {
-                  std::tuple<uint32_t, uint32_t, uint8_t, uint16_t> fragmentKey =
-                      std::make_tuple (ipv4Header.GetSource ().Get (),
-                                       ipv4Header.GetDestination ().Get (),
-                                       protocol,
-                                       ipv4Header.GetIdentification ());
-
-                  m_classifiedIpv4Fragments[fragmentKey] = std::make_pair (localPort, remotePort);
-                }
-            }
-          else if (protocol == TcpL4Protocol::PROT_NUMBER && payloadSize >= 20)
+          uint16_t sourcePort;
+          uint16_t destinationPort;
+          if (((protocol == UdpL4Protocol::PROT_NUMBER && payloadSize >= 8)
+               || (protocol == TcpL4Protocol::PROT_NUMBER && payloadSize >= 20))
+              && PeekPorts (p, ipv4HeaderSize, sourcePort, destinationPort))
             {
-              TcpHeader tcpHeader;
-              pCopy->RemoveHeader (tcpHeader);
               if (direction ==  EpcTft::UPLINK)
                 {
-                  localPort = tcpHeader.GetSourcePort ();
-                  remotePort = tcpHeader.GetDestinationPort ();
+                  localPort = sourcePort;
+                  remotePort = destinationPort;
                 }
               else
                 {
-                  remotePort = tcpHeader.GetSourcePort ();
-                  localPort = tcpHeader.GetDestinationPort ();
+                  remotePort = sourcePort;
+                  localPort = destinationPort;
                 }
 
               if (!isLastFragment)
@@ -202,7 +231,7 @@ EpcTftClassifier::Classify (Ptr<Packet> p, EpcTft::Direction direction, uint16_t
   else if (protocolNumber == Ipv6L3Protocol::PROT_NUMBER)
     {
       Ipv6Header ipv6Header;
-      pCopy->RemoveHeader (ipv6Header);
+      uint32_t ipv6HeaderSize = p->PeekHeader (ipv6Header);
 
       if (direction ==  EpcTft::UPLINK)
         {
@@ -220,35 +249,20 @@ EpcTftClassifier::Classify (Ptr<Packet> p, EpcTft::Direction direction, uint16_t
       protocol = ipv6Header.GetNextHeader ();
       tos = ipv6Header.GetTrafficClass ();
 
-      if (protocol == UdpL4Protocol::PROT_NUMBER)
+      uint16_t sourcePort;
+      uint16_t destinationPort;
+      if ((protocol == UdpL4Protocol::PROT_NUMBER || protocol == TcpL4Protocol::PROT_NUMBER)
+          && PeekPorts (p, ipv6HeaderSize, sourcePort, destinationPort))
         {
-          UdpHeader udpHeader;
-          pCopy->RemoveHeader (udpHeader);
-
           if (direction ==  EpcTft::UPLINK)
             {
-              localPort = udpHeader.GetSourcePort ();
-              remotePort = udpHeader.GetDestinationPort ();
+              localPort = sourcePort;
+              remotePort = destinationPort;
             }
           else
             {
-              remotePort = udpHeader.GetSourcePort ();
-              localPort = udpHeader.GetDestinationPort ();
-            }
-        }
-      else if (protocol == TcpL4Protocol::PROT_NUMBER)
-        {
-          TcpHeader tcpHeader;
-          pCopy->RemoveHeader (tcpHeader);
-          if (direction ==  EpcTft::UPLINK)
-            {
-              localPort = tcpHeader.GetSourcePort ();
-              remotePort = tcpHeader.GetDestinationPort ();
-            }
-          else
-            {
-              remotePort = tcpHeader.GetSourcePort ();
-              localPort = tcpHeader.GetDestinationPort ();
+              remotePort = sourcePort;
+              localPort = destinationPort;
             }
         }
     }
@@ -258,6 +272,11 @@ EpcTftClassifier::Classify (Ptr<Packet> p, EpcTft::Direction direction, uint16_t
     }
 
 
+  FlowKey key;
+  key.remotePort = remotePort;
+  key.localPort = localPort;
+  key.tos = tos;
+  key.direction = direction;
   if (protocolNumber == Ipv4L3Protocol::PROT_NUMBER)
     {
       NS_LOG_INFO ("Classifying packet:"
@@ -266,26 +285,11 @@ EpcTftClassifier::Classify (Ptr<Packet> p, EpcTft::Direction direction, uint16_t
           << " localPort="  << localPort
           << " remotePort=" << remotePort
           << " tos=0x" << (uint16_t) tos );
-
-      // now it is possible to classify the packet!
-      // we use a reverse iterator since filter priority is not implemented properly.
-      // This way, since the default bearer is expected to be added first, it will be evaluated last.
-      std::map <uint32_t, Ptr<EpcTft> >::const_reverse_iterator it;
-      NS_LOG_LOGIC ("TFT MAP size: " << m_tftMap.size ());
-
-      for (it = m_tftMap.rbegin (); it != m_tftMap.rend (); ++it)
-        {
-          NS_LOG_LOGIC ("TFT id: " << it->first );
-          NS_LOG_LOGIC (" Ptr<EpcTft>: " << it->second);
-          Ptr<EpcTft> tft = it->second;
-          if (tft->Matches (direction, remoteAddressIpv4, localAddressIpv4, remotePort, localPort, tos))
-            {
-              NS_LOG_LOGIC ("matches with TFT ID = " << it->first);
-              return it->first; // the id of the matching TFT
-            }
-        }
+      key.remoteAddress = remoteAddressIpv4.Get ();
+      key.localAddress = localAddressIpv4.Get ();
+      key.ipv6 = false;
     }
-  else if (protocolNumber == Ipv6L3Protocol::PROT_NUMBER)
+  else
     {
       NS_LOG_INFO ("Classifying packet:"
           << " localAddr="  << localAddressIpv6
@@ -293,27 +297,197 @@ EpcTftClassifier::Classify (Ptr<Packet> p, EpcTft::Direction direction, uint16_t
           << " localPort="  << localPort
           << " remotePort=" << remotePort
           << " tos=0x" << (uint16_t) tos );
+      key.remoteAddress = 0;
+      key.localAddress = 0;
+      key.ipv6 = true;
+    }
 
-      // now it is possible to classify the packet!
-      // we use a reverse iterator since filter priority is not implemented properly.
-      // This way, since the default bearer is expected to be added first, it will be evaluated last.
-      std::map <uint32_t, Ptr<EpcTft> >::const_reverse_iterator it;
-      NS_LOG_LOGIC ("TFT MAP size: " << m_tftMap.size ());
+  if (IsCompilationNeeded ())
+    {
+      Compile ();
+    }
+  std::unordered_map<FlowKey, uint32_t, FlowKeyHash>::const_iterator cached = m_flowCache.find (key);
+  if (cached != m_flowCache.end ())
+    {
+      NS_LOG_LOGIC ("flow already classified with TFT ID = " << cached->second);
+      return cached->second;
+    }
+
+  // now it is possible to classify the packet!
+  uint32_t rank = Lookup (key.ipv6 ? m_ipv6Filters : m_ipv4Filters, key);
+  uint32_t id = 0;  // no match
+  if (rank < m_rankIds.size ())
+    {
+      id = m_rankIds[rank]; // the id of the matching TFT
+      NS_LOG_LOGIC ("matches with TFT ID = " << id);
+    }
+  else
+    {
+      NS_LOG_LOGIC ("no match");
+    }
+  if (m_flowCache.size () >= MAX_CACHED_FLOWS)
+    {
+      m_flowCache.clear ();
+    }
+  m_flowCache[key] = id;
+  return id;
+}
 
-      for (it = m_tftMap.rbegin (); it != m_tftMap.rend (); ++it)
+bool
+EpcTftClassifier::IsCompilationNeeded () const
+{
+  if (!m_compiled)
+    {
+      return true;
+    }
+  // packet filters may have been added to the TFTs
+  for (std::vector<std::pair<Ptr<EpcTft>, uint8_t> >::const_iterator it = m_compiledTfts.begin ();
+       it != m_compiledTfts.end (); ++it)
+    {
+      if (it->first->GetNumFilters () != it->second)
         {
-          NS_LOG_LOGIC ("TFT id: " << it->first );
-          NS_LOG_LOGIC (" Ptr<EpcTft>: " << it->second);
-          Ptr<EpcTft> tft = it->second;
-          if (tft->Matches (direction, remoteAddressIpv6, localAddressIpv6, remotePort, localPort, tos))
+          return true;
+        }
+    }
+  return false;
+}
+
+void
+EpcTftClassifier::Compile ()
+{
+  NS_LOG_FUNCTION (this);
+  m_compiledTfts.clear ();
+  m_rankIds.clear ();
+  m_ipv4Filters = FilterSet ();
+  m_ipv6Filters = FilterSet ();
+  m_flowCache.clear ();
+
+  // the TFTs are ranked in reverse order since filter priority is not
+  // implemented properly.  This way, since the default bearer is expected to
+  // be added first, it will be evaluated last.  The filters are added by
+  // increasing rank, hence the tuples and the filters of each key are
+  // sorted by rank.
+  uint32_t rank = 0;
+  for (std::map <uint32_t, Ptr<EpcTft> >::const_reverse_iterator it = m_tftMap.rbegin ();
+       it != m_tftMap.rend (); ++it, ++rank)
+    {
+      m_compiledTfts.push_back (std::make_pair (it->second, it->second->GetNumFilters ()));
+      m_rankIds.push_back (it->first);
+      std::list<EpcTft::PacketFilter> filters = it->second->GetPacketFilters ();
+      for (std::list<EpcTft::PacketFilter>::const_iterator fit = filters.begin (); fit != filters.end (); ++fit)
+        {
+          RankedFilter filter;
+          filter.rank = rank;
+          filter.filter = *fit;
+          AddFilter (m_ipv4Filters, filter, true);
+          // the IPv6 addresses are not matched by the packet filters
+          AddFilter (m_ipv6Filters, filter, false);
+        }
+    }
+  NS_LOG_LOGIC ("compiled " << rank << " TFTs in " << m_ipv4Filters.tuples.size () << " IPv4 tuples and "
+                << m_ipv4Filters.rangeFilters.size () << " filters with port ranges");
+  m_compiled = true;
+}
+
+void
+EpcTftClassifier::AddFilter (FilterSet &set, const RankedFilter &filter, bool matchAddresses)
+{
+  const EpcTft::PacketFilter &f = filter.filter;
+  bool singleRemotePort = (f.remotePortStart == f.remotePortEnd);
+  bool anyRemotePort = (f.remotePortStart == 0 && f.remotePortEnd == 65535);
+  bool singleLocalPort = (f.localPortStart == f.localPortEnd);
+  bool anyLocalPort = (f.localPortStart == 0 && f.localPortEnd == 65535);
+  if (!(singleRemotePort || anyRemotePort) || !(singleLocalPort || anyLocalPort))
+    {
+      set.rangeFilters.push_back (filter);
+      return;
+    }
+
+  uint32_t remoteMask = matchAddresses ? f.remoteMask.Get () : 0;
+  uint32_t localMask = matchAddresses ? f.localMask.Get () : 0;
+  std::vector<FilterTuple>::iterator tuple = set.tuples.begin ();
+  while (tuple != set.tuples.end ()
+         && !(tuple->remoteMask == remoteMask && tuple->localMask == localMask
+              && tuple->singleRemotePort == singleRemotePort && tuple->singleLocalPort == singleLocalPort))
+    {
+      ++tuple;
+    }
+  if (tuple == set.tuples.end ())
+    {
+      FilterTuple newTuple;
+      newTuple.remoteMask = remoteMask;
+      newTuple.localMask = localMask;
+      newTuple.singleRemotePort = singleRemotePort;
+      newTuple.singleLocalPort = singleLocalPort;
+      newTuple.firstRank = filter.rank;
+      tuple = set.tuples.insert (set.tuples.end (), newTuple);
+    }
+
+  FlowKey key;
+  key.remoteAddress = f.remoteAddress.Get () & remoteMask;
+  key.localAddress = f.localAddress.Get () & localMask;
+  key.remotePort = singleRemotePort ? f.remotePortStart : 0;
+  key.localPort = singleLocalPort ? f.localPortStart : 0;
+  key.tos = 0;
+  key.direction = 0;
+  key.ipv6 = false;
+  tuple->filters[key].push_back (filter);
+}
+
+uint32_t
+EpcTftClassifier::Lookup (FilterSet &set, const FlowKey &key) const
+{
+  uint32_t bestRank = m_rankIds.size ();
+  for (std::vector<FilterTuple>::iterator tuple = set.tuples.begin ();
+       tuple != set.tuples.end () && tuple->firstRank < bestRank; ++tuple)
+    {
+      FlowKey tupleKey;
+      tupleKey.remoteAddress = key.remoteAddress & tuple->remoteMask;
+      tupleKey.localAddress = key.localAddress & tuple->localMask;
+      tupleKey.remotePort = tuple->singleRemotePort ? key.remotePort : 0;
+      tupleKey.localPort = tuple->singleLocalPort ? key.localPort : 0;
+      tupleKey.tos = 0;
+      tupleKey.direction = 0;
+      tupleKey.ipv6 = false;
+      FilterTupleMap::iterator it = tuple->filters.find (tupleKey);
+      if (it == tuple->filters.end ())
+        {
+          continue;
+        }
+      // the direction and the type of service are checked here
+      for (std::vector<RankedFilter>::iterator filter = it->second.begin ();
+           filter != it->second.end () && filter->rank < bestRank; ++filter)
+        {
+          if (Matches (*filter, key))
             {
-              NS_LOG_LOGIC ("matches with TFT ID = " << it->first);
-              return it->first; // the id of the matching TFT
+              bestRank = filter->rank;
+              break;
             }
         }
     }
-  NS_LOG_LOGIC ("no match");
-  return 0;  // no match
+  for (std::vector<RankedFilter>::iterator filter = set.rangeFilters.begin ();
+       filter != set.rangeFilters.end () && filter->rank < bestRank; ++filter)
+    {
+      if (Matches (*filter, key))
+        {
+          bestRank = filter->rank;
+          break;
+        }
+    }
+  return bestRank;
+}
+
+bool
+EpcTftClassifier::Matches (RankedFilter &filter, const FlowKey &key)
+{
+  EpcTft::Direction direction = static_cast<EpcTft::Direction> (key.direction);
+  if (key.ipv6)
+    {
+      return filter.filter.Matches (direction, Ipv6Address (), Ipv6Address (),
+                                    key.remotePort, key.localPort, key.tos);
+    }
+  return filter.filter.Matches (direction, Ipv4Address (key.remoteAddress), Ipv4Address (key.localAddress),
+                                key.remotePort, key.localPort, key.tos);
 }
 
 
@@ -28,6 +28,8 @@
 #include "ns3/epc-tft.h"
 
 #include <map>
+#include <vector>
+#include <unordered_map>
 
 
 namespace ns3 {
@@ -50,6 +52,16 @@ class Packet;
  *
  * When we cannot cache the port info, the TFT of the default bearer is used. This may happen
  * if there is reordering or losses of IP packets.
+ *
+ * The TFTs are evaluated from the highest to the lowest identifier, and the
+ * packet filters of a TFT in the order of their precedence.  Instead of
+ * testing the filters one by one, the classifier compiles them, when they
+ * are first used after a change, into tuples of filters with the same
+ * address masks and the same kind of ports (a single port or any port),
+ * each hashed on its masked addresses and ports; the filters with other port
+ * ranges are tested one by one.  The result of the classification of each
+ * flow, i.e., of each combination of direction, addresses, ports and type of
+ * service, is also cached until the TFTs change.
  */
 class EpcTftClassifier : public SimpleRefCount<EpcTftClassifier>
 {
@@ -98,6 +110,106 @@ protected:
                                  ///<   not first fragment or not enough payload data for TCP/UDP
                                  ///< An entry is removed when the last fragment is classified
                                  ///<   Note: If last fragment is lost, entry is not removed
+
+private:
+  /// The fields of a packet which are matched by the packet filters.
+  struct FlowKey
+  {
+    uint32_t remoteAddress; ///< the remote IPv4 address, 0 for IPv6 since the IPv6 addresses are not matched
+    uint32_t localAddress;  ///< the local IPv4 address, 0 for IPv6 since the IPv6 addresses are not matched
+    uint16_t remotePort;    ///< the remote port
+    uint16_t localPort;     ///< the local port
+    uint8_t tos;            ///< the type of service
+    uint8_t direction;      ///< the direction
+    bool ipv6;              ///< whether the packet is an IPv6 packet
+
+    /**
+     * \param other another key
+     * \return true if the keys are equal
+     */
+    bool operator== (const FlowKey &other) const;
+  };
+
+  /// Hash function of FlowKey.
+  struct FlowKeyHash
+  {
+    /**
+     * \param key the key
+     * \return the hash of the key
+     */
+    std::size_t operator () (const FlowKey &key) const;
+  };
+
+  /// A packet filter, with the rank of its TFT in the evaluation order.
+  struct RankedFilter
+  {
+    uint32_t rank;                ///< the rank of the TFT, 0 for the TFT evaluated first
+    EpcTft::PacketFilter filter;  ///< the packet filter
+  };
+
+  /// The key of the filters of a tuple: the masked addresses and the single ports, the other fields being 0.
+  typedef std::unordered_map<FlowKey, std::vector<RankedFilter>, FlowKeyHash> FilterTupleMap;
+
+  /// The packet filters with the same address masks and the same kind of ports.
+  struct FilterTuple
+  {
+    uint32_t remoteMask;    ///< the mask of the remote address
+    uint32_t localMask;     ///< the mask of the local address
+    bool singleRemotePort;  ///< whether the filters match a single remote port, or any remote port
+    bool singleLocalPort;   ///< whether the filters match a single local port, or any local port
+    uint32_t firstRank;     ///< the lowest rank of the filters
+    FilterTupleMap filters; ///< the filters, sorted by rank for each key
+  };
+
+  /// The compiled packet filters of an IP version.
+  struct FilterSet
+  {
+    std::vector<FilterTuple> tuples;        ///< the tuples, sorted by first rank
+    std::vector<RankedFilter> rangeFilters; ///< the filters with port ranges, sorted by rank
+  };
+
+  /**
+   * \return true if the TFTs changed since they were compiled
+   */
+  bool IsCompilationNeeded () const;
+
+  /**
+   * Compile the packet filters of the TFTs, and clear the flow cache.
+   */
+  void Compile ();
+
+  /**
+   * Add a packet filter to a filter set.
+   * \param set the filter set
+   * \param filter the packet filter, with the rank of its TFT
+   * \param matchAddresses whether the filters of the set match the addresses
+   */
+  static void AddFilter (FilterSet &set, const RankedFilter &filter, bool matchAddresses);
+
+  /**
+   * \param set the filter set
+   * \param key the fields of a packet
+   * \return the rank of the first TFT matching the packet, or the number
+   * of TFTs if no TFT matched
+   */
+  uint32_t Lookup (FilterSet &set, const FlowKey &key) const;
+
+  /**
+   * \param filter a packet filter
+   * \param key the fields of a packet
+   * \return true if the packet filter matches the packet
+   */
+  static bool Matches (RankedFilter &filter, const FlowKey &key);
+
+  /// The TFTs and their number of packet filters when they were compiled, by rank.
+  std::vector<std::pair<Ptr<EpcTft>, uint8_t> > m_compiledTfts;
+  std::vector<uint32_t> m_rankIds; ///< the identifiers of the TFTs, by rank
+  bool m_compiled;                 ///< whether the TFTs were compiled since they were added or deleted
+  FilterSet m_ipv4Filters;         ///< the compiled filters for IPv4 packets
+  FilterSet m_ipv6Filters;         ///< the compiled filters for IPv6 packets
+
+  /// The identifiers of the TFTs matching the flows classified since the compilation.
+  std::unordered_map<FlowKey, uint32_t, FlowKeyHash> m_flowCache;
 };
 
 
@@ -237,6 +237,18 @@ EpcTft::Add (PacketFilter f)
   return (m_numFilters - 1);
 }
 
+std::list<EpcTft::PacketFilter>
+EpcTft::GetPacketFilters () const
+{
+  return m_filters;
+}
+
+uint8_t
+EpcTft::GetNumFilters () const
+{
+  return m_numFilters;
+}
+
 bool 
 EpcTft::Matches (Direction direction,
                  Ipv4Address remoteAddress,
@@ -152,6 +152,17 @@ public:
    */
   uint8_t Add (PacketFilter f);
 
+  /**
+   * \return the packet filters of the TFT, in the order in which they
+   * are evaluated
+   */
+  std::list<PacketFilter> GetPacketFilters () const;
+
+  /**
+   * \return the number of packet filters of the TFT
+   */
+  uint8_t GetNumFilters () const;
+
 
     /** 
      * 
@@ -26,6 +26,7 @@
 #include <ns3/assert.h>
 #include <ns3/math.h>
 #include <vector>
+#include <algorithm>
 #include <ns3/spectrum-value.h>
 #include <ns3/double.h>
 #include "ns3/enum.h"
@@ -45,7 +46,7 @@ NS_OBJECT_ENSURE_REGISTERED (LteAmc);
  * file `TBS_support.xls` tab "MCS Table" (rounded to 2 decimal digits).
  * The index of the vector (range 0-15) identifies the CQI value.
  */
-static const double SpectralEfficiencyForCqi[16] = {
+static constexpr double SpectralEfficiencyForCqi[16] = {
   0.0, // out of range
   0.15, 0.23, 0.38, 0.6, 0.88, 1.18,
   1.48, 1.91, 2.41,
@@ -80,19 +81,75 @@ static const int ModulationSchemeForMcs[32] = {
  * to the convention in TS 36.213 (i.e., the MCS index reported in R1-081483
  * minus one)
  */
-static const double SpectralEfficiencyForMcs[32] = {
+static constexpr double SpectralEfficiencyForMcs[32] = {
   0.15, 0.19, 0.23, 0.31, 0.38, 0.49, 0.6, 0.74, 0.88, 1.03, 1.18,
   1.33, 1.48, 1.7, 1.91, 2.16, 2.41, 2.57,
   2.73, 3.03, 3.32, 3.61, 3.9, 4.21, 4.52, 4.82, 5.12, 5.33, 5.55,
   0, 0, 0
 };
 
+/**
+ * \param cqi the CQI
+ * \param mcs the MCS from which to search
+ * \return the highest MCS not lower than mcs whose spectral efficiency does
+ *         not exceed the one of the CQI, or mcs
+ */
+static constexpr int
+SearchMcsForCqi (int cqi, int mcs)
+{
+  return ((mcs < 28) && (SpectralEfficiencyForMcs[mcs + 1] <= SpectralEfficiencyForCqi[cqi]))
+         ? SearchMcsForCqi (cqi, mcs + 1) : mcs;
+}
+
+/**
+ * \param mcs the MCS
+ * \param cqi the CQI from which to search
+ * \return the highest CQI not lower than cqi whose spectral efficiency is
+ *         lower than the one of the MCS, or cqi
+ */
+static constexpr int
+SearchCqiForMcs (int mcs, int cqi)
+{
+  return ((cqi < 15) && (SpectralEfficiencyForCqi[cqi + 1] < SpectralEfficiencyForMcs[mcs]))
+         ? SearchCqiForMcs (mcs, cqi + 1) : cqi;
+}
+
+/**
+ * Table of CQI and the highest MCS whose spectral efficiency does not exceed
+ * the one of the CQI, computed at compile time from the tables above.
+ */
+static constexpr int CqiToMcs[16] = {
+  SearchMcsForCqi (0, 0), SearchMcsForCqi (1, 0), SearchMcsForCqi (2, 0), SearchMcsForCqi (3, 0),
+  SearchMcsForCqi (4, 0), SearchMcsForCqi (5, 0), SearchMcsForCqi (6, 0), SearchMcsForCqi (7, 0),
+  SearchMcsForCqi (8, 0), SearchMcsForCqi (9, 0), SearchMcsForCqi (10, 0), SearchMcsForCqi (11, 0),
+  SearchMcsForCqi (12, 0), SearchMcsForCqi (13, 0), SearchMcsForCqi (14, 0), SearchMcsForCqi (15, 0)
+};
+
+/**
+ * Table of MCS (range 0-28) and the highest CQI whose spectral efficiency is
+ * lower than the one of the MCS, computed at compile time from the tables
+ * above.
+ */
+static constexpr int McsToCqi[29] = {
+  SearchCqiForMcs (0, 0), SearchCqiForMcs (1, 0), SearchCqiForMcs (2, 0), SearchCqiForMcs (3, 0),
+  SearchCqiForMcs (4, 0), SearchCqiForMcs (5, 0), SearchCqiForMcs (6, 0), SearchCqiForMcs (7, 0),
+  SearchCqiForMcs (8, 0), SearchCqiForMcs (9, 0), SearchCqiForMcs (10, 0), SearchCqiForMcs (11, 0),
+  SearchCqiForMcs (12, 0), SearchCqiForMcs (13, 0), SearchCqiForMcs (14, 0), SearchCqiForMcs (15, 0),
+  SearchCqiForMcs (16, 0), SearchCqiForMcs (17, 0), SearchCqiForMcs (18, 0), SearchCqiForMcs (19, 0),
+  SearchCqiForMcs (20, 0), SearchCqiForMcs (21, 0), SearchCqiForMcs (22, 0), SearchCqiForMcs (23, 0),
+  SearchCqiForMcs (24, 0), SearchCqiForMcs (25, 0), SearchCqiForMcs (26, 0), SearchCqiForMcs (27, 0),
+  SearchCqiForMcs (28, 0)
+};
+
+static_assert (CqiToMcs[0] == 0 && CqiToMcs[15] == 28, "CQI to MCS table");
+static_assert (McsToCqi[0] == 0 && McsToCqi[28] == 14, "MCS to CQI table");
+
 /**
  * Table of MCS index (IMCS) and its TBS index (ITBS). Taken from 3GPP TS
  * 36.213 v8.8.0 Table 7.1.7.1-1: _Modulation and TBS index table for PDSCH_.
  * The index of the vector (range 0-28) identifies the MCS index.
  */
-static const int McsToItbsDl[29] = {
+static constexpr int McsToItbsDl[29] = {
   0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 9, 10, 11, 12, 13, 14, 15, 15, 16, 17, 18,
   19, 20, 21, 22, 23, 24, 25, 26
 };
@@ -102,7 +159,7 @@ static const int McsToItbsDl[29] = {
  * 36.213 v8.8.0 Table 8.6.1-1: _Modulation, TBS index and redundancy version table for PUSCH_.
  * The index of the vector (range 0-28) identifies the MCS index.
  */
-static const int McsToItbsUl[29] = {
+static constexpr int McsToItbsUl[29] = {
   0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 10, 11, 12, 13, 14, 15, 16, 17, 18,
   19, 19, 20, 21, 22, 23, 24, 25, 26
 };
@@ -115,7 +172,7 @@ static const int McsToItbsUl[29] = {
  *       consistent with the other values, therefore we use 88 obtained by
  *       following the sequence of NPRB = 1 values.
  */
-static const int TransportBlockSizeTable [110][27] = {
+static constexpr int TransportBlockSizeTable [110][27] = {
   /* NPRB 001*/ { 16, 24, 32, 40, 56, 72, 88, 104, 120, 136, 144, 176, 208, 224, 256, 280, 328, 336, 376, 408, 440, 488, 520, 552, 584, 616, 712},
   /* NPRB 002*/ { 32, 56, 72, 104, 120, 144, 176, 224, 256, 296, 328, 376, 440, 488, 552, 600, 632, 696, 776, 840, 904, 1000, 1064, 1128, 1192, 1256, 1480},
   /* NPRB 003*/ { 56, 88, 144, 176, 208, 224, 256, 328, 392, 456, 504, 584, 680, 744, 840, 904, 968, 1064, 1160, 1288, 1384, 1480, 1608, 1736, 1800, 1864, 2216},
@@ -231,6 +288,7 @@ static const int TransportBlockSizeTable [110][27] = {
 
 
 LteAmc::LteAmc ()
+  : m_sinrThresholdsBer (-1.0)
 {
 }
 
@@ -266,11 +324,9 @@ LteAmc::GetCqiFromSpectralEfficiency (double s)
 {
   NS_LOG_FUNCTION (s);
   NS_ASSERT_MSG (s >= 0.0, "negative spectral efficiency = " << s);
-  int cqi = 0;
-  while ((cqi < 15) && (SpectralEfficiencyForCqi[cqi + 1] < s))
-    {
-      ++cqi;
-    }
+  // the number of CQIs above 0 whose spectral efficiency is lower than s
+  int cqi = std::lower_bound (SpectralEfficiencyForCqi + 1, SpectralEfficiencyForCqi + 16, s)
+    - (SpectralEfficiencyForCqi + 1);
   NS_LOG_LOGIC ("cqi = " << cqi);
   return cqi;
 }
@@ -281,12 +337,7 @@ LteAmc::GetMcsFromCqi (int cqi)
 {
   NS_LOG_FUNCTION (cqi);
   NS_ASSERT_MSG (cqi >= 0 && cqi <= 15, "CQI must be in [0..15] = " << cqi);
-  double spectralEfficiency = SpectralEfficiencyForCqi[cqi];
-  int mcs = 0;
-  while ((mcs < 28) && (SpectralEfficiencyForMcs[mcs + 1] <= spectralEfficiency))
-    {
-      ++mcs;
-    }
+  int mcs = CqiToMcs[cqi];
   NS_LOG_LOGIC ("mcs = " << mcs);
   return mcs;
 }
@@ -337,6 +388,11 @@ LteAmc::CreateCqiFeedbacks (const SpectrumValue& sinr, uint8_t rbgSize)
   if (m_amcModel == PiroEW2010)
     {
 
+      if (m_sinrThresholdsBer != m_ber)
+        {
+          ComputeSinrThresholds ();
+        }
+      cqi.reserve (sinr.GetSpectrumModel ()->GetNumBands ());
       for (it = sinr.ConstValuesBegin (); it != sinr.ConstValuesEnd (); it++)
         {
           double sinr_ = (*it);
@@ -346,22 +402,13 @@ LteAmc::CreateCqiFeedbacks (const SpectrumValue& sinr, uint8_t rbgSize)
             }
           else
             {
-              /*
-              * Compute the spectral efficiency from the SINR
-              *                                        SINR
-              * spectralEfficiency = log2 (1 + -------------------- )
-              *                                    -ln(5*BER)/1.5
-              * NB: SINR must be expressed in linear units
-              */
-
-              double s = log2 ( 1 + ( sinr_ / ( (-std::log (5.0 * m_ber )) / 1.5) ));
-
-              int cqi_ = GetCqiFromSpectralEfficiency (s);
+              // the CQI is the number of CQIs above 0 whose SINR threshold
+              // is lower than the SINR, see ComputeSinrThresholds
+              int cqi_ = std::lower_bound (m_sinrThresholds, m_sinrThresholds + 15, sinr_) - m_sinrThresholds;
 
               NS_LOG_LOGIC (" PRB =" << cqi.size ()
                                     << ", sinr = " << sinr_
                                     << " (=" << 10 * std::log10 (sinr_) << " dB)"
-                                    << ", spectral efficiency =" << s
                                     << ", CQI = " << cqi_ << ", BER = " << m_ber);
 
               cqi.push_back (cqi_);
@@ -381,10 +428,16 @@ LteAmc::CreateCqiFeedbacks (const SpectrumValue& sinr, uint8_t rbgSize)
          {
             uint8_t mcs = 0;
             TbStats_t tbStats;
+            HarqProcessInfoList_t harqInfoList;
+            double mib = 0.0;
             while (mcs <= 28)
               {
-                HarqProcessInfoList_t harqInfoList;
-                tbStats = LteMiErrorModel::GetTbDecodificationStats (sinr, rbgMap, (uint16_t)GetDlTbSizeFromMcs (mcs, rbgSize) / 8, mcs, harqInfoList);
+                if ((mcs == 0) || (mcs == MI_QPSK_MAX_ID + 1) || (mcs == MI_16QAM_MAX_ID + 1))
+                  {
+                    // the MI of the RBG only depends on the modulation
+                    mib = LteMiErrorModel::Mib (sinr, rbgMap, mcs);
+                  }
+                tbStats = LteMiErrorModel::GetTbDecodificationStatsFromMib (mib, (uint16_t)GetDlTbSizeFromMcs (mcs, rbgSize) / 8, mcs, harqInfoList);
                 if (tbStats.tbler > 0.1)
                   {
                     break;
@@ -408,12 +461,7 @@ LteAmc::CreateCqiFeedbacks (const SpectrumValue& sinr, uint8_t rbgSize)
               }
             else
               {
-                double s = SpectralEfficiencyForMcs[mcs];
-                rbgCqi = 0;
-                while ((rbgCqi < 15) && (SpectralEfficiencyForCqi[rbgCqi + 1] < s))
-                {
-                  ++rbgCqi;
-                }
+                rbgCqi = McsToCqi[mcs];
               }
             NS_LOG_DEBUG (this << "\t MCS " << (uint16_t)mcs << "-> CQI " << rbgCqi);
             // fill the cqi vector (per RB basis)
@@ -431,4 +479,25 @@ LteAmc::CreateCqiFeedbacks (const SpectrumValue& sinr, uint8_t rbgSize)
   return cqi;
 }
 
+void
+LteAmc::ComputeSinrThresholds ()
+{
+  NS_LOG_FUNCTION (this << m_ber);
+  /*
+   * The spectral efficiency of the PiroEW2010 model is
+   *                                        SINR
+   * spectralEfficiency = log2 (1 + -------------------- )
+   *                                    -ln(5*BER)/1.5
+   * with the SINR in linear units, hence the spectral efficiency exceeds
+   * the one of a CQI when the SINR exceeds
+   * -ln(5*BER)/1.5 * (2^spectralEfficiency(CQI) - 1)
+   */
+  double gap = -std::log (5.0 * m_ber) / 1.5;
+  for (int cqi = 1; cqi <= 15; ++cqi)
+    {
+      m_sinrThresholds[cqi - 1] = gap * (std::pow (2.0, SpectralEfficiencyForCqi[cqi]) - 1.0);
+    }
+  m_sinrThresholdsBer = m_ber;
+}
+
 } // namespace ns3
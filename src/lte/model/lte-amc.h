@@ -118,7 +118,12 @@ public:
   int GetCqiFromSpectralEfficiency (double s);
   
 private:
-  
+  /**
+   * Compute the SINR thresholds of the CQIs of the PiroEW2010 model for
+   * the current BER
+   */
+  void ComputeSinrThresholds ();
+
   /**
    * The `Ber` attribute.
    *
@@ -133,6 +138,14 @@ private:
    */
   AmcModel m_amcModel;
 
+  /**
+   * The linear SINRs above which the PiroEW2010 model reports the CQIs 1 to
+   * 15, which replace the computation of the spectral efficiency of each RB
+   */
+  double m_sinrThresholds[15];
+  /// the BER for which m_sinrThresholds was computed, negative if none
+  double m_sinrThresholdsBer;
+
 }; // end of `class LteAmc`
 
 
@@ -50,7 +50,7 @@ void
 LteChunkProcessor::Start ()
 {
   NS_LOG_FUNCTION (this);
-  m_sumValues = 0;
+  // m_sumValues is kept, and overwritten by the first chunk
   m_totDuration = MicroSeconds (0);
 }
 
@@ -59,11 +59,28 @@ void
 LteChunkProcessor::EvaluateChunk (const SpectrumValue& sinr, Time duration)
 {
   NS_LOG_FUNCTION (this << sinr << duration);
-  if (m_sumValues == 0)
+  if ((m_sumValues == 0) || (m_sumValues->GetSpectrumModel () != sinr.GetSpectrumModel ()))
     {
       m_sumValues = Create<SpectrumValue> (sinr.GetSpectrumModel ());
+      m_totDuration = MicroSeconds (0);
+    }
+  double seconds = duration.GetSeconds ();
+  Values::const_iterator value = sinr.ConstValuesBegin ();
+  Values::iterator end = m_sumValues->ValuesEnd ();
+  if (m_totDuration.IsZero ())
+    {
+      for (Values::iterator sum = m_sumValues->ValuesBegin (); sum != end; ++sum, ++value)
+        {
+          *sum = *value * seconds;
+        }
+    }
+  else
+    {
+      for (Values::iterator sum = m_sumValues->ValuesBegin (); sum != end; ++sum, ++value)
+        {
+          *sum += *value * seconds;
+        }
     }
-  (*m_sumValues) += sinr * duration.GetSeconds ();
   m_totDuration += duration;
 }
 
@@ -73,10 +90,13 @@ LteChunkProcessor::End ()
   NS_LOG_FUNCTION (this);
   if (m_totDuration.GetSeconds () > 0)
     {
+      // the average is computed in place, m_sumValues is overwritten by the
+      // first chunk of the next RX
+      (*m_sumValues) /= m_totDuration.GetSeconds ();
       std::vector<LteChunkProcessorCallback>::iterator it;
       for (it = m_lteChunkProcessorCallbacks.begin (); it != m_lteChunkProcessorCallbacks.end (); it++)
         {
-          (*it)((*m_sumValues) / m_totDuration.GetSeconds ());
+          (*it)(*m_sumValues);
         }
     }
   else
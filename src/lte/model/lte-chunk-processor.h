@@ -88,7 +88,7 @@ public:
   virtual void End ();
 
 private:
-  Ptr<SpectrumValue> m_sumValues; ///< sum values
+  Ptr<SpectrumValue> m_sumValues; ///< sum values, whose buffer is reused from one RX to the next
   Time m_totDuration; ///< total duration
 
   std::vector<LteChunkProcessorCallback> m_lteChunkProcessorCallbacks; ///< chunk processor callback
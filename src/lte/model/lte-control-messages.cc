@@ -54,6 +54,20 @@ LteControlMessage::GetMessageType (void)
 }
 
 
+void
+LteControlMessage::Recycle (void)
+{
+  delete this;
+}
+
+
+void
+LteControlMessageDeleter::Delete (LteControlMessage *msg)
+{
+  msg->Recycle ();
+}
+
+
 // ----------------------------------------------------------------------------------------------------------
 
 
@@ -69,20 +83,27 @@ DlDciLteControlMessage::~DlDciLteControlMessage (void)
 }
 
 void
-DlDciLteControlMessage::SetDci (DlDciListElement_s dci)
+DlDciLteControlMessage::SetDci (const DlDciListElement_s &dci)
 {
   m_dci = dci;
 
 }
 
 
-DlDciListElement_s
-DlDciLteControlMessage::GetDci (void)
+const DlDciListElement_s &
+DlDciLteControlMessage::GetDci (void) const
 {
   return m_dci;
 }
 
 
+void
+DlDciLteControlMessage::Recycle (void)
+{
+  LteControlMessagePool<DlDciLteControlMessage>::Put (this);
+}
+
+
 // ----------------------------------------------------------------------------------------------------------
 
 
@@ -98,20 +119,27 @@ UlDciLteControlMessage::~UlDciLteControlMessage (void)
 }
 
 void
-UlDciLteControlMessage::SetDci (UlDciListElement_s dci)
+UlDciLteControlMessage::SetDci (const UlDciListElement_s &dci)
 {
   m_dci = dci;
 
 }
 
 
-UlDciListElement_s
-UlDciLteControlMessage::GetDci (void)
+const UlDciListElement_s &
+UlDciLteControlMessage::GetDci (void) const
 {
   return m_dci;
 }
 
 
+void
+UlDciLteControlMessage::Recycle (void)
+{
+  LteControlMessagePool<UlDciLteControlMessage>::Put (this);
+}
+
+
 // ----------------------------------------------------------------------------------------------------------
 
 
@@ -127,20 +155,27 @@ DlCqiLteControlMessage::~DlCqiLteControlMessage (void)
 }
 
 void
-DlCqiLteControlMessage::SetDlCqi (CqiListElement_s dlcqi)
+DlCqiLteControlMessage::SetDlCqi (const CqiListElement_s &dlcqi)
 {
   m_dlCqi = dlcqi;
 
 }
 
 
-CqiListElement_s
-DlCqiLteControlMessage::GetDlCqi (void)
+const CqiListElement_s &
+DlCqiLteControlMessage::GetDlCqi (void) const
 {
   return m_dlCqi;
 }
 
 
+void
+DlCqiLteControlMessage::Recycle (void)
+{
+  LteControlMessagePool<DlCqiLteControlMessage>::Put (this);
+}
+
+
 
 // ----------------------------------------------------------------------------------------------------------
 
@@ -157,20 +192,27 @@ BsrLteControlMessage::~BsrLteControlMessage (void)
 }
 
 void
-BsrLteControlMessage::SetBsr (MacCeListElement_s bsr)
+BsrLteControlMessage::SetBsr (const MacCeListElement_s &bsr)
 {
   m_bsr = bsr;
 
 }
 
 
-MacCeListElement_s
-BsrLteControlMessage::GetBsr (void)
+const MacCeListElement_s &
+BsrLteControlMessage::GetBsr (void) const
 {
   return m_bsr;
 }
 
 
+void
+BsrLteControlMessage::Recycle (void)
+{
+  LteControlMessagePool<BsrLteControlMessage>::Put (this);
+}
+
+
 
 // ----------------------------------------------------------------------------------------------------------
 
@@ -296,18 +338,25 @@ DlHarqFeedbackLteControlMessage::~DlHarqFeedbackLteControlMessage (void)
 }
 
 void
-DlHarqFeedbackLteControlMessage::SetDlHarqFeedback (DlInfoListElement_s m)
+DlHarqFeedbackLteControlMessage::SetDlHarqFeedback (const DlInfoListElement_s &m)
 {
   m_dlInfoListElement = m;
 }
 
 
-DlInfoListElement_s
-DlHarqFeedbackLteControlMessage::GetDlHarqFeedback (void)
+const DlInfoListElement_s &
+DlHarqFeedbackLteControlMessage::GetDlHarqFeedback (void) const
 {
   return m_dlInfoListElement;
 }
 
 
+void
+DlHarqFeedbackLteControlMessage::Recycle (void)
+{
+  LteControlMessagePool<DlHarqFeedbackLteControlMessage>::Put (this);
+}
+
+
 } // namespace ns3
 
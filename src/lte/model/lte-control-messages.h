@@ -27,11 +27,26 @@
 #include <ns3/ff-mac-common.h>
 #include <ns3/lte-rrc-sap.h>
 #include <list>
+#include <vector>
 
 namespace ns3 {
 
 class LteNetDevice;
+class LteControlMessage;
 
+/**
+ * \ingroup lte
+ *
+ * The deleter of the control messages, which is called when their last
+ * reference is released and calls LteControlMessage::Recycle.
+ */
+struct LteControlMessageDeleter
+{
+  /**
+   * \param msg the control message which is no longer referenced
+   */
+  static void Delete (LteControlMessage *msg);
+};
 
 /**
  * \ingroup lte
@@ -40,7 +55,7 @@ class LteNetDevice;
  * control messages (such as PDCCH allocation map, CQI feedbacks)
  * that are exchanged among eNodeB and UEs.
  */
-class LteControlMessage : public SimpleRefCount<LteControlMessage>
+class LteControlMessage : public SimpleRefCount<LteControlMessage, empty, LteControlMessageDeleter>
 {
 public:
   /**
@@ -77,11 +92,152 @@ public:
    */
   MessageType GetMessageType (void);
 
+protected:
+  friend struct LteControlMessageDeleter;
+
+  /**
+   * \brief Dispose of the message once its last reference is released
+   *
+   * By default the message is deleted; the messages which are exchanged
+   * every subframe return to their LteControlMessagePool instead.
+   */
+  virtual void Recycle (void);
+
 private:
   MessageType m_type; ///< message type
 };
 
 
+// -----------------------------------------------------------------------
+
+/**
+ * \ingroup lte
+ *
+ * A pool of the control messages of type T. The DL-DCI, UL-DCI, DL-CQI,
+ * BSR and DL HARQ feedback messages, which are exchanged every subframe,
+ * are taken from their pool by the MAC and PHY, and return to it when
+ * their last reference is released. In steady state the control plane
+ * then neither allocates these messages nor the vectors of the FF MAC
+ * API structures that they carry, whose capacity is kept.
+ *
+ * A message taken from the pool keeps the content it had when it was
+ * released, which has to be overwritten before sending it.
+ */
+template <typename T>
+class LteControlMessagePool
+{
+public:
+  /**
+   * \return a message, recycled if the pool has one
+   */
+  static Ptr<T> Get (void);
+  /**
+   * \param msg a message which is no longer referenced
+   */
+  static void Put (T *msg);
+  /**
+   * \return the number of messages allocated by the pool
+   */
+  static uint64_t GetAllocations (void);
+  /**
+   * \return the number of messages taken from the pool
+   */
+  static uint64_t GetRequests (void);
+
+private:
+  LteControlMessagePool ();
+  ~LteControlMessagePool ();
+  /**
+   * \return the pool, or 0 once it has been destroyed at exit
+   */
+  static LteControlMessagePool<T> * Instance (void);
+
+  std::vector<T *> m_free; ///< the messages which are not referenced
+  uint64_t m_allocations; ///< number of messages allocated
+  uint64_t m_requests; ///< number of messages taken
+  static bool s_destroyed; ///< whether the pool has been destroyed at exit
+};
+
+template <typename T>
+bool LteControlMessagePool<T>::s_destroyed = false;
+
+template <typename T>
+LteControlMessagePool<T>::LteControlMessagePool ()
+  : m_allocations (0),
+    m_requests (0)
+{
+}
+
+template <typename T>
+LteControlMessagePool<T>::~LteControlMessagePool ()
+{
+  for (typename std::vector<T *>::iterator it = m_free.begin (); it != m_free.end (); ++it)
+    {
+      delete *it;
+    }
+  m_free.clear ();
+  s_destroyed = true;
+}
+
+template <typename T>
+LteControlMessagePool<T> *
+LteControlMessagePool<T>::Instance (void)
+{
+  static LteControlMessagePool<T> pool;
+  return s_destroyed ? 0 : &pool;
+}
+
+template <typename T>
+Ptr<T>
+LteControlMessagePool<T>::Get (void)
+{
+  LteControlMessagePool<T> *pool = Instance ();
+  if (pool == 0)
+    {
+      return Ptr<T> (new T (), false);
+    }
+  ++pool->m_requests;
+  if (pool->m_free.empty ())
+    {
+      ++pool->m_allocations;
+      return Ptr<T> (new T (), false);
+    }
+  T *msg = pool->m_free.back ();
+  pool->m_free.pop_back ();
+  // the reference count of a released message is zero
+  return Ptr<T> (msg, true);
+}
+
+template <typename T>
+void
+LteControlMessagePool<T>::Put (T *msg)
+{
+  LteControlMessagePool<T> *pool = Instance ();
+  if (pool == 0)
+    {
+      delete msg;
+      return;
+    }
+  pool->m_free.push_back (msg);
+}
+
+template <typename T>
+uint64_t
+LteControlMessagePool<T>::GetAllocations (void)
+{
+  LteControlMessagePool<T> *pool = Instance ();
+  return (pool == 0) ? 0 : pool->m_allocations;
+}
+
+template <typename T>
+uint64_t
+LteControlMessagePool<T>::GetRequests (void)
+{
+  LteControlMessagePool<T> *pool = Instance ();
+  return (pool == 0) ? 0 : pool->m_requests;
+}
+
+
 // -----------------------------------------------------------------------
 
 /**
@@ -99,15 +255,17 @@ public:
   * \brief add a DCI into the message
   * \param dci the dci
   */
-  void SetDci (DlDciListElement_s dci);
+  void SetDci (const DlDciListElement_s &dci);
 
   /**
   * \brief Get dic information
   * \return dci messages
   */
-  DlDciListElement_s GetDci (void);
+  const DlDciListElement_s & GetDci (void) const;
 
 private:
+  virtual void Recycle (void);
+
   DlDciListElement_s m_dci; ///< DCI
 };
 
@@ -129,15 +287,17 @@ public:
   * \brief add a DCI into the message
   * \param dci the dci
   */
-  void SetDci (UlDciListElement_s dci);
+  void SetDci (const UlDciListElement_s &dci);
 
   /**
   * \brief Get dic information
   * \return dci messages
   */
-  UlDciListElement_s GetDci (void);
+  const UlDciListElement_s & GetDci (void) const;
 
 private:
+  virtual void Recycle (void);
+
   UlDciListElement_s m_dci; ///< DCI
 };
 
@@ -159,15 +319,17 @@ public:
   * \brief add a DL-CQI feedback record into the message.
   * \param dlcqi the DL cqi feedback
   */
-  void SetDlCqi (CqiListElement_s dlcqi);
+  void SetDlCqi (const CqiListElement_s &dlcqi);
 
   /**
   * \brief Get DL cqi information
   * \return dlcqi messages
   */
-  CqiListElement_s GetDlCqi (void);
+  const CqiListElement_s & GetDlCqi (void) const;
 
 private:
+  virtual void Recycle (void);
+
   CqiListElement_s m_dlCqi; ///< DL CQI
 };
 
@@ -189,15 +351,17 @@ public:
   * \brief add a BSR feedback record into the message.
   * \param bsr the BSR feedback
   */
-  void SetBsr (MacCeListElement_s bsr);
+  void SetBsr (const MacCeListElement_s &bsr);
 
   /**
   * \brief Get BSR information
   * \return BSR message
   */
-  MacCeListElement_s GetBsr (void);
+  const MacCeListElement_s & GetBsr (void) const;
 
 private:
+  virtual void Recycle (void);
+
   MacCeListElement_s m_bsr; ///< BSR
 
 };
@@ -220,15 +384,17 @@ public:
   * \brief add a DL HARQ feedback record into the message.
   * \param m the DL HARQ feedback
   */
-  void SetDlHarqFeedback (DlInfoListElement_s m);
+  void SetDlHarqFeedback (const DlInfoListElement_s &m);
 
   /**
   * \brief Get DL HARQ information
   * \return DL HARQ message
   */
-  DlInfoListElement_s GetDlHarqFeedback (void);
+  const DlInfoListElement_s & GetDlHarqFeedback (void) const;
 
 private:
+  virtual void Recycle (void);
+
   DlInfoListElement_s m_dlInfoListElement; ///< DL info list element
 
 };
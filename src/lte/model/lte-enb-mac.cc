@@ -692,7 +692,7 @@ LteEnbMac::ReceiveDlCqiLteControlMessage  (Ptr<DlCqiLteControlMessage> msg)
 {
   NS_LOG_FUNCTION (this << msg);
 
-  CqiListElement_s dlcqi = msg->GetDlCqi ();
+  const CqiListElement_s &dlcqi = msg->GetDlCqi ();
   NS_LOG_LOGIC (this << "Enb Received DL-CQI rnti" << dlcqi.m_rnti);
   NS_ASSERT (dlcqi.m_rnti != 0);
   m_dlCqiReceived.push_back (dlcqi);
@@ -1086,7 +1086,7 @@ LteEnbMac::DoSchedDlConfigInd (FfMacSchedSapUser::SchedDlConfigIndParameters ind
             }
         }
       // send the relative DCI
-      Ptr<DlDciLteControlMessage> msg = Create<DlDciLteControlMessage> ();
+      Ptr<DlDciLteControlMessage> msg = LteControlMessagePool<DlDciLteControlMessage>::Get ();
       msg->SetDci (ind.m_buildDataList.at (i).m_dci);
       m_enbPhySapProvider->SendLteControlMessage (msg);
     }
@@ -1171,7 +1171,7 @@ LteEnbMac::DoSchedUlConfigInd (FfMacSchedSapUser::SchedUlConfigIndParameters ind
   for (unsigned int i = 0; i < ind.m_dciList.size (); i++)
     {
       // send the correspondent ul dci
-      Ptr<UlDciLteControlMessage> msg = Create<UlDciLteControlMessage> ();
+      Ptr<UlDciLteControlMessage> msg = LteControlMessagePool<UlDciLteControlMessage>::Get ();
       msg->SetDci (ind.m_dciList.at (i));
       m_enbPhySapProvider->SendLteControlMessage (msg);
     }
@@ -26,6 +26,7 @@
 #include <ns3/simulator.h>
 #include <ns3/attribute-accessor-helper.h>
 #include <ns3/double.h>
+#include <ns3/boolean.h>
 
 
 #include "lte-enb-phy.h"
@@ -158,6 +159,8 @@ LteEnbPhy::LteEnbPhy (Ptr<LteSpectrumPhy> dlPhy, Ptr<LteSpectrumPhy> ulPhy)
     m_enbCphySapUser (0),
     m_nrFrames (0),
     m_nrSubFrames (0),
+    m_idleSubframeSkipping (false),
+    m_skipFrom (0),
     m_srsPeriodicity (0),
     m_srsStartTime (Seconds (0)),
     m_currentSrsOffset (0),
@@ -207,6 +210,17 @@ LteEnbPhy::GetTypeId (void)
                    MakeUintegerAccessor (&LteEnbPhy::SetMacChDelay, 
                                          &LteEnbPhy::GetMacChDelay),
                    MakeUintegerChecker<uint8_t> ())
+    .AddAttribute ("IdleSubframeSkipping",
+                   "If true, the subframes in which the eNB is idle, i.e., no UE "
+                   "is attached and nothing is queued for transmission, are "
+                   "not processed, except the subframes 1 and 6 which carry "
+                   "the PSS, the MIB and the SIB1. The eNB resumes processing "
+                   "every subframe as soon as it receives a RACH preamble or a "
+                   "UE is added. The idle cells then do not transmit the DL "
+                   "control region in the skipped subframes.",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&LteEnbPhy::m_idleSubframeSkipping),
+                   MakeBooleanChecker ())
     .AddTraceSource ("ReportUeSinr",
                      "Report UEs' averaged linear SINR",
                      MakeTraceSourceAccessor (&LteEnbPhy::m_reportUeSinr),
@@ -360,7 +374,7 @@ LteEnbPhy::SetMacChDelay (uint8_t delay)
     {
       Ptr<PacketBurst> pb = CreateObject <PacketBurst> ();
       m_packetBurstQueue.push_back (pb);
-      std::list<Ptr<LteControlMessage> > l;
+      std::vector<Ptr<LteControlMessage> > l;
       m_controlMessagesQueue.push_back (l);
       std::list<UlDciLteControlMessage> l1;
       m_ulDciQueue.push_back (l1);
@@ -433,6 +447,7 @@ LteEnbPhy::DoSendMacPdu (Ptr<Packet> p)
 {
   NS_LOG_FUNCTION (this);
   SetMacPdu (p);
+  WakeUp ();
 }
 
 uint8_t
@@ -523,6 +538,7 @@ LteEnbPhy::DoSendLteControlMessage (Ptr<LteControlMessage> msg)
   NS_LOG_FUNCTION (this << msg);
   // queues the message (wait for MAC-PHY delay)
   SetControlMessages (msg);
+  WakeUp ();
 }
 
 
@@ -536,10 +552,11 @@ LteEnbPhy::ReceiveLteControlMessage (Ptr<LteControlMessage> msg)
 }
 
 void
-LteEnbPhy::ReceiveLteControlMessageList (std::list<Ptr<LteControlMessage> > msgList)
+LteEnbPhy::ReceiveLteControlMessageList (std::vector<Ptr<LteControlMessage> > msgList)
 {
   NS_LOG_FUNCTION (this);
-  std::list<Ptr<LteControlMessage> >::iterator it;
+  WakeUp ();
+  std::vector<Ptr<LteControlMessage> >::iterator it;
   for (it = msgList.begin (); it != msgList.end (); it++)
     {
       switch ((*it)->GetMessageType ())
@@ -553,7 +570,7 @@ LteEnbPhy::ReceiveLteControlMessageList (std::list<Ptr<LteControlMessage> > msgL
         case LteControlMessage::DL_CQI:
           {
             Ptr<DlCqiLteControlMessage> dlcqiMsg = DynamicCast<DlCqiLteControlMessage> (*it);
-            CqiListElement_s dlcqi = dlcqiMsg->GetDlCqi ();
+            const CqiListElement_s &dlcqi = dlcqiMsg->GetDlCqi ();
             // check whether the UE is connected
             if (m_ueAttached.find (dlcqi.m_rnti) != m_ueAttached.end ())
               {
@@ -564,7 +581,7 @@ LteEnbPhy::ReceiveLteControlMessageList (std::list<Ptr<LteControlMessage> > msgL
         case LteControlMessage::BSR:
           {
             Ptr<BsrLteControlMessage> bsrMsg = DynamicCast<BsrLteControlMessage> (*it);
-            MacCeListElement_s bsr = bsrMsg->GetBsr ();
+            const MacCeListElement_s &bsr = bsrMsg->GetBsr ();
             // check whether the UE is connected
             if (m_ueAttached.find (bsr.m_rnti) != m_ueAttached.end ())
               {
@@ -575,7 +592,7 @@ LteEnbPhy::ReceiveLteControlMessageList (std::list<Ptr<LteControlMessage> > msgL
         case LteControlMessage::DL_HARQ:
           {
             Ptr<DlHarqFeedbackLteControlMessage> dlharqMsg = DynamicCast<DlHarqFeedbackLteControlMessage> (*it);
-            DlInfoListElement_s dlharq = dlharqMsg->GetDlHarqFeedback ();
+            const DlInfoListElement_s &dlharq = dlharqMsg->GetDlHarqFeedback ();
             // check whether the UE is connected
             if (m_ueAttached.find (dlharq.m_rnti) != m_ueAttached.end ())
               {
@@ -677,12 +694,12 @@ LteEnbPhy::StartSubFrame (void)
     }
 
   // process the current burst of control messages
-  std::list<Ptr<LteControlMessage> > ctrlMsg = GetControlMessages ();
+  std::vector<Ptr<LteControlMessage> > ctrlMsg = GetControlMessages ();
   m_dlDataRbMap.clear ();
   m_dlPowerAllocationMap.clear ();
   if (ctrlMsg.size () > 0)
     {
-      std::list<Ptr<LteControlMessage> >::iterator it;
+      std::vector<Ptr<LteControlMessage> >::iterator it;
       it = ctrlMsg.begin ();
       while (it != ctrlMsg.end ())
         {
@@ -782,7 +799,7 @@ LteEnbPhy::StartSubFrame (void)
 }
 
 void
-LteEnbPhy::SendControlChannels (std::list<Ptr<LteControlMessage> > ctrlMsgList)
+LteEnbPhy::SendControlChannels (const std::vector<Ptr<LteControlMessage> > &ctrlMsgList)
 {
   NS_LOG_FUNCTION (this << " eNB " << m_cellId << " start tx ctrl frame");
   // set the current tx power spectral density (full bandwidth)
@@ -809,8 +826,7 @@ LteEnbPhy::SendDataChannels (Ptr<PacketBurst> pb)
   SetDownlinkSubChannelsWithPowerAllocation (m_dlDataRbMap);
   // send the current burts of packets
   NS_LOG_LOGIC (this << " eNB start TX DATA");
-  std::list<Ptr<LteControlMessage> > ctrlMsgList;
-  ctrlMsgList.clear ();
+  std::vector<Ptr<LteControlMessage> > ctrlMsgList;
   m_downlinkSpectrumPhy->StartTxDataFrame (pb, ctrlMsgList, DL_DATA_DURATION);
 }
 
@@ -819,6 +835,11 @@ void
 LteEnbPhy::EndSubFrame (void)
 {
   NS_LOG_FUNCTION (this << Simulator::Now ().GetSeconds ());
+  if (m_idleSubframeSkipping && IsIdle ())
+    {
+      SkipIdleSubframes ();
+      return;
+    }
   if (m_nrSubFrames == 10)
     {
       Simulator::ScheduleNow (&LteEnbPhy::EndFrame, this);
@@ -838,6 +859,89 @@ LteEnbPhy::EndFrame (void)
 }
 
 
+bool
+LteEnbPhy::IsIdle (void) const
+{
+  if (!m_ueAttached.empty ())
+    {
+      return false;
+    }
+  for (std::vector< std::vector<Ptr<LteControlMessage> > >::const_iterator it = m_controlMessagesQueue.begin ();
+       it != m_controlMessagesQueue.end (); ++it)
+    {
+      if (!it->empty ())
+        {
+          return false;
+        }
+    }
+  for (std::vector< Ptr<PacketBurst> >::const_iterator it = m_packetBurstQueue.begin ();
+       it != m_packetBurstQueue.end (); ++it)
+    {
+      if ((*it)->GetSize () > 0)
+        {
+          return false;
+        }
+    }
+  for (std::vector< std::list<UlDciLteControlMessage> >::const_iterator it = m_ulDciQueue.begin ();
+       it != m_ulDciQueue.end (); ++it)
+    {
+      if (!it->empty ())
+        {
+          return false;
+        }
+    }
+  return true;
+}
+
+
+void
+LteEnbPhy::SkipIdleSubframes (void)
+{
+  NS_LOG_FUNCTION (this << m_nrFrames << m_nrSubFrames);
+  // the PSS is sent in the subframes 1 and 6, and the UEs measure the RSRP
+  // and RSRQ on it, hence these subframes are never skipped
+  m_skipStart = Simulator::Now ();
+  m_skipFrom = m_nrSubFrames;
+  Time tti = Seconds (GetTti ());
+  if (m_nrSubFrames < 6)
+    {
+      m_skipEvent = Simulator::Schedule (tti * (5 - m_nrSubFrames), &LteEnbPhy::StartSubFrame, this);
+      m_nrSubFrames = 5;
+    }
+  else
+    {
+      m_skipEvent = Simulator::Schedule (tti * (10 - m_nrSubFrames), &LteEnbPhy::StartFrame, this);
+      m_nrSubFrames = 10;
+    }
+}
+
+
+void
+LteEnbPhy::WakeUp (void)
+{
+  if (!m_skipEvent.IsRunning ())
+    {
+      return;
+    }
+  // find the first subframe boundary not earlier than now
+  int64_t tti = Seconds (GetTti ()).GetTimeStep ();
+  int64_t elapsed = (Simulator::Now () - m_skipStart).GetTimeStep ();
+  int64_t skipped = (elapsed + tti - 1) / tti;
+  uint32_t subframe = m_skipFrom + 1 + skipped;
+  uint32_t lastSubframe = (m_skipFrom < 6) ? 6 : 11;
+  if (subframe >= lastSubframe)
+    {
+      // the skipped subframes end there anyway
+      return;
+    }
+  NS_LOG_FUNCTION (this << m_nrFrames << subframe);
+  m_skipEvent.Cancel ();
+  m_nrSubFrames = subframe - 1;
+  m_skipEvent = Simulator::Schedule (m_skipStart + TimeStep (skipped * tti) - Simulator::Now (),
+                                     &LteEnbPhy::StartSubFrame, this);
+}
+
+
 void 
 LteEnbPhy::GenerateCtrlCqiReport (const SpectrumValue& sinr)
 {
@@ -940,6 +1044,7 @@ LteEnbPhy::DoAddUe (uint16_t rnti)
  
   bool success = AddUePhy (rnti);
   NS_ASSERT_MSG (success, "AddUePhy() failed");
+  WakeUp ();
 
   // add default P_A value
   DoSetPa (rnti, 0);
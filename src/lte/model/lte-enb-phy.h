@@ -28,6 +28,7 @@
 #include <ns3/lte-enb-cphy-sap.h>
 #include <ns3/lte-phy.h>
 #include <ns3/lte-harq-phy.h>
+#include <ns3/event-id.h>
 
 #include <map>
 #include <set>
@@ -230,7 +231,7 @@ public:
   * \brief Send the PDCCH and PCFICH in the first 3 symbols
   * \param ctrlMsgList the list of control messages of PDCCH
   */
-  void SendControlChannels (std::list<Ptr<LteControlMessage> > ctrlMsgList);
+  void SendControlChannels (const std::vector<Ptr<LteControlMessage> > &ctrlMsgList);
 
   /**
   * \brief Send the PDSCH
@@ -265,6 +266,30 @@ public:
    * \brief End a LTE frame
    */
   void EndFrame (void);
+  /**
+   * \brief Check whether the eNB has no work in the next subframes
+   *
+   * The eNB is idle if no UE is attached, and if no control message, MAC
+   * PDU or UL DCI is queued.
+   *
+   * \return true if the eNB is idle
+   */
+  bool IsIdle (void) const;
+  /**
+   * \brief Skip the idle subframes up to the next subframe carrying the PSS
+   *
+   * Called at the end of a subframe, instead of starting the next one,
+   * when the IdleSubframeSkipping attribute is set and the eNB is idle.
+   */
+  void SkipIdleSubframes (void);
+  /**
+   * \brief Stop skipping the idle subframes
+   *
+   * Called when new work arrives: the subframes are processed again from
+   * the next subframe boundary.  The frame and subframe numbers are the
+   * same as if no subframe was skipped.
+   */
+  void WakeUp (void);
 
   /**
    * \brief PhySpectrum received a new PHY-PDU
@@ -275,7 +300,7 @@ public:
   /**
    * \brief PhySpectrum received a new list of LteControlMessage
    */
-  virtual void ReceiveLteControlMessageList (std::list<Ptr<LteControlMessage> >);
+  virtual void ReceiveLteControlMessageList (std::vector<Ptr<LteControlMessage> >);
 
   // inherited from LtePhy
   virtual void GenerateCtrlCqiReport (const SpectrumValue& sinr);
@@ -462,6 +487,15 @@ private:
    */
   uint32_t m_nrSubFrames;
 
+  /**
+   * The `IdleSubframeSkipping` attribute. If true, the subframes in which
+   * the eNB is idle are not processed, except those carrying the PSS.
+   */
+  bool m_idleSubframeSkipping;
+  EventId m_skipEvent; ///< the event which ends the skipped subframes
+  Time m_skipStart; ///< start time of the first skipped subframe
+  uint32_t m_skipFrom; ///< the last subframe processed before the skipped subframes
+
   uint16_t m_srsPeriodicity; ///< SRS periodicity
   Time m_srsStartTime; ///< SRS start time
   std::map <uint16_t,uint16_t> m_srsCounter; ///< SRS counter
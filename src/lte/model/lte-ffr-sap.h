@@ -24,6 +24,7 @@
 
 #include <ns3/lte-rrc-sap.h>
 #include <ns3/ff-mac-sched-sap.h>
+#include <ns3/rnti-map.h>
 #include <map>
 
 namespace ns3 {
@@ -111,7 +112,7 @@ public:
    * \brief ReportUlCqiInfo
    * \param ulCqiMap the UL CQI map
    */
-  virtual void ReportUlCqiInfo ( std::map <uint16_t, std::vector <double> > ulCqiMap ) = 0;
+  virtual void ReportUlCqiInfo (const RntiMap <std::vector <double> > &ulCqiMap) = 0;
 
   /**
    * \brief GetTpc
@@ -166,7 +167,7 @@ public:
   virtual bool IsUlRbgAvailableForUe (int i, uint16_t rnti);
   virtual void ReportDlCqiInfo (const struct FfMacSchedSapProvider::SchedDlCqiInfoReqParameters& params);
   virtual void ReportUlCqiInfo (const struct FfMacSchedSapProvider::SchedUlCqiInfoReqParameters& params);
-  virtual void ReportUlCqiInfo ( std::map <uint16_t, std::vector <double> > ulCqiMap );
+  virtual void ReportUlCqiInfo (const RntiMap <std::vector <double> > &ulCqiMap);
   virtual uint8_t GetTpc (uint16_t rnti);
   virtual uint8_t GetMinContinuousUlBandwidth ();
 private:
@@ -227,7 +228,7 @@ MemberLteFfrSapProvider<C>::ReportUlCqiInfo (const struct FfMacSchedSapProvider:
 
 template <class C>
 void
-MemberLteFfrSapProvider<C>::ReportUlCqiInfo ( std::map <uint16_t, std::vector <double> > ulCqiMap )
+MemberLteFfrSapProvider<C>::ReportUlCqiInfo (const RntiMap <std::vector <double> > &ulCqiMap)
 {
   m_owner->DoReportUlCqiInfo (ulCqiMap);
 }
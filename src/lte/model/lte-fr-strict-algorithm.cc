@@ -456,7 +456,7 @@ LteFrStrictAlgorithm::DoReportUlCqiInfo (const struct FfMacSchedSapProvider::Sch
 }
 
 void
-LteFrStrictAlgorithm::DoReportUlCqiInfo (std::map <uint16_t, std::vector <double> > ulCqiMap)
+LteFrStrictAlgorithm::DoReportUlCqiInfo (const RntiMap <std::vector <double> > &ulCqiMap)
 {
   NS_LOG_FUNCTION (this);
   NS_LOG_WARN ("Method should not be called, because it is empty");
@@ -53,6 +53,8 @@ LteInterference::DoDispose ()
   m_rxSignal = 0;
   m_allSignals = 0;
   m_noise = 0;
+  m_interf = 0;
+  m_sinr = 0;
   Object::DoDispose ();
 } 
 
@@ -75,7 +77,15 @@ LteInterference::StartRx (Ptr<const SpectrumValue> rxPsd)
   if (m_receiving == false)
     {
       NS_LOG_LOGIC ("first signal");
-      m_rxSignal = rxPsd->Copy ();
+      if ((m_rxSignal != 0) && (m_rxSignal->GetSpectrumModel () == rxPsd->GetSpectrumModel ()))
+        {
+          // reuse the buffer of the previous RX
+          *m_rxSignal = *rxPsd;
+        }
+      else
+        {
+          m_rxSignal = rxPsd->Copy ();
+        }
       m_lastChangeTime = Now ();
       m_receiving = true;
       for (std::list<Ptr<LteChunkProcessor> >::const_iterator it = m_rsPowerChunkProcessorList.begin (); it != m_rsPowerChunkProcessorList.end (); ++it)
@@ -188,17 +198,31 @@ LteInterference::ConditionallyEvaluateChunk ()
     {
       NS_LOG_LOGIC (this << " signal = " << *m_rxSignal << " allSignals = " << *m_allSignals << " noise = " << *m_noise);
 
-      SpectrumValue interf =  (*m_allSignals) - (*m_rxSignal) + (*m_noise);
+      NS_ASSERT (m_rxSignal->GetSpectrumModel ()->GetNumBands () == m_interf->GetSpectrumModel ()->GetNumBands ());
+      NS_ASSERT (m_noise->GetSpectrumModel ()->GetNumBands () == m_interf->GetSpectrumModel ()->GetNumBands ());
+      Values::const_iterator rx = m_rxSignal->ConstValuesBegin ();
+      Values::const_iterator all = m_allSignals->ConstValuesBegin ();
+      Values::const_iterator noise = m_noise->ConstValuesBegin ();
+      Values::iterator sinr = m_sinr->ValuesBegin ();
+      Values::iterator end = m_interf->ValuesEnd ();
+      for (Values::iterator interf = m_interf->ValuesBegin (); interf != end; ++interf)
+        {
+          *interf = (*all - *rx) + *noise;
+          *sinr = *rx / *interf;
+          ++rx;
+          ++all;
+          ++noise;
+          ++sinr;
+        }
 
-      SpectrumValue sinr = (*m_rxSignal) / interf;
       Time duration = Now () - m_lastChangeTime;
       for (std::list<Ptr<LteChunkProcessor> >::const_iterator it = m_sinrChunkProcessorList.begin (); it != m_sinrChunkProcessorList.end (); ++it)
         {
-          (*it)->EvaluateChunk (sinr, duration);
+          (*it)->EvaluateChunk (*m_sinr, duration);
         }
       for (std::list<Ptr<LteChunkProcessor> >::const_iterator it = m_interfChunkProcessorList.begin (); it != m_interfChunkProcessorList.end (); ++it)
         {
-          (*it)->EvaluateChunk (interf, duration);
+          (*it)->EvaluateChunk (*m_interf, duration);
         }
       for (std::list<Ptr<LteChunkProcessor> >::const_iterator it = m_rsPowerChunkProcessorList.begin (); it != m_rsPowerChunkProcessorList.end (); ++it)
         {
@@ -217,6 +241,8 @@ LteInterference::SetNoisePowerSpectralDensity (Ptr<const SpectrumValue> noisePsd
   // reset m_allSignals (will reset if already set previously)
   // this is needed since this method can potentially change the SpectrumModel
   m_allSignals = Create<SpectrumValue> (noisePsd->GetSpectrumModel ());
+  m_interf = Create<SpectrumValue> (noisePsd->GetSpectrumModel ());
+  m_sinr = Create<SpectrumValue> (noisePsd->GetSpectrumModel ());
   if (m_receiving == true)
     {
       // abort rx
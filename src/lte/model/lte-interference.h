@@ -120,6 +120,10 @@ public:
 private:
   /**
    * Considitionally evaluate chunk
+   *
+   * The interference plus noise and the SINR of each RB are computed in a
+   * single pass into m_interf and m_sinr, which are allocated with
+   * m_allSignals, and then passed to the chunk processors.
    */
   void ConditionallyEvaluateChunk ();
   /**
@@ -152,6 +156,9 @@ private:
 
   Ptr<const SpectrumValue> m_noise; ///< the noise value
 
+  Ptr<SpectrumValue> m_interf; ///< the interference plus noise of the last chunk
+  Ptr<SpectrumValue> m_sinr; ///< the SINR of the last chunk
+
   Time m_lastChangeTime;     /**< the time of the last change in
                                 m_TotalPower */
 
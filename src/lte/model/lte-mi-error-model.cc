@@ -35,6 +35,7 @@
 #include <ns3/pointer.h>
 #include <stdint.h>
 #include <cmath>
+#include <algorithm>
 #include "stdlib.h"
 #include <ns3/lte-mi-error-model.h>
 
@@ -331,133 +332,321 @@ static const double cEcrTable [9][38] = {
 };
 
 
-double 
-LteMiErrorModel::Mib (const SpectrumValue& sinr, const std::vector<int>& map, uint8_t mcs)
+/// MiMap structure: the MI table of a modulation
+struct MiMap
 {
-  NS_LOG_FUNCTION (sinr << &map << (uint32_t) mcs);
-  
-  double MI;
-  double MIsum = 0.0;
-  SpectrumValue sinrCopy = sinr;
-  
-  for (uint32_t i = 0; i < map.size (); i++)
+  const double *mi; ///< the MI values
+  const double *axis; ///< the uniformly spaced SINR values (linear) of the MI values
+  uint16_t size; ///< the number of values
+  /**
+   * The scaling coefficient of the index of a SINR value. Since the values of
+   * the axis are uniformly spaced, we have
+   * index = ((sinrLin - value[0]) / (value[SIZE-1] - value[0])) * (SIZE-1)
+   */
+  double scalingCoeff;
+};
+
+/// the MI tables of QPSK, 16QAM and 64QAM
+static const MiMap MiMaps[3] = {
+  { MI_map_qpsk, MI_map_qpsk_axis, MI_MAP_QPSK_SIZE,
+    (MI_MAP_QPSK_SIZE - 1) / (MI_map_qpsk_axis[MI_MAP_QPSK_SIZE-1] - MI_map_qpsk_axis[0]) },
+  { MI_map_16qam, MI_map_16qam_axis, MI_MAP_16QAM_SIZE,
+    (MI_MAP_16QAM_SIZE - 1) / (MI_map_16qam_axis[MI_MAP_16QAM_SIZE-1] - MI_map_16qam_axis[0]) },
+  { MI_map_64qam, MI_map_64qam_axis, MI_MAP_64QAM_SIZE,
+    (MI_MAP_64QAM_SIZE - 1) / (MI_map_64qam_axis[MI_MAP_64QAM_SIZE-1] - MI_map_64qam_axis[0]) }
+};
+
+/**
+ * \param mcs the MCS
+ * \return the index in MiMaps of the modulation of the MCS
+ */
+static inline uint8_t
+GetMiMapIndex (uint8_t mcs)
+{
+  if (mcs <= MI_QPSK_MAX_ID)
     {
-      double sinrLin = sinrCopy[map.at (i)];
-      if (mcs <= MI_QPSK_MAX_ID) // QPSK
-        {
+      return 0;
+    }
+  else if (mcs <= MI_16QAM_MAX_ID)
+    {
+      return 1;
+    }
+  return 2;
+}
 
-          if (sinrLin > MI_map_qpsk_axis[MI_MAP_QPSK_SIZE-1])
+/**
+ * \param miMap the MI table of the modulation
+ * \param sinrLin the SINR (linear)
+ * \return the MI
+ */
+static inline double
+GetMi (const MiMap &miMap, double sinrLin)
+{
+  if (sinrLin > miMap.axis[miMap.size - 1])
+    {
+      return 1;
+    }
+  double sinrIndexDouble = (sinrLin - miMap.axis[0]) * miMap.scalingCoeff + 1;
+  uint32_t sinrIndex = std::max (0.0, std::floor (sinrIndexDouble));
+  NS_ASSERT_MSG (sinrIndex < miMap.size, "MI map out of data");
+  return miMap.mi[sinrIndex];
+}
+
+/**
+ * \param cbSize the size of the CB
+ * \return the index in cbMiSizeTable of the BLER curves of the CB
+ */
+static int
+GetCbMiSizeIndex (uint16_t cbSize)
+{
+  int cbIndex = 1;
+  while ((cbIndex < 9)&&(cbMiSizeTable[cbIndex]<= cbSize))
+    {
+      cbIndex++;
+    }
+  cbIndex--;
+  return cbIndex;
+}
+
+/// BlerCurveParams structure: the parameters of the BLER curves of bEcrTable and cEcrTable
+struct BlerCurveParams
+{
+  BlerCurveParams ()
+  {
+    for (int cbIndex = 0; cbIndex < 9; cbIndex++)
+      {
+        for (int ecrId = 0; ecrId <= MI_64QAM_BLER_MAX_ID; ecrId++)
+          {
+            b[cbIndex][ecrId] = Get (bEcrTable, cbIndex, ecrId);
+            c[cbIndex][ecrId] = Get (cEcrTable, cbIndex, ecrId);
+          }
+      }
+  }
+  /**
+   * \param table bEcrTable or cEcrTable
+   * \param cbIndex the index of the CB size
+   * \param ecrId the ECR ID
+   * \return the parameter of the curve, or of the curve of the lowest CB
+   * size including this CB if there is no curve for this CB size, for
+   * removing CB size quantization errors
+   */
+  static double Get (const double table[9][38], int cbIndex, int ecrId)
+  {
+    double value = table[cbIndex][ecrId];
+    int i = cbIndex;
+    while ((i<9)&&(value<0))
+      {
+        value = table[i++][ecrId];
+      }
+    return value;
+  }
+  double b[9][38]; ///< the b parameters of the curves
+  double c[9][38]; ///< the c parameters of the curves
+};
+
+/**
+ * \param mib mean mutual information per bit of a code-block
+ * \param ecrId Effective Code Rate ID
+ * \param cbIndex the index of the CB size in cbMiSizeTable
+ * \return the code block error rate
+ */
+static double
+GetCbBler (double mib, uint8_t ecrId, int cbIndex)
+{
+  static const BlerCurveParams params;
+  NS_ASSERT_MSG (ecrId <= MI_64QAM_BLER_MAX_ID, "ECR out of range [0..37]: " << (uint16_t) ecrId);
+  double b = params.b[cbIndex][ecrId];
+  double c = params.c[cbIndex][ecrId];
+  // see IEEE802.16m EMD formula 55 of section 4.3.2.1
+  double bler = 0.5*( 1 - erf((mib-b)/(sqrt(2)*c)) );
+  NS_LOG_LOGIC ("MIB: " << mib << " BLER:" << bler << " b:" << b << " c:" << c);
+  return bler;
+}
+
+/// CbSegmentation structure: the code block segmentation of a TB
+struct CbSegmentation
+{
+  uint32_t C; ///< no. of codeblocks, 0 if not computed yet
+  uint32_t Cplus; ///< no. of codeblocks with size K+
+  uint32_t Kplus; ///< size K+
+  uint32_t Cminus; ///< no. of codeblocks with size K-
+  uint32_t Kminus; ///< size K-
+  int cbIndexPlus; ///< the index of K+ in cbMiSizeTable
+  int cbIndexMinus; ///< the index of K- in cbMiSizeTable
+};
+
+/**
+ * Estimate the CB size (according to sec 5.1.2 of TS 36.212)
+ * \param size the size in bytes of the TB
+ * \param seg the segmentation
+ */
+static void
+ComputeCbSegmentation (uint16_t size, CbSegmentation &seg)
+{
+  uint16_t Z = 6144; // max size of a codeblock (including CRC)
+  uint32_t B = size * 8;
+  uint32_t C = 0; // no. of codeblocks
+  uint32_t Cplus = 0; // no. of codeblocks with size K+
+  uint32_t Kplus = 0; // no. of codeblocks with size K+
+  uint32_t Cminus = 0; // no. of codeblocks with size K+
+  uint32_t Kminus = 0; // no. of codeblocks with size K+
+  uint32_t B1 = 0;
+  uint32_t deltaK = 0;
+  if (B <= Z)
+    {
+      // only one codeblock
+      //L = 0;
+      C = 1;
+      B1 = B;
+    }
+  else
+    {
+      uint32_t L = 24;
+      C = ceil ((double)B / ((double)(Z-L)));
+      B1 = B + C * L;
+    }
+  // first segmentation: K+ = minimum K in table such that C * K >= B1
+  // implement a modified binary search
+  int min = 0;
+  int max = 187;
+  int mid = 0;
+  do
+    {
+      mid = (min+max) / 2;
+      if (B1 > cbSizeTable[mid]*C)
+        {
+          if (B1 < cbSizeTable[mid+1]*C)
             {
-              MI = 1;
+              break;
             }
-          else 
-            { 
-              // since the values in MI_map_qpsk_axis are uniformly spaced, we have
-              // index = ((sinrLin - value[0]) / (value[SIZE-1] - value[0])) * (SIZE-1)
-              // the scaling coefficient is always the same, so we use a static const
-              // to speed up the calculation
-              static const double scalingCoeffQpsk = 
-                (MI_MAP_QPSK_SIZE - 1) / (MI_map_qpsk_axis[MI_MAP_QPSK_SIZE-1] - MI_map_qpsk_axis[0]);
-              double sinrIndexDouble = (sinrLin -  MI_map_qpsk_axis[0]) * scalingCoeffQpsk + 1;
-              uint32_t sinrIndex = std::max(0.0, std::floor (sinrIndexDouble));
-              NS_ASSERT_MSG (sinrIndex < MI_MAP_QPSK_SIZE, "MI map out of data");
-              MI = MI_map_qpsk[sinrIndex];
+          else
+            {
+              min = mid + 1;
             }
         }
       else
         {
-          if (mcs > MI_QPSK_MAX_ID && mcs <= MI_16QAM_MAX_ID )	// 16-QAM
+          if (B1 > cbSizeTable[mid-1]*C)
             {
-              if (sinrLin > MI_map_16qam_axis[MI_MAP_16QAM_SIZE-1])
-                {
-                  MI = 1;
-                }
-              else 
-                {
-                  // since the values in MI_map_16QAM_axis are uniformly spaced, we have
-                  // index = ((sinrLin - value[0]) / (value[SIZE-1] - value[0])) * (SIZE-1)
-                  // the scaling coefficient is always the same, so we use a static const
-                  // to speed up the calculation
-                  static const double scalingCoeff16qam = 
-                    (MI_MAP_16QAM_SIZE - 1) / (MI_map_16qam_axis[MI_MAP_16QAM_SIZE-1] - MI_map_16qam_axis[0]);
-                  double sinrIndexDouble = (sinrLin -  MI_map_16qam_axis[0]) * scalingCoeff16qam + 1;
-                  uint32_t sinrIndex = std::max(0.0, std::floor (sinrIndexDouble));
-                  NS_ASSERT_MSG (sinrIndex < MI_MAP_16QAM_SIZE, "MI map out of data");
-                  MI = MI_map_16qam[sinrIndex];
-                }
+              break;
             }
-          else // 64-QAM
+          else
             {
-              if (sinrLin > MI_map_64qam_axis[MI_MAP_64QAM_SIZE-1])
-                {
-                  MI = 1;
-                }
-              else
-                {
-                  // since the values in MI_map_64QAM_axis are uniformly spaced, we have
-                  // index = ((sinrLin - value[0]) / (value[SIZE-1] - value[0])) * (SIZE-1)
-                  // the scaling coefficient is always the same, so we use a static const
-                  // to speed up the calculation
-                  static const double scalingCoeff64qam = 
-                    (MI_MAP_64QAM_SIZE - 1) / (MI_map_64qam_axis[MI_MAP_64QAM_SIZE-1] - MI_map_64qam_axis[0]);
-                  double sinrIndexDouble = (sinrLin -  MI_map_64qam_axis[0]) * scalingCoeff64qam + 1;
-                  uint32_t sinrIndex = std::max(0.0, std::floor (sinrIndexDouble));
-                  NS_ASSERT_MSG (sinrIndex < MI_MAP_64QAM_SIZE, "MI map out of data");
-                  MI = MI_map_64qam[sinrIndex];
-                }
+              max = mid - 1;
             }
         }
-      NS_LOG_LOGIC (" RB " << map.at (i) << "Minimum SNR = " << 10 * std::log10 (sinrLin) << " dB, " << sinrLin << " V, MCS = " << (uint16_t)mcs << ", MI = " << MI);
-      MIsum += MI;
+  } while ((cbSizeTable[mid]*C != B1) && (min < max));
+  // adjust binary search to the largest integer value of K containing B1
+  if (B1 > cbSizeTable[mid]*C)
+    {
+      mid ++;
     }
-  MI = MIsum / map.size ();
-  NS_LOG_LOGIC (" MI = " << MI);
-  return MI;
+
+  uint16_t KplusId = mid;
+  Kplus = cbSizeTable[mid];
+
+
+  if (C==1)
+    {
+      Cplus = 1;
+      Cminus = 0;
+      Kminus = 0;
+    }
+  else
+    {
+      // second segmentation size: K- = maximum K in table such that K < K+
+      // -fstrict-overflow sensitive, see bug 1868
+      Kminus = cbSizeTable[ KplusId > 1 ? KplusId - 1 : 0];
+      deltaK = Kplus - Kminus;
+      Cminus = floor ((((double) C * Kplus) - (double)B1) / (double)deltaK);
+      Cplus = C - Cminus;
+    }
+  NS_LOG_INFO ("--------------------LteMiErrorModel: TB size of " << B << " needs of " << B1 << " bits reparted in " << C << " CBs as "<< Cplus << " block(s) of " << Kplus << " and " << Cminus << " of " << Kminus);
+  seg.C = C;
+  seg.Cplus = Cplus;
+  seg.Kplus = Kplus;
+  seg.Cminus = Cminus;
+  seg.Kminus = Kminus;
+  seg.cbIndexPlus = GetCbMiSizeIndex (Kplus);
+  seg.cbIndexMinus = GetCbMiSizeIndex (Kminus);
+}
+
+/**
+ * \param size the size in bytes of the TB
+ * \return the code block segmentation of the TB, computed once for each size
+ */
+static const CbSegmentation &
+GetCbSegmentation (uint16_t size)
+{
+  static std::vector<CbSegmentation> cache;
+  if (size >= cache.size ())
+    {
+      CbSegmentation notComputed = { 0, 0, 0, 0, 0, 0, 0 };
+      cache.resize (size + 1, notComputed);
+    }
+  CbSegmentation &seg = cache[size];
+  if (seg.C == 0)
+    {
+      ComputeCbSegmentation (size, seg);
+    }
+  return seg;
 }
 
 
 double 
-LteMiErrorModel::MappingMiBler (double mib, uint8_t ecrId, uint16_t cbSize)
+LteMiErrorModel::Mib (const SpectrumValue& sinr, const std::vector<int>& map, uint8_t mcs)
 {
-  NS_LOG_FUNCTION (mib << (uint32_t) ecrId << (uint32_t) cbSize);
-  double b = 0;
-  double c = 0;
-
-  NS_ASSERT_MSG (ecrId <= MI_64QAM_BLER_MAX_ID, "ECR out of range [0..37]: " << (uint16_t) ecrId);
-  int cbIndex = 1;
-  while ((cbIndex < 9)&&(cbMiSizeTable[cbIndex]<= cbSize))
+  NS_LOG_FUNCTION (sinr << &map << (uint32_t) mcs);
+  
+  const MiMap &miMap = MiMaps[GetMiMapIndex (mcs)];
+  double MI;
+  double MIsum = 0.0;
+  for (uint32_t i = 0; i < map.size (); i++)
     {
-      cbIndex++;
+      double sinrLin = sinr[map[i]];
+      MI = GetMi (miMap, sinrLin);
+      NS_LOG_LOGIC (" RB " << map[i] << "Minimum SNR = " << 10 * std::log10 (sinrLin) << " dB, " << sinrLin << " V, MCS = " << (uint16_t)mcs << ", MI = " << MI);
+      MIsum += MI;
     }
-  cbIndex--;
-  NS_LOG_LOGIC (" ECRid " << (uint16_t)ecrId << " ECR " << BlerCurvesEcrMap[ecrId] << " CB size " << cbSize << " CB size curve " << cbMiSizeTable[cbIndex]);
+  MI = MIsum / map.size ();
+  NS_LOG_LOGIC (" MI = " << MI);
+  return MI;
+}
 
-  b = bEcrTable[cbIndex][ecrId];
-  if (b<0.0)
+double
+LteMiErrorModel::Mib (const std::vector<double>& miPerRb, const std::vector<int>& map)
+{
+  double MIsum = 0.0;
+  for (uint32_t i = 0; i < map.size (); i++)
     {
-      //take the lowest CB size including this CB for removing CB size
-      //quatization errors
-      int i = cbIndex;
-      while ((i<9)&&(b<0))
-        {
-          b = bEcrTable[i++][ecrId];
-        }
+      MIsum += miPerRb[map[i]];
     }
-  c = cEcrTable[cbIndex][ecrId];
-  if (c<0.0)
+  double MI = MIsum / map.size ();
+  NS_LOG_LOGIC (" MI = " << MI);
+  return MI;
+}
+
+void
+LteMiErrorModel::GetMiPerRb (const SpectrumValue& sinr, uint8_t mcs, std::vector<double>& miPerRb)
+{
+  NS_LOG_FUNCTION (sinr << (uint32_t) mcs);
+  const MiMap &miMap = MiMaps[GetMiMapIndex (mcs)];
+  miPerRb.resize (sinr.GetSpectrumModel ()->GetNumBands ());
+  std::vector<double>::iterator miIt = miPerRb.begin ();
+  for (Values::const_iterator it = sinr.ConstValuesBegin (); it != sinr.ConstValuesEnd (); ++it, ++miIt)
     {
-      //take the lowest CB size including this CB for removing CB size
-      //quatization errors
-      int i = cbIndex;
-      while ((i<9)&&(c<0))
-        {
-          c = cEcrTable[i++][ecrId];
-        }
+      *miIt = GetMi (miMap, *it);
     }
-  // see IEEE802.16m EMD formula 55 of section 4.3.2.1
-  double bler = 0.5*( 1 - erf((mib-b)/(sqrt(2)*c)) );
-  NS_LOG_LOGIC ("MIB: " << mib << " BLER:" << bler << " b:" << b << " c:" << c);
-  return bler;
+}
+
+
+double 
+LteMiErrorModel::MappingMiBler (double mib, uint8_t ecrId, uint16_t cbSize)
+{
+  NS_LOG_FUNCTION (mib << (uint32_t) ecrId << (uint32_t) cbSize);
+  int cbIndex = GetCbMiSizeIndex (cbSize);
+  NS_LOG_LOGIC (" ECRid " << (uint16_t)ecrId << " ECR " << BlerCurvesEcrMap[ecrId] << " CB size " << cbSize << " CB size curve " << cbMiSizeTable[cbIndex]);
+  return GetCbBler (mib, ecrId, cbIndex);
 }
 
 
@@ -468,42 +657,20 @@ LteMiErrorModel::GetPcfichPdcchError (const SpectrumValue& sinr)
   NS_LOG_FUNCTION (sinr);
   double MI;
   double MIsum = 0.0;
-  SpectrumValue sinrCopy = sinr;
-  Values::iterator sinrIt = sinrCopy.ValuesBegin ();
+  Values::const_iterator sinrIt = sinr.ConstValuesBegin ();
   uint16_t rb = 0;
-  NS_ASSERT (sinrIt!=sinrCopy.ValuesEnd ());
-  while (sinrIt!=sinrCopy.ValuesEnd ())
+  NS_ASSERT (sinrIt!=sinr.ConstValuesEnd ());
+  while (sinrIt!=sinr.ConstValuesEnd ())
     {
-      double sinrLin = *sinrIt;
-      if (sinrLin > MI_map_qpsk_axis[MI_MAP_QPSK_SIZE-1])
-        {
-          MI = 1;
-        }
-      else 
-        { 
-          // since the values in MI_map_qpsk_axis are uniformly spaced, we have
-          // index = ((sinrLin - value[0]) / (value[SIZE-1] - value[0])) * (SIZE-1)
-              // the scaling coefficient is always the same, so we use a static const
-              // to speed up the calculation
-          static const double scalingCoeffQpsk = 
-            (MI_MAP_QPSK_SIZE - 1) / (MI_map_qpsk_axis[MI_MAP_QPSK_SIZE-1] - MI_map_qpsk_axis[0]);
-          double sinrIndexDouble = (sinrLin -  MI_map_qpsk_axis[0]) * scalingCoeffQpsk + 1;
-          uint32_t sinrIndex = std::max(0.0, std::floor (sinrIndexDouble));
-          NS_ASSERT_MSG (sinrIndex < MI_MAP_QPSK_SIZE, "MI map out of data");
-          MI = MI_map_qpsk[sinrIndex];
-        }
-      MIsum += MI;
+      MIsum += GetMi (MiMaps[0], *sinrIt);
       sinrIt++;
       rb++;
     }
   MI = MIsum / rb;
-  // return to the effective SINR value
-  int j = 0;
+  // return to the effective SINR value: the MI values increase with the
+  // SINR, find the first one not lower than MI
+  int j = std::lower_bound (MI_map_qpsk, MI_map_qpsk + MI_MAP_QPSK_SIZE, MI) - MI_map_qpsk;
   double esinr = 0.0;
-  while ((j<MI_MAP_QPSK_SIZE)&&(MI_map_qpsk[j] < MI))
-    {
-      j++;
-    }
   if (MI > MI_map_qpsk[MI_MAP_QPSK_SIZE-1])
     {
       esinr = MI_map_qpsk_axis[MI_MAP_QPSK_SIZE-1];
@@ -530,13 +697,8 @@ LteMiErrorModel::GetPcfichPdcchError (const SpectrumValue& sinr)
     }
 
   double esirnDb = 10*log10 (esinr); 
-//   NS_LOG_DEBUG ("Effective SINR " << esirnDb << " max " << 10*log10 (MI_map_qpsk [MI_MAP_QPSK_SIZE-1]));
-  uint16_t i = 0;
+  uint16_t i = std::lower_bound (PdcchPcfichBlerCurveXaxis, PdcchPcfichBlerCurveXaxis + PDCCH_PCFICH_CURVE_SIZE, esirnDb) - PdcchPcfichBlerCurveXaxis;
   double errorRate = 0.0;
-  while ((i<PDCCH_PCFICH_CURVE_SIZE)&&(PdcchPcfichBlerCurveXaxis[i] < esirnDb))
-    {
-      i++;
-    }
   if (esirnDb > PdcchPcfichBlerCurveXaxis[PDCCH_PCFICH_CURVE_SIZE-1])
     {
       errorRate = 0.0;
@@ -558,7 +720,49 @@ LteMiErrorModel::GetTbDecodificationStats (const SpectrumValue& sinr, const std:
 {
   NS_LOG_FUNCTION (sinr << &map << (uint32_t) size << (uint32_t) mcs);
 
-  double tbMi = Mib(sinr, map, mcs);
+  double tbMi = Mib (sinr, map, mcs);
+  return GetTbDecodificationStatsFromMib (tbMi, size, mcs, miHistory);
+}
+
+void
+LteMiErrorModel::GetTbDecodificationStats (const SpectrumValue& sinr, const std::vector<TbErrorModelParams_t>& tbs, std::vector<TbStats_t>& stats)
+{
+  NS_LOG_FUNCTION (sinr << tbs.size ());
+
+  // the MI of all the RBs is looked up only for the modulations of more than one TB
+  uint32_t nTbs[3] = { 0, 0, 0 };
+  for (std::vector<TbErrorModelParams_t>::const_iterator it = tbs.begin (); it != tbs.end (); ++it)
+    {
+      nTbs[GetMiMapIndex (it->mcs)]++;
+    }
+  std::vector<double> miPerRb[3];
+  stats.resize (tbs.size ());
+  for (uint32_t i = 0; i < tbs.size (); i++)
+    {
+      const TbErrorModelParams_t &tb = tbs[i];
+      uint8_t miMapIndex = GetMiMapIndex (tb.mcs);
+      double tbMi;
+      if (nTbs[miMapIndex] > 1)
+        {
+          if (miPerRb[miMapIndex].empty ())
+            {
+              GetMiPerRb (sinr, tb.mcs, miPerRb[miMapIndex]);
+            }
+          tbMi = Mib (miPerRb[miMapIndex], *tb.map);
+        }
+      else
+        {
+          tbMi = Mib (sinr, *tb.map, tb.mcs);
+        }
+      stats[i] = GetTbDecodificationStatsFromMib (tbMi, tb.size, tb.mcs, tb.miHistory);
+    }
+}
+
+TbStats_t
+LteMiErrorModel::GetTbDecodificationStatsFromMib (double tbMi, uint16_t size, uint8_t mcs, const HarqProcessInfoList_t& miHistory)
+{
+  NS_LOG_FUNCTION (tbMi << (uint32_t) size << (uint32_t) mcs);
+
   double MI = 0.0;
   double Reff = 0.0;
   NS_ASSERT (mcs < 29);
@@ -583,96 +787,7 @@ LteMiErrorModel::GetTbDecodificationStats (const SpectrumValue& sinr, const std:
       MI = tbMi;
     }
   NS_LOG_DEBUG (" MI " << MI << " Reff " << Reff << " HARQ " << miHistory.size ());
-  // estimate CB size (according to sec 5.1.2 of TS 36.212)
-  uint16_t Z = 6144; // max size of a codeblock (including CRC)
-  uint32_t B = size * 8;
-//   B = 1234;
-  uint32_t C = 0; // no. of codeblocks
-  uint32_t Cplus = 0; // no. of codeblocks with size K+
-  uint32_t Kplus = 0; // no. of codeblocks with size K+
-  uint32_t Cminus = 0; // no. of codeblocks with size K+
-  uint32_t Kminus = 0; // no. of codeblocks with size K+
-  uint32_t B1 = 0;
-  uint32_t deltaK = 0;
-  if (B <= Z)
-    {
-      // only one codeblock
-      //L = 0;
-      C = 1;
-      B1 = B;
-    }
-  else
-    {
-      uint32_t L = 24;
-      C = ceil ((double)B / ((double)(Z-L)));
-      B1 = B + C * L;
-    }
-  // first segmentation: K+ = minimum K in table such that C * K >= B1
-//   uint i = 0;
-//   while (B1 > cbSizeTable[i] * C)
-//     {
-// //       NS_LOG_INFO (" K+ " << cbSizeTable[i] << " means " << cbSizeTable[i] * C);
-//       i++;
-//     }
-//   uint16_t KplusId = i;
-//   Kplus = cbSizeTable[i];
-
-  // implement a modified binary search
-  int min = 0;
-  int max = 187;
-  int mid = 0;
-  do
-    {
-      mid = (min+max) / 2;
-      if (B1 > cbSizeTable[mid]*C)
-        {
-          if (B1 < cbSizeTable[mid+1]*C)
-            {
-              break;
-            }
-          else
-            {
-              min = mid + 1;
-            }
-        }
-      else
-        {
-          if (B1 > cbSizeTable[mid-1]*C)
-            {
-              break;
-            }
-          else
-            {
-              max = mid - 1;
-            }
-        }
-  } while ((cbSizeTable[mid]*C != B1) && (min < max));
-  // adjust binary search to the largest integer value of K containing B1
-  if (B1 > cbSizeTable[mid]*C)
-    {
-      mid ++;
-    }
-
-  uint16_t KplusId = mid;
-  Kplus = cbSizeTable[mid];
-
-
-  if (C==1)
-    {
-      Cplus = 1;
-      Cminus = 0;
-      Kminus = 0;
-    }
-  else
-    {
-      // second segmentation size: K- = maximum K in table such that K < K+
-      // -fstrict-overflow sensitive, see bug 1868
-      Kminus = cbSizeTable[ KplusId > 1 ? KplusId - 1 : 0];
-      deltaK = Kplus - Kminus;
-      Cminus = floor ((((double) C * Kplus) - (double)B1) / (double)deltaK);
-      Cplus = C - Cminus;
-    }
-  NS_LOG_INFO ("--------------------LteMiErrorModel: TB size of " << B << " needs of " << B1 << " bits reparted in " << C << " CBs as "<< Cplus << " block(s) of " << Kplus << " and " << Cminus << " of " << Kminus);
+  const CbSegmentation &seg = GetCbSegmentation (size);
 
   double errorRate = 1.0;
   uint8_t ecrId = 0;
@@ -719,17 +834,17 @@ LteMiErrorModel::GetTbDecodificationStats (const SpectrumValue& sinr, const std:
       NS_LOG_DEBUG ("HARQ ECR " << (uint16_t)ecrId);
     }
 
-  if (C!=1)
+  if (seg.C!=1)
     {
-      double cbler = MappingMiBler (MI, ecrId, Kplus);
-      errorRate *= pow (1.0 - cbler, Cplus);
-      cbler = MappingMiBler (MI, ecrId, Kminus);
-      errorRate *= pow (1.0 - cbler, Cminus);
+      double cbler = GetCbBler (MI, ecrId, seg.cbIndexPlus);
+      errorRate *= pow (1.0 - cbler, seg.Cplus);
+      cbler = GetCbBler (MI, ecrId, seg.cbIndexMinus);
+      errorRate *= pow (1.0 - cbler, seg.Cminus);
       errorRate = 1.0 - errorRate;
     }
   else
     {
-      errorRate = MappingMiBler (MI, ecrId, Kplus);
+      errorRate = GetCbBler (MI, ecrId, seg.cbIndexPlus);
     }
 
   NS_LOG_LOGIC (" Error rate " << errorRate);
@@ -743,4 +858,3 @@ LteMiErrorModel::GetTbDecodificationStats (const SpectrumValue& sinr, const std:
   
 
 } // namespace ns3
-
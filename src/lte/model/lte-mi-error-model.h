@@ -72,6 +72,15 @@ struct TbStats_t
   double tbler; ///< tbler
   double mi; ///< mi
 };
+
+/// TbErrorModelParams_t structure: a TB evaluated by the batch interface of LteMiErrorModel
+struct TbErrorModelParams_t
+{
+  const std::vector<int> *map; ///< the active RBs of the TB, not copied
+  uint16_t size; ///< the size in bytes of the TB
+  uint8_t mcs; ///< the MCS of the TB
+  HarqProcessInfoList_t miHistory; ///< MI of past transmissions (in case of retx)
+};
   
 
 
@@ -91,6 +100,25 @@ public:
    * \return the mmib
    */
   static double Mib (const SpectrumValue& sinr, const std::vector<int>& map, uint8_t mcs);
+  /**
+   * \brief find the mmib of a TB from the MI of each RB
+   * \param miPerRb the MI of each RB for the modulation of the TB, see GetMiPerRb
+   * \param map the actives RBs for the TB
+   * \return the mmib
+   */
+  static double Mib (const std::vector<double>& miPerRb, const std::vector<int>& map);
+  /**
+   * \brief find the MI of each RB of the whole bandwidth for the modulation of an MCS
+   *
+   * The MI is looked up in the table of the modulation for all the RBs in a
+   * single loop, so that the MI of several TBs with the same modulation is
+   * found at once.
+   *
+   * \param sinr the perceived sinrs in the whole bandwidth
+   * \param mcs an MCS of the modulation
+   * \param miPerRb the MI of each RB
+   */
+  static void GetMiPerRb (const SpectrumValue& sinr, uint8_t mcs, std::vector<double>& miPerRb);
   /** 
    * \brief map the mmib (mean mutual information per bit) for different MCS
    * \param mib mean mutual information per bit of a code-block
@@ -110,6 +138,30 @@ public:
    * \return the TB error rate and MI
    */
   static TbStats_t GetTbDecodificationStats (const SpectrumValue& sinr, const std::vector<int>& map, uint16_t size, uint8_t mcs, HarqProcessInfoList_t miHistory);
+  /**
+   * \brief run the error-model algorithm for a TB whose mmib is known
+   *
+   * The code block segmentation of each TB size is computed once and cached.
+   *
+   * \param mib the mmib of the TB, see Mib
+   * \param size the size in bytes of the TB
+   * \param mcs the MCS of the TB
+   * \param miHistory  MI of past transmissions (in case of retx)
+   * \return the TB error rate and MI
+   */
+  static TbStats_t GetTbDecodificationStatsFromMib (double mib, uint16_t size, uint8_t mcs, const HarqProcessInfoList_t& miHistory);
+  /**
+   * \brief run the error-model algorithm for all the TBs received with the same SINR
+   *
+   * The MI of the RBs is looked up once for each modulation used by the
+   * TBs, and the results are the same as those of GetTbDecodificationStats
+   * called for each TB.
+   *
+   * \param sinr the perceived sinrs in the whole bandwidth
+   * \param tbs the TBs
+   * \param stats the TB error rate and MI of each TB
+   */
+  static void GetTbDecodificationStats (const SpectrumValue& sinr, const std::vector<TbErrorModelParams_t>& tbs, std::vector<TbStats_t>& stats);
   
   /** 
   * \brief run the error-model algorithm for the specified PCFICH+PDCCH channels
@@ -136,7 +136,7 @@ LteRlcTm::DoNotifyTxOpportunity (LteMacSapUser::TxOpportunityParameters txOpPara
     }
 
   m_txBufferSize -= (*(m_txBuffer.begin()))->GetSize ();
-  m_txBuffer.erase (m_txBuffer.begin ());
+  m_txBuffer.pop_front ();
  
   // Sender timestamp
   RlcTag rlcTag (Simulator::Now ());
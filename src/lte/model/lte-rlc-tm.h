@@ -26,6 +26,7 @@
 
 #include <ns3/event-id.h>
 #include <map>
+#include <deque>
 
 namespace ns3 {
 
@@ -72,7 +73,7 @@ private:
 private:
   uint32_t m_maxTxBufferSize; ///< maximum transmit buffer size
   uint32_t m_txBufferSize; ///< transmit buffer size
-  std::vector < Ptr<Packet> > m_txBuffer; ///< Transmission buffer
+  std::deque < Ptr<Packet> > m_txBuffer; ///< Transmission buffer
 
   EventId m_rbsTimer; ///< RBS timer
 
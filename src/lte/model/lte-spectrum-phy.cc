@@ -166,7 +166,7 @@ void LteSpectrumPhy::DoDispose ()
   m_interferenceCtrl = 0;
   m_ltePhyRxDataEndErrorCallback = MakeNullCallback< void > ();
   m_ltePhyRxDataEndOkCallback    = MakeNullCallback< void, Ptr<Packet> >  ();
-  m_ltePhyRxCtrlEndOkCallback = MakeNullCallback< void, std::list<Ptr<LteControlMessage> > > ();
+  m_ltePhyRxCtrlEndOkCallback = MakeNullCallback< void, std::vector<Ptr<LteControlMessage> > > ();
   m_ltePhyRxCtrlEndErrorCallback = MakeNullCallback< void > ();
   m_ltePhyDlHarqFeedbackCallback = MakeNullCallback< void, DlInfoListElement_s > ();
   m_ltePhyUlHarqFeedbackCallback = MakeNullCallback< void, UlInfoListElement_s > ();
@@ -443,7 +443,7 @@ LteSpectrumPhy::SetHarqPhyModule (Ptr<LteHarqPhy> harq)
 
 
 bool
-LteSpectrumPhy::StartTxDataFrame (Ptr<PacketBurst> pb, std::list<Ptr<LteControlMessage> > ctrlMsgList, Time duration)
+LteSpectrumPhy::StartTxDataFrame (Ptr<PacketBurst> pb, const std::vector<Ptr<LteControlMessage> > &ctrlMsgList, Time duration)
 {
   NS_LOG_FUNCTION (this << pb);
   NS_LOG_LOGIC (this << " state: " << m_state);
@@ -502,7 +502,7 @@ LteSpectrumPhy::StartTxDataFrame (Ptr<PacketBurst> pb, std::list<Ptr<LteControlM
 }
 
 bool
-LteSpectrumPhy::StartTxDlCtrlFrame (std::list<Ptr<LteControlMessage> > ctrlMsgList, bool pss)
+LteSpectrumPhy::StartTxDlCtrlFrame (const std::vector<Ptr<LteControlMessage> > &ctrlMsgList, bool pss)
 {
   NS_LOG_FUNCTION (this << " PSS " << (uint16_t)pss);
   NS_LOG_LOGIC (this << " state: " << m_state);
@@ -971,26 +971,42 @@ LteSpectrumPhy::EndRxData ()
   NS_ASSERT (m_transmissionMode < m_txModeGain.size ());
   m_sinrPerceived *= m_txModeGain.at (m_transmissionMode);
   
-  while (itTb!=m_expectedTbs.end ())
+  if ((m_dataErrorModelEnabled)&&(m_rxPacketBurstList.size ()>0)) // avoid to check for errors when there is no actual data transmitted
     {
-      if ((m_dataErrorModelEnabled)&&(m_rxPacketBurstList.size ()>0)) // avoid to check for errors when there is no actual data transmitted
+      // evaluate all the TBs at once, so that the MI of the RBs is looked
+      // up once for each modulation
+      std::vector<TbErrorModelParams_t> tbs;
+      tbs.reserve (m_expectedTbs.size ());
+      for (itTb = m_expectedTbs.begin (); itTb != m_expectedTbs.end (); itTb++)
         {
+          TbErrorModelParams_t tb;
+          tb.map = &(*itTb).second.rbBitmap;
+          tb.size = (*itTb).second.size;
+          tb.mcs = (*itTb).second.mcs;
           // retrieve HARQ info
-          HarqProcessInfoList_t harqInfoList;
           if ((*itTb).second.ndi == 0)
             {
               // TB retxed: retrieve HARQ history
               uint16_t ulHarqId = 0;
               if ((*itTb).second.downlink)
                 {
-                  harqInfoList = m_harqPhyModule->GetHarqProcessInfoDl ((*itTb).second.harqProcessId, (*itTb).first.m_layer);
+                  tb.miHistory = m_harqPhyModule->GetHarqProcessInfoDl ((*itTb).second.harqProcessId, (*itTb).first.m_layer);
                 }
               else
                 {
-                  harqInfoList = m_harqPhyModule->GetHarqProcessInfoUl ((*itTb).first.m_rnti, ulHarqId);
+                  tb.miHistory = m_harqPhyModule->GetHarqProcessInfoUl ((*itTb).first.m_rnti, ulHarqId);
                 }
             }
-          TbStats_t tbStats = LteMiErrorModel::GetTbDecodificationStats (m_sinrPerceived, (*itTb).second.rbBitmap, (*itTb).second.size, (*itTb).second.mcs, harqInfoList);
+          tbs.push_back (tb);
+        }
+      std::vector<TbStats_t> tbStatsList;
+      LteMiErrorModel::GetTbDecodificationStats (m_sinrPerceived, tbs, tbStatsList);
+
+      std::vector<TbErrorModelParams_t>::const_iterator tbIt = tbs.begin ();
+      std::vector<TbStats_t>::const_iterator statsIt = tbStatsList.begin ();
+      for (itTb = m_expectedTbs.begin (); itTb != m_expectedTbs.end (); itTb++, tbIt++, statsIt++)
+        {
+          const TbStats_t &tbStats = *statsIt;
           (*itTb).second.mi = tbStats.mi;
           (*itTb).second.corrupt = m_random->GetValue () > tbStats.tbler ? false : true;
           NS_LOG_DEBUG (this << "RNTI " << (*itTb).first.m_rnti << " size " << (*itTb).second.size << " mcs " << (uint32_t)(*itTb).second.mcs << " bitmap " << (*itTb).second.rbBitmap.size () << " layer " << (uint16_t)(*itTb).first.m_layer << " TBLER " << tbStats.tbler << " corrupted " << (*itTb).second.corrupt);
@@ -1016,12 +1032,10 @@ LteSpectrumPhy::EndRxData ()
           else
             {
               // UL
-              params.m_rv = harqInfoList.size ();
+              params.m_rv = (*tbIt).miHistory.size ();
               m_ulPhyReception (params);
             }
-       }
-      
-      itTb++;
+        }
     }
     std::map <uint16_t, DlInfoListElement_s> harqDlInfoMap;
     for (std::list<Ptr<PacketBurst> >::const_iterator i = m_rxPacketBurstList.begin (); 
@@ -111,7 +111,7 @@ typedef Callback< void, Ptr<Packet> > LtePhyRxDataEndOkCallback;
 *
 * @param packet the received Packet
 */
-typedef Callback< void, std::list<Ptr<LteControlMessage> > > LtePhyRxCtrlEndOkCallback;
+typedef Callback< void, std::vector<Ptr<LteControlMessage> > > LtePhyRxCtrlEndOkCallback;
 
 /**
 * This method is used by the LteSpectrumPhy to notify the PHY that a
@@ -241,7 +241,7 @@ public:
   * @return true if an error occurred and the transmission was not
   * started, false otherwise.
   */
-  bool StartTxDataFrame (Ptr<PacketBurst> pb, std::list<Ptr<LteControlMessage> > ctrlMsgList, Time duration);
+  bool StartTxDataFrame (Ptr<PacketBurst> pb, const std::vector<Ptr<LteControlMessage> > &ctrlMsgList, Time duration);
   
   /**
   * Start a transmission of control frame in DL
@@ -253,7 +253,7 @@ public:
   * @return true if an error occurred and the transmission was not
   * started, false otherwise.
   */
-  bool StartTxDlCtrlFrame (std::list<Ptr<LteControlMessage> > ctrlMsgList, bool pss);
+  bool StartTxDlCtrlFrame (const std::vector<Ptr<LteControlMessage> > &ctrlMsgList, bool pss);
   
   
   /**
@@ -476,8 +476,8 @@ private:
   Ptr<PacketBurst> m_txPacketBurst; ///< the transmit packet burst
   std::list<Ptr<PacketBurst> > m_rxPacketBurstList; ///< the receive burst list
   
-  std::list<Ptr<LteControlMessage> > m_txControlMessageList; ///< the transmit control message list
-  std::list<Ptr<LteControlMessage> > m_rxControlMessageList; ///< the receive control message list
+  std::vector<Ptr<LteControlMessage> > m_txControlMessageList; ///< the transmit control message list
+  std::vector<Ptr<LteControlMessage> > m_rxControlMessageList; ///< the receive control message list
   
   
   State m_state; ///< the state
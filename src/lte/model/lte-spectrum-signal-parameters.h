@@ -89,7 +89,7 @@ struct LteSpectrumSignalParametersDataFrame : public SpectrumSignalParameters
   */
   Ptr<PacketBurst> packetBurst;
   
-  std::list<Ptr<LteControlMessage> > ctrlMsgList; ///< the control message list
+  std::vector<Ptr<LteControlMessage> > ctrlMsgList; ///< the control message list
   
   uint16_t cellId; ///< cell ID
 };
@@ -118,7 +118,7 @@ struct LteSpectrumSignalParametersDlCtrlFrame : public SpectrumSignalParameters
   LteSpectrumSignalParametersDlCtrlFrame (const LteSpectrumSignalParametersDlCtrlFrame& p);
 
 
-  std::list<Ptr<LteControlMessage> > ctrlMsgList; ///< control message list
+  std::vector<Ptr<LteControlMessage> > ctrlMsgList; ///< control message list
   
   uint16_t cellId; ///< cell ID
   bool pss; ///< primary synchronization signal
@@ -385,7 +385,7 @@ LteUeMac::SendReportBufferStatus (void)
   bsr.m_macCeValue.m_bufferStatus.push_back (BufferSizeLevelBsr::BufferSize2BsrId (queue.at (3)));
 
   // create the feedback to eNB
-  Ptr<BsrLteControlMessage> msg = Create<BsrLteControlMessage> ();
+  Ptr<BsrLteControlMessage> msg = LteControlMessagePool<BsrLteControlMessage>::Get ();
   msg->SetBsr (bsr);
   m_uePhySapProvider->SendLteControlMessage (msg);
 
@@ -720,7 +720,7 @@ LteUePhy::CreateDlCqiFeedbackMessage (const SpectrumValue& sinr)
   newSinr *= m_txModeGain.at (m_transmissionMode);
 
   // CREATE DlCqiLteControlMessage
-  Ptr<DlCqiLteControlMessage> msg = Create<DlCqiLteControlMessage> ();
+  Ptr<DlCqiLteControlMessage> msg = LteControlMessagePool<DlCqiLteControlMessage>::Get ();
   CqiListElement_s dlcqi;
   std::vector<int> cqi;
   if (Simulator::Now () > m_p10CqiLast + m_p10CqiPeriodicity)
@@ -882,11 +882,11 @@ LteUePhy::DoSendRachPreamble (uint32_t raPreambleId, uint32_t raRnti)
 
 
 void
-LteUePhy::ReceiveLteControlMessageList (std::list<Ptr<LteControlMessage> > msgList)
+LteUePhy::ReceiveLteControlMessageList (std::vector<Ptr<LteControlMessage> > msgList)
 {
   NS_LOG_FUNCTION (this);
 
-  std::list<Ptr<LteControlMessage> >::iterator it;
+  std::vector<Ptr<LteControlMessage> >::iterator it;
   NS_LOG_DEBUG (this << " I am rnti = " << m_rnti << " and I received msgs " << (uint16_t) msgList.size ());
   for (it = msgList.begin (); it != msgList.end (); it++)
     {
@@ -896,7 +896,7 @@ LteUePhy::ReceiveLteControlMessageList (std::list<Ptr<LteControlMessage> > msgLi
         {
           Ptr<DlDciLteControlMessage> msg2 = DynamicCast<DlDciLteControlMessage> (msg);
 
-          DlDciListElement_s dci = msg2->GetDci ();
+          const DlDciListElement_s &dci = msg2->GetDci ();
           if (dci.m_rnti != m_rnti)
             {
               // DCI not for me
@@ -1134,7 +1134,7 @@ LteUePhy::SubframeIndication (uint32_t frameNo, uint32_t subframeNo)
             }
         }
 
-      std::list<Ptr<LteControlMessage> > ctrlMsg = GetControlMessages ();
+      std::vector<Ptr<LteControlMessage> > ctrlMsg = GetControlMessages ();
       // send packets in queue
       NS_LOG_LOGIC (this << " UE - start slot for PUSCH + PUCCH - RNTI " << m_rnti << " CELLID " << m_cellId);
       // send the current burts of packets
@@ -1234,7 +1234,7 @@ LteUePhy::DoReset ()
     {
       Ptr<PacketBurst> pb = CreateObject <PacketBurst> ();
       m_packetBurstQueue.push_back (pb);
-      std::list<Ptr<LteControlMessage> > l;
+      std::vector<Ptr<LteControlMessage> > l;
       m_controlMessagesQueue.push_back (l);
     }
   std::vector <int> ulRb;
@@ -1456,7 +1456,7 @@ LteUePhy::ReceiveLteDlHarqFeedback (DlInfoListElement_s m)
 {
   NS_LOG_FUNCTION (this);
   // generate feedback to eNB and send it through ideal PUCCH
-  Ptr<DlHarqFeedbackLteControlMessage> msg = Create<DlHarqFeedbackLteControlMessage> ();
+  Ptr<DlHarqFeedbackLteControlMessage> msg = LteControlMessagePool<DlHarqFeedbackLteControlMessage>::Get ();
   msg->SetDlHarqFeedback (m);
   SetControlMessages (msg);
 }
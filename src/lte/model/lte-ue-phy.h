@@ -217,7 +217,7 @@ public:
    *
    * \param msgList LTE control message list
    */
-  virtual void ReceiveLteControlMessageList (std::list<Ptr<LteControlMessage> > msgList);
+  virtual void ReceiveLteControlMessageList (std::vector<Ptr<LteControlMessage> > msgList);
   /**
    * \brief Receive PSS function
    *
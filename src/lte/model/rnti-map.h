@@ -0,0 +1,322 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef RNTI_MAP_H
+#define RNTI_MAP_H
+
+#include <ns3/assert.h>
+#include <stdint.h>
+#include <vector>
+#include <utility>
+
+namespace ns3 {
+
+/**
+ * \ingroup lte
+ * \brief A map keyed by RNTI, stored as a dense array indexed by RNTI.
+ *
+ * The schedulers keep their per-UE state in several maps keyed by RNTI (one
+ * map per quantity, e.g. CQI, CQI timer, HARQ process status), which they
+ * look up and walk at every TTI.  Since the RNTIs of the UEs of a cell are
+ * allocated sequentially from 1, RntiMap stores the entries of such a map
+ * in a vector indexed by RNTI, with a presence flag per slot: lookups,
+ * insertions and removals are a vector access, and walking the entries,
+ * e.g. to decrement the CQI timers of all the UEs, is a single pass over
+ * contiguous memory.
+ *
+ * RntiMap provides the subset of the std::map interface used by the
+ * schedulers, and iterates over the entries in increasing RNTI order, like
+ * std::map, so that the scheduling decisions do not change.  Its iterators
+ * are an index in the vector: they stay valid until the entry they point
+ * to is erased.  References to the entries are invalidated by the
+ * insertion of an RNTI larger than all the RNTIs inserted before.
+ */
+template <typename T>
+class RntiMap
+{
+public:
+  typedef uint16_t key_type;                  ///< the key type
+  typedef T mapped_type;                      ///< the mapped type
+  typedef std::pair<uint16_t, T> value_type;  ///< the type of the entries
+
+  /**
+   * \brief Iterator over the entries of a RntiMap, in increasing RNTI order
+   * \tparam M the (possibly const) map type
+   * \tparam V the (possibly const) entry type
+   */
+  template <typename M, typename V>
+  class Iterator
+  {
+public:
+    Iterator ()
+      : m_map (0),
+        m_slot (0)
+    {
+    }
+    /**
+     * \param map the map
+     * \param slot the slot of the entry, or the size of the map storage
+     */
+    Iterator (M *map, uint32_t slot)
+      : m_map (map),
+        m_slot (slot)
+    {
+    }
+    /**
+     * Conversion from a non-const iterator
+     * \param o the iterator
+     */
+    template <typename M2, typename V2>
+    Iterator (const Iterator<M2, V2> &o)
+      : m_map (o.m_map),
+        m_slot (o.m_slot)
+    {
+    }
+    /// \return the entry
+    V & operator* () const
+    {
+      return m_map->m_values[m_slot];
+    }
+    /// \return a pointer to the entry
+    V * operator-> () const
+    {
+      return &m_map->m_values[m_slot];
+    }
+    /// \return the iterator to the next entry
+    Iterator & operator++ ()
+    {
+      m_slot = m_map->NextSlot (m_slot + 1);
+      return *this;
+    }
+    /// \return the iterator before the increment
+    Iterator operator++ (int)
+    {
+      Iterator tmp = *this;
+      ++*this;
+      return tmp;
+    }
+    /**
+     * \param o another iterator
+     * \return true if the iterators point to the same entry
+     */
+    template <typename M2, typename V2>
+    bool operator== (const Iterator<M2, V2> &o) const
+    {
+      return m_slot == o.m_slot;
+    }
+    /**
+     * \param o another iterator
+     * \return true if the iterators point to different entries
+     */
+    template <typename M2, typename V2>
+    bool operator!= (const Iterator<M2, V2> &o) const
+    {
+      return m_slot != o.m_slot;
+    }
+
+private:
+    template <typename U> friend class RntiMap;
+    template <typename M2, typename V2> friend class Iterator;
+    M *m_map;         ///< the map
+    uint32_t m_slot;  ///< the slot of the entry
+  };
+
+  typedef Iterator<RntiMap, value_type> iterator;                   ///< iterator
+  typedef Iterator<const RntiMap, const value_type> const_iterator; ///< const iterator
+
+  RntiMap ()
+    : m_size (0)
+  {
+  }
+
+  /// \return an iterator to the entry with the smallest RNTI
+  iterator begin ()
+  {
+    return iterator (this, NextSlot (0));
+  }
+  /// \return an iterator to the entry with the smallest RNTI
+  const_iterator begin () const
+  {
+    return const_iterator (this, NextSlot (0));
+  }
+  /// \return the past-the-end iterator
+  iterator end ()
+  {
+    return iterator (this, m_values.size ());
+  }
+  /// \return the past-the-end iterator
+  const_iterator end () const
+  {
+    return const_iterator (this, m_values.size ());
+  }
+
+  /// \return the number of entries
+  std::size_t size () const
+  {
+    return m_size;
+  }
+  /// \return true if the map has no entries
+  bool empty () const
+  {
+    return m_size == 0;
+  }
+
+  /**
+   * \param rnti the RNTI
+   * \return an iterator to the entry of the RNTI, or end () if none
+   */
+  iterator find (uint16_t rnti)
+  {
+    return iterator (this, Contains (rnti) ? rnti : m_values.size ());
+  }
+  /**
+   * \param rnti the RNTI
+   * \return an iterator to the entry of the RNTI, or end () if none
+   */
+  const_iterator find (uint16_t rnti) const
+  {
+    return const_iterator (this, Contains (rnti) ? rnti : m_values.size ());
+  }
+  /**
+   * \param rnti the RNTI
+   * \return 1 if the map has an entry for the RNTI, 0 otherwise
+   */
+  std::size_t count (uint16_t rnti) const
+  {
+    return Contains (rnti) ? 1 : 0;
+  }
+
+  /**
+   * \param rnti the RNTI
+   * \return the value of the RNTI, inserted with its default value if the
+   * map had no entry for it
+   */
+  T & operator[] (uint16_t rnti)
+  {
+    if (!Contains (rnti))
+      {
+        Insert (rnti, T ());
+      }
+    return m_values[rnti].second;
+  }
+
+  /**
+   * Insert an entry, unless the map has an entry for the same RNTI
+   * \param value the entry
+   * \return an iterator to the entry of the RNTI, and true if the entry was
+   * inserted
+   */
+  std::pair<iterator, bool> insert (const value_type &value)
+  {
+    if (Contains (value.first))
+      {
+        return std::make_pair (iterator (this, value.first), false);
+      }
+    Insert (value.first, value.second);
+    return std::make_pair (iterator (this, value.first), true);
+  }
+
+  /**
+   * Erase an entry
+   * \param it an iterator to the entry
+   */
+  void erase (iterator it)
+  {
+    NS_ASSERT (it.m_slot < m_values.size () && m_present[it.m_slot]);
+    Erase (it.m_slot);
+  }
+  /**
+   * Erase the entry of an RNTI, if any
+   * \param rnti the RNTI
+   * \return the number of erased entries
+   */
+  std::size_t erase (uint16_t rnti)
+  {
+    if (!Contains (rnti))
+      {
+        return 0;
+      }
+    Erase (rnti);
+    return 1;
+  }
+
+  /// Erase all the entries
+  void clear ()
+  {
+    m_values.clear ();
+    m_present.clear ();
+    m_size = 0;
+  }
+
+private:
+  /**
+   * \param rnti the RNTI
+   * \return true if the map has an entry for the RNTI
+   */
+  bool Contains (uint16_t rnti) const
+  {
+    return rnti < m_present.size () && m_present[rnti];
+  }
+  /**
+   * \param slot a slot
+   * \return the first slot from the given one which holds an entry, or the
+   * size of the storage if none
+   */
+  uint32_t NextSlot (uint32_t slot) const
+  {
+    uint32_t n = m_present.size ();
+    while (slot < n && !m_present[slot])
+      {
+        slot++;
+      }
+    return slot;
+  }
+  /**
+   * Store an entry in a free slot
+   * \param rnti the RNTI
+   * \param value the value
+   */
+  void Insert (uint16_t rnti, const T &value)
+  {
+    if (rnti >= m_values.size ())
+      {
+        m_values.resize (rnti + 1);
+        m_present.resize (rnti + 1, 0);
+      }
+    m_values[rnti].first = rnti;
+    m_values[rnti].second = value;
+    m_present[rnti] = 1;
+    m_size++;
+  }
+  /**
+   * Free a slot, and release the memory held by its value
+   * \param slot the slot
+   */
+  void Erase (uint32_t slot)
+  {
+    m_values[slot].second = T ();
+    m_present[slot] = 0;
+    m_size--;
+  }
+
+  std::vector<value_type> m_values;  ///< the entries, indexed by RNTI
+  std::vector<uint8_t> m_present;    ///< whether each slot holds an entry
+  std::size_t m_size;                ///< the number of entries
+};
+
+} // namespace ns3
+
+#endif /* RNTI_MAP_H */
@@ -27,19 +27,156 @@
 #include <ns3/string.h>
 #include <ns3/double.h>
 #include "ns3/uinteger.h"
+#include <ns3/simple-ref-count.h>
+#include <ns3/abort.h>
 #include <fstream>
+#include <cstring>
 #include <ns3/simulator.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 
 namespace ns3 {
 
 NS_LOG_COMPONENT_DEFINE ("TraceFadingLossModel");
 
 NS_OBJECT_ENSURE_REGISTERED (TraceFadingLossModel);
+
+
+/**
+ * Header of the binary fading trace files, followed by the samples
+ */
+struct FadingTraceHeader
+{
+  char magic[8];       ///< identifies the format of the file
+  uint32_t rbNum;      ///< number of RBs
+  uint32_t samplesNum; ///< number of samples per RB
+};
+
+/// magic string of the binary fading trace files
+static const char FADING_TRACE_MAGIC[8] = { 'N', 'S', '3', 'F', 'A', 'D', '0', '1' };
+
+
+/**
+ * \ingroup lte
+ *
+ * \brief A binary fading trace, memory-mapped read-only and shared by all
+ * the TraceFadingLossModel instances which use the same file
+ */
+class MappedFadingTrace : public SimpleRefCount<MappedFadingTrace>
+{
+public:
+  /**
+   * Map a binary fading trace, or get the existing mapping of the file
+   *
+   * \param fileName the trace file
+   * \return the mapped trace, or 0 if the file is not a binary fading trace
+   */
+  static Ptr<MappedFadingTrace> Open (std::string fileName);
+  ~MappedFadingTrace ();
+
+  /// \return the number of RBs
+  uint32_t GetRbNum (void) const;
+  /// \return the number of samples per RB
+  uint32_t GetSamplesNum (void) const;
+  /// \return the samples, RB after RB
+  const double * GetSamples (void) const;
+
+private:
+  /**
+   * \param fileName the trace file
+   * \param address the address of the mapping
+   * \param length the length of the mapping
+   */
+  MappedFadingTrace (std::string fileName, void *address, size_t length);
+
+  /// the mapped traces of the process, by file name
+  typedef std::map<std::string, MappedFadingTrace *> TraceMap;
+  /// \return the mapped traces of the process
+  static TraceMap & GetTraces (void);
+
+  std::string m_fileName; ///< the trace file
+  void *m_address;        ///< the address of the mapping
+  size_t m_length;        ///< the length of the mapping
+};
+
+MappedFadingTrace::TraceMap &
+MappedFadingTrace::GetTraces (void)
+{
+  static TraceMap traces;
+  return traces;
+}
+
+Ptr<MappedFadingTrace>
+MappedFadingTrace::Open (std::string fileName)
+{
+  TraceMap::const_iterator it = GetTraces ().find (fileName);
+  if (it != GetTraces ().end ())
+    {
+      return Ptr<MappedFadingTrace> (it->second);
+    }
+
+  int fd = open (fileName.c_str (), O_RDONLY);
+  if (fd < 0)
+    {
+      return 0;
+    }
+  FadingTraceHeader header;
+  struct stat status;
+  if (read (fd, &header, sizeof (header)) != sizeof (header)
+      || std::memcmp (header.magic, FADING_TRACE_MAGIC, sizeof (header.magic)) != 0
+      || fstat (fd, &status) != 0)
+    {
+      close (fd);
+      return 0;
+    }
+  size_t length = sizeof (header) + sizeof (double) * header.rbNum * header.samplesNum;
+  NS_ABORT_MSG_IF (static_cast<size_t> (status.st_size) < length, "Fading trace file " << fileName << " is truncated");
+  void *address = mmap (0, length, PROT_READ, MAP_SHARED, fd, 0);
+  close (fd);
+  NS_ABORT_MSG_IF (address == MAP_FAILED, "Could not map fading trace file " << fileName);
+  NS_LOG_INFO ("Mapped fading trace " << fileName << " with " << header.rbNum << " RBs of " << header.samplesNum << " samples");
+  return Ptr<MappedFadingTrace> (new MappedFadingTrace (fileName, address, length), false);
+}
+
+MappedFadingTrace::MappedFadingTrace (std::string fileName, void *address, size_t length)
+  : m_fileName (fileName),
+    m_address (address),
+    m_length (length)
+{
+  GetTraces ()[m_fileName] = this;
+}
+
+MappedFadingTrace::~MappedFadingTrace ()
+{
+  GetTraces ().erase (m_fileName);
+  munmap (m_address, m_length);
+}
+
+uint32_t
+MappedFadingTrace::GetRbNum (void) const
+{
+  return static_cast<const FadingTraceHeader *> (m_address)->rbNum;
+}
+
+uint32_t
+MappedFadingTrace::GetSamplesNum (void) const
+{
+  return static_cast<const FadingTraceHeader *> (m_address)->samplesNum;
+}
+
+const double *
+MappedFadingTrace::GetSamples (void) const
+{
+  return reinterpret_cast<const double *> (static_cast<const char *> (m_address) + sizeof (FadingTraceHeader));
+}
   
 
 
 TraceFadingLossModel::TraceFadingLossModel ()
-  : m_streamsAssigned (false)
+  : m_samples (0),
+    m_streamsAssigned (false)
 {
   NS_LOG_FUNCTION (this);
   SetNext (NULL);
@@ -49,6 +186,8 @@ TraceFadingLossModel::TraceFadingLossModel ()
 TraceFadingLossModel::~TraceFadingLossModel ()
 {
   m_fadingTrace.clear ();
+  m_mappedTrace = 0;
+  m_samples = 0;
   m_windowOffsetsMap.clear ();
   m_startVariableMap.clear ();
 }
@@ -120,27 +259,32 @@ void
 TraceFadingLossModel::LoadTrace ()
 {
   NS_LOG_FUNCTION (this << "Loading Fading Trace " << m_traceFile);
-  std::ifstream ifTraceFile;
-  ifTraceFile.open (m_traceFile.c_str (), std::ifstream::in);
   m_fadingTrace.clear ();
-  if (!ifTraceFile.good ())
+  m_mappedTrace = MappedFadingTrace::Open (m_traceFile);
+  if (m_mappedTrace != 0)
     {
-      NS_LOG_INFO (this << " File: " << m_traceFile);
-      NS_ASSERT_MSG(ifTraceFile.good (), " Fading trace file not found");
+      NS_ABORT_MSG_IF (m_mappedTrace->GetRbNum () != m_rbNum || m_mappedTrace->GetSamplesNum () != m_samplesNum,
+                       "Fading trace " << m_traceFile << " has " << m_mappedTrace->GetRbNum () << " RBs of "
+                                       << m_mappedTrace->GetSamplesNum () << " samples, instead of the "
+                                       << (uint32_t) m_rbNum << " RBs of " << m_samplesNum << " samples of the RbNum and SamplesNum attributes");
+      m_samples = m_mappedTrace->GetSamples ();
     }
-
-//   NS_LOG_INFO (this << " length " << m_traceLength.GetSeconds ());
-//   NS_LOG_INFO (this << " RB " << (uint32_t)m_rbNum << " samples " << m_samplesNum);
-  for (uint32_t i = 0; i < m_rbNum; i++)
+  else
     {
-      FadingTraceSample rbTimeFadingTrace;
-      for (uint32_t j = 0; j < m_samplesNum; j++)
+      std::ifstream ifTraceFile;
+      ifTraceFile.open (m_traceFile.c_str (), std::ifstream::in);
+      if (!ifTraceFile.good ())
+        {
+          NS_LOG_INFO (this << " File: " << m_traceFile);
+          NS_ASSERT_MSG(ifTraceFile.good (), " Fading trace file not found");
+        }
+
+      m_fadingTrace.resize (m_rbNum * m_samplesNum);
+      for (uint32_t i = 0; i < m_fadingTrace.size (); i++)
         {
-          double sample;
-          ifTraceFile >> sample;
-          rbTimeFadingTrace.push_back (sample);
+          ifTraceFile >> m_fadingTrace[i];
         }
-      m_fadingTrace.push_back (rbTimeFadingTrace);
+      m_samples = m_fadingTrace.empty () ? 0 : &m_fadingTrace[0];
     }
   m_timeGranularity = m_traceLength.GetMilliSeconds () / m_samplesNum;
   m_lastWindowUpdate = Simulator::Now ();
@@ -201,17 +345,17 @@ TraceFadingLossModel::DoCalcRxPowerSpectralDensity (
   //double speed = std::sqrt (std::pow (aSpeedVector.x-bSpeedVector.x,2) + std::pow (aSpeedVector.y-bSpeedVector.y,2));
 
   NS_LOG_LOGIC (this << *rxPsd);
-  NS_ASSERT (!m_fadingTrace.empty ());
+  NS_ASSERT (m_samples != 0);
   int now_ms = static_cast<int> (Simulator::Now ().GetMilliSeconds () * m_timeGranularity);
   int lastUpdate_ms = static_cast<int> (m_lastWindowUpdate.GetMilliSeconds () * m_timeGranularity);
   int index = ((*itOff).second + now_ms - lastUpdate_ms) % m_samplesNum;
   int subChannel = 0;
   while (vit != rxPsd->ValuesEnd ())
     {
-      NS_ASSERT (subChannel < 100);
+      NS_ASSERT (subChannel < m_rbNum);
       if (*vit != 0.)
         {
-          double fading = m_fadingTrace.at (subChannel).at (index);
+          double fading = m_samples[subChannel * m_samplesNum + index];
           NS_LOG_INFO (this << " FADING now " << now_ms << " offset " << (*itOff).second << " id " << index << " fading " << fading);
           double power = *vit; // in Watt/Hz
           power = 10 * std::log10 (180000 * power); // in dB
@@ -254,6 +398,34 @@ TraceFadingLossModel::AssignStreams (int64_t stream)
   return m_streamSetSize;
 }
 
+void
+TraceFadingLossModel::ConvertTrace (std::string textFileName, std::string binaryFileName,
+                                    uint8_t rbNum, uint32_t samplesNum)
+{
+  NS_LOG_FUNCTION (textFileName << binaryFileName << (uint32_t) rbNum << samplesNum);
+  std::ifstream ifTraceFile (textFileName.c_str (), std::ifstream::in);
+  NS_ABORT_MSG_IF (!ifTraceFile.good (), "Fading trace file " << textFileName << " not found");
+  std::vector<double> samples (rbNum * samplesNum);
+  for (uint32_t i = 0; i < samples.size (); i++)
+    {
+      ifTraceFile >> samples[i];
+    }
+  NS_ABORT_MSG_IF (ifTraceFile.fail (), "Fading trace file " << textFileName << " has less than "
+                                                              << samples.size () << " samples");
+
+  FadingTraceHeader header;
+  std::memcpy (header.magic, FADING_TRACE_MAGIC, sizeof (header.magic));
+  header.rbNum = rbNum;
+  header.samplesNum = samplesNum;
+  std::ofstream ofTraceFile (binaryFileName.c_str (), std::ios::out | std::ios::binary | std::ios::trunc);
+  ofTraceFile.write (reinterpret_cast<const char *> (&header), sizeof (header));
+  if (!samples.empty ())
+    {
+      ofTraceFile.write (reinterpret_cast<const char *> (&samples[0]), samples.size () * sizeof (double));
+    }
+  NS_ABORT_MSG_IF (!ofTraceFile, "Could not write fading trace file " << binaryFileName);
+}
+
 
 
 } // namespace ns3
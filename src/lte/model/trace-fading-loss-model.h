@@ -27,6 +27,7 @@
 #include <ns3/object.h>
 #include <ns3/spectrum-propagation-loss-model.h>
 #include <map>
+#include <vector>
 #include "ns3/random-variable-stream.h"
 #include <ns3/nstime.h>
 
@@ -34,12 +35,19 @@ namespace ns3 {
 
 
 class MobilityModel;
+class MappedFadingTrace;
 
 
 /**
  * \ingroup lte
  *
  * \brief fading loss model based on precalculated fading traces
+ *
+ * The trace file is either a text file, parsed by each instance, or a
+ * binary file written by ConvertTrace.  A binary file is memory-mapped
+ * read-only: its samples are shared by all the instances of a process
+ * which use it, and by all the processes of a host which map it.  Each
+ * link reads the shared samples from its own offset.
  */
 class TraceFadingLossModel : public SpectrumPropagationLossModel
 {
@@ -70,6 +78,21 @@ public:
   */
   int64_t AssignStreams (int64_t stream);
 
+  /**
+   * \brief Convert a text fading trace into the binary format, which
+   * TraceFadingLossModel memory-maps
+   *
+   * The binary file holds a header with the number of RBs and samples,
+   * followed by the samples in the byte order of the host, RB after RB.
+   *
+   * \param textFileName the text trace file
+   * \param binaryFileName the binary trace file to write
+   * \param rbNum the number of RBs of the trace
+   * \param samplesNum the number of samples per RB of the trace
+   */
+  static void ConvertTrace (std::string textFileName, std::string binaryFileName,
+                            uint8_t rbNum = 100, uint32_t samplesNum = 10000);
+
   
 private:
   /**
@@ -112,20 +135,11 @@ private:
   
   mutable std::map <ChannelRealizationId_t, Ptr<UniformRandomVariable> > m_startVariableMap; ///< start variable map
   
-  /**
-   * Vector with fading samples in time domain (for a fixed RB)
-   */
-  typedef std::vector<double> FadingTraceSample;
-  /**
-   * Vector collecting the time fading traces in the frequency domain (per RB)
-   */
-  typedef std::vector<FadingTraceSample> FadingTrace;
-
-
-  
   std::string m_traceFile; ///< the trace file name
   
-  FadingTrace m_fadingTrace; ///< fading trace
+  std::vector<double> m_fadingTrace; ///< samples of a text trace, RB after RB
+  Ptr<MappedFadingTrace> m_mappedTrace; ///< the binary trace, if mapped
+  const double *m_samples; ///< the samples of the trace, RB after RB
 
   
   Time m_traceLength; ///< the trace time
@@ -26,6 +26,7 @@ cpp_examples = [
     ("lena-profiling", "True", "True"),
     ("lena-profiling --simTime=0.1 --nUe=2 --nEnb=5 --nFloors=0", "True", "True"),
     ("lena-profiling --simTime=0.1 --nUe=3 --nEnb=6 --nFloors=1", "True", "True"),
+    ("lena-scheduler-bench --nUes=50 --ttis=50", "True", "True"),
     ("lena-rlc-traces", "True", "True"),
     ("lena-rem", "True", "True"),
     ("lena-rem-sector-antenna", "True", "True"),
@@ -0,0 +1,191 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <ns3/test.h>
+#include <ns3/log.h>
+#include <ns3/lte-amc.h>
+#include <ns3/lte-spectrum-value-helper.h>
+#include <ns3/spectrum-value.h>
+#include <ns3/double.h>
+#include <ns3/enum.h>
+#include <cmath>
+#include <vector>
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("LteAmcTest");
+
+/// the spectral efficiency of the CQIs, as in lte-amc.cc
+static const double g_amcTestSpectralEfficiencyForCqi[16] = {
+  0.0, 0.15, 0.23, 0.38, 0.6, 0.88, 1.18, 1.48, 1.91, 2.41,
+  2.73, 3.32, 3.9, 4.52, 5.12, 5.55
+};
+
+/// the spectral efficiency of the MCSs, as in lte-amc.cc
+static const double g_amcTestSpectralEfficiencyForMcs[29] = {
+  0.15, 0.19, 0.23, 0.31, 0.38, 0.49, 0.6, 0.74, 0.88, 1.03, 1.18,
+  1.33, 1.48, 1.7, 1.91, 2.16, 2.41, 2.57,
+  2.73, 3.03, 3.32, 3.61, 3.9, 4.21, 4.52, 4.82, 5.12, 5.33, 5.55
+};
+
+/**
+ * \ingroup lte-test
+ * \ingroup tests
+ *
+ * \brief Check the CQI and MCS mappings of LteAmc, which are looked up in
+ * tables, against the searches they replace
+ */
+class LteAmcMappingTestCase : public TestCase
+{
+public:
+  LteAmcMappingTestCase ();
+
+private:
+  virtual void DoRun (void);
+
+  /**
+   * \param s the spectral efficiency
+   * \return the CQI, found by a linear search
+   */
+  static int ReferenceCqiFromSpectralEfficiency (double s);
+};
+
+LteAmcMappingTestCase::LteAmcMappingTestCase ()
+  : TestCase ("Check the CQI and MCS mappings of LteAmc")
+{
+}
+
+int
+LteAmcMappingTestCase::ReferenceCqiFromSpectralEfficiency (double s)
+{
+  int cqi = 0;
+  while ((cqi < 15) && (g_amcTestSpectralEfficiencyForCqi[cqi + 1] < s))
+    {
+      ++cqi;
+    }
+  return cqi;
+}
+
+void
+LteAmcMappingTestCase::DoRun (void)
+{
+  Ptr<LteAmc> amc = CreateObject<LteAmc> ();
+
+  for (int cqi = 0; cqi <= 15; ++cqi)
+    {
+      int mcs = 0;
+      while ((mcs < 28) && (g_amcTestSpectralEfficiencyForMcs[mcs + 1] <= g_amcTestSpectralEfficiencyForCqi[cqi]))
+        {
+          ++mcs;
+        }
+      NS_TEST_ASSERT_MSG_EQ (amc->GetMcsFromCqi (cqi), mcs, "wrong MCS for CQI " << cqi);
+      // the spectral efficiencies of the tables are on the boundaries
+      NS_TEST_ASSERT_MSG_EQ (amc->GetCqiFromSpectralEfficiency (g_amcTestSpectralEfficiencyForCqi[cqi]),
+                             ReferenceCqiFromSpectralEfficiency (g_amcTestSpectralEfficiencyForCqi[cqi]),
+                             "wrong CQI for the spectral efficiency of CQI " << cqi);
+    }
+  for (int mcs = 0; mcs <= 28; ++mcs)
+    {
+      double s = g_amcTestSpectralEfficiencyForMcs[mcs];
+      NS_TEST_ASSERT_MSG_EQ (amc->GetCqiFromSpectralEfficiency (s), ReferenceCqiFromSpectralEfficiency (s),
+                             "wrong CQI for the spectral efficiency of MCS " << mcs);
+    }
+  for (int i = 0; i <= 7000; ++i)
+    {
+      double s = i * 0.001;
+      NS_TEST_ASSERT_MSG_EQ (amc->GetCqiFromSpectralEfficiency (s), ReferenceCqiFromSpectralEfficiency (s),
+                             "wrong CQI for spectral efficiency " << s);
+    }
+}
+
+/**
+ * \ingroup lte-test
+ * \ingroup tests
+ *
+ * \brief Check the CQIs of the PiroEW2010 model of LteAmc, which compares the
+ * SINR with precomputed thresholds, against the spectral efficiency
+ * formula, for several BERs
+ */
+class LteAmcPiroCqiTestCase : public TestCase
+{
+public:
+  LteAmcPiroCqiTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+LteAmcPiroCqiTestCase::LteAmcPiroCqiTestCase ()
+  : TestCase ("Check the CQIs of the PiroEW2010 model of LteAmc")
+{
+}
+
+void
+LteAmcPiroCqiTestCase::DoRun (void)
+{
+  const uint16_t nRbs = 100;
+  Ptr<LteAmc> amc = CreateObject<LteAmc> ();
+  amc->SetAttribute ("AmcModel", EnumValue (LteAmc::PiroEW2010));
+
+  // the BER changes after the thresholds were computed for the first one
+  const double bers[] = { 0.00005, 0.001, 0.00005 };
+  for (uint32_t b = 0; b < sizeof (bers) / sizeof (double); ++b)
+    {
+      amc->SetAttribute ("Ber", DoubleValue (bers[b]));
+      for (int offset = 0; offset < 20; ++offset)
+        {
+          // from -15 dB to 35 dB, with a few RBs without signal
+          SpectrumValue sinr (LteSpectrumValueHelper::GetSpectrumModel (100, nRbs));
+          for (uint16_t rb = 0; rb < nRbs; ++rb)
+            {
+              sinr[rb] = (rb % 37 == 36) ? 0.0 : std::pow (10.0, (-15.0 + 0.5 * rb + 0.023 * offset) / 10.0);
+            }
+          std::vector<int> cqis = amc->CreateCqiFeedbacks (sinr);
+          NS_TEST_ASSERT_MSG_EQ (cqis.size (), nRbs, "wrong number of CQIs");
+          for (uint16_t rb = 0; rb < nRbs; ++rb)
+            {
+              int cqi = -1;
+              if (sinr[rb] != 0.0)
+                {
+                  double s = log2 (1 + (sinr[rb] / ((-std::log (5.0 * bers[b])) / 1.5)));
+                  cqi = amc->GetCqiFromSpectralEfficiency (s);
+                }
+              NS_TEST_ASSERT_MSG_EQ (cqis[rb], cqi, "wrong CQI for SINR " << sinr[rb] << " and BER " << bers[b]);
+            }
+        }
+    }
+}
+
+/**
+ * \ingroup lte-test
+ * \ingroup tests
+ *
+ * \brief Test suite of LteAmc
+ */
+class LteAmcTestSuite : public TestSuite
+{
+public:
+  LteAmcTestSuite ();
+};
+
+LteAmcTestSuite::LteAmcTestSuite ()
+  : TestSuite ("lte-amc", UNIT)
+{
+  AddTestCase (new LteAmcMappingTestCase, TestCase::QUICK);
+  AddTestCase (new LteAmcPiroCqiTestCase, TestCase::QUICK);
+}
+
+static LteAmcTestSuite g_lteAmcTestSuite; ///< the test suite
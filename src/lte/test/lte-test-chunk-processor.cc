@@ -0,0 +1,217 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <ns3/test.h>
+#include <ns3/log.h>
+#include <ns3/simulator.h>
+#include <ns3/spectrum-value.h>
+#include <ns3/lte-interference.h>
+#include <ns3/lte-chunk-processor.h>
+#include <cmath>
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("LteChunkProcessorTest");
+
+/**
+ * \ingroup lte-test
+ * \ingroup tests
+ *
+ * \brief Check the SINR, the interference and the power of the received
+ * signal which LteInterference passes to its chunk processors, and their
+ * time average, for consecutive receptions with interferers starting and
+ * ending during the reception, and after a change of spectrum model
+ */
+class LteChunkProcessorTestCase : public TestCase
+{
+public:
+  LteChunkProcessorTestCase ();
+
+private:
+  virtual void DoRun (void);
+
+  /**
+   * Create a spectrum value
+   * \param sm the spectrum model
+   * \param value the value of the first band, multiplied by the band index
+   * plus one for the other bands
+   * \return the spectrum value
+   */
+  static Ptr<SpectrumValue> CreateValue (Ptr<const SpectrumModel> sm, double value);
+  /**
+   * Start a reception, as LteSpectrumPhy does
+   * \param rx the power spectral density of the signal of interest
+   * \param duration the duration of the signal
+   */
+  void StartRx (Ptr<SpectrumValue> rx, Time duration);
+  /**
+   * Check the values reported at the end of a reception
+   * \param sinr the expected SINR
+   * \param interf the expected interference plus noise
+   * \param rsPower the expected power of the received signal
+   */
+  void Check (SpectrumValue sinr, SpectrumValue interf, SpectrumValue rsPower);
+  /**
+   * Check a reported value
+   * \param actual the reported value
+   * \param expected the expected value
+   * \param what the name of the value
+   */
+  void CheckValue (Ptr<SpectrumValue> actual, const SpectrumValue &expected, std::string what);
+
+  Ptr<LteInterference> m_interference; ///< the interference model
+  LteSpectrumValueCatcher m_sinr; ///< the catcher of the SINR
+  LteSpectrumValueCatcher m_interf; ///< the catcher of the interference
+  LteSpectrumValueCatcher m_rsPower; ///< the catcher of the power of the received signal
+  uint32_t m_nChecks; ///< the number of checks
+};
+
+LteChunkProcessorTestCase::LteChunkProcessorTestCase ()
+  : TestCase ("Check the chunks evaluated by LteInterference"),
+    m_nChecks (0)
+{
+}
+
+Ptr<SpectrumValue>
+LteChunkProcessorTestCase::CreateValue (Ptr<const SpectrumModel> sm, double value)
+{
+  Ptr<SpectrumValue> v = Create<SpectrumValue> (sm);
+  for (uint32_t i = 0; i < sm->GetNumBands (); ++i)
+    {
+      (*v)[i] = value * (i + 1);
+    }
+  return v;
+}
+
+void
+LteChunkProcessorTestCase::StartRx (Ptr<SpectrumValue> rx, Time duration)
+{
+  m_interference->AddSignal (rx, duration);
+  m_interference->StartRx (rx);
+  Simulator::Schedule (duration, &LteInterference::EndRx, m_interference);
+}
+
+void
+LteChunkProcessorTestCase::CheckValue (Ptr<SpectrumValue> actual, const SpectrumValue &expected, std::string what)
+{
+  NS_TEST_ASSERT_MSG_NE (actual, 0, "no " << what << " reported");
+  NS_TEST_ASSERT_MSG_EQ (actual->GetSpectrumModel (), expected.GetSpectrumModel (), "wrong spectrum model of the " << what);
+  for (uint32_t i = 0; i < expected.GetSpectrumModel ()->GetNumBands (); ++i)
+    {
+      NS_TEST_ASSERT_MSG_EQ_TOL ((*actual)[i], expected[i], std::abs (expected[i]) * 1e-12,
+                                 "wrong " << what << " in band " << i << " of check " << m_nChecks);
+    }
+}
+
+void
+LteChunkProcessorTestCase::Check (SpectrumValue sinr, SpectrumValue interf, SpectrumValue rsPower)
+{
+  CheckValue (m_sinr.GetValue (), sinr, "SINR");
+  CheckValue (m_interf.GetValue (), interf, "interference");
+  CheckValue (m_rsPower.GetValue (), rsPower, "power of the received signal");
+  ++m_nChecks;
+}
+
+void
+LteChunkProcessorTestCase::DoRun (void)
+{
+  m_interference = CreateObject<LteInterference> ();
+  Ptr<LteChunkProcessor> p = Create<LteChunkProcessor> ();
+  p->AddCallback (MakeCallback (&LteSpectrumValueCatcher::ReportValue, &m_sinr));
+  m_interference->AddSinrChunkProcessor (p);
+  p = Create<LteChunkProcessor> ();
+  p->AddCallback (MakeCallback (&LteSpectrumValueCatcher::ReportValue, &m_interf));
+  m_interference->AddInterferenceChunkProcessor (p);
+  p = Create<LteChunkProcessor> ();
+  p->AddCallback (MakeCallback (&LteSpectrumValueCatcher::ReportValue, &m_rsPower));
+  m_interference->AddRsPowerChunkProcessor (p);
+
+  Bands bands;
+  for (uint32_t i = 0; i < 4; ++i)
+    {
+      BandInfo bi;
+      bi.fl = 2.1e9 + i * 180e3;
+      bi.fc = bi.fl + 90e3;
+      bi.fh = bi.fl + 180e3;
+      bands.push_back (bi);
+    }
+  Ptr<SpectrumModel> sm1 = Create<SpectrumModel> (bands);
+  bands.pop_back ();
+  Ptr<SpectrumModel> sm2 = Create<SpectrumModel> (bands);
+
+  Ptr<SpectrumValue> noise1 = CreateValue (sm1, 1e-19);
+  Ptr<SpectrumValue> noise2 = CreateValue (sm2, 3e-19);
+  m_interference->SetNoisePowerSpectralDensity (noise1);
+
+  // first RX: the interferer b is received in the middle of the signal
+  Ptr<SpectrumValue> s = CreateValue (sm1, 4e-16);
+  Ptr<SpectrumValue> a = CreateValue (sm1, 2e-17);
+  Ptr<SpectrumValue> b = CreateValue (sm1, 5e-17);
+  Simulator::Schedule (MicroSeconds (0), &LteChunkProcessorTestCase::StartRx, this, s, MicroSeconds (1000));
+  Simulator::Schedule (MicroSeconds (0), &LteInterference::AddSignal, m_interference, a, MicroSeconds (1000));
+  Simulator::Schedule (MicroSeconds (300), &LteInterference::AddSignal, m_interference, b, MicroSeconds (300));
+  SpectrumValue interfA = (*a) + (*noise1);
+  SpectrumValue interfAb = (*a) + (*b) + (*noise1);
+  SpectrumValue interf1 = (interfA * 0.7 + interfAb * 0.3);
+  SpectrumValue sinr1 = (((*s) / interfA) * 0.7 + ((*s) / interfAb) * 0.3);
+  Simulator::Schedule (MicroSeconds (1001), &LteChunkProcessorTestCase::Check, this, sinr1, interf1, *s);
+
+  // second RX: a single chunk, which overwrites the values of the first RX
+  Ptr<SpectrumValue> s2 = CreateValue (sm1, 1e-16);
+  Ptr<SpectrumValue> c = CreateValue (sm1, 3e-17);
+  Simulator::Schedule (MicroSeconds (2000), &LteChunkProcessorTestCase::StartRx, this, s2, MicroSeconds (1000));
+  Simulator::Schedule (MicroSeconds (2000), &LteInterference::AddSignal, m_interference, c, MicroSeconds (1000));
+  SpectrumValue interf2 = (*c) + (*noise1);
+  SpectrumValue sinr2 = (*s2) / interf2;
+  Simulator::Schedule (MicroSeconds (3001), &LteChunkProcessorTestCase::Check, this, sinr2, interf2, *s2);
+
+  // third RX, after a change of the spectrum model, e.g., at handover
+  Simulator::Schedule (MicroSeconds (4000), &LteInterference::SetNoisePowerSpectralDensity, m_interference, noise2);
+  Ptr<SpectrumValue> s3 = CreateValue (sm2, 6e-16);
+  Ptr<SpectrumValue> d = CreateValue (sm2, 1e-17);
+  Simulator::Schedule (MicroSeconds (5000), &LteChunkProcessorTestCase::StartRx, this, s3, MicroSeconds (1000));
+  Simulator::Schedule (MicroSeconds (5500), &LteInterference::AddSignal, m_interference, d, MicroSeconds (1000));
+  SpectrumValue interfNone = *noise2;
+  SpectrumValue interfD = (*d) + (*noise2);
+  SpectrumValue interf3 = (interfNone * 0.5 + interfD * 0.5);
+  SpectrumValue sinr3 = (((*s3) / interfNone) * 0.5 + ((*s3) / interfD) * 0.5);
+  Simulator::Schedule (MicroSeconds (6001), &LteChunkProcessorTestCase::Check, this, sinr3, interf3, *s3);
+
+  Simulator::Run ();
+  Simulator::Destroy ();
+  m_interference->Dispose ();
+  NS_TEST_ASSERT_MSG_EQ (m_nChecks, 3, "some checks were not done");
+}
+
+/**
+ * \ingroup lte-test
+ * \ingroup tests
+ *
+ * \brief Test suite of the chunk processors of LteInterference
+ */
+class LteChunkProcessorTestSuite : public TestSuite
+{
+public:
+  LteChunkProcessorTestSuite ();
+};
+
+LteChunkProcessorTestSuite::LteChunkProcessorTestSuite ()
+  : TestSuite ("lte-chunk-processor", UNIT)
+{
+  AddTestCase (new LteChunkProcessorTestCase, TestCase::QUICK);
+}
+
+static LteChunkProcessorTestSuite g_lteChunkProcessorTestSuite; ///< the test suite
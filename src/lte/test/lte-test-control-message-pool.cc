@@ -0,0 +1,231 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <ns3/test.h>
+#include <ns3/log.h>
+#include <ns3/simulator.h>
+#include <ns3/config.h>
+#include <ns3/uinteger.h>
+#include <ns3/node-container.h>
+#include <ns3/net-device-container.h>
+#include <ns3/mobility-helper.h>
+#include <ns3/lte-helper.h>
+#include <ns3/eps-bearer.h>
+#include <ns3/lte-control-messages.h>
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("LteControlMessagePoolTest");
+
+/**
+ * \ingroup lte-test
+ * \ingroup tests
+ *
+ * \brief Check that the control messages of a pool are recycled once their
+ * last reference is released, and keep their content
+ */
+class LteControlMessagePoolTestCase : public TestCase
+{
+public:
+  LteControlMessagePoolTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+LteControlMessagePoolTestCase::LteControlMessagePoolTestCase ()
+  : TestCase ("Check the recycling of the control messages")
+{
+}
+
+void
+LteControlMessagePoolTestCase::DoRun (void)
+{
+  typedef LteControlMessagePool<DlDciLteControlMessage> Pool;
+
+  DlDciListElement_s dci;
+  dci.m_rnti = 7;
+  dci.m_tbsSize.push_back (1000);
+  dci.m_mcs.push_back (20);
+
+  Ptr<DlDciLteControlMessage> msg = Pool::Get ();
+  msg->SetDci (dci);
+  DlDciLteControlMessage *raw = PeekPointer (msg);
+  Ptr<LteControlMessage> base = msg;
+  msg = 0;
+  NS_TEST_ASSERT_MSG_EQ (base->GetReferenceCount (), 1, "wrong reference count");
+  base = 0;
+
+  // the message released last is taken first
+  uint64_t allocations = Pool::GetAllocations ();
+  uint64_t requests = Pool::GetRequests ();
+  msg = Pool::Get ();
+  NS_TEST_ASSERT_MSG_EQ (PeekPointer (msg), raw, "the message was not recycled");
+  NS_TEST_ASSERT_MSG_EQ (msg->GetReferenceCount (), 1, "wrong reference count of a recycled message");
+  NS_TEST_ASSERT_MSG_EQ (msg->GetMessageType (), LteControlMessage::DL_DCI, "wrong type of a recycled message");
+  NS_TEST_ASSERT_MSG_EQ (msg->GetDci ().m_rnti, 7, "the content of a recycled message was lost");
+  NS_TEST_ASSERT_MSG_EQ (msg->GetDci ().m_tbsSize.size (), 1, "the content of a recycled message was lost");
+  NS_TEST_ASSERT_MSG_EQ (Pool::GetAllocations (), allocations, "a message was allocated");
+  NS_TEST_ASSERT_MSG_EQ (Pool::GetRequests (), requests + 1, "the request was not counted");
+
+  // the pool is empty, so a new message is allocated
+  Ptr<DlDciLteControlMessage> other = Pool::Get ();
+  NS_TEST_ASSERT_MSG_NE (PeekPointer (other), raw, "the message was taken twice");
+  NS_TEST_ASSERT_MSG_EQ (Pool::GetAllocations (), allocations + 1, "the allocation was not counted");
+
+  // a message which was not taken from the pool is recycled as well
+  msg = 0;
+  other = 0;
+  Ptr<DlDciLteControlMessage> created = Create<DlDciLteControlMessage> ();
+  raw = PeekPointer (created);
+  created = 0;
+  msg = Pool::Get ();
+  NS_TEST_ASSERT_MSG_EQ (PeekPointer (msg), raw, "the created message was not recycled");
+
+  // the messages which are not pooled are deleted, as before
+  Ptr<RachPreambleLteControlMessage> rach = Create<RachPreambleLteControlMessage> ();
+  rach->SetRapId (3);
+  rach = 0;
+}
+
+/**
+ * \ingroup lte-test
+ * \ingroup tests
+ *
+ * \brief Check that in steady state the control plane of a cell with 100
+ * saturated UEs does not allocate DL-DCI, UL-DCI, DL-CQI, BSR and DL HARQ
+ * feedback messages, which are all taken from their pool
+ */
+class LteControlMessagePoolSteadyStateTestCase : public TestCase
+{
+public:
+  LteControlMessagePoolSteadyStateTestCase ();
+
+private:
+  virtual void DoRun (void);
+
+  /// the number of message types which are pooled
+  static const uint32_t N_POOLS = 5;
+
+  /**
+   * Get the counters of the pools
+   * \param allocations the number of messages allocated by each pool
+   * \param requests the number of messages taken from each pool
+   */
+  static void GetCounters (uint64_t allocations[N_POOLS], uint64_t requests[N_POOLS]);
+  /**
+   * Record the counters of the pools, once the UEs are connected
+   */
+  void RecordCounters (void);
+
+  uint64_t m_allocations[N_POOLS]; ///< the number of messages allocated once the UEs are connected
+  uint64_t m_requests[N_POOLS]; ///< the number of messages taken once the UEs are connected
+};
+
+LteControlMessagePoolSteadyStateTestCase::LteControlMessagePoolSteadyStateTestCase ()
+  : TestCase ("Check that the control messages of 100 UEs are not allocated in steady state")
+{
+}
+
+void
+LteControlMessagePoolSteadyStateTestCase::GetCounters (uint64_t allocations[N_POOLS], uint64_t requests[N_POOLS])
+{
+  allocations[0] = LteControlMessagePool<DlDciLteControlMessage>::GetAllocations ();
+  requests[0] = LteControlMessagePool<DlDciLteControlMessage>::GetRequests ();
+  allocations[1] = LteControlMessagePool<UlDciLteControlMessage>::GetAllocations ();
+  requests[1] = LteControlMessagePool<UlDciLteControlMessage>::GetRequests ();
+  allocations[2] = LteControlMessagePool<DlCqiLteControlMessage>::GetAllocations ();
+  requests[2] = LteControlMessagePool<DlCqiLteControlMessage>::GetRequests ();
+  allocations[3] = LteControlMessagePool<BsrLteControlMessage>::GetAllocations ();
+  requests[3] = LteControlMessagePool<BsrLteControlMessage>::GetRequests ();
+  allocations[4] = LteControlMessagePool<DlHarqFeedbackLteControlMessage>::GetAllocations ();
+  requests[4] = LteControlMessagePool<DlHarqFeedbackLteControlMessage>::GetRequests ();
+}
+
+void
+LteControlMessagePoolSteadyStateTestCase::RecordCounters (void)
+{
+  GetCounters (m_allocations, m_requests);
+}
+
+void
+LteControlMessagePoolSteadyStateTestCase::DoRun (void)
+{
+  const uint32_t nUes = 100;
+  const char *names[N_POOLS] = { "DL-DCI", "UL-DCI", "DL-CQI", "BSR", "DL HARQ feedback" };
+
+  Config::SetDefault ("ns3::LteEnbRrc::SrsPeriodicity", UintegerValue (160));
+  Ptr<LteHelper> lteHelper = CreateObject<LteHelper> ();
+  NodeContainer enbNodes;
+  NodeContainer ueNodes;
+  enbNodes.Create (1);
+  ueNodes.Create (nUes);
+  MobilityHelper mobility;
+  mobility.SetMobilityModel ("ns3::ConstantPositionMobilityModel");
+  mobility.Install (enbNodes);
+  mobility.Install (ueNodes);
+  for (uint32_t i = 0; i < nUes; ++i)
+    {
+      ueNodes.Get (i)->GetObject<MobilityModel> ()->SetPosition (Vector (50.0 + 5.0 * i, 0, 0));
+    }
+
+  NetDeviceContainer enbDevs = lteHelper->InstallEnbDevice (enbNodes);
+  NetDeviceContainer ueDevs = lteHelper->InstallUeDevice (ueNodes);
+  lteHelper->AssignStreams (enbDevs, 1);
+  lteHelper->AssignStreams (ueDevs, 100);
+  lteHelper->Attach (ueDevs, enbDevs.Get (0));
+  // saturated RLC SM bearers in both directions
+  lteHelper->ActivateDataRadioBearer (ueDevs, EpsBearer (EpsBearer::NGBR_VIDEO_TCP_DEFAULT));
+
+  Simulator::Schedule (Seconds (0.3), &LteControlMessagePoolSteadyStateTestCase::RecordCounters, this);
+  Simulator::Stop (Seconds (0.5));
+  Simulator::Run ();
+
+  uint64_t allocations[N_POOLS];
+  uint64_t requests[N_POOLS];
+  GetCounters (allocations, requests);
+  for (uint32_t i = 0; i < N_POOLS; ++i)
+    {
+      NS_LOG_INFO (names[i] << ": " << requests[i] - m_requests[i] << " messages, "
+                            << allocations[i] - m_allocations[i] << " allocations in steady state, "
+                            << allocations[i] << " allocations in total");
+      NS_TEST_ASSERT_MSG_GT (requests[i], m_requests[i], "no " << names[i] << " messages were sent");
+      NS_TEST_ASSERT_MSG_EQ (allocations[i], m_allocations[i], names[i] << " messages were allocated in steady state");
+    }
+  Simulator::Destroy ();
+  Config::SetDefault ("ns3::LteEnbRrc::SrsPeriodicity", UintegerValue (40));
+}
+
+/**
+ * \ingroup lte-test
+ * \ingroup tests
+ *
+ * \brief Test suite of the pools of control messages
+ */
+class LteControlMessagePoolTestSuite : public TestSuite
+{
+public:
+  LteControlMessagePoolTestSuite ();
+};
+
+LteControlMessagePoolTestSuite::LteControlMessagePoolTestSuite ()
+  : TestSuite ("lte-control-message-pool", SYSTEM)
+{
+  AddTestCase (new LteControlMessagePoolTestCase, TestCase::QUICK);
+  AddTestCase (new LteControlMessagePoolSteadyStateTestCase, TestCase::QUICK);
+}
+
+static LteControlMessagePoolTestSuite g_lteControlMessagePoolTestSuite; ///< the test suite
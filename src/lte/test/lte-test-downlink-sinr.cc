@@ -323,7 +323,7 @@ LteDownlinkCtrlSinrTestCase::DoRun (void)
   const int numOfCtrlMsgs = 10;
   
   // control messages in the list
-  std::list<Ptr<LteControlMessage> > ctrlMsgList[numOfUes];
+  std::vector<Ptr<LteControlMessage> > ctrlMsgList[numOfUes];
   
   // signals cellId
   uint16_t pbCellId[numOfUes];
@@ -0,0 +1,236 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <ns3/test.h>
+#include <ns3/log.h>
+#include <ns3/simulator.h>
+#include <ns3/config.h>
+#include <ns3/boolean.h>
+#include <ns3/uinteger.h>
+#include <ns3/double.h>
+#include <ns3/node-container.h>
+#include <ns3/net-device-container.h>
+#include <ns3/mobility-helper.h>
+#include <ns3/lte-helper.h>
+#include <ns3/lte-common.h>
+#include <ns3/eps-bearer.h>
+#include <ns3/spectrum-channel.h>
+#include <ns3/spectrum-signal-parameters.h>
+#include <sstream>
+#include <vector>
+#include <algorithm>
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("LteIdleSubframeSkippingTest");
+
+/**
+ * \ingroup lte-test
+ * \ingroup tests
+ *
+ * \brief Check that the IdleSubframeSkipping attribute of LteEnbPhy does not
+ * change the connection of the UEs and the DL scheduling, and that it reduces
+ * the number of DL transmissions
+ *
+ * Two cells on different carriers are simulated twice, without and with the
+ * idle subframe skipping.  A UE attaches to the first cell at the start, and
+ * another one attaches to the second cell, which was idle, in the middle of
+ * a subframe.
+ */
+class LteIdleSubframeSkippingTestCase : public TestCase
+{
+public:
+  LteIdleSubframeSkippingTestCase ();
+  virtual ~LteIdleSubframeSkippingTestCase ();
+
+private:
+  virtual void DoRun (void);
+  /**
+   * Run the simulation
+   * \param skipping the value of the IdleSubframeSkipping attribute
+   * \param events the DL scheduling events and the connections, in order
+   * \return the number of DL transmissions
+   */
+  uint32_t RunSimulation (bool skipping, std::vector<std::string> &events);
+  /**
+   * Attach a UE to an eNB and activate a data radio bearer
+   * \param lteHelper the helper
+   * \param ueDevice the UE device
+   * \param enbDevice the eNB device
+   */
+  static void Attach (Ptr<LteHelper> lteHelper, Ptr<NetDevice> ueDevice, Ptr<NetDevice> enbDevice);
+  /**
+   * Record a DL scheduling event
+   * \param context the trace context
+   * \param info the DL scheduling info
+   */
+  void DlScheduling (std::string context, DlSchedulingCallbackInfo info);
+  /**
+   * Record a connection
+   * \param context the trace context
+   * \param imsi the IMSI
+   * \param cellId the cell ID
+   * \param rnti the RNTI
+   */
+  void ConnectionEstablished (std::string context, uint64_t imsi, uint16_t cellId, uint16_t rnti);
+  /**
+   * Count a DL transmission
+   * \param params the parameters of the transmitted signal
+   */
+  void DlTransmission (Ptr<SpectrumSignalParameters> params);
+
+  std::vector<std::string> *m_events; ///< the events of the current simulation
+  uint32_t m_nConnections; ///< the number of connections of the current simulation
+  uint32_t m_nDlTransmissions; ///< the number of DL transmissions of the current simulation
+};
+
+LteIdleSubframeSkippingTestCase::LteIdleSubframeSkippingTestCase ()
+  : TestCase ("Check the idle subframe skipping of the eNB"),
+    m_events (0),
+    m_nConnections (0),
+    m_nDlTransmissions (0)
+{
+}
+
+LteIdleSubframeSkippingTestCase::~LteIdleSubframeSkippingTestCase ()
+{
+}
+
+void
+LteIdleSubframeSkippingTestCase::Attach (Ptr<LteHelper> lteHelper, Ptr<NetDevice> ueDevice, Ptr<NetDevice> enbDevice)
+{
+  lteHelper->Attach (ueDevice, enbDevice);
+  lteHelper->ActivateDataRadioBearer (ueDevice, EpsBearer (EpsBearer::NGBR_VIDEO_TCP_DEFAULT));
+}
+
+void
+LteIdleSubframeSkippingTestCase::DlScheduling (std::string context, DlSchedulingCallbackInfo info)
+{
+  std::ostringstream oss;
+  oss << Simulator::Now ().GetTimeStep () << " " << context << " frame " << info.frameNo
+      << " subframe " << info.subframeNo << " rnti " << info.rnti
+      << " mcs " << (uint32_t) info.mcsTb1 << " size " << info.sizeTb1;
+  m_events->push_back (oss.str ());
+}
+
+void
+LteIdleSubframeSkippingTestCase::ConnectionEstablished (std::string context, uint64_t imsi, uint16_t cellId, uint16_t rnti)
+{
+  std::ostringstream oss;
+  oss << Simulator::Now ().GetTimeStep () << " imsi " << imsi << " connected to cell " << cellId
+      << " rnti " << rnti;
+  m_events->push_back (oss.str ());
+  ++m_nConnections;
+}
+
+void
+LteIdleSubframeSkippingTestCase::DlTransmission (Ptr<SpectrumSignalParameters> params)
+{
+  ++m_nDlTransmissions;
+}
+
+uint32_t
+LteIdleSubframeSkippingTestCase::RunSimulation (bool skipping, std::vector<std::string> &events)
+{
+  Config::SetDefault ("ns3::LteEnbPhy::IdleSubframeSkipping", BooleanValue (skipping));
+  m_events = &events;
+  m_nConnections = 0;
+  m_nDlTransmissions = 0;
+
+  Ptr<LteHelper> lteHelper = CreateObject<LteHelper> ();
+  NodeContainer enbNodes;
+  NodeContainer ueNodes;
+  enbNodes.Create (2);
+  ueNodes.Create (2);
+  MobilityHelper mobility;
+  mobility.SetMobilityModel ("ns3::ConstantPositionMobilityModel");
+  mobility.Install (enbNodes);
+  mobility.Install (ueNodes);
+  ueNodes.Get (0)->GetObject<MobilityModel> ()->SetPosition (Vector (100, 0, 0));
+  enbNodes.Get (1)->GetObject<MobilityModel> ()->SetPosition (Vector (1000, 0, 0));
+  ueNodes.Get (1)->GetObject<MobilityModel> ()->SetPosition (Vector (1200, 0, 0));
+
+  NetDeviceContainer enbDevs;
+  lteHelper->SetEnbDeviceAttribute ("DlEarfcn", UintegerValue (100));
+  lteHelper->SetEnbDeviceAttribute ("UlEarfcn", UintegerValue (18100));
+  enbDevs.Add (lteHelper->InstallEnbDevice (enbNodes.Get (0)));
+  lteHelper->SetEnbDeviceAttribute ("DlEarfcn", UintegerValue (500));
+  lteHelper->SetEnbDeviceAttribute ("UlEarfcn", UintegerValue (18500));
+  enbDevs.Add (lteHelper->InstallEnbDevice (enbNodes.Get (1)));
+  NetDeviceContainer ueDevs = lteHelper->InstallUeDevice (ueNodes);
+  lteHelper->AssignStreams (enbDevs, 1);
+  lteHelper->AssignStreams (ueDevs, 100);
+
+  Attach (lteHelper, ueDevs.Get (0), enbDevs.Get (0));
+  // attach in the middle of a subframe of the idle cell
+  Simulator::Schedule (MicroSeconds (300400), &LteIdleSubframeSkippingTestCase::Attach,
+                       lteHelper, ueDevs.Get (1), enbDevs.Get (1));
+
+  Config::Connect ("/NodeList/*/DeviceList/*/ComponentCarrierMap/*/LteEnbMac/DlScheduling",
+                   MakeCallback (&LteIdleSubframeSkippingTestCase::DlScheduling, this));
+  Config::Connect ("/NodeList/*/DeviceList/*/LteUeRrc/ConnectionEstablished",
+                   MakeCallback (&LteIdleSubframeSkippingTestCase::ConnectionEstablished, this));
+  lteHelper->GetDownlinkSpectrumChannel ()->TraceConnectWithoutContext ("TxSigParams",
+                                                                        MakeCallback (&LteIdleSubframeSkippingTestCase::DlTransmission, this));
+
+  Simulator::Stop (Seconds (0.5));
+  Simulator::Run ();
+  Simulator::Destroy ();
+  m_events = 0;
+  NS_TEST_EXPECT_MSG_EQ (m_nConnections, 2, "the UEs did not connect");
+  return m_nDlTransmissions;
+}
+
+void
+LteIdleSubframeSkippingTestCase::DoRun (void)
+{
+  std::vector<std::string> events;
+  std::vector<std::string> skippingEvents;
+  uint32_t nTransmissions = RunSimulation (false, events);
+  uint32_t nSkippingTransmissions = RunSimulation (true, skippingEvents);
+  Config::Reset ();
+
+  // the events of the two cells at the same time may be in any order
+  std::sort (events.begin (), events.end ());
+  std::sort (skippingEvents.begin (), skippingEvents.end ());
+
+  NS_TEST_ASSERT_MSG_EQ (skippingEvents.size (), events.size (), "different number of events");
+  for (uint32_t i = 0; i < events.size () && i < skippingEvents.size (); ++i)
+    {
+      NS_TEST_ASSERT_MSG_EQ (skippingEvents[i], events[i], "different event " << i);
+    }
+  NS_TEST_ASSERT_MSG_LT (nSkippingTransmissions, nTransmissions, "the idle subframes were not skipped");
+}
+
+/**
+ * \ingroup lte-test
+ * \ingroup tests
+ *
+ * \brief Test suite for the idle subframe skipping of the eNB
+ */
+class LteIdleSubframeSkippingTestSuite : public TestSuite
+{
+public:
+  LteIdleSubframeSkippingTestSuite ();
+};
+
+LteIdleSubframeSkippingTestSuite::LteIdleSubframeSkippingTestSuite ()
+  : TestSuite ("lte-idle-subframe-skipping", SYSTEM)
+{
+  AddTestCase (new LteIdleSubframeSkippingTestCase, TestCase::QUICK);
+}
+
+static LteIdleSubframeSkippingTestSuite g_lteIdleSubframeSkippingTestSuite; ///< the test suite
@@ -0,0 +1,314 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <ns3/test.h>
+#include <ns3/log.h>
+#include <ns3/lte-amc.h>
+#include <ns3/lte-mi-error-model.h>
+#include <ns3/lte-spectrum-value-helper.h>
+#include <ns3/spectrum-value.h>
+#include <cmath>
+#include <vector>
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("LteMiErrorModelTest");
+
+/// the number of RBs of the SINR profiles
+static const uint16_t g_miErrorModelTestRbs = 25;
+
+/// the MCSs of the reference TBs; the MI of the past transmission of a
+/// retransmitted TB depends on the index of its MCS
+static const uint8_t g_miErrorModelTestMcs[] = { 0, 4, 9, 10, 14, 16, 17, 22, 28 };
+
+/// a reference TB error rate and MI, found with the error model as it was
+/// before the MI tables were looked up in batch
+struct MiErrorModelTbReference
+{
+  uint8_t sinrProfile; ///< the index of the SINR profile
+  uint8_t mapType; ///< 0: all the RBs, 1: the first 6 RBs, 2: the odd RBs
+  uint8_t mcs; ///< the MCS
+  uint8_t harq; ///< whether the TB is a retransmission
+  double tbler; ///< the reference TB error rate
+  double mi; ///< the reference MI
+};
+
+/// the reference PCFICH+PDCCH error rate of a SINR profile
+struct MiErrorModelPdcchReference
+{
+  uint8_t sinrProfile; ///< the index of the SINR profile
+  double error; ///< the reference error rate
+};
+
+/// reference TBs, mostly with error rates strictly between 0 and 1
+static const MiErrorModelTbReference g_miErrorModelTbReferences[] = {
+  { 0, 0, 14, 1, 0.41233395842188836, 0.086993120000000021 },
+  { 0, 1, 9, 1, 0.99300368117772209, 0.23849483333333332 },
+  { 0, 2, 4, 0, 0.99994991172232961, 0.19875508333333333 },
+  { 1, 0, 4, 0, 0.99998071732312377, 0.21379748000000004 },
+  { 1, 1, 9, 1, 0.97324555980418292, 0.26157866666666668 },
+  { 1, 2, 4, 0, 0.99726535577224107, 0.21855141666666664 },
+  { 1, 2, 17, 1, 0.88700066826462332, 0.065518333333333331 },
+  { 2, 1, 4, 0, 0.37674997075844358, 0.28611349999999997 },
+  { 2, 1, 17, 1, 0.85452807782392082, 0.080656666666666668 },
+  { 2, 2, 14, 1, 0.0083406649134281086, 0.10817216666666668 },
+  { 3, 0, 17, 1, 0.9132103117394722, 0.075404759999999987 },
+  { 3, 1, 14, 1, 0.0011051752979968077, 0.14307283333333334 },
+  { 3, 2, 10, 1, 0.9992162892715265, 0.11924766666666665 },
+  { 4, 0, 9, 1, 0.99969976785873116, 0.28096920000000003 },
+  { 4, 1, 9, 1, 0.5394824752361802, 0.34186133333333329 },
+  { 4, 2, 4, 0, 0.14370295250453569, 0.28693616666666671 },
+  { 4, 2, 17, 1, 0.48032441604434656, 0.084056166666666668 },
+  { 5, 1, 4, 0, 0.00010050462242050529, 0.3718871666666666 },
+  { 5, 1, 17, 1, 0.54446655730295079, 0.1045275 },
+  { 5, 2, 17, 1, 0.32572243721116073, 0.08997641666666667 },
+  { 6, 1, 9, 1, 0.094168936259586555, 0.40386583333333331 },
+  { 6, 2, 9, 1, 0.49103581478766084, 0.33993750000000006 },
+  { 7, 0, 10, 1, 0.99573136448289312, 0.16789560000000001 },
+  { 7, 1, 17, 1, 0.26455168589518002, 0.12325966666666666 },
+  { 8, 0, 9, 1, 1.6603941838666536e-05, 0.39123140000000001 },
+  { 8, 1, 9, 1, 0.0021934854225238443, 0.47107533333333335 },
+  { 8, 2, 10, 1, 0.15736281129236351, 0.18692166666666665 },
+  { 9, 1, 9, 0, 0.99975448204561457, 0.50632050000000006 },
+  { 9, 2, 9, 1, 0.00054872062804101063, 0.43029500000000004 },
+  { 10, 0, 17, 1, 0.00073172666820542354, 0.13303796000000001 },
+  { 10, 1, 17, 1, 0.01913379656917541, 0.15972466666666665 },
+  { 11, 0, 10, 1, 0.00086885011907944509, 0.23454804000000007 },
+  { 11, 1, 10, 1, 3.3397367569243386e-06, 0.28235083333333338 },
+  { 12, 1, 9, 0, 0.38859848189149948, 0.6163628333333333 },
+  { 13, 0, 9, 0, 0.99926900528359985, 0.55446947999999996 },
+  { 13, 2, 9, 0, 0.94955733208690662, 0.5638165833333334 },
+  { 14, 1, 17, 1, 5.1066855468739902e-06, 0.21888933333333335 },
+  { 15, 1, 10, 0, 0.55367449230204824, 0.37557400000000002 },
+  { 16, 2, 10, 0, 0.98394283386158521, 0.34518391666666676 },
+  { 18, 0, 10, 0, 0.46046384724119316, 0.38731324 },
+  { 19, 1, 14, 0, 0.99988847593075147, 0.48180099999999998 },
+  { 22, 1, 14, 0, 0.11687914386742315, 0.56723783333333333 },
+  { 23, 1, 16, 0, 0.99975265659625301, 0.59640799999999994 },
+  { 24, 1, 16, 0, 0.97306229053900894, 0.62565666666666664 },
+  { 25, 2, 16, 0, 0.99999840572178544, 0.59996641666666672 },
+  { 26, 2, 16, 0, 0.3153199674221619, 0.6611218333333333 },
+  { 29, 1, 17, 0, 0.13523153377372582, 0.52492416666666664 },
+  { 30, 2, 17, 0, 0.79952910164296753, 0.49229216666666664 },
+  { 32, 0, 17, 0, 0.0011467849403596908, 0.5312038 },
+  { 37, 1, 22, 0, 0.087252410333276909, 0.71286499999999997 },
+  { 39, 0, 22, 0, 0.9061394987330571, 0.69349379999999994 },
+  { 41, 0, 22, 0, 7.2979215145485554e-06, 0.73891175999999992 },
+  { 49, 1, 28, 0, 0.062207611253649486, 0.94480916666666659 },
+  { 51, 1, 28, 0, 1.2672866278040651e-06, 0.96730783333333326 },
+  { 53, 0, 28, 0, 0.061194978163576774, 0.94431411999999981 },
+  { 55, 2, 28, 0, 1.5014536863700023e-05, 0.96463216666666662 },
+  { 0, 0, 16, 0, 1, 0.086993120000000021 },
+  { 8, 1, 28, 1, 0, 0.13300399999999998 },
+  { 15, 2, 4, 0, 0, 0.6412863333333334 },
+  { 21, 2, 22, 0, 1, 0.30579308333333333 },
+  { 28, 0, 4, 1, 0, 0.96323164000000006 },
+  { 34, 0, 0, 1, 0, 1 },
+  { 39, 2, 14, 1, 0, 0.9586673333333332 },
+  { 45, 1, 16, 1, 0, 1 },
+  { 51, 0, 22, 0, 0, 0.92301415999999992 },
+  { 57, 0, 10, 1, 0, 1 },
+  { 62, 2, 10, 0, 0, 1 },
+};
+
+/// reference PCFICH+PDCCH error rates
+static const MiErrorModelPdcchReference g_miErrorModelPdcchReferences[] = {
+  { 0, 0.10911899999999999 },
+  { 1, 0.076924400000000004 },
+  { 2, 0.045497099999999999 },
+  { 3, 0.0310472 },
+  { 4, 0.017502299999999998 },
+  { 5, 0.0119524 },
+  { 6, 0.0081623600000000004 },
+  { 7, 0.0042047600000000001 },
+  { 8, 0.0026238500000000001 },
+  { 9, 0 },
+  { 10, 0 },
+};
+
+/**
+ * \ingroup lte-test
+ * \ingroup tests
+ *
+ * \brief Check the TB error rates and the MI found by LteMiErrorModel, one
+ * TB at a time, in batch and from the mmib, against reference values
+ *
+ * The SINR of the profile b in the RB i is -6 + 0.5 b + 4 sin (0.7 i) dB.
+ */
+class LteMiErrorModelTestCase : public TestCase
+{
+public:
+  LteMiErrorModelTestCase ();
+  virtual ~LteMiErrorModelTestCase ();
+
+private:
+  virtual void DoRun (void);
+  /**
+   * \param b the index of the SINR profile
+   * \return the SINR profile
+   */
+  static SpectrumValue GetSinr (uint8_t b);
+  /**
+   * \param mapType the type of map, see MiErrorModelTbReference
+   * \return the active RBs
+   */
+  static std::vector<int> GetMap (uint8_t mapType);
+  /**
+   * Build the parameters of a TB of a reference
+   * \param amc the AMC module which gives the TB size
+   * \param ref the reference
+   * \param map the active RBs
+   * \return the parameters of the TB
+   */
+  static TbErrorModelParams_t GetTb (Ptr<LteAmc> amc, const MiErrorModelTbReference &ref, const std::vector<int> &map);
+};
+
+LteMiErrorModelTestCase::LteMiErrorModelTestCase ()
+  : TestCase ("Check the TB error rates and the MI of LteMiErrorModel")
+{
+}
+
+LteMiErrorModelTestCase::~LteMiErrorModelTestCase ()
+{
+}
+
+SpectrumValue
+LteMiErrorModelTestCase::GetSinr (uint8_t b)
+{
+  SpectrumValue sinr (LteSpectrumValueHelper::GetSpectrumModel (100, g_miErrorModelTestRbs));
+  for (uint16_t rb = 0; rb < g_miErrorModelTestRbs; ++rb)
+    {
+      sinr[rb] = std::pow (10.0, ((-6.0 + 0.5 * b) + 4.0 * std::sin (rb * 0.7)) / 10.0);
+    }
+  return sinr;
+}
+
+std::vector<int>
+LteMiErrorModelTestCase::GetMap (uint8_t mapType)
+{
+  std::vector<int> map;
+  for (int rb = 0; rb < g_miErrorModelTestRbs; ++rb)
+    {
+      if (mapType == 0 || (mapType == 1 && rb < 6) || (mapType == 2 && rb % 2 == 1))
+        {
+          map.push_back (rb);
+        }
+    }
+  return map;
+}
+
+TbErrorModelParams_t
+LteMiErrorModelTestCase::GetTb (Ptr<LteAmc> amc, const MiErrorModelTbReference &ref, const std::vector<int> &map)
+{
+  TbErrorModelParams_t tb;
+  tb.map = &map;
+  tb.mcs = ref.mcs;
+  tb.size = amc->GetDlTbSizeFromMcs (ref.mcs, map.size ()) / 8;
+  if (ref.harq)
+    {
+      uint8_t k = 0;
+      while (g_miErrorModelTestMcs[k] != ref.mcs)
+        {
+          ++k;
+        }
+      HarqProcessInfoElement_t el;
+      el.m_mi = 0.2 + 0.05 * k;
+      el.m_rv = 0;
+      el.m_infoBits = tb.size * 8;
+      el.m_codeBits = tb.size * 8 * 2;
+      tb.miHistory.push_back (el);
+    }
+  return tb;
+}
+
+void
+LteMiErrorModelTestCase::DoRun (void)
+{
+  const double tolerance = 1e-12;
+  Ptr<LteAmc> amc = CreateObject<LteAmc> ();
+  std::vector<std::vector<int> > maps;
+  for (uint8_t mapType = 0; mapType < 3; ++mapType)
+    {
+      maps.push_back (GetMap (mapType));
+    }
+
+  uint32_t nRefs = sizeof (g_miErrorModelTbReferences) / sizeof (MiErrorModelTbReference);
+  uint32_t i = 0;
+  while (i < nRefs)
+    {
+      // the references with the same SINR profile are evaluated in a batch
+      uint8_t b = g_miErrorModelTbReferences[i].sinrProfile;
+      SpectrumValue sinr = GetSinr (b);
+      std::vector<TbErrorModelParams_t> tbs;
+      uint32_t first = i;
+      for (; i < nRefs && g_miErrorModelTbReferences[i].sinrProfile == b; ++i)
+        {
+          const MiErrorModelTbReference &ref = g_miErrorModelTbReferences[i];
+          const std::vector<int> &map = maps[ref.mapType];
+          TbErrorModelParams_t tb = GetTb (amc, ref, map);
+          tbs.push_back (tb);
+
+          TbStats_t single = LteMiErrorModel::GetTbDecodificationStats (sinr, map, tb.size, tb.mcs, tb.miHistory);
+          NS_TEST_ASSERT_MSG_EQ_TOL (single.tbler, ref.tbler, tolerance, "wrong TB error rate, profile " << (uint16_t) b << " MCS " << (uint16_t) ref.mcs);
+          NS_TEST_ASSERT_MSG_EQ_TOL (single.mi, ref.mi, tolerance, "wrong MI, profile " << (uint16_t) b << " MCS " << (uint16_t) ref.mcs);
+
+          if (!ref.harq)
+            {
+              double mib = LteMiErrorModel::Mib (sinr, map, tb.mcs);
+              TbStats_t fromMib = LteMiErrorModel::GetTbDecodificationStatsFromMib (mib, tb.size, tb.mcs, tb.miHistory);
+              NS_TEST_ASSERT_MSG_EQ_TOL (fromMib.tbler, ref.tbler, tolerance, "wrong TB error rate from the mmib, profile " << (uint16_t) b << " MCS " << (uint16_t) ref.mcs);
+            }
+        }
+
+      std::vector<TbStats_t> stats;
+      LteMiErrorModel::GetTbDecodificationStats (sinr, tbs, stats);
+      NS_TEST_ASSERT_MSG_EQ (stats.size (), tbs.size (), "wrong number of TB stats");
+      for (uint32_t j = 0; j < stats.size (); ++j)
+        {
+          const MiErrorModelTbReference &ref = g_miErrorModelTbReferences[first + j];
+          NS_TEST_ASSERT_MSG_EQ_TOL (stats[j].tbler, ref.tbler, tolerance, "wrong batch TB error rate, profile " << (uint16_t) b << " MCS " << (uint16_t) ref.mcs);
+          NS_TEST_ASSERT_MSG_EQ_TOL (stats[j].mi, ref.mi, tolerance, "wrong batch MI, profile " << (uint16_t) b << " MCS " << (uint16_t) ref.mcs);
+        }
+    }
+
+  uint32_t nPdcchRefs = sizeof (g_miErrorModelPdcchReferences) / sizeof (MiErrorModelPdcchReference);
+  for (uint32_t j = 0; j < nPdcchRefs; ++j)
+    {
+      const MiErrorModelPdcchReference &ref = g_miErrorModelPdcchReferences[j];
+      double error = LteMiErrorModel::GetPcfichPdcchError (GetSinr (ref.sinrProfile));
+      NS_TEST_ASSERT_MSG_EQ_TOL (error, ref.error, tolerance, "wrong PCFICH+PDCCH error rate, profile " << (uint16_t) ref.sinrProfile);
+    }
+}
+
+/**
+ * \ingroup lte-test
+ * \ingroup tests
+ *
+ * \brief Test suite of LteMiErrorModel
+ */
+class LteMiErrorModelTestSuite : public TestSuite
+{
+public:
+  LteMiErrorModelTestSuite ();
+};
+
+LteMiErrorModelTestSuite::LteMiErrorModelTestSuite ()
+  : TestSuite ("lte-mi-error-model", UNIT)
+{
+  AddTestCase (new LteMiErrorModelTestCase, TestCase::QUICK);
+}
+
+static LteMiErrorModelTestSuite g_lteMiErrorModelTestSuite; ///< the test suite
@@ -0,0 +1,304 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <ns3/test.h>
+#include <ns3/log.h>
+#include <ns3/simulator.h>
+#include <ns3/boolean.h>
+#include <ns3/double.h>
+#include <ns3/uinteger.h>
+#include <ns3/string.h>
+#include <ns3/node-container.h>
+#include <ns3/net-device-container.h>
+#include <ns3/mobility-helper.h>
+#include <ns3/mobility-model.h>
+#include <ns3/position-allocator.h>
+#include <ns3/spectrum-channel.h>
+#include <ns3/lte-helper.h>
+#include <ns3/radio-environment-map-helper.h>
+#include <ns3/building.h>
+#include <ns3/buildings-helper.h>
+#include <fstream>
+#include <sstream>
+#include <vector>
+#include <cmath>
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("LteRadioEnvironmentMapTest");
+
+/**
+ * \ingroup lte-test
+ * \ingroup tests
+ *
+ * \brief Check the maps generated with the DirectComputation attribute of
+ * RadioEnvironmentMapHelper
+ *
+ * Three eNBs with cosine antennas and no UE are deployed.  The test checks
+ * that the direct computation gives the same map as the listeners, with one
+ * or several threads, that the binary file holds the map, and that Update
+ * recomputes only the tiles near a moved eNB, giving the same map as a
+ * computation with the eNB at its new position.  With a building and a
+ * buildings propagation loss model, which force a single thread, the map
+ * computed with several threads is checked to be the same as well.
+ */
+class LteRadioEnvironmentMapTestCase : public TestCase
+{
+public:
+  LteRadioEnvironmentMapTestCase ();
+  virtual ~LteRadioEnvironmentMapTestCase ();
+
+private:
+  virtual void DoRun (void);
+  /**
+   * Generate a map
+   * \param direct the DirectComputation attribute
+   * \param threads the Threads attribute
+   * \param maxRange the MaxRange attribute of the channel
+   * \param building if true, a building is placed in the map and the
+   *        HybridBuildingsPropagationLossModel is used
+   * \param enbPosition the position of the last eNB
+   * \param outputFile the OutputFile attribute
+   * \param binaryOutputFile the BinaryOutputFile attribute
+   * \param newEnbPosition if not equal to enbPosition, the position to
+   *        which the last eNB is moved before calling Update
+   * \param updatedTiles the value returned by Update
+   * \return the SINR of the points of a direct computation, empty otherwise
+   */
+  std::vector<double> GenerateMap (bool direct, uint32_t threads, double maxRange, bool building,
+                                   Vector enbPosition, std::string outputFile,
+                                   std::string binaryOutputFile,
+                                   Vector newEnbPosition, uint32_t &updatedTiles);
+  /**
+   * Read the SINR of the points of a text map
+   * \param filename the file name
+   * \param lines the points of the map, without their SINR
+   * \return the SINR of the points
+   */
+  static std::vector<double> ReadMap (std::string filename, std::vector<std::string> &lines);
+
+  static const uint16_t m_xRes = 30; ///< the number of points along x
+  static const uint16_t m_yRes = 20; ///< the number of points along y
+  static const uint16_t m_tileSize = 4; ///< the size of the tiles
+};
+
+LteRadioEnvironmentMapTestCase::LteRadioEnvironmentMapTestCase ()
+  : TestCase ("Check the maps of RadioEnvironmentMapHelper computed directly")
+{
+}
+
+LteRadioEnvironmentMapTestCase::~LteRadioEnvironmentMapTestCase ()
+{
+}
+
+std::vector<double>
+LteRadioEnvironmentMapTestCase::GenerateMap (bool direct, uint32_t threads, double maxRange, bool building,
+                                             Vector enbPosition, std::string outputFile,
+                                             std::string binaryOutputFile,
+                                             Vector newEnbPosition, uint32_t &updatedTiles)
+{
+  Ptr<LteHelper> lteHelper = CreateObject<LteHelper> ();
+  lteHelper->SetEnbAntennaModelType ("ns3::CosineAntennaModel");
+  lteHelper->SetEnbAntennaModelAttribute ("Beamwidth", DoubleValue (90));
+  lteHelper->SetSpectrumChannelAttribute ("MaxRange", DoubleValue (maxRange));
+  if (building)
+    {
+      lteHelper->SetAttribute ("PathlossModel", StringValue ("ns3::HybridBuildingsPropagationLossModel"));
+      // no shadowing, which would be drawn from different streams by each map
+      lteHelper->SetPathlossModelAttribute ("ShadowSigmaOutdoor", DoubleValue (0.0));
+      lteHelper->SetPathlossModelAttribute ("ShadowSigmaIndoor", DoubleValue (0.0));
+      lteHelper->SetPathlossModelAttribute ("ShadowSigmaExtWalls", DoubleValue (0.0));
+      Ptr<Building> b = CreateObject<Building> ();
+      b->SetBoundaries (Box (100.0, 300.0, 0.0, 200.0, 0.0, 20.0));
+      b->SetBuildingType (Building::Office);
+      b->SetExtWallsType (Building::ConcreteWithWindows);
+    }
+
+  NodeContainer enbNodes;
+  enbNodes.Create (3);
+  Ptr<ListPositionAllocator> positionAlloc = CreateObject<ListPositionAllocator> ();
+  positionAlloc->Add (Vector (0.0, 0.0, 30.0));
+  positionAlloc->Add (Vector (500.0, 0.0, 30.0));
+  positionAlloc->Add (enbPosition);
+  MobilityHelper mobility;
+  mobility.SetMobilityModel ("ns3::ConstantPositionMobilityModel");
+  mobility.SetPositionAllocator (positionAlloc);
+  mobility.Install (enbNodes);
+  if (building)
+    {
+      BuildingsHelper::Install (enbNodes);
+    }
+  NetDeviceContainer enbDevs = lteHelper->InstallEnbDevice (enbNodes);
+
+  std::ostringstream channelPath;
+  channelPath << "/ChannelList/" << lteHelper->GetDownlinkSpectrumChannel ()->GetId ();
+  Ptr<RadioEnvironmentMapHelper> remHelper = CreateObject<RadioEnvironmentMapHelper> ();
+  remHelper->SetAttribute ("ChannelPath", StringValue (channelPath.str ()));
+  remHelper->SetAttribute ("OutputFile", StringValue (outputFile));
+  remHelper->SetAttribute ("BinaryOutputFile", StringValue (binaryOutputFile));
+  remHelper->SetAttribute ("XMin", DoubleValue (-200.0));
+  remHelper->SetAttribute ("XMax", DoubleValue (700.0));
+  remHelper->SetAttribute ("XRes", UintegerValue (m_xRes));
+  remHelper->SetAttribute ("YMin", DoubleValue (-300.0));
+  remHelper->SetAttribute ("YMax", DoubleValue (600.0));
+  remHelper->SetAttribute ("YRes", UintegerValue (m_yRes));
+  remHelper->SetAttribute ("Z", DoubleValue (1.5));
+  remHelper->SetAttribute ("MaxPointsPerIteration", UintegerValue (150));
+  remHelper->SetAttribute ("DirectComputation", BooleanValue (direct));
+  remHelper->SetAttribute ("Threads", UintegerValue (threads));
+  remHelper->SetAttribute ("TileSize", UintegerValue (m_tileSize));
+  remHelper->Install ();
+
+  Simulator::Stop (Seconds (1));
+  Simulator::Run ();
+
+  std::vector<double> sinrs;
+  if (direct)
+    {
+      Ptr<MobilityModel> enbMobility = enbNodes.Get (2)->GetObject<MobilityModel> ();
+      if (CalculateDistance (newEnbPosition, enbPosition) > 0)
+        {
+          enbMobility->SetPosition (newEnbPosition);
+          updatedTiles = remHelper->Update ();
+        }
+      for (uint16_t ix = 0; ix < m_xRes; ++ix)
+        {
+          for (uint16_t iy = 0; iy < m_yRes; ++iy)
+            {
+              sinrs.push_back (remHelper->GetSinr (ix, iy));
+            }
+        }
+    }
+  Simulator::Destroy ();
+  return sinrs;
+}
+
+std::vector<double>
+LteRadioEnvironmentMapTestCase::ReadMap (std::string filename, std::vector<std::string> &lines)
+{
+  std::vector<double> sinrs;
+  std::ifstream ifs (filename.c_str ());
+  std::string x, y, z;
+  double sinr;
+  while (ifs >> x >> y >> z >> sinr)
+    {
+      lines.push_back (x + " " + y + " " + z);
+      sinrs.push_back (sinr);
+    }
+  return sinrs;
+}
+
+void
+LteRadioEnvironmentMapTestCase::DoRun (void)
+{
+  Vector enbPosition (250.0, 400.0, 30.0);
+  Vector newEnbPosition (650.0, 500.0, 30.0);
+  uint32_t updatedTiles = 0;
+  std::string listenersFile = CreateTempDirFilename ("rem-listeners.out");
+  std::string directFile = CreateTempDirFilename ("rem-direct.out");
+  std::string binaryFile = CreateTempDirFilename ("rem-direct.bin");
+
+  // the listeners and the direct computation measure the same signals
+  GenerateMap (false, 1, 0.0, false, enbPosition, listenersFile, "", enbPosition, updatedTiles);
+  std::vector<double> direct = GenerateMap (true, 1, 0.0, false, enbPosition, directFile, binaryFile, enbPosition, updatedTiles);
+  std::vector<std::string> listenersLines;
+  std::vector<std::string> directLines;
+  std::vector<double> listenersSinrs = ReadMap (listenersFile, listenersLines);
+  std::vector<double> directSinrs = ReadMap (directFile, directLines);
+  NS_TEST_ASSERT_MSG_EQ (listenersSinrs.size (), (uint32_t) m_xRes * m_yRes, "wrong number of points measured by the listeners");
+  NS_TEST_ASSERT_MSG_EQ (directSinrs.size (), listenersSinrs.size (), "wrong number of points computed directly");
+  for (uint32_t i = 0; i < listenersSinrs.size (); ++i)
+    {
+      NS_TEST_ASSERT_MSG_EQ (directLines[i], listenersLines[i], "wrong point " << i);
+      NS_TEST_ASSERT_MSG_EQ_TOL (directSinrs[i], listenersSinrs[i], 1e-5 * listenersSinrs[i], "wrong SINR at " << listenersLines[i]);
+      NS_TEST_ASSERT_MSG_EQ_TOL (direct[i], directSinrs[i], 1e-5 * directSinrs[i], "GetSinr differs from the text file at " << directLines[i]);
+    }
+
+  // the binary file holds the points and their SINR
+  std::ifstream ifs (binaryFile.c_str (), std::ios::in | std::ios::binary);
+  std::string magic;
+  uint32_t nx;
+  uint32_t ny;
+  double z;
+  ifs >> magic >> nx >> ny >> z;
+  ifs.ignore (1);
+  NS_TEST_ASSERT_MSG_EQ (magic, "ns3-rem-1", "wrong binary file");
+  NS_TEST_ASSERT_MSG_EQ (nx, m_xRes, "wrong number of points along x in the binary file");
+  NS_TEST_ASSERT_MSG_EQ (ny, m_yRes, "wrong number of points along y in the binary file");
+  NS_TEST_ASSERT_MSG_EQ (z, 1.5, "wrong z in the binary file");
+  std::vector<double> xCoords (nx);
+  std::vector<double> yCoords (ny);
+  std::vector<float> binarySinrs (nx * ny);
+  ifs.read (reinterpret_cast<char *> (xCoords.data ()), nx * sizeof (double));
+  ifs.read (reinterpret_cast<char *> (yCoords.data ()), ny * sizeof (double));
+  ifs.read (reinterpret_cast<char *> (binarySinrs.data ()), nx * ny * sizeof (float));
+  NS_TEST_ASSERT_MSG_EQ (ifs.fail (), false, "binary file too short");
+  NS_TEST_ASSERT_MSG_EQ_TOL (xCoords[0], -200.0, 1e-9, "wrong first x in the binary file");
+  NS_TEST_ASSERT_MSG_EQ_TOL (yCoords[ny - 1], 600.0, 1e-9, "wrong last y in the binary file");
+  for (uint32_t i = 0; i < direct.size (); ++i)
+    {
+      NS_TEST_ASSERT_MSG_EQ (binarySinrs[i], (float) direct[i], "wrong SINR in the binary file at " << directLines[i]);
+    }
+
+  // the threads compute the same map
+  std::vector<double> threaded = GenerateMap (true, 4, 0.0, false, enbPosition, directFile, "", enbPosition, updatedTiles);
+  for (uint32_t i = 0; i < direct.size (); ++i)
+    {
+      NS_TEST_ASSERT_MSG_EQ (threaded[i], direct[i], "wrong SINR computed by several threads at " << directLines[i]);
+    }
+
+  // the buildings propagation loss model forces a single thread, so that
+  // the points inside the building are known to be indoor
+  std::vector<double> buildingMap = GenerateMap (true, 1, 0.0, true, enbPosition, directFile, "", enbPosition, updatedTiles);
+  std::vector<double> buildingThreaded = GenerateMap (true, 4, 0.0, true, enbPosition, directFile, "", enbPosition, updatedTiles);
+  for (uint32_t i = 0; i < buildingMap.size (); ++i)
+    {
+      NS_TEST_ASSERT_MSG_EQ (buildingThreaded[i], buildingMap[i], "wrong SINR computed with a building by several threads at " << directLines[i]);
+    }
+
+  // only the tiles near the moved eNB are recomputed, and the map is the
+  // one computed with the eNB at its new position
+  double maxRange = 300.0;
+  uint32_t nTiles = ((m_xRes + m_tileSize - 1) / m_tileSize) * ((m_yRes + m_tileSize - 1) / m_tileSize);
+  std::vector<double> updated = GenerateMap (true, 1, maxRange, false, enbPosition, directFile, "", newEnbPosition, updatedTiles);
+  NS_TEST_ASSERT_MSG_GT (updatedTiles, 0, "no tile was recomputed");
+  NS_TEST_ASSERT_MSG_LT (updatedTiles, nTiles, "all the tiles were recomputed");
+  std::vector<double> moved = GenerateMap (true, 1, maxRange, false, newEnbPosition, directFile, "", newEnbPosition, updatedTiles);
+  for (uint32_t i = 0; i < moved.size (); ++i)
+    {
+      NS_TEST_ASSERT_MSG_EQ (updated[i], moved[i], "wrong SINR after the update at " << directLines[i]);
+    }
+}
+
+/**
+ * \ingroup lte-test
+ * \ingroup tests
+ *
+ * \brief Test suite of RadioEnvironmentMapHelper
+ */
+class LteRadioEnvironmentMapTestSuite : public TestSuite
+{
+public:
+  LteRadioEnvironmentMapTestSuite ();
+};
+
+LteRadioEnvironmentMapTestSuite::LteRadioEnvironmentMapTestSuite ()
+  : TestSuite ("lte-radio-environment-map", SYSTEM)
+{
+  AddTestCase (new LteRadioEnvironmentMapTestCase, TestCase::QUICK);
+}
+
+static LteRadioEnvironmentMapTestSuite g_lteRadioEnvironmentMapTestSuite; ///< the test suite
@@ -0,0 +1,152 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/config.h"
+#include "ns3/simulator.h"
+#include "ns3/log.h"
+#include "ns3/test.h"
+#include "ns3/string.h"
+#include "ns3/uinteger.h"
+#include "ns3/node-container.h"
+#include "ns3/net-device-container.h"
+
+#include "lte-simple-helper.h"
+#include "lte-test-entities.h"
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("LteRlcLargeBufferTest");
+
+/**
+ * \ingroup lte-test
+ * \ingroup tests
+ *
+ * \brief Check the throughput of an RLC entity whose transmission buffer
+ * holds many SDUs
+ *
+ * Many SDUs arrive in a burst at the eNB, and large transmission
+ * opportunities drain the transmission buffer, segmenting and concatenating
+ * the SDUs.  The test checks that all the SDUs are delivered to the UE, and
+ * that the buffer is drained at the rate of the transmission opportunities.
+ */
+class LteRlcLargeBufferTestCase : public TestCase
+{
+public:
+  /**
+   * Constructor
+   * \param rlcEntity the type of RLC entity, "RlcUm" or "RlcAm"
+   * \param numSdu the number of SDUs
+   */
+  LteRlcLargeBufferTestCase (std::string rlcEntity, uint32_t numSdu);
+  virtual ~LteRlcLargeBufferTestCase ();
+
+private:
+  virtual void DoRun (void);
+
+  std::string m_rlcEntity; ///< the type of RLC entity
+  uint32_t m_numSdu; ///< the number of SDUs
+};
+
+LteRlcLargeBufferTestCase::LteRlcLargeBufferTestCase (std::string rlcEntity, uint32_t numSdu)
+  : TestCase (rlcEntity + " with a large transmission buffer"),
+    m_rlcEntity (rlcEntity),
+    m_numSdu (numSdu)
+{
+}
+
+LteRlcLargeBufferTestCase::~LteRlcLargeBufferTestCase ()
+{
+}
+
+void
+LteRlcLargeBufferTestCase::DoRun (void)
+{
+  uint32_t sduSizeBytes = 100;
+  Time sduStartTime = Seconds (0.100);
+  Time sduBurstDuration = Seconds (0.010);
+  uint32_t dlTxOppSizeBytes = 10000;
+  Time dlTxOppTime = MilliSeconds (1);
+  uint32_t ulTxOppSizeBytes = 140;
+  Time ulTxOppTime = MilliSeconds (1);
+
+  Config::SetDefault ("ns3::LteRlcUm::MaxTxBufferSize", UintegerValue (2 * m_numSdu * sduSizeBytes));
+
+  Ptr<LteSimpleHelper> lteSimpleHelper = CreateObject<LteSimpleHelper> ();
+  lteSimpleHelper->SetAttribute ("RlcEntity", StringValue (m_rlcEntity));
+
+  NodeContainer enbNodes;
+  NodeContainer ueNodes;
+  enbNodes.Create (1);
+  ueNodes.Create (1);
+  NetDeviceContainer enbLteDevs = lteSimpleHelper->InstallEnbDevice (enbNodes);
+  NetDeviceContainer ueLteDevs = lteSimpleHelper->InstallUeDevice (ueNodes);
+
+  lteSimpleHelper->m_enbRrc->SetArrivalTime (sduBurstDuration / m_numSdu);
+  lteSimpleHelper->m_enbRrc->SetPduSize (sduSizeBytes);
+
+  lteSimpleHelper->m_enbMac->SetTxOppSize (dlTxOppSizeBytes);
+  lteSimpleHelper->m_enbMac->SetTxOppTime (dlTxOppTime);
+  lteSimpleHelper->m_enbMac->SetTxOpportunityMode (LteTestMac::AUTOMATIC_MODE);
+
+  lteSimpleHelper->m_ueMac->SetTxOppSize (ulTxOppSizeBytes);
+  lteSimpleHelper->m_ueMac->SetTxOppTime (ulTxOppTime);
+  lteSimpleHelper->m_ueMac->SetTxOpportunityMode (LteTestMac::AUTOMATIC_MODE);
+
+  Simulator::Schedule (sduStartTime, &LteTestRrc::Start, lteSimpleHelper->m_enbRrc);
+  Simulator::Schedule (sduStartTime + sduBurstDuration, &LteTestRrc::Stop, lteSimpleHelper->m_enbRrc);
+
+  // each SDU carries a PDCP header of 2 bytes, and at most 2 bytes of RLC
+  // header, hence the buffer is drained at least at this rate
+  double minSdusPerTxOpp = dlTxOppSizeBytes / (sduSizeBytes + 4.0);
+  Time drainTime = dlTxOppTime * (int64_t) std::ceil (m_numSdu / minSdusPerTxOpp);
+  Time stopTime = sduStartTime + drainTime + Seconds (0.200);
+  Simulator::Stop (stopTime);
+  Simulator::Run ();
+
+  uint32_t txSdus = lteSimpleHelper->m_enbRrc->GetTxPdus ();
+  uint32_t rxSdus = lteSimpleHelper->m_ueRrc->GetRxPdus ();
+  NS_LOG_INFO (m_rlcEntity << ": " << txSdus << " SDUs sent, " << rxSdus << " SDUs received, last at " << lteSimpleHelper->m_ueRrc->GetRxLastTime ().GetSeconds () << " s");
+
+  NS_TEST_ASSERT_MSG_GT_OR_EQ (txSdus, m_numSdu, "not all the SDUs were sent");
+  NS_TEST_ASSERT_MSG_EQ (rxSdus, txSdus, "not all the SDUs were received");
+  NS_TEST_ASSERT_MSG_EQ (lteSimpleHelper->m_ueRrc->GetRxBytes (), lteSimpleHelper->m_enbRrc->GetTxBytes (), "not all the bytes were received");
+  // the AM entity waits for a STATUS PDU once its transmission window is full
+  Time maxRxLastTime = sduStartTime + drainTime + (m_rlcEntity == "RlcAm" ? Seconds (0.100) : Seconds (0.010));
+  NS_TEST_ASSERT_MSG_LT_OR_EQ (lteSimpleHelper->m_ueRrc->GetRxLastTime (), maxRxLastTime, "the transmission buffer was drained too slowly");
+
+  Simulator::Destroy ();
+}
+
+/**
+ * \ingroup lte-test
+ * \ingroup tests
+ *
+ * \brief Test suite of the RLC entities with large transmission buffers
+ */
+class LteRlcLargeBufferTestSuite : public TestSuite
+{
+public:
+  LteRlcLargeBufferTestSuite ();
+};
+
+LteRlcLargeBufferTestSuite::LteRlcLargeBufferTestSuite ()
+  : TestSuite ("lte-rlc-large-buffer", SYSTEM)
+{
+  AddTestCase (new LteRlcLargeBufferTestCase ("RlcUm", 20000), TestCase::QUICK);
+  AddTestCase (new LteRlcLargeBufferTestCase ("RlcAm", 20000), TestCase::QUICK);
+}
+
+static LteRlcLargeBufferTestSuite g_lteRlcLargeBufferTestSuite; ///< the test suite
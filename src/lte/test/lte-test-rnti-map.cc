@@ -0,0 +1,172 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <ns3/test.h>
+#include <ns3/random-variable-stream.h>
+#include <ns3/rnti-map.h>
+#include <map>
+
+using namespace ns3;
+
+/**
+ * \ingroup lte-test
+ * \ingroup tests
+ *
+ * \brief Check that RntiMap behaves like a std::map keyed by RNTI under a
+ * random sequence of insertions, lookups and removals
+ */
+class LteRntiMapTestCase : public TestCase
+{
+public:
+  LteRntiMapTestCase ();
+  virtual ~LteRntiMapTestCase ();
+
+private:
+  virtual void DoRun (void);
+  /**
+   * Compare the entries of the maps, in iteration order
+   * \param map the RntiMap
+   * \param reference the std::map
+   */
+  void Compare (const RntiMap<uint32_t> &map, const std::map<uint16_t, uint32_t> &reference);
+};
+
+LteRntiMapTestCase::LteRntiMapTestCase ()
+  : TestCase ("Check RntiMap against std::map")
+{
+}
+
+LteRntiMapTestCase::~LteRntiMapTestCase ()
+{
+}
+
+void
+LteRntiMapTestCase::Compare (const RntiMap<uint32_t> &map, const std::map<uint16_t, uint32_t> &reference)
+{
+  NS_TEST_ASSERT_MSG_EQ (map.size (), reference.size (), "Unexpected number of entries");
+  NS_TEST_ASSERT_MSG_EQ (map.empty (), reference.empty (), "Unexpected number of entries");
+  RntiMap<uint32_t>::const_iterator it = map.begin ();
+  for (std::map<uint16_t, uint32_t>::const_iterator ref = reference.begin (); ref != reference.end (); ++ref, ++it)
+    {
+      NS_TEST_ASSERT_MSG_EQ ((it != map.end ()), true, "Missing entry for RNTI " << ref->first);
+      NS_TEST_ASSERT_MSG_EQ (it->first, ref->first, "Entries in unexpected order");
+      NS_TEST_ASSERT_MSG_EQ ((*it).second, ref->second, "Unexpected value for RNTI " << ref->first);
+    }
+  NS_TEST_ASSERT_MSG_EQ ((it == map.end ()), true, "Unexpected additional entry");
+}
+
+void
+LteRntiMapTestCase::DoRun (void)
+{
+  Ptr<UniformRandomVariable> random = CreateObject<UniformRandomVariable> ();
+  random->SetStream (1);
+  RntiMap<uint32_t> map;
+  std::map<uint16_t, uint32_t> reference;
+  Compare (map, reference);
+
+  for (uint32_t i = 0; i < 20000; i++)
+    {
+      uint16_t rnti = random->GetInteger (1, 300);
+      uint32_t value = random->GetInteger (0, 1000);
+      switch (random->GetInteger (0, 4))
+        {
+        case 0:
+          {
+            bool inserted = map.insert (std::pair<uint16_t, uint32_t> (rnti, value)).second;
+            bool expected = reference.insert (std::pair<uint16_t, uint32_t> (rnti, value)).second;
+            NS_TEST_ASSERT_MSG_EQ (inserted, expected, "Unexpected insertion of RNTI " << rnti);
+          }
+          break;
+        case 1:
+          map[rnti] = value;
+          reference[rnti] = value;
+          break;
+        case 2:
+          NS_TEST_ASSERT_MSG_EQ (map.erase (rnti), reference.erase (rnti), "Unexpected removal of RNTI " << rnti);
+          break;
+        case 3:
+          {
+            RntiMap<uint32_t>::iterator it = map.find (rnti);
+            NS_TEST_ASSERT_MSG_EQ ((it != map.end ()), (reference.count (rnti) == 1), "Unexpected lookup of RNTI " << rnti);
+            if (it != map.end ())
+              {
+                NS_TEST_ASSERT_MSG_EQ (it->second, reference[rnti], "Unexpected value for RNTI " << rnti);
+                map.erase (it);
+                reference.erase (rnti);
+              }
+          }
+          break;
+        default:
+          {
+            // decrement the timers, and remove the expired ones, as the
+            // schedulers do with their CQI timers
+            RntiMap<uint32_t>::iterator it = map.begin ();
+            while (it != map.end ())
+              {
+                if ((*it).second < 100)
+                  {
+                    map.erase (it++);
+                  }
+                else
+                  {
+                    (*it).second -= 100;
+                    it++;
+                  }
+              }
+            std::map<uint16_t, uint32_t>::iterator ref = reference.begin ();
+            while (ref != reference.end ())
+              {
+                if ((*ref).second < 100)
+                  {
+                    reference.erase (ref++);
+                  }
+                else
+                  {
+                    (*ref).second -= 100;
+                    ref++;
+                  }
+              }
+          }
+          break;
+        }
+      Compare (map, reference);
+    }
+
+  map.clear ();
+  reference.clear ();
+  Compare (map, reference);
+  NS_TEST_ASSERT_MSG_EQ (map.count (1), 0, "The map should be empty");
+}
+
+/**
+ * \ingroup lte-test
+ * \ingroup tests
+ *
+ * \brief RntiMap Test Suite
+ */
+class LteRntiMapTestSuite : public TestSuite
+{
+public:
+  LteRntiMapTestSuite ();
+};
+
+LteRntiMapTestSuite::LteRntiMapTestSuite ()
+  : TestSuite ("lte-rnti-map", UNIT)
+{
+  AddTestCase (new LteRntiMapTestCase, TestCase::QUICK);
+}
+
+static LteRntiMapTestSuite g_lteRntiMapTestSuite; ///< the test suite
@@ -0,0 +1,177 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <ns3/test.h>
+#include <ns3/log.h>
+#include <ns3/simulator.h>
+#include <ns3/string.h>
+#include <ns3/uinteger.h>
+#include <ns3/nstime.h>
+#include <ns3/spectrum-value.h>
+#include <ns3/constant-position-mobility-model.h>
+#include <ns3/trace-fading-loss-model.h>
+#include <fstream>
+#include <cmath>
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("LteTraceFadingTest");
+
+/**
+ * \ingroup lte-test
+ * \ingroup tests
+ *
+ * \brief Check that TraceFadingLossModel applies the same fading with a
+ * text trace and with the memory-mapped binary trace converted from it
+ */
+class LteTraceFadingTestCase : public TestCase
+{
+public:
+  LteTraceFadingTestCase ();
+  virtual ~LteTraceFadingTestCase ();
+
+private:
+  virtual void DoRun (void);
+  /**
+   * \param fileName the trace file
+   * \return a new fading model which uses the trace
+   */
+  Ptr<TraceFadingLossModel> CreateModel (std::string fileName);
+  /**
+   * Compare the received PSDs of the models
+   */
+  void Compare (void);
+
+  std::vector<Ptr<TraceFadingLossModel> > m_models; ///< the text model, then the binary models
+  std::vector<Ptr<MobilityModel> > m_mobility; ///< the mobility models of the links
+  Ptr<SpectrumValue> m_txPsd; ///< the transmitted PSD
+  uint32_t m_nComparisons; ///< number of PSDs compared
+};
+
+LteTraceFadingTestCase::LteTraceFadingTestCase ()
+  : TestCase ("Check the text and binary fading traces"),
+    m_nComparisons (0)
+{
+}
+
+LteTraceFadingTestCase::~LteTraceFadingTestCase ()
+{
+}
+
+Ptr<TraceFadingLossModel>
+LteTraceFadingTestCase::CreateModel (std::string fileName)
+{
+  Ptr<TraceFadingLossModel> model = CreateObject<TraceFadingLossModel> ();
+  model->SetAttribute ("TraceFilename", StringValue (fileName));
+  model->SetAttribute ("TraceLength", TimeValue (Seconds (2.0)));
+  model->SetAttribute ("SamplesNum", UintegerValue (2000));
+  model->SetAttribute ("WindowSize", TimeValue (Seconds (0.5)));
+  model->SetAttribute ("RbNum", UintegerValue (3));
+  model->Initialize ();
+  model->AssignStreams (1);
+  return model;
+}
+
+void
+LteTraceFadingTestCase::Compare (void)
+{
+  for (uint32_t i = 0; i + 1 < m_mobility.size (); ++i)
+    {
+      Ptr<SpectrumValue> expected = m_models[0]->CalcRxPowerSpectralDensity (m_txPsd, m_mobility[i], m_mobility[i + 1]);
+      NS_TEST_ASSERT_MSG_NE ((*expected)[0], (*m_txPsd)[0], "no fading applied");
+      for (uint32_t j = 1; j < m_models.size (); ++j)
+        {
+          Ptr<SpectrumValue> rxPsd = m_models[j]->CalcRxPowerSpectralDensity (m_txPsd, m_mobility[i], m_mobility[i + 1]);
+          for (uint32_t k = 0; k < 3; ++k)
+            {
+              NS_TEST_ASSERT_MSG_EQ ((*rxPsd)[k], (*expected)[k], "different fading on RB " << k << " of link " << i);
+            }
+        }
+    }
+  m_nComparisons++;
+}
+
+void
+LteTraceFadingTestCase::DoRun (void)
+{
+  // 3 RBs of 2000 samples, RB after RB
+  std::string textFileName = CreateTempDirFilename ("fading-trace.fad");
+  std::ofstream ofs (textFileName.c_str ());
+  for (uint32_t i = 0; i < 3; ++i)
+    {
+      for (uint32_t j = 0; j < 2000; ++j)
+        {
+          ofs << -10 + 10 * std::sin (0.01 * j + i) << " ";
+        }
+      ofs << std::endl;
+    }
+  ofs.close ();
+  std::string binaryFileName = CreateTempDirFilename ("fading-trace.bin");
+  TraceFadingLossModel::ConvertTrace (textFileName, binaryFileName, 3, 2000);
+
+  // two binary models share the mapped trace
+  m_models.push_back (CreateModel (textFileName));
+  m_models.push_back (CreateModel (binaryFileName));
+  m_models.push_back (CreateModel (binaryFileName));
+
+  for (uint32_t i = 0; i < 4; ++i)
+    {
+      m_mobility.push_back (CreateObject<ConstantPositionMobilityModel> ());
+    }
+  std::vector<double> frequencies;
+  for (uint32_t i = 0; i < 3; ++i)
+    {
+      frequencies.push_back (2.1e9 + i * 180e3);
+    }
+  m_txPsd = Create<SpectrumValue> (Create<SpectrumModel> (frequencies));
+  (*m_txPsd) = 1e-15;
+
+  for (uint32_t ms = 0; ms < 1700; ms += 37)
+    {
+      Simulator::Schedule (MilliSeconds (ms), &LteTraceFadingTestCase::Compare, this);
+    }
+  Simulator::Run ();
+  Simulator::Destroy ();
+  NS_TEST_EXPECT_MSG_EQ (m_nComparisons, 46, "not all the comparisons ran");
+
+  for (uint32_t i = 0; i < m_models.size (); ++i)
+    {
+      m_models[i]->Dispose ();
+    }
+  m_models.clear ();
+  m_mobility.clear ();
+}
+
+
+/**
+ * \ingroup lte-test
+ * \ingroup tests
+ *
+ * \brief TraceFadingLossModel Test Suite
+ */
+class LteTraceFadingTestSuite : public TestSuite
+{
+public:
+  LteTraceFadingTestSuite ();
+};
+
+LteTraceFadingTestSuite::LteTraceFadingTestSuite ()
+  : TestSuite ("lte-trace-fading", UNIT)
+{
+  AddTestCase (new LteTraceFadingTestCase, TestCase::QUICK);
+}
+
+static LteTraceFadingTestSuite g_lteTraceFadingTestSuite; ///< the test suite
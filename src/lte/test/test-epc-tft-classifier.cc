@@ -24,15 +24,19 @@
 #include "ns3/log.h"
 #include "ns3/packet.h"
 #include "ns3/ipv4-header.h"
+#include "ns3/ipv6-header.h"
 #include "ns3/udp-header.h"
 #include "ns3/tcp-header.h"
 #include "ns3/ipv4-l3-protocol.h"
+#include "ns3/ipv6-l3-protocol.h"
 #include "ns3/udp-l4-protocol.h"
 #include "ns3/tcp-l4-protocol.h"
+#include "ns3/random-variable-stream.h"
 
 #include "ns3/epc-tft-classifier.h"
 
 #include <iomanip>
+#include <map>
 
 using namespace ns3;
 
@@ -171,6 +175,193 @@ EpcTftClassifierTestCase::DoRun (void)
 
 
 
+/**
+ * \ingroup lte-test
+ * \ingroup tests
+ *
+ * \brief Test case checking that the compiled classifier and its flow cache
+ * give the same results as testing the packet filters of the TFTs one by
+ * one, for random UDP and TCP flows over IPv4 and IPv6, including after
+ * packet filters are added to a TFT of the classifier and after a TFT is
+ * deleted.
+ */
+class EpcTftClassifierReferenceTestCase : public TestCase
+{
+public:
+  EpcTftClassifierReferenceTestCase ();
+  virtual ~EpcTftClassifierReferenceTestCase ();
+
+private:
+  virtual void DoRun (void);
+
+  /**
+   * Classify random flows with the classifier and by testing the TFTs one by one
+   * \param stage the name of the stage of the test
+   */
+  void CheckRandomFlows (std::string stage);
+
+  Ptr<EpcTftClassifier> m_c;                ///< the EPC TFT classifier
+  std::map <uint32_t, Ptr<EpcTft> > m_tfts; ///< the TFTs of the classifier
+  Ptr<UniformRandomVariable> m_random;      ///< the random variable
+};
+
+EpcTftClassifierReferenceTestCase::EpcTftClassifierReferenceTestCase ()
+  : TestCase ("Compare the classification of random flows with the TFTs tested one by one")
+{
+}
+
+EpcTftClassifierReferenceTestCase::~EpcTftClassifierReferenceTestCase ()
+{
+}
+
+void
+EpcTftClassifierReferenceTestCase::CheckRandomFlows (std::string stage)
+{
+  static const char * addresses[] = {"1.0.0.1", "1.2.3.4", "2.0.0.7", "3.3.3.9", "4.4.4.4", "9.1.1.1"};
+  static const uint16_t ports[] = {0, 4, 80, 1024, 1030, 3456, 3460, 5897, 7895};
+  static const uint8_t toses[] = {0, 5, 0xb8};
+
+  for (uint32_t i = 0; i < 2000; ++i)
+    {
+      EpcTft::Direction d = m_random->GetInteger (0, 1) ? EpcTft::UPLINK : EpcTft::DOWNLINK;
+      Ipv4Address sa (addresses[m_random->GetInteger (0, 5)]);
+      Ipv4Address da (addresses[m_random->GetInteger (0, 5)]);
+      uint16_t sp = ports[m_random->GetInteger (0, 8)];
+      uint16_t dp = ports[m_random->GetInteger (0, 8)];
+      uint8_t tos = toses[m_random->GetInteger (0, 2)];
+      bool tcp = m_random->GetInteger (0, 1);
+      bool ipv6 = m_random->GetInteger (0, 3) == 0;
+
+      Ptr<Packet> packet = Create<Packet> ();
+      if (tcp)
+        {
+          TcpHeader tcpHeader;
+          tcpHeader.SetSourcePort (sp);
+          tcpHeader.SetDestinationPort (dp);
+          packet->AddHeader (tcpHeader);
+        }
+      else
+        {
+          UdpHeader udpHeader;
+          udpHeader.SetSourcePort (sp);
+          udpHeader.SetDestinationPort (dp);
+          packet->AddHeader (udpHeader);
+        }
+      uint8_t protocol = tcp ? TcpL4Protocol::PROT_NUMBER : UdpL4Protocol::PROT_NUMBER;
+      uint16_t protocolNumber;
+      if (ipv6)
+        {
+          Ipv6Header ipv6Header;
+          ipv6Header.SetSourceAddress (Ipv6Address::MakeIpv4MappedAddress (sa));
+          ipv6Header.SetDestinationAddress (Ipv6Address::MakeIpv4MappedAddress (da));
+          ipv6Header.SetTrafficClass (tos);
+          ipv6Header.SetNextHeader (protocol);
+          ipv6Header.SetPayloadLength (packet->GetSize ());
+          packet->AddHeader (ipv6Header);
+          protocolNumber = Ipv6L3Protocol::PROT_NUMBER;
+        }
+      else
+        {
+          Ipv4Header ipv4Header;
+          ipv4Header.SetSource (sa);
+          ipv4Header.SetDestination (da);
+          ipv4Header.SetTos (tos);
+          ipv4Header.SetProtocol (protocol);
+          ipv4Header.SetPayloadSize (packet->GetSize ());
+          packet->AddHeader (ipv4Header);
+          protocolNumber = Ipv4L3Protocol::PROT_NUMBER;
+        }
+
+      Ipv4Address ra = (d == EpcTft::UPLINK) ? da : sa;
+      Ipv4Address la = (d == EpcTft::UPLINK) ? sa : da;
+      uint16_t rp = (d == EpcTft::UPLINK) ? dp : sp;
+      uint16_t lp = (d == EpcTft::UPLINK) ? sp : dp;
+      uint32_t expectedTftId = 0;
+      for (std::map <uint32_t, Ptr<EpcTft> >::reverse_iterator it = m_tfts.rbegin (); it != m_tfts.rend (); ++it)
+        {
+          bool matches = ipv6 ? it->second->Matches (d, Ipv6Address::MakeIpv4MappedAddress (ra), Ipv6Address::MakeIpv4MappedAddress (la), rp, lp, tos)
+                              : it->second->Matches (d, ra, la, rp, lp, tos);
+          if (matches)
+            {
+              expectedTftId = it->first;
+              break;
+            }
+        }
+
+      uint32_t obtainedTftId = m_c->Classify (packet, d, protocolNumber);
+      NS_TEST_ASSERT_MSG_EQ (obtainedTftId, expectedTftId, stage << ": bad classification of "
+                             << (tcp ? "TCP" : "UDP") << (ipv6 ? "/IPv6" : "/IPv4") << " packet, d = " << d
+                             << ", sa = " << sa << ", da = " << da << ", sp = " << sp << ", dp = " << dp
+                             << ", tos = 0x" << std::hex << (int) tos << std::dec);
+    }
+}
+
+void
+EpcTftClassifierReferenceTestCase::DoRun (void)
+{
+  m_random = CreateObject<UniformRandomVariable> ();
+  m_random->SetStream (1);
+  m_c = Create<EpcTftClassifier> ();
+
+  m_tfts[1] = EpcTft::Default ();
+
+  Ptr<EpcTft> addressTft = Create<EpcTft> ();
+  EpcTft::PacketFilter addressFilter;
+  addressFilter.remoteAddress.Set ("1.0.0.0");
+  addressFilter.remoteMask.Set (0xFF000000);
+  addressFilter.localAddress.Set ("3.3.3.0");
+  addressFilter.localMask.Set (0xFFFFFF00);
+  addressTft->Add (addressFilter);
+  m_tfts[2] = addressTft;
+
+  Ptr<EpcTft> portTft = Create<EpcTft> ();
+  EpcTft::PacketFilter rangeFilter;
+  rangeFilter.remotePortStart = 1024;
+  rangeFilter.remotePortEnd = 1035;
+  rangeFilter.direction = EpcTft::UPLINK;
+  portTft->Add (rangeFilter);
+  EpcTft::PacketFilter portFilter;
+  portFilter.localPortStart = 7895;
+  portFilter.localPortEnd = 7895;
+  portTft->Add (portFilter);
+  m_tfts[3] = portTft;
+
+  Ptr<EpcTft> exactTft = Create<EpcTft> ();
+  EpcTft::PacketFilter exactFilter;
+  exactFilter.remoteAddress.Set ("9.1.1.1");
+  exactFilter.remoteMask.Set (0xFFFFFFFF);
+  exactFilter.localAddress.Set ("1.2.3.4");
+  exactFilter.localMask.Set (0xFFFFFFFF);
+  exactFilter.remotePortStart = 80;
+  exactFilter.remotePortEnd = 80;
+  exactFilter.localPortStart = 3456;
+  exactFilter.localPortEnd = 3456;
+  exactFilter.typeOfService = 0xb8;
+  exactFilter.typeOfServiceMask = 0xFC;
+  exactTft->Add (exactFilter);
+  m_tfts[4] = exactTft;
+
+  for (std::map <uint32_t, Ptr<EpcTft> >::iterator it = m_tfts.begin (); it != m_tfts.end (); ++it)
+    {
+      m_c->Add (it->second, it->first);
+    }
+  CheckRandomFlows ("initial TFTs");
+
+  // a filter added to a TFT of the classifier is taken into account
+  EpcTft::PacketFilter newFilter;
+  newFilter.remotePortStart = 4;
+  newFilter.remotePortEnd = 80;
+  newFilter.typeOfService = 5;
+  newFilter.typeOfServiceMask = 0xFF;
+  portTft->Add (newFilter);
+  CheckRandomFlows ("filter added");
+
+  m_c->Delete (4);
+  m_tfts.erase (4);
+  CheckRandomFlows ("TFT deleted");
+}
+
+
 /**
  * \ingroup lte-test
  * \ingroup tests
@@ -369,4 +560,11 @@ EpcTftClassifierTestSuite::EpcTftClassifierTestSuite ()
   AddTestCase (new EpcTftClassifierTestCase (c4, EpcTft::UPLINK,   Ipv4Address ("9.1.1.1"), Ipv4Address ("8.1.1.1"),     9,     5897,     0,    2), TestCase::QUICK);
   AddTestCase (new EpcTftClassifierTestCase (c4, EpcTft::DOWNLINK, Ipv4Address ("9.1.1.1"), Ipv4Address ("8.1.1.1"),  5897,       10,     0,    2), TestCase::QUICK);
 
+
+  ///////////////////////////////////////////
+  // check random flows against the TFTs
+  ///////////////////////////////////////////
+
+  AddTestCase (new EpcTftClassifierReferenceTestCase, TestCase::QUICK);
+
 }
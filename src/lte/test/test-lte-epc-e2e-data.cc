@@ -113,19 +113,22 @@ public:
    *
    * \param name the reference name
    * \param v the ENB test data
+   * \param numberOfSgwPgwShards the number of SGW/PGW nodes
    */
-  LteEpcE2eDataTestCase (std::string name, std::vector<EnbTestData> v);
+  LteEpcE2eDataTestCase (std::string name, std::vector<EnbTestData> v, uint16_t numberOfSgwPgwShards = 1);
   virtual ~LteEpcE2eDataTestCase ();
 
 private:
   virtual void DoRun (void);
   std::vector<EnbTestData> m_enbTestData; ///< the ENB test data
+  uint16_t m_numberOfSgwPgwShards; ///< the number of SGW/PGW nodes
 };
 
 
-LteEpcE2eDataTestCase::LteEpcE2eDataTestCase (std::string name, std::vector<EnbTestData> v)
+LteEpcE2eDataTestCase::LteEpcE2eDataTestCase (std::string name, std::vector<EnbTestData> v, uint16_t numberOfSgwPgwShards)
   : TestCase (name),
-    m_enbTestData (v)
+    m_enbTestData (v),
+    m_numberOfSgwPgwShards (numberOfSgwPgwShards)
 {
   NS_LOG_FUNCTION (this << name);
 }
@@ -143,6 +146,7 @@ LteEpcE2eDataTestCase::DoRun ()
   Config::SetDefault ("ns3::LteSpectrumPhy::DataErrorModelEnabled", BooleanValue (false));  
   Config::SetDefault ("ns3::LteHelper::UseIdealRrc", BooleanValue (true));
   Ptr<LteHelper> lteHelper = CreateObject<LteHelper> ();
+  Config::SetDefault ("ns3::PointToPointEpcHelper::NumberOfSgwPgwShards", UintegerValue (m_numberOfSgwPgwShards));
   Ptr<PointToPointEpcHelper> epcHelper = CreateObject<PointToPointEpcHelper> ();
   lteHelper->SetEpcHelper (epcHelper);
 
@@ -362,6 +366,7 @@ LteEpcE2eDataTestCase::DoRun ()
     }
   
   Simulator::Destroy ();
+  Config::SetDefault ("ns3::PointToPointEpcHelper::NumberOfSgwPgwShards", UintegerValue (1));
 }
 
 
@@ -429,6 +434,7 @@ LteEpcE2eDataTestSuite::LteEpcE2eDataTestSuite ()
   v4.push_back (e1);
   v4.push_back (e2);
   AddTestCase (new LteEpcE2eDataTestCase ("3 eNBs", v4), TestCase::EXTENSIVE);
+  AddTestCase (new LteEpcE2eDataTestCase ("3 eNBs, 4 SGW/PGW shards", v4, 4), TestCase::QUICK);
 
   EnbTestData e5;
   UeTestData u5;
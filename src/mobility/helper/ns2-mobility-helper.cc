@@ -41,9 +41,15 @@
 #include <fstream>
 #include <sstream>
 #include <map>
+#include <deque>
+#include <queue>
+#include <cstdlib>
+#include <cstring>
+#include <sys/stat.h>
 #include "ns3/log.h"
 #include "ns3/unused.h"
 #include "ns3/simulator.h"
+#include "ns3/simple-ref-count.h"
 #include "ns3/node-list.h"
 #include "ns3/node.h"
 #include "ns3/constant-velocity-mobility-model.h"
@@ -183,12 +189,29 @@ static Vector SetSchedPosition (Ptr<ConstantVelocityMobilityModel> model, double
 
 
 Ns2MobilityHelper::Ns2MobilityHelper (std::string filename)
-  : m_filename (filename)
+  : m_filename (filename),
+    m_streaming (false),
+    m_window (Seconds (60))
 {
   std::ifstream file (m_filename.c_str (), std::ios::in);
   if (!(file.is_open ())) NS_FATAL_ERROR("Could not open trace file " << m_filename.c_str() << " for reading, aborting here \n"); 
 }
 
+void
+Ns2MobilityHelper::EnableStreaming (Time window)
+{
+  NS_ASSERT (window.IsStrictlyPositive ());
+  m_streaming = true;
+  m_window = window;
+}
+
+void
+Ns2MobilityHelper::SetCacheFilename (std::string filename)
+{
+  m_streaming = true;
+  m_cacheFilename = filename;
+}
+
 Ptr<ConstantVelocityMobilityModel>
 Ns2MobilityHelper::GetMobilityModel (std::string idString, const ObjectStore &store) const
 {
@@ -214,6 +237,12 @@ Ns2MobilityHelper::GetMobilityModel (std::string idString, const ObjectStore &st
 void
 Ns2MobilityHelper::ConfigNodesMovements (const ObjectStore &store) const
 {
+  if (m_streaming)
+    {
+      ConfigNodesStreaming (store);
+      return;
+    }
+
   std::map<int, DestinationPoint> last_pos;    // Stores previous movement scheduled for each node
 
   //*****************************************************************
@@ -807,6 +836,823 @@ SetSchedPosition (Ptr<ConstantVelocityMobilityModel> model, double at, std::stri
   return position;
 }
 
+/**
+ * Types of the statements of an ns-2 mobility trace
+ */
+enum Ns2RecordType
+{
+  NS2_RECORD_SETDEST = 0, //!< $ns_ at 1 "$node_(0) setdest 2 3 4"
+  NS2_RECORD_SET_X,       //!< $ns_ at 1 "$node_(0) set X_ 2"
+  NS2_RECORD_SET_Y,       //!< $ns_ at 1 "$node_(0) set Y_ 2"
+  NS2_RECORD_SET_Z,       //!< $ns_ at 1 "$node_(0) set Z_ 2"
+  NS2_RECORD_INITIAL_X,   //!< $node_(0) set X_ 2
+  NS2_RECORD_INITIAL_Y,   //!< $node_(0) set Y_ 2
+  NS2_RECORD_INITIAL_Z    //!< $node_(0) set Z_ 2
+};
+
+/**
+ * A parsed statement of an ns-2 mobility trace, as stored in the binary
+ * cache files
+ */
+struct Ns2Record
+{
+  double time;      //!< time of a scheduled statement, in seconds
+  uint32_t node;    //!< node id
+  uint32_t type;    //!< the Ns2RecordType
+  double values[3]; //!< x, y and speed of a setdest, or the coordinate of a set in values[0]
+};
+
+/**
+ * Header of the binary cache files
+ */
+struct Ns2CacheHeader
+{
+  char magic[8];             //!< identifies the format of the file
+  uint64_t traceSize;        //!< size of the trace file
+  int64_t traceModification; //!< modification time of the trace file
+  uint64_t nScheduled;       //!< number of scheduled records, which follow the header
+  uint64_t nInitial;         //!< number of initial positions, which follow the scheduled records
+};
+
+/// magic string of the binary cache files
+static const char NS2_CACHE_MAGIC[8] = { 'N', 'S', '2', 'M', 'O', 'B', '0', '1' };
+
+/**
+ * Parse a number which fills a token
+ * \param token the start of the token
+ * \param length the length of the token
+ * \param value the number
+ * \return true if the token is a number
+ */
+static bool
+ParseNs2Number (const char *token, size_t length, double &value)
+{
+  char buffer[64];
+  if (length == 0 || length >= sizeof (buffer))
+    {
+      return false;
+    }
+  std::memcpy (buffer, token, length);
+  buffer[length] = 0;
+  char *end;
+  value = std::strtod (buffer, &end);
+  return end == buffer + length;
+}
+
+/**
+ * Parse the node id of a token like $node_(4)
+ * \param token the start of the token
+ * \param length the length of the token
+ * \param node the node id
+ * \return true if the token has a node id
+ */
+static bool
+ParseNs2NodeId (const char *token, size_t length, uint32_t &node)
+{
+  const char *open = static_cast<const char *> (std::memchr (token, '(', length));
+  if (open == 0)
+    {
+      return false;
+    }
+  const char *close = static_cast<const char *> (std::memchr (open, ')', token + length - open));
+  if (close == 0 || close == open + 1)
+    {
+      return false;
+    }
+  node = 0;
+  for (const char *c = open + 1; c != close; c++)
+    {
+      if (*c < '0' || *c > '9')
+        {
+          return false;
+        }
+      node = node * 10 + (*c - '0');
+    }
+  return true;
+}
+
+/**
+ * Parse the coordinate of a set statement
+ * \param token the start of the token
+ * \param length the length of the token
+ * \return 0, 1 or 2 for X_, Y_ or Z_, 3 otherwise
+ */
+static uint32_t
+ParseNs2Coordinate (const char *token, size_t length)
+{
+  if (length != 2 || token[1] != '_' || token[0] < 'X' || token[0] > 'Z')
+    {
+      return 3;
+    }
+  return token[0] - 'X';
+}
+
+/**
+ * Parse a line of an ns-2 mobility trace in place.  This is the parser of
+ * the streaming mode: it accepts the statements accepted by ParseNs2Line,
+ * with integer node ids, without copying the tokens.
+ * \param line the line
+ * \param record the parsed statement
+ * \return true if the line is a valid statement
+ */
+static bool
+ParseNs2Record (const std::string &line, Ns2Record &record)
+{
+  const uint32_t maxTokens = 9;
+  const char *tokens[maxTokens];
+  size_t lengths[maxTokens];
+  uint32_t n = 0;
+
+  // split the line before its comment into tokens
+  size_t end = line.find ('#');
+  if (end == std::string::npos)
+    {
+      end = line.size ();
+    }
+  size_t i = 0;
+  while (i < end)
+    {
+      while (i < end && std::isspace (static_cast<unsigned char> (line[i])))
+        {
+          i++;
+        }
+      if (i == end)
+        {
+          break;
+        }
+      size_t start = i;
+      while (i < end && !std::isspace (static_cast<unsigned char> (line[i])))
+        {
+          i++;
+        }
+      if (n == maxTokens)
+        {
+          NS_LOG_WARN ("Line has not correct number of parameters (corrupted file?): " << line);
+          return false;
+        }
+      tokens[n] = line.c_str () + start;
+      lengths[n] = i - start;
+      n++;
+    }
+  // remove the trailing semicolons and quotes
+  while (n > 0)
+    {
+      while (lengths[n - 1] > 0 && tokens[n - 1][lengths[n - 1] - 1] == ';')
+        {
+          lengths[n - 1]--;
+        }
+      if (lengths[n - 1] == 0 || (n > 7 && lengths[n - 1] == 1 && tokens[n - 1][0] == '"'))
+        {
+          n--;
+          continue;
+        }
+      break;
+    }
+  if (n == 0)
+    {
+      return false;
+    }
+  if ((n == 7 || n == 8) && tokens[n - 1][lengths[n - 1] - 1] == '"')
+    {
+      lengths[n - 1]--;
+    }
+
+  if (n == 4)
+    {
+      // $node_(0) set X_ 151.05190721688197
+      uint32_t coordinate = ParseNs2Coordinate (tokens[2], lengths[2]);
+      if (!ParseNs2NodeId (tokens[0], lengths[0], record.node)
+          || lengths[1] != 3 || std::strncmp (tokens[1], NS2_SET, 3) != 0
+          || coordinate == 3
+          || !ParseNs2Number (tokens[3], lengths[3], record.values[0]))
+        {
+          NS_LOG_WARN ("Format Line is not correct: " << line);
+          return false;
+        }
+      record.time = 0;
+      record.type = NS2_RECORD_INITIAL_X + coordinate;
+      return true;
+    }
+  if (n != 7 && n != 8)
+    {
+      NS_LOG_WARN ("Line has not correct number of parameters (corrupted file?): " << line);
+      return false;
+    }
+  if (lengths[0] != 4 || std::strncmp (tokens[0], NS2_NS_SCH, 4) != 0
+      || lengths[1] != 2 || std::strncmp (tokens[1], NS2_AT, 2) != 0
+      || !ParseNs2NodeId (tokens[3], lengths[3], record.node))
+    {
+      NS_LOG_WARN ("Format Line is not correct: " << line);
+      return false;
+    }
+  if (!ParseNs2Number (tokens[2], lengths[2], record.time))
+    {
+      NS_LOG_WARN ("Time is not a number: " << line);
+      return false;
+    }
+  if (record.time < 0)
+    {
+      NS_LOG_WARN ("Time is less than cero: " << line);
+      return false;
+    }
+  if (n == 8)
+    {
+      // $ns_ at 1 "$node_(0) setdest 2 3 4"
+      if (lengths[4] != 7 || std::strncmp (tokens[4], NS2_SETDEST, 7) != 0
+          || !ParseNs2Number (tokens[5], lengths[5], record.values[0])
+          || !ParseNs2Number (tokens[6], lengths[6], record.values[1])
+          || !ParseNs2Number (tokens[7], lengths[7], record.values[2]))
+        {
+          NS_LOG_WARN ("Format Line is not correct: " << line);
+          return false;
+        }
+      if (record.values[2] < 0)
+        {
+          NS_LOG_WARN ("Speed is less than cero: " << line);
+          return false;
+        }
+      record.type = NS2_RECORD_SETDEST;
+      return true;
+    }
+  // $ns_ at 4.634906291962 "$node_(0) set X_ 28.675920486450"
+  uint32_t coordinate = ParseNs2Coordinate (tokens[5], lengths[5]);
+  if (lengths[4] != 3 || std::strncmp (tokens[4], NS2_SET, 3) != 0
+      || coordinate == 3
+      || !ParseNs2Number (tokens[6], lengths[6], record.values[0]))
+    {
+      NS_LOG_WARN ("Format Line is not correct: " << line);
+      return false;
+    }
+  record.type = NS2_RECORD_SET_X + coordinate;
+  return true;
+}
+
+/**
+ * Get the size and the modification time of a file
+ * \param filename the name of the file
+ * \param size the size of the file
+ * \param modification the modification time of the file
+ * \return true if the file exists
+ */
+static bool
+GetNs2FileStatus (std::string filename, uint64_t &size, int64_t &modification)
+{
+  struct stat status;
+  if (stat (filename.c_str (), &status) != 0)
+    {
+      return false;
+    }
+  size = status.st_size;
+  modification = status.st_mtime;
+  return true;
+}
+
+/**
+ * Parse a trace into a binary cache file: the scheduled records in the
+ * order of the trace, then the initial positions
+ * \param traceFilename the name of the trace file
+ * \param cacheFilename the name of the cache file
+ */
+static void
+WriteNs2Cache (std::string traceFilename, std::string cacheFilename)
+{
+  NS_LOG_FUNCTION (traceFilename << cacheFilename);
+  Ns2CacheHeader header;
+  std::memcpy (header.magic, NS2_CACHE_MAGIC, sizeof (header.magic));
+  if (!GetNs2FileStatus (traceFilename, header.traceSize, header.traceModification))
+    {
+      NS_FATAL_ERROR ("Could not open trace file " << traceFilename << " for reading");
+    }
+  header.nScheduled = 0;
+  header.nInitial = 0;
+
+  std::ifstream trace (traceFilename.c_str (), std::ios::in);
+  std::ofstream cache (cacheFilename.c_str (), std::ios::out | std::ios::binary | std::ios::trunc);
+  if (!cache.is_open ())
+    {
+      NS_FATAL_ERROR ("Could not open cache file " << cacheFilename << " for writing");
+    }
+  cache.write (reinterpret_cast<const char *> (&header), sizeof (header));
+  std::vector<Ns2Record> initial;
+  std::string line;
+  Ns2Record record;
+  while (std::getline (trace, line))
+    {
+      if (!ParseNs2Record (line, record))
+        {
+          continue;
+        }
+      if (record.type >= NS2_RECORD_INITIAL_X)
+        {
+          initial.push_back (record);
+          continue;
+        }
+      cache.write (reinterpret_cast<const char *> (&record), sizeof (record));
+      header.nScheduled++;
+    }
+  if (!initial.empty ())
+    {
+      cache.write (reinterpret_cast<const char *> (&initial[0]), initial.size () * sizeof (Ns2Record));
+    }
+  header.nInitial = initial.size ();
+  cache.seekp (0);
+  cache.write (reinterpret_cast<const char *> (&header), sizeof (header));
+  if (!cache)
+    {
+      NS_FATAL_ERROR ("Could not write cache file " << cacheFilename);
+    }
+}
+
+/**
+ * Reads an ns-2 mobility trace, or its binary cache, during the
+ * simulation, and moves the nodes.
+ *
+ * The trace is read one time window ahead of the simulation.  The records
+ * read are queued per node, and a single heap holds the next action of
+ * each node: its next record, or the end of its current movement.  A
+ * single event runs the actions which are due, in the order in which the
+ * eager parser schedules them.
+ */
+class Ns2MobilityStream : public SimpleRefCount<Ns2MobilityStream>
+{
+public:
+  /**
+   * \param objects the objects whose index is the node id
+   * \param window the duration of the trace read at once
+   */
+  Ns2MobilityStream (const std::vector<Ptr<Object> > &objects, Time window);
+  /**
+   * Read a trace file
+   * \param filename the name of the trace file
+   */
+  void OpenTrace (std::string filename);
+  /**
+   * Read a binary cache file, and set the initial positions it stores
+   * \param filename the name of the cache file
+   * \param traceFilename the name of the trace file it was written from
+   * \return false if the cache file is missing or was not written from the
+   *         current trace file
+   */
+  bool OpenCache (std::string filename, std::string traceFilename);
+  /**
+   * Read the first window, and schedule the first event
+   */
+  void Start (void);
+
+private:
+  /// The next action of a node, ordered by time, then by order in the trace
+  struct Action
+  {
+    Time time;      //!< time of the action
+    uint64_t order; //!< order in the trace of the record which caused the action
+    uint32_t stop;  //!< 1 if the action ends a movement, 0 if it runs a record
+    uint32_t node;  //!< node id
+    /**
+     * \param o another action
+     * \return true if this action runs after the other one
+     */
+    bool operator> (const Action &o) const
+    {
+      if (time != o.time)
+        {
+          return time > o.time;
+        }
+      if (order != o.order)
+        {
+          return order > o.order;
+        }
+      return stop > o.stop;
+    }
+  };
+  /// A record waiting for its time
+  struct PendingRecord
+  {
+    Ns2Record record; //!< the record
+    Time time;        //!< time of the record
+    uint64_t order;   //!< order of the record in the trace
+  };
+  /// The state of a node
+  struct NodeState
+  {
+    Ptr<ConstantVelocityMobilityModel> model; //!< the mobility model
+    std::deque<PendingRecord> pending;        //!< records read, earliest first
+    bool moving;                              //!< whether a setdest movement is in progress
+    Time stopTime;                            //!< end of the movement
+    uint64_t stopOrder;                       //!< order of the setdest which started the movement
+    bool hasNext;                             //!< whether the node has an action in the heap
+    Action next;                              //!< the next action of the node
+  };
+
+  /**
+   * Read the next scheduled record, and set the initial positions read
+   * before it
+   * \param record the record
+   * \return false at the end of the trace
+   */
+  bool ReadRecord (Ns2Record &record);
+  /**
+   * Queue the records earlier than a time
+   * \param limit the time
+   */
+  void ReadUntil (Time limit);
+  /**
+   * \param id a node id
+   * \return the state of the node, or 0 if the node is unknown
+   */
+  NodeState * GetNode (uint32_t id);
+  /**
+   * Set an initial position coordinate
+   * \param record the record
+   */
+  void SetInitialPosition (const Ns2Record &record);
+  /**
+   * Put the next action of a node in the heap, if it changed
+   * \param id the node id
+   * \param state the state of the node
+   */
+  void UpdateNext (uint32_t id, NodeState &state);
+  /**
+   * Run a record
+   * \param state the state of the node
+   * \param pending the record
+   */
+  void Apply (NodeState &state, const PendingRecord &pending);
+  /**
+   * Run the actions which are due, read the next records, and schedule the
+   * next event
+   */
+  void Dispatch (void);
+  /**
+   * Schedule the next event
+   */
+  void ScheduleDispatch (void);
+
+  std::vector<Ptr<Object> > m_objects; //!< objects whose index is the node id
+  Time m_window;                       //!< duration of the trace read at once
+  std::map<uint32_t, NodeState> m_nodes; //!< the nodes which appeared in the trace
+  std::priority_queue<Action, std::vector<Action>, std::greater<Action> > m_actions; //!< next actions; stale ones are skipped
+  std::ifstream m_file;                //!< the trace or cache file
+  bool m_binary;                       //!< whether m_file is a cache file
+  uint64_t m_nRemaining;               //!< number of records left in the cache file
+  bool m_hasLookahead;                 //!< whether m_lookahead holds the next record
+  Ns2Record m_lookahead;               //!< the first record which was read but not queued
+  uint64_t m_order;                    //!< order of the next record
+};
+
+Ns2MobilityStream::Ns2MobilityStream (const std::vector<Ptr<Object> > &objects, Time window)
+  : m_objects (objects),
+    m_window (window),
+    m_binary (false),
+    m_nRemaining (0),
+    m_hasLookahead (false),
+    m_order (0)
+{
+}
+
+void
+Ns2MobilityStream::OpenTrace (std::string filename)
+{
+  m_file.open (filename.c_str (), std::ios::in);
+  if (!m_file.is_open ())
+    {
+      NS_FATAL_ERROR ("Could not open trace file " << filename << " for reading");
+    }
+  m_binary = false;
+}
+
+bool
+Ns2MobilityStream::OpenCache (std::string filename, std::string traceFilename)
+{
+  uint64_t traceSize;
+  int64_t traceModification;
+  if (!GetNs2FileStatus (traceFilename, traceSize, traceModification))
+    {
+      return false;
+    }
+  m_file.open (filename.c_str (), std::ios::in | std::ios::binary);
+  if (!m_file.is_open ())
+    {
+      return false;
+    }
+  Ns2CacheHeader header;
+  if (!m_file.read (reinterpret_cast<char *> (&header), sizeof (header))
+      || std::memcmp (header.magic, NS2_CACHE_MAGIC, sizeof (header.magic)) != 0
+      || header.traceSize != traceSize || header.traceModification != traceModification)
+    {
+      NS_LOG_LOGIC ("Cache file " << filename << " is not up to date");
+      m_file.close ();
+      return false;
+    }
+
+  // the initial positions follow the scheduled records
+  m_file.seekg (sizeof (header) + header.nScheduled * sizeof (Ns2Record));
+  std::vector<Ns2Record> initial (header.nInitial);
+  if (header.nInitial > 0
+      && !m_file.read (reinterpret_cast<char *> (&initial[0]), initial.size () * sizeof (Ns2Record)))
+    {
+      NS_LOG_LOGIC ("Cache file " << filename << " is truncated");
+      m_file.close ();
+      return false;
+    }
+  for (std::vector<Ns2Record>::const_iterator it = initial.begin (); it != initial.end (); ++it)
+    {
+      SetInitialPosition (*it);
+    }
+  m_file.seekg (sizeof (header));
+  m_binary = true;
+  m_nRemaining = header.nScheduled;
+  return true;
+}
+
+void
+Ns2MobilityStream::Start (void)
+{
+  m_hasLookahead = ReadRecord (m_lookahead);
+  ReadUntil (Simulator::Now () + m_window);
+  ScheduleDispatch ();
+}
+
+bool
+Ns2MobilityStream::ReadRecord (Ns2Record &record)
+{
+  if (m_binary)
+    {
+      if (m_nRemaining == 0 || !m_file.read (reinterpret_cast<char *> (&record), sizeof (record)))
+        {
+          return false;
+        }
+      m_nRemaining--;
+      return true;
+    }
+  std::string line;
+  while (std::getline (m_file, line))
+    {
+      if (!ParseNs2Record (line, record))
+        {
+          continue;
+        }
+      if (record.type >= NS2_RECORD_INITIAL_X)
+        {
+          SetInitialPosition (record);
+          continue;
+        }
+      return true;
+    }
+  return false;
+}
+
+void
+Ns2MobilityStream::ReadUntil (Time limit)
+{
+  Time now = Simulator::Now ();
+  while (m_hasLookahead && Seconds (m_lookahead.time) < limit)
+    {
+      NodeState *state = GetNode (m_lookahead.node);
+      if (state != 0)
+        {
+          PendingRecord pending;
+          pending.record = m_lookahead;
+          pending.time = Seconds (m_lookahead.time);
+          pending.order = m_order++;
+          Time earliest = state->pending.empty () ? now : state->pending.back ().time;
+          if (pending.time < earliest)
+            {
+              NS_LOG_WARN ("Statement for node " << m_lookahead.node << " at " << m_lookahead.time
+                                                 << " s is out of order, moved to " << earliest.GetSeconds () << " s");
+              pending.time = earliest;
+            }
+          state->pending.push_back (pending);
+          if (state->pending.size () == 1)
+            {
+              UpdateNext (m_lookahead.node, *state);
+            }
+        }
+      m_hasLookahead = ReadRecord (m_lookahead);
+    }
+}
+
+Ns2MobilityStream::NodeState *
+Ns2MobilityStream::GetNode (uint32_t id)
+{
+  std::map<uint32_t, NodeState>::iterator it = m_nodes.find (id);
+  if (it != m_nodes.end ())
+    {
+      return &it->second;
+    }
+  if (id >= m_objects.size () || m_objects[id] == 0)
+    {
+      NS_LOG_ERROR ("Unknown node ID (corrupted file?): " << id);
+      return 0;
+    }
+  Ptr<Object> object = m_objects[id];
+  NodeState &state = m_nodes[id];
+  state.model = object->GetObject<ConstantVelocityMobilityModel> ();
+  if (state.model == 0)
+    {
+      state.model = CreateObject<ConstantVelocityMobilityModel> ();
+      object->AggregateObject (state.model);
+    }
+  state.moving = false;
+  state.stopOrder = 0;
+  state.hasNext = false;
+  return &state;
+}
+
+void
+Ns2MobilityStream::SetInitialPosition (const Ns2Record &record)
+{
+  NodeState *state = GetNode (record.node);
+  if (state == 0)
+    {
+      return;
+    }
+  Vector position = state->model->GetPosition ();
+  switch (record.type)
+    {
+    case NS2_RECORD_INITIAL_X:
+      position.x = record.values[0];
+      break;
+    case NS2_RECORD_INITIAL_Y:
+      position.y = record.values[0];
+      break;
+    default:
+      position.z = record.values[0];
+      break;
+    }
+  state->model->SetPosition (position);
+}
+
+void
+Ns2MobilityStream::UpdateNext (uint32_t id, NodeState &state)
+{
+  bool hasNext = false;
+  Action next;
+  next.node = id;
+  if (!state.pending.empty ())
+    {
+      const PendingRecord &front = state.pending.front ();
+      next.time = front.time;
+      next.order = front.order;
+      next.stop = 0;
+      hasNext = true;
+    }
+  if (state.moving)
+    {
+      Action stop;
+      stop.time = state.stopTime;
+      stop.order = state.stopOrder;
+      stop.stop = 1;
+      stop.node = id;
+      if (!hasNext || next > stop)
+        {
+          next = stop;
+          hasNext = true;
+        }
+    }
+  if (hasNext && state.hasNext && !(next > state.next) && !(state.next > next))
+    {
+      return;
+    }
+  state.hasNext = hasNext;
+  if (hasNext)
+    {
+      state.next = next;
+      m_actions.push (next);
+    }
+}
+
+void
+Ns2MobilityStream::Apply (NodeState &state, const PendingRecord &pending)
+{
+  const Ns2Record &record = pending.record;
+  Ptr<ConstantVelocityMobilityModel> model = state.model;
+  bool wasMoving = state.moving;
+  state.moving = false;
+  if (record.type != NS2_RECORD_SETDEST)
+    {
+      Vector position = model->GetPosition ();
+      switch (record.type)
+        {
+        case NS2_RECORD_SET_X:
+          position.x = record.values[0];
+          break;
+        case NS2_RECORD_SET_Y:
+          position.y = record.values[0];
+          break;
+        default:
+          position.z = record.values[0];
+          break;
+        }
+      model->SetPosition (position);
+      return;
+    }
+
+  double speed = record.values[2];
+  if (speed == 0)
+    {
+      // We have to maintain last position, and stop the movement
+      model->SetVelocity (Vector (0, 0, 0));
+      return;
+    }
+  Vector position = model->GetPosition ();
+  double dx = record.values[0] - position.x;
+  double dy = record.values[1] - position.y;
+  double time = std::sqrt (dx * dx + dy * dy) / speed;
+  if (time == 0)
+    {
+      if (wasMoving)
+        {
+          model->SetVelocity (Vector (0, 0, 0));
+        }
+      return;
+    }
+  model->SetVelocity (Vector (dx / time, dy / time, 0));
+  state.moving = true;
+  state.stopTime = Seconds (record.time + time);
+  state.stopOrder = pending.order;
+}
+
+void
+Ns2MobilityStream::Dispatch (void)
+{
+  Time now = Simulator::Now ();
+  ReadUntil (now + m_window);
+  while (!m_actions.empty () && m_actions.top ().time <= now)
+    {
+      Action action = m_actions.top ();
+      m_actions.pop ();
+      NodeState &state = m_nodes[action.node];
+      // skip the actions which were replaced since they were queued
+      if (!state.hasNext || action > state.next || state.next > action)
+        {
+          continue;
+        }
+      state.hasNext = false;
+      if (action.stop)
+        {
+          state.moving = false;
+          state.model->SetVelocity (Vector (0, 0, 0));
+        }
+      else
+        {
+          PendingRecord pending = state.pending.front ();
+          state.pending.pop_front ();
+          Apply (state, pending);
+        }
+      UpdateNext (action.node, state);
+    }
+  ScheduleDispatch ();
+}
+
+void
+Ns2MobilityStream::ScheduleDispatch (void)
+{
+  Time next = Time::Max ();
+  if (!m_actions.empty ())
+    {
+      next = m_actions.top ().time;
+    }
+  if (m_hasLookahead)
+    {
+      next = std::min (next, std::max (Seconds (m_lookahead.time), Simulator::Now ()));
+    }
+  if (next == Time::Max ())
+    {
+      return;
+    }
+  Simulator::Schedule (next - Simulator::Now (), &Ns2MobilityStream::Dispatch, Ptr<Ns2MobilityStream> (this));
+}
+
+void
+Ns2MobilityHelper::ConfigNodesStreaming (const ObjectStore &store) const
+{
+  std::vector<Ptr<Object> > objects;
+  for (uint32_t i = 0; ; i++)
+    {
+      Ptr<Object> object = store.Get (i);
+      if (object == 0)
+        {
+          break;
+        }
+      objects.push_back (object);
+    }
+
+  Ptr<Ns2MobilityStream> stream = Create<Ns2MobilityStream> (objects, m_window);
+  if (m_cacheFilename.empty ())
+    {
+      stream->OpenTrace (m_filename);
+    }
+  else if (!stream->OpenCache (m_cacheFilename, m_filename))
+    {
+      WriteNs2Cache (m_filename, m_cacheFilename);
+      if (!stream->OpenCache (m_cacheFilename, m_filename))
+        {
+          NS_FATAL_ERROR ("Could not read cache file " << m_cacheFilename);
+        }
+    }
+  stream->Start ();
+}
+
 void
 Ns2MobilityHelper::Install (void) const
 {
@@ -27,6 +27,7 @@
 #include <stdint.h>
 #include "ns3/ptr.h"
 #include "ns3/object.h"
+#include "ns3/nstime.h"
 
 namespace ns3 {
 
@@ -69,6 +70,13 @@ class ConstantVelocityMobilityModel;
  *
  *  See usage example in examples/mobility/ns2-mobility-trace.cc
  *
+ * By default, Install reads the whole trace and schedules all its
+ * movements before the simulation starts.  For long traces with many
+ * nodes, EnableStreaming reads the trace during the simulation instead, one
+ * time window at a time, and schedules only the next movement of each node;
+ * SetCacheFilename also stores the parsed trace in a binary file, which is
+ * read instead of the trace by the next simulations.
+ *
  * \bug Rounding errors may cause movement to diverge from the mobility
  * pattern in ns-2 (using the same trace).
  * See https://www.nsnam.org/bugzilla/show_bug.cgi?id=1316
@@ -103,6 +111,33 @@ public:
    */
   template <typename T>
   void Install (T begin, T end) const;
+
+  /**
+   * Read the trace during the simulation instead of reading it entirely
+   * in Install.
+   *
+   * Install reads the initial positions and the statements of the first
+   * time window; the statements of each next window are read when the
+   * simulation reaches it.  The scheduled statements must be sorted by
+   * time, and the initial positions must precede them: the initial
+   * positions which follow them are only set when they are read.  The
+   * nodes which do not appear before the end of the first window get
+   * their ConstantVelocityMobilityModel when their first statement is read.
+   *
+   * \param window the duration of the trace read at once
+   */
+  void EnableStreaming (Time window = Seconds (60));
+  /**
+   * Store the parsed trace in a binary file, used by the streaming mode.
+   *
+   * If the file was written from the current trace file, it is read
+   * instead of the trace.  Otherwise, Install parses the trace into it
+   * first.  The initial positions stored in the file are all set by
+   * Install, wherever they appear in the trace.  Implies EnableStreaming.
+   *
+   * \param filename the name of the binary file
+   */
+  void SetCacheFilename (std::string filename);
 private:
   /**
    * \brief a class to hold input objects internally
@@ -130,7 +165,15 @@ public:
    * \return pointer to a ConstantVelocityMobilityModel
    */
   Ptr<ConstantVelocityMobilityModel> GetMobilityModel (std::string idString, const ObjectStore &store) const;
+  /**
+   * Read the ns-2 mobility file during the simulation
+   * \param store Object store containing ns-3 mobility models
+   */
+  void ConfigNodesStreaming (const ObjectStore &store) const;
   std::string m_filename; //!< filename of file containing ns-2 mobility trace 
+  bool m_streaming;       //!< whether the trace is read during the simulation
+  Time m_window;          //!< duration of the trace read at once when streaming
+  std::string m_cacheFilename; //!< filename of the binary parsed trace, empty if none
 };
 
 } // namespace ns3
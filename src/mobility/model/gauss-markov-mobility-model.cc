@@ -18,6 +18,7 @@
  * Author: Dan Broyles <dbroyl01@ku.edu>
  */
 #include <cmath>
+#include <algorithm>
 #include "ns3/simulator.h"
 #include "ns3/double.h"
 #include "ns3/pointer.h"
@@ -80,12 +81,20 @@ GaussMarkovMobilityModel::GetTypeId (void)
                    "A gaussian random variable used to calculate the next pitch value.",
                    StringValue ("ns3::NormalRandomVariable[Mean=0.0|Variance=1.0|Bound=10.0]"),
                    MakePointerAccessor (&GaussMarkovMobilityModel::m_normalPitch),
-                   MakePointerChecker<NormalRandomVariable> ());
+                   MakePointerChecker<NormalRandomVariable> ())
+    .AddAttribute ("Engine",
+                   "The mobility engine which stores the trajectory, "
+                   "or null to schedule one event per time step.",
+                   PointerValue (),
+                   MakePointerAccessor (&GaussMarkovMobilityModel::m_engine),
+                   MakePointerChecker<MobilityEngine> ());
 
   return tid;
 }
 
 GaussMarkovMobilityModel::GaussMarkovMobilityModel ()
+  : m_engineRegistered (false),
+    m_engineIndex (0)
 {
   m_meanVelocity = 0.0;
   m_meanDirection = 0.0;
@@ -97,25 +106,49 @@ GaussMarkovMobilityModel::GaussMarkovMobilityModel ()
 void
 GaussMarkovMobilityModel::Start (void)
 {
+  if (m_engine)
+    {
+      NS_ASSERT_MSG (m_timeStep.IsStrictlyPositive (), "The time step must be positive");
+      m_engineIndex = m_engine->Add (MakeCallback (&GaussMarkovMobilityModel::NextLeg, this));
+      m_engineRegistered = true;
+      m_engine->SetPosition (m_engineIndex, m_helper.GetCurrentPosition ());
+      return;
+    }
   if (m_meanVelocity == 0.0)
     {
-      //Initialize the mean velocity, direction, and pitch variables
-      m_meanVelocity = m_rndMeanVelocity->GetValue ();
-      m_meanDirection = m_rndMeanDirection->GetValue ();
-      m_meanPitch = m_rndMeanPitch->GetValue ();
-      double cosD = std::cos (m_meanDirection);
-      double cosP = std::cos (m_meanPitch);
-      double sinD = std::sin (m_meanDirection);
-      double sinP = std::sin (m_meanPitch);
-      //Initialize the starting velocity, direction, and pitch to be identical to the mean ones
-      m_Velocity = m_meanVelocity;
-      m_Direction = m_meanDirection;
-      m_Pitch = m_meanPitch;
       //Set the velocity vector to give to the constant velocity helper
-      m_helper.SetVelocity (Vector (m_Velocity*cosD*cosP, m_Velocity*sinD*cosP, m_Velocity*sinP));
+      m_helper.SetVelocity (InitializeMeans ());
     }
   m_helper.Update ();
 
+  m_helper.SetVelocity (DrawVelocity ());
+
+  m_helper.Unpause ();
+
+  DoWalk (m_timeStep);
+}
+
+Vector
+GaussMarkovMobilityModel::InitializeMeans (void)
+{
+  //Initialize the mean velocity, direction, and pitch variables
+  m_meanVelocity = m_rndMeanVelocity->GetValue ();
+  m_meanDirection = m_rndMeanDirection->GetValue ();
+  m_meanPitch = m_rndMeanPitch->GetValue ();
+  double cosD = std::cos (m_meanDirection);
+  double cosP = std::cos (m_meanPitch);
+  double sinD = std::sin (m_meanDirection);
+  double sinP = std::sin (m_meanPitch);
+  //Initialize the starting velocity, direction, and pitch to be identical to the mean ones
+  m_Velocity = m_meanVelocity;
+  m_Direction = m_meanDirection;
+  m_Pitch = m_meanPitch;
+  return Vector (m_Velocity*cosD*cosP, m_Velocity*sinD*cosP, m_Velocity*sinP);
+}
+
+Vector
+GaussMarkovMobilityModel::DrawVelocity (void)
+{
   //Get the next values from the gaussian distributions for velocity, direction, and pitch
   double rv = m_normalVelocity->GetValue ();
   double rd = m_normalDirection->GetValue ();
@@ -138,63 +171,87 @@ GaussMarkovMobilityModel::Start (void)
   double vx = m_Velocity * cosDir * cosPit;
   double vy = m_Velocity * sinDir * cosPit;
   double vz = m_Velocity * sinPit;
-  m_helper.SetVelocity (Vector (vx, vy, vz));
-
-  m_helper.Unpause ();
-
-  DoWalk (m_timeStep);
+  return Vector (vx, vy, vz);
 }
 
-void
-GaussMarkovMobilityModel::DoWalk (Time delayLeft)
+Vector
+GaussMarkovMobilityModel::Bounce (const Vector &position, Vector speed, Time delayLeft)
 {
-  m_helper.UpdateWithBounds (m_bounds);
-  Vector position = m_helper.GetCurrentPosition ();
-  Vector speed = m_helper.GetVelocity ();
   Vector nextPosition = position;
   nextPosition.x += speed.x * delayLeft.GetSeconds ();
   nextPosition.y += speed.y * delayLeft.GetSeconds ();
   nextPosition.z += speed.z * delayLeft.GetSeconds ();
-  if (delayLeft.GetSeconds () < 0.0) delayLeft = Seconds (1.0);
 
   // Make sure that the position by the next time step is still within the boundary.
   // If out of bounds, then alter the velocity vector and average direction to keep the position in bounds
   if (m_bounds.IsInside (nextPosition))
     {
-      m_event = Simulator::Schedule (delayLeft, &GaussMarkovMobilityModel::Start, this);
+      return speed;
     }
-  else
+
+  if (nextPosition.x > m_bounds.xMax || nextPosition.x < m_bounds.xMin) 
     {
-      if (nextPosition.x > m_bounds.xMax || nextPosition.x < m_bounds.xMin) 
-        {
-          speed.x = -speed.x;
-          m_meanDirection = M_PI - m_meanDirection;
-        }
-
-      if (nextPosition.y > m_bounds.yMax || nextPosition.y < m_bounds.yMin) 
-        {
-          speed.y = -speed.y;
-          m_meanDirection = -m_meanDirection;
-        }
-
-      if (nextPosition.z > m_bounds.zMax || nextPosition.z < m_bounds.zMin) 
-        {
-          speed.z = -speed.z;
-          m_meanPitch = -m_meanPitch;
-        }
-
-      m_Direction = m_meanDirection;
-      m_Pitch = m_meanPitch;
-      m_helper.SetVelocity (speed);
-      m_helper.Unpause ();
-      m_event = Simulator::Schedule (delayLeft, &GaussMarkovMobilityModel::Start, this);
+      speed.x = -speed.x;
+      m_meanDirection = M_PI - m_meanDirection;
     }
+
+  if (nextPosition.y > m_bounds.yMax || nextPosition.y < m_bounds.yMin) 
+    {
+      speed.y = -speed.y;
+      m_meanDirection = -m_meanDirection;
+    }
+
+  if (nextPosition.z > m_bounds.zMax || nextPosition.z < m_bounds.zMin) 
+    {
+      speed.z = -speed.z;
+      m_meanPitch = -m_meanPitch;
+    }
+
+  m_Direction = m_meanDirection;
+  m_Pitch = m_meanPitch;
+  return speed;
+}
+
+void
+GaussMarkovMobilityModel::DoWalk (Time delayLeft)
+{
+  m_helper.UpdateWithBounds (m_bounds);
+  Vector position = m_helper.GetCurrentPosition ();
+  Vector speed = Bounce (position, m_helper.GetVelocity (), delayLeft);
+  if (delayLeft.GetSeconds () < 0.0) delayLeft = Seconds (1.0);
+
+  m_helper.SetVelocity (speed);
+  m_helper.Unpause ();
+  m_event = Simulator::Schedule (delayLeft, &GaussMarkovMobilityModel::Start, this);
+  NotifyCourseChange ();
+}
+
+void
+GaussMarkovMobilityModel::NextLeg (void)
+{
+  // the end of the previous time step may be slightly out of the bounds
+  Vector position = m_engine->GetLegStartPosition (m_engineIndex);
+  position.x = std::min (m_bounds.xMax, std::max (m_bounds.xMin, position.x));
+  position.y = std::min (m_bounds.yMax, std::max (m_bounds.yMin, position.y));
+  position.z = std::min (m_bounds.zMax, std::max (m_bounds.zMin, position.z));
+  if (m_meanVelocity == 0.0)
+    {
+      InitializeMeans ();
+    }
+  Vector speed = Bounce (position, DrawVelocity (), m_timeStep);
+  m_engine->SetLeg (m_engineIndex, position, speed, m_timeStep);
   NotifyCourseChange ();
 }
 
 void
 GaussMarkovMobilityModel::DoDispose (void)
 {
+  if (m_engineRegistered)
+    {
+      m_engine->Remove (m_engineIndex);
+      m_engineRegistered = false;
+    }
+  m_engine = 0;
   // chain up
   MobilityModel::DoDispose ();
 }
@@ -202,12 +259,21 @@ GaussMarkovMobilityModel::DoDispose (void)
 Vector
 GaussMarkovMobilityModel::DoGetPosition (void) const
 {
+  if (m_engineRegistered)
+    {
+      return m_engine->GetPosition (m_engineIndex);
+    }
   m_helper.Update ();
   return m_helper.GetCurrentPosition ();
 }
 void 
 GaussMarkovMobilityModel::DoSetPosition (const Vector &position)
 {
+  if (m_engineRegistered)
+    {
+      m_engine->SetPosition (m_engineIndex, position);
+      return;
+    }
   m_helper.SetPosition (position);
   Simulator::Remove (m_event);
   m_event = Simulator::ScheduleNow (&GaussMarkovMobilityModel::Start, this);
@@ -215,6 +281,10 @@ GaussMarkovMobilityModel::DoSetPosition (const Vector &position)
 Vector
 GaussMarkovMobilityModel::DoGetVelocity (void) const
 {
+  if (m_engineRegistered)
+    {
+      return m_engine->GetVelocity (m_engineIndex);
+    }
   return m_helper.GetVelocity ();
 }
 
@@ -25,6 +25,7 @@
 #include "constant-velocity-helper.h"
 #include "mobility-model.h"
 #include "position-allocator.h"
+#include "mobility-engine.h"
 #include "ns3/ptr.h"
 #include "ns3/object.h"
 #include "ns3/nstime.h"
@@ -76,6 +77,10 @@ namespace ns3 {
  * [1] Tracy Camp, Jeff Boleng, Vanessa Davies, "A Survey of Mobility Models
  * for Ad Hoc Network Research", Wireless Communications and Mobile Computing,
  * Wiley, vol.2 iss.5, September 2002, pp.483-502
+ *
+ * If the Engine attribute is set, the model does not schedule one event per
+ * time step: its trajectory is stored by the MobilityEngine, which draws the
+ * next velocity only when it is needed.
  */
 class GaussMarkovMobilityModel : public MobilityModel
 {
@@ -96,6 +101,30 @@ private:
    * \param timeLeft time until Start method is called again
    */
   void DoWalk (Time timeLeft);
+  /**
+   * Initialize the mean velocity, direction, and pitch, and the current
+   * ones to the same values
+   * \return the mean velocity vector
+   */
+  Vector InitializeMeans (void);
+  /**
+   * Calculate the new velocity, direction, and pitch
+   * \return the new velocity vector
+   */
+  Vector DrawVelocity (void);
+  /**
+   * Alter the velocity vector and the mean direction to keep the position in
+   * the bounds at the end of the time step
+   * \param position the position at the start of the time step
+   * \param velocity the velocity during the time step
+   * \param timeLeft the duration of the time step
+   * \return the velocity which keeps the position in the bounds
+   */
+  Vector Bounce (const Vector &position, Vector velocity, Time timeLeft);
+  /**
+   * Set the next time step in the engine, and notify the course change
+   */
+  void NextLeg (void);
   virtual void DoDispose (void);
   virtual Vector DoGetPosition (void) const;
   virtual void DoSetPosition (const Vector &position);
@@ -118,6 +147,9 @@ private:
   Ptr<NormalRandomVariable> m_normalPitch; //!< Gaussian rv for next pitch
   EventId m_event; //!< event id of scheduled start
   Box m_bounds; //!< bounding box
+  Ptr<MobilityEngine> m_engine; //!< the engine which stores the trajectory, if any
+  bool m_engineRegistered; //!< whether the trajectory was added to the engine
+  uint32_t m_engineIndex; //!< the index of the trajectory in the engine
 };
 
 } // namespace ns3
@@ -0,0 +1,257 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "mobility-engine.h"
+#include "ns3/simulator.h"
+#include "ns3/log.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("MobilityEngine");
+
+NS_OBJECT_ENSURE_REGISTERED (MobilityEngine);
+
+TypeId
+MobilityEngine::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::MobilityEngine")
+    .SetParent<Object> ()
+    .SetGroupName ("Mobility")
+    .AddConstructor<MobilityEngine> ()
+    .AddAttribute ("NotificationInterval",
+                   "The period of the events which process the legs which ended, "
+                   "and notify the course changes.  If zero, an event runs at the "
+                   "end of each leg.",
+                   TimeValue (Seconds (0)),
+                   MakeTimeAccessor (&MobilityEngine::m_notificationInterval),
+                   MakeTimeChecker (Seconds (0)));
+  return tid;
+}
+
+MobilityEngine::MobilityEngine ()
+  : m_processing (false)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+MobilityEngine::~MobilityEngine ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+void
+MobilityEngine::DoDispose (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_event.Cancel ();
+  m_positions.clear ();
+  m_velocities.clear ();
+  m_legStarts.clear ();
+  m_legEnds.clear ();
+  m_nextLegs.clear ();
+  m_freeIndexes.clear ();
+  m_legEndQueue = std::priority_queue<LegEnd, std::vector<LegEnd>, std::greater<LegEnd> > ();
+  Object::DoDispose ();
+}
+
+uint32_t
+MobilityEngine::Add (Callback<void> nextLeg)
+{
+  NS_LOG_FUNCTION (this);
+  NS_ASSERT (!nextLeg.IsNull ());
+  uint32_t index;
+  if (m_freeIndexes.empty ())
+    {
+      index = m_positions.size ();
+      m_positions.push_back (Vector ());
+      m_velocities.push_back (Vector ());
+      m_legStarts.push_back (Time ());
+      m_legEnds.push_back (Time::Max ());
+      m_nextLegs.push_back (nextLeg);
+    }
+  else
+    {
+      index = m_freeIndexes.back ();
+      m_freeIndexes.pop_back ();
+      m_nextLegs[index] = nextLeg;
+    }
+  return index;
+}
+
+void
+MobilityEngine::Remove (uint32_t index)
+{
+  NS_LOG_FUNCTION (this << index);
+  NS_ASSERT (index < m_nextLegs.size () && !m_nextLegs[index].IsNull ());
+  m_nextLegs[index] = Callback<void> ();
+  m_legEnds[index] = Time::Max ();
+  m_freeIndexes.push_back (index);
+}
+
+void
+MobilityEngine::SetPosition (uint32_t index, const Vector &position)
+{
+  NS_LOG_FUNCTION (this << index << position);
+  NS_ASSERT (index < m_nextLegs.size () && !m_nextLegs[index].IsNull ());
+  Restart (index, position);
+}
+
+Vector
+MobilityEngine::GetPosition (uint32_t index)
+{
+  NS_ASSERT (index < m_nextLegs.size () && !m_nextLegs[index].IsNull ());
+  Advance (index);
+  double t = (Simulator::Now () - m_legStarts[index]).GetSeconds ();
+  const Vector &position = m_positions[index];
+  const Vector &velocity = m_velocities[index];
+  return Vector (position.x + velocity.x * t,
+                 position.y + velocity.y * t,
+                 position.z + velocity.z * t);
+}
+
+Vector
+MobilityEngine::GetVelocity (uint32_t index)
+{
+  NS_ASSERT (index < m_nextLegs.size () && !m_nextLegs[index].IsNull ());
+  Advance (index);
+  return m_velocities[index];
+}
+
+Vector
+MobilityEngine::GetLegStartPosition (uint32_t index) const
+{
+  return m_positions[index];
+}
+
+Time
+MobilityEngine::GetLegStartTime (uint32_t index) const
+{
+  return m_legStarts[index];
+}
+
+void
+MobilityEngine::SetLeg (uint32_t index, const Vector &position, const Vector &velocity, Time duration)
+{
+  NS_LOG_FUNCTION (this << index << position << velocity << duration);
+  NS_ASSERT (!duration.IsStrictlyNegative ());
+  m_positions[index] = position;
+  m_velocities[index] = velocity;
+  if (duration == Time::Max ())
+    {
+      m_legEnds[index] = Time::Max ();
+      return;
+    }
+  Time legEnd = m_legStarts[index] + duration;
+  m_legEnds[index] = legEnd;
+  if (legEnd > Simulator::Now ())
+    {
+      // the legs which end in the past are advanced by the caller
+      m_legEndQueue.push (std::make_pair (legEnd, index));
+      ScheduleLegEnd (legEnd);
+    }
+}
+
+uint32_t
+MobilityEngine::GetN (void) const
+{
+  return m_nextLegs.size () - m_freeIndexes.size ();
+}
+
+void
+MobilityEngine::Restart (uint32_t index, const Vector &position)
+{
+  m_positions[index] = position;
+  m_velocities[index] = Vector ();
+  m_legStarts[index] = Simulator::Now ();
+  m_legEnds[index] = Time::Max ();
+  m_nextLegs[index] ();
+  Advance (index);
+}
+
+void
+MobilityEngine::Advance (uint32_t index)
+{
+  Time now = Simulator::Now ();
+  while (m_legEnds[index] <= now)
+    {
+      Time legEnd = m_legEnds[index];
+      double t = (legEnd - m_legStarts[index]).GetSeconds ();
+      Vector &position = m_positions[index];
+      const Vector &velocity = m_velocities[index];
+      position.x += velocity.x * t;
+      position.y += velocity.y * t;
+      position.z += velocity.z * t;
+      m_legStarts[index] = legEnd;
+      m_legEnds[index] = Time::Max ();
+      // the callback may query the position, which advances the trajectory
+      // further, or remove the trajectory
+      Callback<void> nextLeg = m_nextLegs[index];
+      nextLeg ();
+      if (m_nextLegs[index].IsNull ())
+        {
+          return;
+        }
+    }
+}
+
+void
+MobilityEngine::ProcessLegEnds (void)
+{
+  NS_LOG_FUNCTION (this);
+  Time now = Simulator::Now ();
+  m_processing = true;
+  while (!m_legEndQueue.empty () && m_legEndQueue.top ().first <= now)
+    {
+      LegEnd legEnd = m_legEndQueue.top ();
+      m_legEndQueue.pop ();
+      uint32_t index = legEnd.second;
+      // skip the legs which were replaced since they were queued
+      if (!m_nextLegs[index].IsNull () && m_legEnds[index] == legEnd.first)
+        {
+          Advance (index);
+        }
+    }
+  m_processing = false;
+  if (!m_legEndQueue.empty ())
+    {
+      ScheduleLegEnd (m_legEndQueue.top ().first);
+    }
+}
+
+void
+MobilityEngine::ScheduleLegEnd (Time legEnd)
+{
+  if (m_processing)
+    {
+      // ProcessLegEnds schedules the next event when it is done
+      return;
+    }
+  Time eventTime = legEnd;
+  if (m_notificationInterval.IsStrictlyPositive ())
+    {
+      int64_t interval = m_notificationInterval.GetTimeStep ();
+      eventTime = m_notificationInterval * ((legEnd.GetTimeStep () + interval - 1) / interval);
+    }
+  if (m_event.IsRunning () && m_eventTime <= eventTime)
+    {
+      return;
+    }
+  m_event.Cancel ();
+  m_eventTime = eventTime;
+  m_event = Simulator::Schedule (eventTime - Simulator::Now (), &MobilityEngine::ProcessLegEnds, this);
+}
+
+} // namespace ns3
@@ -0,0 +1,172 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#ifndef MOBILITY_ENGINE_H
+#define MOBILITY_ENGINE_H
+
+#include "ns3/object.h"
+#include "ns3/nstime.h"
+#include "ns3/event-id.h"
+#include "ns3/callback.h"
+#include "ns3/vector.h"
+#include <vector>
+#include <queue>
+
+namespace ns3 {
+
+/**
+ * \ingroup mobility
+ * \brief Stores the piecewise linear trajectories of many mobility models
+ * and advances them lazily.
+ *
+ * A trajectory is a sequence of legs, each with a start position, a
+ * constant velocity and a duration.  The mobility models which use an
+ * engine (see the Engine attribute of RandomWaypointMobilityModel,
+ * RandomWalk2dMobilityModel and GaussMarkovMobilityModel) do not schedule
+ * one event per leg: the engine stores the current leg of each of them in
+ * contiguous arrays, and asks a mobility model for its next leg only when
+ * its position is queried after the end of the current leg, or when the
+ * engine processes the legs which ended.
+ *
+ * The legs which ended are processed by a single event, so that the mobility
+ * models notify their course changes in batches.  With a zero
+ * NotificationInterval, the event runs at the end of each leg, and the
+ * course changes are notified on time.  With a positive interval, the event
+ * runs at most once per interval, and the course changes are notified up to
+ * one interval late; the positions and velocities returned by the mobility
+ * models are exact in both cases.
+ */
+class MobilityEngine : public Object
+{
+public:
+  /**
+   * Register this type with the TypeId system.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+
+  MobilityEngine ();
+  virtual ~MobilityEngine ();
+
+  /**
+   * Add a trajectory.  Its first leg starts when SetPosition is called.
+   * \param nextLeg the callback which sets the next leg with SetLeg, called
+   *        at the end of each leg
+   * \return the index of the trajectory
+   */
+  uint32_t Add (Callback<void> nextLeg);
+  /**
+   * Remove a trajectory.  Its index may be reused by Add.
+   * \param index the index of the trajectory
+   */
+  void Remove (uint32_t index);
+
+  /**
+   * Set the position of a trajectory at the current time, and start a new
+   * leg by calling its nextLeg callback.
+   * \param index the index of the trajectory
+   * \param position the new position
+   */
+  void SetPosition (uint32_t index, const Vector &position);
+  /**
+   * \param index the index of the trajectory
+   * \return the position at the current time
+   */
+  Vector GetPosition (uint32_t index);
+  /**
+   * \param index the index of the trajectory
+   * \return the velocity at the current time
+   */
+  Vector GetVelocity (uint32_t index);
+
+  /**
+   * Get the start position of the leg being set.  To be called by the
+   * nextLeg callback: the position is the end position of the previous leg.
+   * \param index the index of the trajectory
+   * \return the start position of the leg
+   */
+  Vector GetLegStartPosition (uint32_t index) const;
+  /**
+   * Get the start time of the leg being set.  To be called by the nextLeg
+   * callback: the time is the end time of the previous leg, which may be
+   * earlier than the current time.
+   * \param index the index of the trajectory
+   * \return the start time of the leg
+   */
+  Time GetLegStartTime (uint32_t index) const;
+  /**
+   * Set the leg which starts at GetLegStartTime.  To be called by the
+   * nextLeg callback.
+   * \param index the index of the trajectory
+   * \param position the start position of the leg
+   * \param velocity the velocity during the leg
+   * \param duration the duration of the leg, Time::Max () if infinite
+   */
+  void SetLeg (uint32_t index, const Vector &position, const Vector &velocity, Time duration);
+
+  /**
+   * \return the number of trajectories
+   */
+  uint32_t GetN (void) const;
+
+protected:
+  virtual void DoDispose (void);
+
+private:
+  /**
+   * Start the legs of a trajectory until the current leg ends after the
+   * current time
+   * \param index the index of the trajectory
+   */
+  void Advance (uint32_t index);
+  /**
+   * Start a leg at the current time
+   * \param index the index of the trajectory
+   * \param position the start position
+   */
+  void Restart (uint32_t index, const Vector &position);
+  /**
+   * Advance the trajectories whose leg ended, and schedule the next event
+   */
+  void ProcessLegEnds (void);
+  /**
+   * Schedule the event which processes the leg ends, if a leg ends before
+   * the scheduled event
+   * \param legEnd the end time of a leg
+   */
+  void ScheduleLegEnd (Time legEnd);
+
+  /// a leg end, ordered by time in m_legEndQueue
+  typedef std::pair<Time, uint32_t> LegEnd;
+
+  Time m_notificationInterval; //!< the period of the leg end events, 0 if the events run at the end of each leg
+
+  std::vector<Vector> m_positions;  //!< start positions of the current legs
+  std::vector<Vector> m_velocities; //!< velocities of the current legs
+  std::vector<Time> m_legStarts;    //!< start times of the current legs
+  std::vector<Time> m_legEnds;      //!< end times of the current legs
+  std::vector<Callback<void> > m_nextLegs; //!< callbacks which set the next legs, null if removed
+  std::vector<uint32_t> m_freeIndexes;     //!< indexes of the removed trajectories
+
+  /// leg ends, earliest first; the entries of legs which were replaced are skipped
+  std::priority_queue<LegEnd, std::vector<LegEnd>, std::greater<LegEnd> > m_legEndQueue;
+  EventId m_event;       //!< the event which processes the leg ends
+  Time m_eventTime;      //!< the time of m_event
+  bool m_processing;     //!< whether the leg ends are being processed
+};
+
+} // namespace ns3
+
+#endif /* MOBILITY_ENGINE_H */
@@ -25,6 +25,7 @@
 #include "ns3/simulator.h"
 #include "ns3/log.h"
 #include <cmath>
+#include <algorithm>
 
 namespace ns3 {
 
@@ -70,17 +71,97 @@ RandomWalk2dMobilityModel::GetTypeId (void)
                    "A random variable used to pick the speed (m/s).",
                    StringValue ("ns3::UniformRandomVariable[Min=2.0|Max=4.0]"),
                    MakePointerAccessor (&RandomWalk2dMobilityModel::m_speed),
-                   MakePointerChecker<RandomVariableStream> ());
+                   MakePointerChecker<RandomVariableStream> ())
+    .AddAttribute ("Engine",
+                   "The mobility engine which stores the trajectory, "
+                   "or null to schedule one event per walk and rebound.",
+                   PointerValue (),
+                   MakePointerAccessor (&RandomWalk2dMobilityModel::m_engine),
+                   MakePointerChecker<MobilityEngine> ());
   return tid;
 }
 
+RandomWalk2dMobilityModel::RandomWalk2dMobilityModel ()
+  : m_engineRegistered (false),
+    m_engineIndex (0),
+    m_engineRebound (false)
+{
+}
+
 void
 RandomWalk2dMobilityModel::DoInitialize (void)
 {
-  DoInitializePrivate ();
+  if (m_engine)
+    {
+      m_engineRebound = false;
+      m_engineIndex = m_engine->Add (MakeCallback (&RandomWalk2dMobilityModel::NextLeg, this));
+      m_engineRegistered = true;
+      m_engine->SetPosition (m_engineIndex, m_helper.GetCurrentPosition ());
+    }
+  else
+    {
+      DoInitializePrivate ();
+    }
   MobilityModel::DoInitialize ();
 }
 
+void
+RandomWalk2dMobilityModel::NextLeg (void)
+{
+  // the end of the previous leg may be slightly out of the bounds
+  Vector position = m_engine->GetLegStartPosition (m_engineIndex);
+  position.x = std::min (m_bounds.xMax, std::max (m_bounds.xMin, position.x));
+  position.y = std::min (m_bounds.yMax, std::max (m_bounds.yMin, position.y));
+  if (m_engineRebound)
+    {
+      switch (m_bounds.GetClosestSide (position))
+        {
+        case Rectangle::RIGHT:
+        case Rectangle::LEFT:
+          m_engineVelocity.x = -m_engineVelocity.x;
+          break;
+        case Rectangle::TOP:
+        case Rectangle::BOTTOM:
+          m_engineVelocity.y = -m_engineVelocity.y;
+          break;
+        }
+    }
+  else
+    {
+      double speed = m_speed->GetValue ();
+      double direction = m_direction->GetValue ();
+      m_engineVelocity = Vector (std::cos (direction) * speed,
+                                 std::sin (direction) * speed,
+                                 0.0);
+      if (m_mode == RandomWalk2dMobilityModel::MODE_TIME)
+        {
+          m_engineDelayLeft = m_modeTime;
+        }
+      else
+        {
+          m_engineDelayLeft = Seconds (m_modeDistance / speed);
+        }
+    }
+
+  Vector nextPosition = position;
+  nextPosition.x += m_engineVelocity.x * m_engineDelayLeft.GetSeconds ();
+  nextPosition.y += m_engineVelocity.y * m_engineDelayLeft.GetSeconds ();
+  if (m_bounds.IsInside (nextPosition))
+    {
+      m_engine->SetLeg (m_engineIndex, position, m_engineVelocity, m_engineDelayLeft);
+      m_engineRebound = false;
+    }
+  else
+    {
+      nextPosition = m_bounds.CalculateIntersection (position, m_engineVelocity);
+      Time delay = Seconds ((nextPosition.x - position.x) / m_engineVelocity.x);
+      m_engine->SetLeg (m_engineIndex, position, m_engineVelocity, delay);
+      m_engineDelayLeft -= delay;
+      m_engineRebound = true;
+    }
+  NotifyCourseChange ();
+}
+
 void
 RandomWalk2dMobilityModel::DoInitializePrivate (void)
 {
@@ -153,12 +234,22 @@ RandomWalk2dMobilityModel::Rebound (Time delayLeft)
 void
 RandomWalk2dMobilityModel::DoDispose (void)
 {
+  if (m_engineRegistered)
+    {
+      m_engine->Remove (m_engineIndex);
+      m_engineRegistered = false;
+    }
+  m_engine = 0;
   // chain up
   MobilityModel::DoDispose ();
 }
 Vector
 RandomWalk2dMobilityModel::DoGetPosition (void) const
 {
+  if (m_engineRegistered)
+    {
+      return m_engine->GetPosition (m_engineIndex);
+    }
   m_helper.UpdateWithBounds (m_bounds);
   return m_helper.GetCurrentPosition ();
 }
@@ -166,13 +257,29 @@ void
 RandomWalk2dMobilityModel::DoSetPosition (const Vector &position)
 {
   NS_ASSERT (m_bounds.IsInside (position));
+  if (m_engineRegistered)
+    {
+      // the new position starts a new walk
+      m_engineRebound = false;
+      m_engine->SetPosition (m_engineIndex, position);
+      return;
+    }
   m_helper.SetPosition (position);
+  if (m_engine)
+    {
+      // the trajectory starts when the model is initialized
+      return;
+    }
   Simulator::Remove (m_event);
   m_event = Simulator::ScheduleNow (&RandomWalk2dMobilityModel::DoInitializePrivate, this);
 }
 Vector
 RandomWalk2dMobilityModel::DoGetVelocity (void) const
 {
+  if (m_engineRegistered)
+    {
+      return m_engine->GetVelocity (m_engineIndex);
+    }
   return m_helper.GetVelocity ();
 }
 int64_t
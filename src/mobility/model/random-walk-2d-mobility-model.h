@@ -27,6 +27,7 @@
 #include "ns3/random-variable-stream.h"
 #include "mobility-model.h"
 #include "constant-velocity-helper.h"
+#include "mobility-engine.h"
 
 namespace ns3 {
 
@@ -42,6 +43,10 @@ namespace ns3 {
  * of the model, we rebound on the boundary with a reflexive angle
  * and speed. This model is often identified as a brownian motion
  * model.
+ *
+ * If the Engine attribute is set, the model does not schedule the events
+ * of its walks and rebounds: its trajectory is stored by the MobilityEngine,
+ * which draws the next walk only when it is needed.
  */
 class RandomWalk2dMobilityModel : public MobilityModel 
 {
@@ -57,6 +62,8 @@ public:
     MODE_TIME
   };
 
+  RandomWalk2dMobilityModel ();
+
 private:
   /**
    * \brief Performs the rebound of the node if it reaches a boundary
@@ -72,6 +79,10 @@ private:
    * Perform initialization of the object before MobilityModel::DoInitialize ()
    */
   void DoInitializePrivate (void);
+  /**
+   * Set the next walk or rebound in the engine, and notify the course change
+   */
+  void NextLeg (void);
   virtual void DoDispose (void);
   virtual void DoInitialize (void);
   virtual Vector DoGetPosition (void) const;
@@ -87,6 +98,12 @@ private:
   Ptr<RandomVariableStream> m_speed; //!< rv for picking speed
   Ptr<RandomVariableStream> m_direction; //!< rv for picking direction
   Rectangle m_bounds; //!< Bounds of the area to cruise
+  Ptr<MobilityEngine> m_engine; //!< the engine which stores the trajectory, if any
+  bool m_engineRegistered; //!< whether the trajectory was added to the engine
+  uint32_t m_engineIndex; //!< the index of the trajectory in the engine
+  Vector m_engineVelocity; //!< the velocity of the current leg in the engine
+  Time m_engineDelayLeft; //!< the remaining time of the current walk after its current leg in the engine
+  bool m_engineRebound; //!< whether the current leg in the engine ends on a boundary
 };
 
 
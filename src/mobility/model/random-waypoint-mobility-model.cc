@@ -50,11 +50,24 @@ RandomWaypointMobilityModel::GetTypeId (void)
                    "The position model used to pick a destination point.",
                    PointerValue (),
                    MakePointerAccessor (&RandomWaypointMobilityModel::m_position),
-                   MakePointerChecker<PositionAllocator> ());
+                   MakePointerChecker<PositionAllocator> ())
+    .AddAttribute ("Engine",
+                   "The mobility engine which stores the trajectory, "
+                   "or null to schedule one event per pause and walk.",
+                   PointerValue (),
+                   MakePointerAccessor (&RandomWaypointMobilityModel::m_engine),
+                   MakePointerChecker<MobilityEngine> ());
 
   return tid;
 }
 
+RandomWaypointMobilityModel::RandomWaypointMobilityModel ()
+  : m_engineRegistered (false),
+    m_engineIndex (0),
+    m_walking (false)
+{
+}
+
 void
 RandomWaypointMobilityModel::BeginWalk (void)
 {
@@ -80,10 +93,58 @@ RandomWaypointMobilityModel::BeginWalk (void)
 void
 RandomWaypointMobilityModel::DoInitialize (void)
 {
-  DoInitializePrivate ();
+  if (m_engine)
+    {
+      // the first leg is a pause
+      m_walking = true;
+      m_engineIndex = m_engine->Add (MakeCallback (&RandomWaypointMobilityModel::NextLeg, this));
+      m_engineRegistered = true;
+      m_engine->SetPosition (m_engineIndex, m_helper.GetCurrentPosition ());
+    }
+  else
+    {
+      DoInitializePrivate ();
+    }
   MobilityModel::DoInitialize ();
 }
 
+void
+RandomWaypointMobilityModel::DoDispose (void)
+{
+  if (m_engineRegistered)
+    {
+      m_engine->Remove (m_engineIndex);
+      m_engineRegistered = false;
+    }
+  m_engine = 0;
+  MobilityModel::DoDispose ();
+}
+
+void
+RandomWaypointMobilityModel::NextLeg (void)
+{
+  Vector current = m_engine->GetLegStartPosition (m_engineIndex);
+  if (m_walking)
+    {
+      m_walking = false;
+      m_engine->SetLeg (m_engineIndex, current, Vector (0, 0, 0), Seconds (m_pause->GetValue ()));
+    }
+  else
+    {
+      NS_ASSERT_MSG (m_position, "No position allocator added before using this model");
+      Vector destination = m_position->GetNext ();
+      double speed = m_speed->GetValue ();
+      double dx = (destination.x - current.x);
+      double dy = (destination.y - current.y);
+      double dz = (destination.z - current.z);
+      double k = speed / std::sqrt (dx*dx + dy*dy + dz*dz);
+      m_walking = true;
+      m_engine->SetLeg (m_engineIndex, current, Vector (k*dx, k*dy, k*dz),
+                        Seconds (CalculateDistance (destination, current) / speed));
+    }
+  NotifyCourseChange ();
+}
+
 void
 RandomWaypointMobilityModel::DoInitializePrivate (void)
 {
@@ -97,19 +158,39 @@ RandomWaypointMobilityModel::DoInitializePrivate (void)
 Vector
 RandomWaypointMobilityModel::DoGetPosition (void) const
 {
+  if (m_engineRegistered)
+    {
+      return m_engine->GetPosition (m_engineIndex);
+    }
   m_helper.Update ();
   return m_helper.GetCurrentPosition ();
 }
 void 
 RandomWaypointMobilityModel::DoSetPosition (const Vector &position)
 {
+  if (m_engineRegistered)
+    {
+      // the new position starts a pause
+      m_walking = true;
+      m_engine->SetPosition (m_engineIndex, position);
+      return;
+    }
   m_helper.SetPosition (position);
+  if (m_engine)
+    {
+      // the trajectory starts when the model is initialized
+      return;
+    }
   Simulator::Remove (m_event);
   m_event = Simulator::ScheduleNow (&RandomWaypointMobilityModel::DoInitializePrivate, this);
 }
 Vector
 RandomWaypointMobilityModel::DoGetVelocity (void) const
 {
+  if (m_engineRegistered)
+    {
+      return m_engine->GetVelocity (m_engineIndex);
+    }
   return m_helper.GetVelocity ();
 }
 int64_t
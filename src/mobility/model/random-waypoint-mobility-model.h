@@ -23,6 +23,7 @@
 #include "constant-velocity-helper.h"
 #include "mobility-model.h"
 #include "position-allocator.h"
+#include "mobility-engine.h"
 #include "ns3/ptr.h"
 #include "ns3/random-variable-stream.h"
 
@@ -48,6 +49,12 @@ namespace ns3 {
  * a 3d random waypoint position model to this mobility model, the model 
  * will still work. There is no 3d position allocator for now but it should
  * be trivial to add one.
+ *
+ * If the Engine attribute is set, the model does not schedule the events
+ * of its pauses and walks: its trajectory is stored by the MobilityEngine,
+ * which draws the next pause or walk only when it is needed.  The trajectory
+ * is the same as without an engine, unless the PositionAllocator is shared
+ * with other models, in which case the order of its draws may differ.
  */
 class RandomWaypointMobilityModel : public MobilityModel
 {
@@ -57,8 +64,10 @@ public:
    * \return the object TypeId
    */
   static TypeId GetTypeId (void);
+  RandomWaypointMobilityModel ();
 protected:
   virtual void DoInitialize (void);
+  virtual void DoDispose (void);
 private:
   /**
    * Get next position, begin moving towards it, schedule future pause event
@@ -68,6 +77,10 @@ private:
    * Begin current pause event, schedule future walk event
    */
   void DoInitializePrivate (void);
+  /**
+   * Set the next pause or walk in the engine, and notify the course change
+   */
+  void NextLeg (void);
   virtual Vector DoGetPosition (void) const;
   virtual void DoSetPosition (const Vector &position);
   virtual Vector DoGetVelocity (void) const;
@@ -78,6 +91,10 @@ private:
   Ptr<RandomVariableStream> m_speed; //!< random variable to generate speeds
   Ptr<RandomVariableStream> m_pause; //!< random variable to generate pauses
   EventId m_event; //!< event ID of next scheduled event
+  Ptr<MobilityEngine> m_engine; //!< the engine which stores the trajectory, if any
+  bool m_engineRegistered; //!< whether the trajectory was added to the engine
+  uint32_t m_engineIndex; //!< the index of the trajectory in the engine
+  bool m_walking; //!< whether the current leg in the engine is a walk
 };
 
 } // namespace ns3
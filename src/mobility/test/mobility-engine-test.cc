@@ -0,0 +1,315 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/simulator.h"
+#include "ns3/pointer.h"
+#include "ns3/string.h"
+#include "ns3/nstime.h"
+#include "ns3/object-factory.h"
+#include "ns3/mobility-engine.h"
+#include "ns3/random-waypoint-mobility-model.h"
+#include "ns3/random-walk-2d-mobility-model.h"
+#include "ns3/gauss-markov-mobility-model.h"
+#include "ns3/position-allocator.h"
+#include "ns3/test.h"
+#include <cmath>
+
+using namespace ns3;
+
+/**
+ * \ingroup mobility-test
+ * \ingroup tests
+ *
+ * \brief Check that a mobility model which uses a MobilityEngine follows the
+ * same trajectory as the same model which schedules its own events
+ */
+class MobilityEngineTrajectoryTest : public TestCase
+{
+public:
+  /**
+   * Constructor
+   *
+   * \param typeId the type of the mobility model
+   * \param notificationInterval the NotificationInterval of the engine
+   */
+  MobilityEngineTrajectoryTest (std::string typeId, Time notificationInterval);
+  virtual ~MobilityEngineTrajectoryTest ();
+
+private:
+  virtual void DoRun (void);
+  /**
+   * \param engine the engine, or null
+   * \return a new mobility model
+   */
+  Ptr<MobilityModel> CreateModel (Ptr<MobilityEngine> engine);
+  /**
+   * Compare the positions and velocities of the two models
+   */
+  void Compare (void);
+  /**
+   * Move both models
+   * \param position the new position
+   */
+  void SetPosition (Vector position);
+
+  std::string m_typeId;         //!< the type of the mobility model
+  Time m_notificationInterval;  //!< the NotificationInterval of the engine
+  Ptr<MobilityModel> m_events;  //!< the model which schedules its own events
+  Ptr<MobilityModel> m_engine;  //!< the model which uses the engine
+  double m_maxError;            //!< largest distance between the two models
+  uint32_t m_nComparisons;      //!< number of comparisons
+};
+
+MobilityEngineTrajectoryTest::MobilityEngineTrajectoryTest (std::string typeId, Time notificationInterval)
+  : TestCase ("Check the trajectory of " + typeId + " with a MobilityEngine, "
+              + (notificationInterval.IsZero () ? "notified per leg" : "notified in batches")),
+    m_typeId (typeId),
+    m_notificationInterval (notificationInterval),
+    m_maxError (0),
+    m_nComparisons (0)
+{
+}
+
+MobilityEngineTrajectoryTest::~MobilityEngineTrajectoryTest ()
+{
+}
+
+Ptr<MobilityModel>
+MobilityEngineTrajectoryTest::CreateModel (Ptr<MobilityEngine> engine)
+{
+  ObjectFactory factory;
+  factory.SetTypeId (m_typeId);
+  factory.Set ("Engine", PointerValue (engine));
+  if (m_typeId == "ns3::RandomWaypointMobilityModel")
+    {
+      Ptr<PositionAllocator> allocator = CreateObject<RandomRectanglePositionAllocator> ();
+      allocator->SetAttribute ("X", StringValue ("ns3::UniformRandomVariable[Min=0.0|Max=100.0]"));
+      allocator->SetAttribute ("Y", StringValue ("ns3::UniformRandomVariable[Min=0.0|Max=100.0]"));
+      factory.Set ("PositionAllocator", PointerValue (allocator));
+      factory.Set ("Speed", StringValue ("ns3::UniformRandomVariable[Min=1.0|Max=20.0]"));
+      factory.Set ("Pause", StringValue ("ns3::UniformRandomVariable[Min=0.0|Max=3.0]"));
+    }
+  else if (m_typeId == "ns3::RandomWalk2dMobilityModel")
+    {
+      // the initial position must not be on the bounds
+      factory.Set ("Bounds", StringValue ("-100|100|-100|100"));
+      factory.Set ("Mode", StringValue ("Time"));
+      factory.Set ("Time", StringValue ("3s"));
+      factory.Set ("Speed", StringValue ("ns3::UniformRandomVariable[Min=5.0|Max=20.0]"));
+    }
+  else
+    {
+      factory.Set ("TimeStep", StringValue ("0.5s"));
+      factory.Set ("Alpha", StringValue ("0.85"));
+      factory.Set ("MeanVelocity", StringValue ("ns3::UniformRandomVariable[Min=5.0|Max=10.0]"));
+    }
+  Ptr<MobilityModel> model = factory.Create<MobilityModel> ();
+  model->AssignStreams (1);
+  model->Initialize ();
+  return model;
+}
+
+void
+MobilityEngineTrajectoryTest::Compare (void)
+{
+  Vector a = m_events->GetPosition ();
+  Vector b = m_engine->GetPosition ();
+  m_maxError = std::max (m_maxError, CalculateDistance (a, b));
+  Vector va = m_events->GetVelocity ();
+  Vector vb = m_engine->GetVelocity ();
+  m_maxError = std::max (m_maxError, CalculateDistance (va, vb));
+  m_nComparisons++;
+}
+
+void
+MobilityEngineTrajectoryTest::SetPosition (Vector position)
+{
+  m_events->SetPosition (position);
+  m_engine->SetPosition (position);
+}
+
+void
+MobilityEngineTrajectoryTest::DoRun (void)
+{
+  Ptr<MobilityEngine> engine = CreateObject<MobilityEngine> ();
+  engine->SetAttribute ("NotificationInterval", TimeValue (m_notificationInterval));
+  m_events = CreateModel (0);
+  m_engine = CreateModel (engine);
+
+  // the models are compared at irregular times, sometimes many legs apart,
+  // and never at the end of a time step of GaussMarkovMobilityModel, where
+  // the velocity depends on the order of the events
+  Time t = MicroSeconds (1);
+  for (uint32_t i = 0; i < 2000; i++)
+    {
+      t += MilliSeconds (i % 10 == 0 ? 7919 : 13 + (i % 7) * 97);
+      Simulator::Schedule (t, &MobilityEngineTrajectoryTest::Compare, this);
+    }
+  Simulator::Schedule (t / 2, &MobilityEngineTrajectoryTest::SetPosition, this, Vector (50, 50, 50));
+  Simulator::Stop (t);
+  Simulator::Run ();
+  Simulator::Destroy ();
+
+  NS_TEST_EXPECT_MSG_EQ (m_nComparisons, 2000, "Not all the comparisons ran");
+  NS_TEST_EXPECT_MSG_LT (m_maxError, 1e-6, "The trajectories are different");
+  NS_TEST_EXPECT_MSG_EQ (engine->GetN (), 1, "The model should have been added to the engine");
+
+  m_engine->Dispose ();
+  m_events->Dispose ();
+  NS_TEST_EXPECT_MSG_EQ (engine->GetN (), 0, "The model should have been removed from the engine");
+  engine->Dispose ();
+}
+
+/**
+ * \ingroup mobility-test
+ * \ingroup tests
+ *
+ * \brief Check the course change notifications of the mobility models which
+ * use a MobilityEngine
+ */
+class MobilityEngineNotificationTest : public TestCase
+{
+public:
+  MobilityEngineNotificationTest ();
+  virtual ~MobilityEngineNotificationTest ();
+
+private:
+  virtual void DoRun (void);
+  /**
+   * Record a course change of a model which schedules its own events
+   * \param model the mobility model
+   */
+  void EventsCourseChange (Ptr<const MobilityModel> model);
+  /**
+   * Record a course change of a model which uses the engine
+   * \param model the mobility model
+   */
+  void EngineCourseChange (Ptr<const MobilityModel> model);
+
+  std::vector<Time> m_eventsChanges; //!< times of the course changes without engine
+  std::vector<Time> m_engineChanges; //!< times of the course changes with the engine
+  bool m_onInterval;                 //!< whether all the course changes with the engine were on the interval
+};
+
+MobilityEngineNotificationTest::MobilityEngineNotificationTest ()
+  : TestCase ("Check the batched course change notifications of MobilityEngine"),
+    m_onInterval (true)
+{
+}
+
+MobilityEngineNotificationTest::~MobilityEngineNotificationTest ()
+{
+}
+
+void
+MobilityEngineNotificationTest::EventsCourseChange (Ptr<const MobilityModel> model)
+{
+  m_eventsChanges.push_back (Simulator::Now ());
+}
+
+void
+MobilityEngineNotificationTest::EngineCourseChange (Ptr<const MobilityModel> model)
+{
+  if (Simulator::Now () != Seconds (std::floor (Simulator::Now ().GetSeconds ())))
+    {
+      m_onInterval = false;
+    }
+  m_engineChanges.push_back (Simulator::Now ());
+}
+
+void
+MobilityEngineNotificationTest::DoRun (void)
+{
+  Ptr<MobilityEngine> engine = CreateObject<MobilityEngine> ();
+  engine->SetAttribute ("NotificationInterval", TimeValue (Seconds (1)));
+  std::vector<Ptr<MobilityModel> > models;
+  for (uint32_t i = 0; i < 100; i++)
+    {
+      for (uint32_t withEngine = 0; withEngine < 2; withEngine++)
+        {
+          Ptr<RandomWalk2dMobilityModel> model = CreateObject<RandomWalk2dMobilityModel> ();
+          model->SetAttribute ("Bounds", StringValue ("-100|100|-100|100"));
+          model->SetAttribute ("Mode", StringValue ("Time"));
+          model->SetAttribute ("Time", StringValue ("0.3s"));
+          if (withEngine)
+            {
+              model->SetAttribute ("Engine", PointerValue (engine));
+              model->TraceConnectWithoutContext ("CourseChange", MakeCallback (&MobilityEngineNotificationTest::EngineCourseChange, this));
+            }
+          else
+            {
+              model->TraceConnectWithoutContext ("CourseChange", MakeCallback (&MobilityEngineNotificationTest::EventsCourseChange, this));
+            }
+          model->AssignStreams (i);
+          model->Initialize ();
+          models.push_back (model);
+        }
+    }
+  // the initial course changes are notified at time 0
+  m_eventsChanges.clear ();
+  m_engineChanges.clear ();
+
+  Simulator::Stop (Seconds (100.5));
+  Simulator::Run ();
+  Simulator::Destroy ();
+
+  // all the legs which started by 100 s were notified at a multiple of 1 s
+  uint32_t nEventsChanges = 0;
+  for (std::vector<Time>::const_iterator it = m_eventsChanges.begin (); it != m_eventsChanges.end (); ++it)
+    {
+      if (*it <= Seconds (100))
+        {
+          nEventsChanges++;
+        }
+    }
+  NS_TEST_EXPECT_MSG_GT (nEventsChanges, 30000, "Too few course changes");
+  NS_TEST_EXPECT_MSG_EQ (m_engineChanges.size (), nEventsChanges, "Unexpected number of course changes");
+  NS_TEST_EXPECT_MSG_EQ (m_onInterval, true, "The course changes should be notified on the interval");
+
+  for (uint32_t i = 0; i < models.size (); i++)
+    {
+      models[i]->Dispose ();
+    }
+  engine->Dispose ();
+}
+
+/**
+ * \ingroup mobility-test
+ * \ingroup tests
+ *
+ * \brief MobilityEngine Test Suite
+ */
+class MobilityEngineTestSuite : public TestSuite
+{
+public:
+  MobilityEngineTestSuite ();
+};
+
+MobilityEngineTestSuite::MobilityEngineTestSuite ()
+  : TestSuite ("mobility-engine", UNIT)
+{
+  const char *types[] = { "ns3::RandomWaypointMobilityModel",
+                          "ns3::RandomWalk2dMobilityModel",
+                          "ns3::GaussMarkovMobilityModel" };
+  for (uint32_t i = 0; i < 3; i++)
+    {
+      AddTestCase (new MobilityEngineTrajectoryTest (types[i], Seconds (0)), TestCase::QUICK);
+      AddTestCase (new MobilityEngineTrajectoryTest (types[i], Seconds (1)), TestCase::QUICK);
+    }
+  AddTestCase (new MobilityEngineNotificationTest, TestCase::QUICK);
+}
+
+static MobilityEngineTestSuite g_mobilityEngineTestSuite; //!< the test suite
@@ -23,6 +23,8 @@
 #include "ns3/double.h"
 #include "ns3/log.h"
 #include "ns3/uinteger.h"
+#include "ns3/enum.h"
+#include <cmath>
 #include "propagation-loss-model.h"
 #include "jakes-propagation-loss-model.h"
 
@@ -30,6 +32,11 @@ namespace ns3 {
 
 NS_LOG_COMPONENT_DEFINE ("JakesProcess");
 
+/// Number of rotations of the phasors after which they are set to their exact value again
+static const uint32_t MAX_ROTATIONS_SINCE_SYNC = 1000;
+/// Number of samples beyond which the phasors are set to their exact value instead of being rotated
+static const int64_t MAX_SAMPLES_ROTATED = 16;
+
 /// Represents a single oscillator
 JakesProcess::Oscillator::Oscillator (std::complex<double> amplitude, double initialPhase, double omega) :
   m_amplitude (amplitude),
@@ -60,6 +67,17 @@ JakesProcess::GetTypeId ()
                    UintegerValue (20),
                    MakeUintegerAccessor (&JakesProcess::SetNOscillators),
                    MakeUintegerChecker<unsigned int> (4, 1000))
+    .AddAttribute ("Mode", "How the complex gain is evaluated: exactly at each call, "
+                   "or interpolated between samples of the process",
+                   EnumValue (JakesProcess::EXACT),
+                   MakeEnumAccessor (&JakesProcess::m_mode),
+                   MakeEnumChecker (JakesProcess::EXACT, "Exact",
+                                    JakesProcess::INTERPOLATED, "Interpolated"))
+    .AddAttribute ("SamplesPerDopplerPeriod", "The number of samples per period of "
+                   "the maximum Doppler frequency in the Interpolated mode",
+                   UintegerValue (32),
+                   MakeUintegerAccessor (&JakesProcess::m_samplesPerDopplerPeriod),
+                   MakeUintegerChecker<uint32_t> (4))
   ;
   return tid;
 }
@@ -72,7 +90,6 @@ JakesProcess::SetPropagationLossModel (Ptr<const PropagationLossModel> propagati
   m_jakes = jakes;
   
   NS_ASSERT (m_nOscillators != 0);
-  NS_ASSERT (m_omegaDopplerMax != 0);
   
   ConstructOscillators ();
 }
@@ -111,11 +128,31 @@ JakesProcess::ConstructOscillators ()
       /// 3. Construct oscillator:
       m_oscillators.push_back (Oscillator (amplitude, phi, omega)); 
     }
+  // without Doppler, the process is constant and there is no sample
+  // interval, so that the gain is always evaluated exactly
+  m_sampleInterval = 0;
+  m_rotations.clear ();
+  if (m_omegaDopplerMax > 0)
+    {
+      m_sampleInterval = 2 * M_PI / (m_omegaDopplerMax * m_samplesPerDopplerPeriod);
+      for (unsigned int i = 0; i < m_oscillators.size (); i++)
+        {
+          double angle = m_oscillators[i].m_omega * m_sampleInterval;
+          m_rotations.push_back (std::complex<double> (std::cos (angle), std::sin (angle)));
+        }
+    }
+  m_phasors.resize (m_oscillators.size ());
+  m_sample = -1;
 }
 
 JakesProcess::JakesProcess () :
   m_omegaDopplerMax (0),
-  m_nOscillators (0)
+  m_nOscillators (0),
+  m_mode (EXACT),
+  m_samplesPerDopplerPeriod (32),
+  m_sampleInterval (0),
+  m_sample (-1),
+  m_rotationsSinceSync (0)
 {
 }
 
@@ -133,6 +170,10 @@ JakesProcess::DoDispose ()
 std::complex<double>
 JakesProcess::GetComplexGain () const
 {
+  if (m_mode == INTERPOLATED && m_sampleInterval > 0)
+    {
+      return GetInterpolatedComplexGain ();
+    }
   std::complex<double> sumAplitude = std::complex<double> (0, 0);
   for (unsigned int i = 0; i < m_oscillators.size (); i++)
     {
@@ -141,6 +182,85 @@ JakesProcess::GetComplexGain () const
   return sumAplitude;
 }
 
+std::complex<double>
+JakesProcess::GetInterpolatedComplexGain () const
+{
+  NS_ASSERT (m_sampleInterval > 0);
+  double position = Now ().GetSeconds () / m_sampleInterval;
+  int64_t sample = static_cast<int64_t> (std::floor (position));
+  if (sample != m_sample)
+    {
+      AdvanceSamples (sample);
+    }
+  return m_gain0 + (m_gain1 - m_gain0) * (position - sample);
+}
+
+void
+JakesProcess::AdvanceSamples (int64_t sample) const
+{
+  // the phasors are at sample m_sample + 1
+  if (m_sample < 0 || sample <= m_sample || sample - m_sample > MAX_SAMPLES_ROTATED
+      || m_rotationsSinceSync + (sample - m_sample) > MAX_ROTATIONS_SINCE_SYNC)
+    {
+      SetPhasors (sample);
+      m_gain0 = SumPhasors ();
+    }
+  else if (sample == m_sample + 1)
+    {
+      m_gain0 = m_gain1;
+    }
+  else
+    {
+      for (int64_t i = m_sample + 1; i < sample; i++)
+        {
+          RotatePhasors ();
+        }
+      m_gain0 = SumPhasors ();
+    }
+  RotatePhasors ();
+  m_gain1 = SumPhasors ();
+  m_sample = sample;
+}
+
+void
+JakesProcess::SetPhasors (int64_t sample) const
+{
+  double t = sample * m_sampleInterval;
+  for (unsigned int i = 0; i < m_oscillators.size (); i++)
+    {
+      double angle = t * m_oscillators[i].m_omega + m_oscillators[i].m_phase;
+      m_phasors[i] = std::complex<double> (std::cos (angle), std::sin (angle));
+    }
+  m_rotationsSinceSync = 0;
+}
+
+void
+JakesProcess::RotatePhasors () const
+{
+  // plain loop over the real and imaginary parts so that it is vectorized
+  for (unsigned int i = 0; i < m_phasors.size (); i++)
+    {
+      double re = m_phasors[i].real () * m_rotations[i].real () - m_phasors[i].imag () * m_rotations[i].imag ();
+      double im = m_phasors[i].real () * m_rotations[i].imag () + m_phasors[i].imag () * m_rotations[i].real ();
+      m_phasors[i] = std::complex<double> (re, im);
+    }
+  m_rotationsSinceSync++;
+}
+
+std::complex<double>
+JakesProcess::SumPhasors () const
+{
+  // the value of an oscillator is its amplitude times the real part of its phasor
+  double re = 0;
+  double im = 0;
+  for (unsigned int i = 0; i < m_phasors.size (); i++)
+    {
+      re += m_oscillators[i].m_amplitude.real () * m_phasors[i].real ();
+      im += m_oscillators[i].m_amplitude.imag () * m_phasors[i].real ();
+    }
+  return std::complex<double> (re, im);
+}
+
 double
 JakesProcess::GetChannelGainDb () const
 {
@@ -51,6 +51,17 @@ class JakesPropagationLossModel;
  * [1] Y. R. Zheng and C. Xiao, "Simulation Models With Correct
  * Statistical Properties for Rayleigh Fading Channel", IEEE
  * Trans. on Communications, Vol. 51, pp 920-928, June 2003
+ *
+ * With the "Mode" attribute set to INTERPOLATED, the complex gain is
+ * sampled SamplesPerDopplerPeriod times per period of the maximum Doppler
+ * frequency and linearly interpolated in between.  The samples are computed
+ * on demand by rotating the phasor \f$e^{j(\omega_d t\cos(\alpha_n)+\phi)}\f$
+ * of each oscillator by a constant step, without calling std::cos, and are
+ * resynchronized with the exact value of the phasors from time to time.
+ * The oscillators are the same as in the EXACT mode, so that the
+ * statistics of the process, including its Doppler spectrum, are preserved
+ * up to the interpolation error.  With a zero DopplerFrequencyHz, the
+ * process is constant and is evaluated exactly in both modes.
  */
 class JakesProcess : public Object
 {
@@ -60,6 +71,14 @@ public:
    * \return the object TypeId
    */
   static TypeId GetTypeId (void);
+
+  /// How the complex gain is evaluated
+  enum Mode
+  {
+    EXACT,        //!< sum of the oscillators at the current time
+    INTERPOLATED  //!< interpolation between samples of the sum of the oscillators
+  };
+
   JakesProcess ();
   virtual ~JakesProcess();
   virtual void DoDispose ();
@@ -122,12 +141,47 @@ private:
    *
    */
   void ConstructOscillators ();
+
+  /**
+   * Get the channel complex gain interpolated between the two samples
+   * surrounding the current time
+   * \return the channel complex gain
+   */
+  std::complex<double> GetInterpolatedComplexGain () const;
+  /**
+   * Make m_gain0 and m_gain1 the samples of index sample and sample + 1
+   * \param sample the index of the sample
+   */
+  void AdvanceSamples (int64_t sample) const;
+  /**
+   * Set the phasors of the oscillators to their exact value at a sample
+   * \param sample the index of the sample
+   */
+  void SetPhasors (int64_t sample) const;
+  /**
+   * Rotate the phasors of the oscillators to the next sample
+   */
+  void RotatePhasors () const;
+  /**
+   * \return the complex gain given by the current phasors of the oscillators
+   */
+  std::complex<double> SumPhasors () const;
+
 private:
   std::vector<Oscillator> m_oscillators; //!< Vector of oscillators
   double m_omegaDopplerMax; //!< max rotation speed Doppler frequency
   unsigned int m_nOscillators;  //!< number of oscillators
   Ptr<UniformRandomVariable> m_uniformVariable; //!< random stream
   Ptr<const JakesPropagationLossModel> m_jakes; //!< pointer to the propagation loss model
+  Mode m_mode; //!< how the complex gain is evaluated
+  uint32_t m_samplesPerDopplerPeriod; //!< number of samples per period of the maximum Doppler frequency
+  double m_sampleInterval; //!< interval between two samples [s]
+  mutable std::vector<std::complex<double> > m_phasors; //!< phasors of the oscillators at sample m_sample + 1
+  std::vector<std::complex<double> > m_rotations; //!< rotation of the phasors of the oscillators between two samples
+  mutable int64_t m_sample; //!< index of the sample m_gain0, or -1 before the first sample
+  mutable uint32_t m_rotationsSinceSync; //!< number of rotations of the phasors since they were last set to their exact value
+  mutable std::complex<double> m_gain0; //!< complex gain at sample m_sample
+  mutable std::complex<double> m_gain1; //!< complex gain at sample m_sample + 1
 };
 } // namespace ns3
 #endif // DOPPLER_PROCESS_H
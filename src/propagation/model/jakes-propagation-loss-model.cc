@@ -20,6 +20,7 @@
 
 #include "jakes-propagation-loss-model.h"
 #include "ns3/double.h"
+#include "ns3/uinteger.h"
 #include "ns3/log.h"
 
 namespace ns3
@@ -31,6 +32,8 @@ NS_OBJECT_ENSURE_REGISTERED (JakesPropagationLossModel);
 
 
 JakesPropagationLossModel::JakesPropagationLossModel()
+  : m_cacheMaxSize (0),
+    m_cacheMaxIdleTime (Seconds (0))
 {
   m_uniformVariable = CreateObject<UniformRandomVariable> ();
   m_uniformVariable->SetAttribute ("Min", DoubleValue (-1.0 * M_PI));
@@ -47,6 +50,21 @@ JakesPropagationLossModel::GetTypeId ()
     .SetParent<PropagationLossModel> ()
     .SetGroupName ("Propagation")
     .AddConstructor<JakesPropagationLossModel> ()
+    .AddAttribute ("CacheMaxSize",
+                   "The maximum number of paths whose fading process is kept, "
+                   "the least recently used path being dropped first. "
+                   "A dropped path gets a new fading process. Zero means no limit.",
+                   UintegerValue (0),
+                   MakeUintegerAccessor (&JakesPropagationLossModel::SetCacheMaxSize,
+                                         &JakesPropagationLossModel::GetCacheMaxSize),
+                   MakeUintegerChecker<uint32_t> ())
+    .AddAttribute ("CacheMaxIdleTime",
+                   "The time after which the fading process of a path which "
+                   "has not been used is dropped. Zero means no limit.",
+                   TimeValue (Seconds (0)),
+                   MakeTimeAccessor (&JakesPropagationLossModel::SetCacheMaxIdleTime,
+                                     &JakesPropagationLossModel::GetCacheMaxIdleTime),
+                   MakeTimeChecker ())
   ;
   return tid;
 }
@@ -72,6 +90,32 @@ JakesPropagationLossModel::GetUniformRandomVariable () const
   return m_uniformVariable;
 }
 
+void
+JakesPropagationLossModel::SetCacheMaxSize (uint32_t maxSize)
+{
+  m_cacheMaxSize = maxSize;
+  m_propagationCache.SetMaxSize (maxSize);
+}
+
+uint32_t
+JakesPropagationLossModel::GetCacheMaxSize (void) const
+{
+  return m_cacheMaxSize;
+}
+
+void
+JakesPropagationLossModel::SetCacheMaxIdleTime (Time maxIdleTime)
+{
+  m_cacheMaxIdleTime = maxIdleTime;
+  m_propagationCache.SetMaxIdleTime (maxIdleTime);
+}
+
+Time
+JakesPropagationLossModel::GetCacheMaxIdleTime (void) const
+{
+  return m_cacheMaxIdleTime;
+}
+
 int64_t
 JakesPropagationLossModel::DoAssignStreams (int64_t stream)
 {
@@ -70,9 +70,31 @@ private:
    * \return the RNG stream
    */
   Ptr<UniformRandomVariable> GetUniformRandomVariable () const;
+  /**
+   * Set the maximum number of JakesProcess kept in the cache
+   * \param maxSize the maximum number of paths, or zero for no limit
+   */
+  void SetCacheMaxSize (uint32_t maxSize);
+  /**
+   * \return the maximum number of JakesProcess kept in the cache
+   */
+  uint32_t GetCacheMaxSize (void) const;
+  /**
+   * Set the time after which a JakesProcess which has not been used is
+   * removed from the cache
+   * \param maxIdleTime the maximum idle time, or zero for no limit
+   */
+  void SetCacheMaxIdleTime (Time maxIdleTime);
+  /**
+   * \return the time after which a JakesProcess which has not been used is
+   * removed from the cache
+   */
+  Time GetCacheMaxIdleTime (void) const;
 
   Ptr<UniformRandomVariable> m_uniformVariable; //!< random stream
   mutable PropagationCache<JakesProcess> m_propagationCache; //!< Propagation cache
+  uint32_t m_cacheMaxSize; //!< maximum number of paths in the cache
+  Time m_cacheMaxIdleTime; //!< maximum idle time of the paths in the cache
 };
 
 } // namespace ns3
@@ -0,0 +1,399 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "path-loss-matrix-propagation-loss-model.h"
+#include "ns3/mobility-model.h"
+#include "ns3/node.h"
+#include "ns3/pointer.h"
+#include "ns3/log.h"
+#include "ns3/abort.h"
+#include <cmath>
+#include <fstream>
+#include <limits>
+#include <set>
+#include <sstream>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("PathLossMatrixPropagationLossModel");
+
+NS_OBJECT_ENSURE_REGISTERED (PathLossMatrixPropagationLossModel);
+
+/// First line of the files written by PathLossMatrixPropagationLossModel::Save
+static const std::string PATH_LOSS_MATRIX_FILE_MAGIC = "ns3-path-loss-matrix-2";
+
+/**
+ * \param a the 1st vector
+ * \param b the 2nd vector
+ * \return true if both vectors are equal
+ */
+static bool
+IsSameVector (const Vector &a, const Vector &b)
+{
+  return a.x == b.x && a.y == b.y && a.z == b.z;
+}
+
+/**
+ * Write the type of an object and the values of its attributes, with the
+ * objects it points to described in the same way, in the format of
+ * ObjectFactory (e.g., "ns3::LogDistancePropagationLossModel[Exponent=3|...]")
+ * \param os the output stream
+ * \param object the object
+ * \param visited the objects already described
+ */
+static void
+DescribeObject (std::ostream &os, Ptr<Object> object, std::set<Ptr<Object> > &visited)
+{
+  if (object == 0)
+    {
+      os << "0";
+      return;
+    }
+  TypeId tid = object->GetInstanceTypeId ();
+  os << tid.GetName () << "[";
+  if (visited.insert (object).second)
+    {
+      bool first = true;
+      for (TypeId t = tid; ; t = t.GetParent ())
+        {
+          for (uint32_t i = 0; i < t.GetAttributeN (); i++)
+            {
+              struct TypeId::AttributeInformation info = t.GetAttribute (i);
+              if (!(info.flags & TypeId::ATTR_GET) || !info.accessor->HasGetter ()
+                  || info.checker->GetValueTypeName () == "ns3::ObjectPtrContainerValue")
+                {
+                  continue;
+                }
+              os << (first ? "" : "|") << info.name << "=";
+              first = false;
+              if (info.checker->GetValueTypeName () == "ns3::PointerValue")
+                {
+                  PointerValue pointer;
+                  object->GetAttribute (info.name, pointer);
+                  DescribeObject (os, pointer.Get<Object> (), visited);
+                }
+              else
+                {
+                  Ptr<AttributeValue> value = info.checker->Create ();
+                  object->GetAttribute (info.name, *value);
+                  os << value->SerializeToString (info.checker);
+                }
+            }
+          if (!t.HasParent () || t.GetParent () == t)
+            {
+              break;
+            }
+        }
+    }
+  os << "]";
+}
+
+TypeId
+PathLossMatrixPropagationLossModel::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::PathLossMatrixPropagationLossModel")
+    .SetParent<PropagationLossModel> ()
+    .SetGroupName ("Propagation")
+    .AddConstructor<PathLossMatrixPropagationLossModel> ()
+    .AddAttribute ("Model", "The propagation loss model whose losses are cached.",
+                   PointerValue (),
+                   MakePointerAccessor (&PathLossMatrixPropagationLossModel::SetModel,
+                                        &PathLossMatrixPropagationLossModel::GetModel),
+                   MakePointerChecker<PropagationLossModel> ())
+  ;
+  return tid;
+}
+
+PathLossMatrixPropagationLossModel::PathLossMatrixPropagationLossModel ()
+  : m_capacity (0)
+{
+}
+
+PathLossMatrixPropagationLossModel::~PathLossMatrixPropagationLossModel ()
+{
+}
+
+void
+PathLossMatrixPropagationLossModel::DoDispose (void)
+{
+  Clear ();
+  m_model = 0;
+  m_loadedIds.clear ();
+  m_loadedPositions.clear ();
+  m_loadedMatrix.clear ();
+  PropagationLossModel::DoDispose ();
+}
+
+void
+PathLossMatrixPropagationLossModel::SetModel (Ptr<PropagationLossModel> model)
+{
+  NS_LOG_FUNCTION (this << model);
+  Clear ();
+  m_model = model;
+}
+
+Ptr<PropagationLossModel>
+PathLossMatrixPropagationLossModel::GetModel (void) const
+{
+  return m_model;
+}
+
+void
+PathLossMatrixPropagationLossModel::Clear (void)
+{
+  for (std::vector<MobilityInfo>::const_iterator it = m_mobilities.begin (); it != m_mobilities.end (); ++it)
+    {
+      it->mobility->TraceDisconnectWithoutContext ("CourseChange",
+                                                   MakeCallback (&PathLossMatrixPropagationLossModel::CourseChanged, this));
+    }
+  m_mobilities.clear ();
+  m_indexes.clear ();
+  m_matrix.clear ();
+  m_capacity = 0;
+}
+
+uint32_t
+PathLossMatrixPropagationLossModel::GetIndex (Ptr<MobilityModel> mobility) const
+{
+  std::unordered_map<const MobilityModel *, uint32_t>::const_iterator it = m_indexes.find (PeekPointer (mobility));
+  if (it != m_indexes.end ())
+    {
+      return it->second;
+    }
+  uint32_t index = m_mobilities.size ();
+  NS_LOG_DEBUG ("Add mobility model " << mobility << " at index " << index);
+  if (index == m_capacity)
+    {
+      // grow the matrix geometrically, keeping the losses already computed
+      uint32_t capacity = std::max<uint32_t> (16, 2 * m_capacity);
+      std::vector<float> matrix (static_cast<std::size_t> (capacity) * capacity, std::numeric_limits<float>::quiet_NaN ());
+      for (uint32_t i = 0; i < m_capacity; i++)
+        {
+          std::copy (m_matrix.begin () + static_cast<std::size_t> (i) * m_capacity,
+                     m_matrix.begin () + static_cast<std::size_t> (i + 1) * m_capacity,
+                     matrix.begin () + static_cast<std::size_t> (i) * capacity);
+        }
+      m_matrix.swap (matrix);
+      m_capacity = capacity;
+    }
+  MobilityInfo info;
+  info.mobility = mobility;
+  info.moving = !IsSameVector (mobility->GetVelocity (), Vector (0, 0, 0));
+  info.loadedIndex = -1;
+  m_mobilities.push_back (info);
+  m_indexes[PeekPointer (mobility)] = index;
+  MatchLoadedNode (index);
+  mobility->TraceConnectWithoutContext ("CourseChange",
+                                        MakeCallback (&PathLossMatrixPropagationLossModel::CourseChanged,
+                                                      const_cast<PathLossMatrixPropagationLossModel *> (this)));
+  return index;
+}
+
+void
+PathLossMatrixPropagationLossModel::MatchLoadedNode (uint32_t index) const
+{
+  MobilityInfo &info = m_mobilities[index];
+  info.loadedIndex = -1;
+  Ptr<Node> node = info.mobility->GetObject<Node> ();
+  if (node == 0 || info.moving)
+    {
+      return;
+    }
+  std::unordered_map<uint32_t, uint32_t>::const_iterator it = m_loadedIds.find (node->GetId ());
+  if (it != m_loadedIds.end () && IsSameVector (m_loadedPositions[it->second], info.mobility->GetPosition ()))
+    {
+      info.loadedIndex = it->second;
+    }
+}
+
+void
+PathLossMatrixPropagationLossModel::CourseChanged (Ptr<const MobilityModel> mobility)
+{
+  uint32_t index = m_indexes[PeekPointer (mobility)];
+  NS_LOG_FUNCTION (this << mobility << index);
+  MobilityInfo &info = m_mobilities[index];
+  info.moving = !IsSameVector (mobility->GetVelocity (), Vector (0, 0, 0));
+  MatchLoadedNode (index);
+  for (uint32_t i = 0; i < m_mobilities.size (); i++)
+    {
+      m_matrix[static_cast<std::size_t> (index) * m_capacity + i] = std::numeric_limits<float>::quiet_NaN ();
+      m_matrix[static_cast<std::size_t> (i) * m_capacity + index] = std::numeric_limits<float>::quiet_NaN ();
+    }
+}
+
+float
+PathLossMatrixPropagationLossModel::ComputeLoss (uint32_t a, uint32_t b) const
+{
+  int64_t loadedA = m_mobilities[a].loadedIndex;
+  int64_t loadedB = m_mobilities[b].loadedIndex;
+  if (loadedA >= 0 && loadedB >= 0)
+    {
+      float loss = m_loadedMatrix[loadedA * m_loadedPositions.size () + loadedB];
+      if (!std::isnan (loss))
+        {
+          return loss;
+        }
+    }
+  return static_cast<float> (-m_model->CalcRxPower (0, m_mobilities[a].mobility, m_mobilities[b].mobility));
+}
+
+void
+PathLossMatrixPropagationLossModel::Precompute (NodeContainer nodes)
+{
+  NS_LOG_FUNCTION (this << nodes.GetN ());
+  NS_ABORT_MSG_IF (m_model == 0, "No propagation loss model to precompute");
+  for (NodeContainer::Iterator it = nodes.Begin (); it != nodes.End (); ++it)
+    {
+      Ptr<MobilityModel> mobility = (*it)->GetObject<MobilityModel> ();
+      NS_ABORT_MSG_IF (mobility == 0, "Node " << (*it)->GetId () << " has no mobility model");
+      GetIndex (mobility);
+    }
+  uint32_t n = m_mobilities.size ();
+  for (uint32_t a = 0; a < n; a++)
+    {
+      if (m_mobilities[a].moving)
+        {
+          continue;
+        }
+      for (uint32_t b = 0; b < n; b++)
+        {
+          float &loss = m_matrix[static_cast<std::size_t> (a) * m_capacity + b];
+          if (a != b && !m_mobilities[b].moving && std::isnan (loss))
+            {
+              loss = ComputeLoss (a, b);
+            }
+        }
+    }
+}
+
+std::string
+PathLossMatrixPropagationLossModel::GetModelDescription (void) const
+{
+  std::ostringstream oss;
+  std::set<Ptr<Object> > visited;
+  DescribeObject (oss, m_model, visited);
+  // the next models of the chain are part of the loss of the wrapped model
+  for (Ptr<PropagationLossModel> next = m_model->GetNext (); next != 0; next = next->GetNext ())
+    {
+      oss << " ";
+      DescribeObject (oss, next, visited);
+    }
+  return oss.str ();
+}
+
+void
+PathLossMatrixPropagationLossModel::Save (std::string filename) const
+{
+  NS_LOG_FUNCTION (this << filename);
+  NS_ABORT_MSG_IF (m_model == 0, "No propagation loss model to save");
+  // only the nodes can be identified in another run
+  std::vector<uint32_t> indexes;
+  std::vector<uint32_t> ids;
+  for (uint32_t i = 0; i < m_mobilities.size (); i++)
+    {
+      Ptr<Node> node = m_mobilities[i].mobility->GetObject<Node> ();
+      if (node != 0 && !m_mobilities[i].moving)
+        {
+          indexes.push_back (i);
+          ids.push_back (node->GetId ());
+        }
+    }
+  std::ofstream ofs (filename.c_str (), std::ios::out | std::ios::binary);
+  NS_ABORT_MSG_UNLESS (ofs.is_open (), "Could not open " << filename);
+  ofs << PATH_LOSS_MATRIX_FILE_MAGIC << " " << indexes.size () << "\n";
+  ofs << GetModelDescription () << "\n";
+  ofs.precision (17);
+  for (uint32_t i = 0; i < indexes.size (); i++)
+    {
+      Vector position = m_mobilities[indexes[i]].mobility->GetPosition ();
+      ofs << ids[i] << " " << position.x << " " << position.y << " " << position.z << "\n";
+    }
+  for (uint32_t i = 0; i < indexes.size (); i++)
+    {
+      for (uint32_t j = 0; j < indexes.size (); j++)
+        {
+          float loss = m_matrix[static_cast<std::size_t> (indexes[i]) * m_capacity + indexes[j]];
+          ofs.write (reinterpret_cast<const char *> (&loss), sizeof (loss));
+        }
+    }
+  NS_ABORT_MSG_IF (ofs.fail (), "Could not write " << filename);
+}
+
+void
+PathLossMatrixPropagationLossModel::Load (std::string filename)
+{
+  NS_LOG_FUNCTION (this << filename);
+  NS_ABORT_MSG_IF (m_model == 0, "The propagation loss model must be set before loading a file");
+  std::ifstream ifs (filename.c_str (), std::ios::in | std::ios::binary);
+  NS_ABORT_MSG_UNLESS (ifs.is_open (), "Could not open " << filename);
+  std::string magic;
+  uint32_t n;
+  ifs >> magic >> n;
+  NS_ABORT_MSG_IF (ifs.fail () || magic != PATH_LOSS_MATRIX_FILE_MAGIC, filename << " is not a path loss matrix file");
+  ifs.ignore (std::numeric_limits<std::streamsize>::max (), '\n');
+  std::string model;
+  std::getline (ifs, model);
+  std::string expected = GetModelDescription ();
+  NS_ABORT_MSG_IF (model != expected, filename << " was saved with " << model << " instead of " << expected);
+  m_loadedIds.clear ();
+  m_loadedPositions.resize (n);
+  for (uint32_t i = 0; i < n; i++)
+    {
+      uint32_t id;
+      ifs >> id >> m_loadedPositions[i].x >> m_loadedPositions[i].y >> m_loadedPositions[i].z;
+      m_loadedIds[id] = i;
+    }
+  ifs.ignore (std::numeric_limits<std::streamsize>::max (), '\n');
+  m_loadedMatrix.resize (static_cast<std::size_t> (n) * n);
+  ifs.read (reinterpret_cast<char *> (m_loadedMatrix.data ()), m_loadedMatrix.size () * sizeof (float));
+  NS_ABORT_MSG_IF (ifs.fail (), "Could not read " << filename);
+  for (uint32_t i = 0; i < m_mobilities.size (); i++)
+    {
+      MatchLoadedNode (i);
+    }
+}
+
+double
+PathLossMatrixPropagationLossModel::DoCalcRxPower (double txPowerDbm,
+                                                   Ptr<MobilityModel> a,
+                                                   Ptr<MobilityModel> b) const
+{
+  NS_ASSERT (m_model != 0);
+  uint32_t indexA = GetIndex (a);
+  uint32_t indexB = GetIndex (b);
+  if (m_mobilities[indexA].moving || m_mobilities[indexB].moving)
+    {
+      return m_model->CalcRxPower (txPowerDbm, a, b);
+    }
+  float &loss = m_matrix[static_cast<std::size_t> (indexA) * m_capacity + indexB];
+  if (std::isnan (loss))
+    {
+      loss = ComputeLoss (indexA, indexB);
+    }
+  return txPowerDbm - loss;
+}
+
+int64_t
+PathLossMatrixPropagationLossModel::DoAssignStreams (int64_t stream)
+{
+  if (m_model == 0)
+    {
+      return 0;
+    }
+  return m_model->AssignStreams (stream);
+}
+
+} // namespace ns3
@@ -0,0 +1,178 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef PATH_LOSS_MATRIX_PROPAGATION_LOSS_MODEL_H
+#define PATH_LOSS_MATRIX_PROPAGATION_LOSS_MODEL_H
+
+#include "ns3/propagation-loss-model.h"
+#include "ns3/node-container.h"
+#include "ns3/vector.h"
+#include <unordered_map>
+#include <vector>
+#include <string>
+
+namespace ns3 {
+
+class MobilityModel;
+
+/**
+ * \ingroup propagation
+ *
+ * \brief Caches the losses of another propagation loss model in a matrix
+ * indexed by pairs of nodes
+ *
+ * The loss of the wrapped model (see the Model attribute) between two nodes
+ * is computed the first time it is needed and stored as a float in a
+ * matrix, so that the later calls cost two hash table lookups.  Precompute
+ * fills the matrix for a set of nodes, and Save and Load store the matrix to and read it from a file, so that
+ * repeated runs of the same topology skip the computation.
+ *
+ * The entries of a node are invalidated when its mobility model notifies a
+ * course change.  Nodes which are moving (i.e., whose velocity is not zero)
+ * are not cached, and their losses are always computed by the wrapped model.
+ *
+ * The wrapped model must be deterministic (e.g., not NakagamiPropagationLossModel)
+ * and its loss must not depend on the transmit power.  The matrix takes
+ * 4 bytes per pair of nodes, i.e., 400 MB for 10000 nodes.
+ */
+class PathLossMatrixPropagationLossModel : public PropagationLossModel
+{
+public:
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+
+  PathLossMatrixPropagationLossModel ();
+  virtual ~PathLossMatrixPropagationLossModel ();
+
+  /**
+   * Set the propagation loss model whose losses are cached.  The matrix is
+   * cleared.
+   * \param model the wrapped propagation loss model
+   */
+  void SetModel (Ptr<PropagationLossModel> model);
+  /**
+   * \return the wrapped propagation loss model
+   */
+  Ptr<PropagationLossModel> GetModel (void) const;
+
+  /**
+   * Compute the losses between all the pairs of the given nodes which are
+   * not known yet.  The nodes must have a mobility model.
+   * \param nodes the nodes
+   */
+  void Precompute (NodeContainer nodes);
+
+  /**
+   * Save the losses between the nodes known to the matrix to a file.  The
+   * nodes are identified by their ID and position.
+   * \param filename the name of the file
+   */
+  void Save (std::string filename) const;
+  /**
+   * Load the losses saved by Save.  A loss between two nodes read from the
+   * file is used instead of the wrapped model if both nodes have the same ID
+   * and the same position as when the file was saved.  The file must have
+   * been saved with a wrapped model of the same type and with the same
+   * attribute values, as well as the next models of its chain.
+   * \param filename the name of the file
+   */
+  void Load (std::string filename);
+
+protected:
+  virtual void DoDispose (void);
+
+private:
+  /**
+   * \brief Copy constructor
+   *
+   * Defined and unimplemented to avoid misuse
+   */
+  PathLossMatrixPropagationLossModel (const PathLossMatrixPropagationLossModel &);
+  /**
+   * \brief Copy constructor
+   *
+   * Defined and unimplemented to avoid misuse
+   * \returns
+   */
+  PathLossMatrixPropagationLossModel & operator = (const PathLossMatrixPropagationLossModel &);
+
+  virtual double DoCalcRxPower (double txPowerDbm,
+                                Ptr<MobilityModel> a,
+                                Ptr<MobilityModel> b) const;
+  virtual int64_t DoAssignStreams (int64_t stream);
+
+  /**
+   * Get the index of a mobility model in the matrix, adding it if needed
+   * \param mobility the mobility model
+   * \return the index of the mobility model
+   */
+  uint32_t GetIndex (Ptr<MobilityModel> mobility) const;
+  /**
+   * Match a mobility model with the nodes of the loaded file
+   * \param index the index of the mobility model
+   */
+  void MatchLoadedNode (uint32_t index) const;
+  /**
+   * Compute the loss between two mobility models with the wrapped model,
+   * or read it from the loaded file
+   * \param a the index of the 1st mobility model
+   * \param b the index of the 2nd mobility model
+   * \return the loss (dB)
+   */
+  float ComputeLoss (uint32_t a, uint32_t b) const;
+  /**
+   * Describe the configuration of the wrapped model, and of the next models
+   * of its chain, which Load checks against the configuration saved in the
+   * file
+   * \return the types and attribute values of the models
+   */
+  std::string GetModelDescription (void) const;
+  /**
+   * Invalidate the losses of a mobility model whose course changed
+   * \param mobility the mobility model
+   */
+  void CourseChanged (Ptr<const MobilityModel> mobility);
+  /**
+   * Clear the matrix and disconnect from the mobility models
+   */
+  void Clear (void);
+
+  Ptr<PropagationLossModel> m_model; //!< the wrapped propagation loss model
+
+  /// The state of a mobility model known to the matrix
+  struct MobilityInfo
+  {
+    Ptr<MobilityModel> mobility; //!< the mobility model
+    bool moving;                 //!< whether the mobility model has a non-zero velocity
+    int64_t loadedIndex;         //!< the index of the node in the loaded file, or -1
+  };
+
+  mutable std::vector<MobilityInfo> m_mobilities; //!< the mobility models known to the matrix
+  mutable std::unordered_map<const MobilityModel *, uint32_t> m_indexes; //!< index of each mobility model
+  mutable std::vector<float> m_matrix; //!< losses (dB), NaN if not computed
+  mutable uint32_t m_capacity;         //!< number of rows and columns of the matrix
+
+  std::unordered_map<uint32_t, uint32_t> m_loadedIds; //!< index of each node ID in the loaded file
+  std::vector<Vector> m_loadedPositions;       //!< positions of the nodes of the loaded file
+  std::vector<float> m_loadedMatrix;           //!< losses (dB) of the loaded file
+};
+
+} // namespace ns3
+
+#endif /* PATH_LOSS_MATRIX_PROPAGATION_LOSS_MODEL_H */
@@ -21,21 +21,40 @@
 #define PROPAGATION_CACHE_H_
 
 #include "ns3/mobility-model.h"
-#include <map>
+#include "ns3/simulator.h"
+#include "ns3/nstime.h"
+#include <algorithm>
+#include <functional>
+#include <list>
+#include <unordered_map>
 
 namespace ns3
 {
 /**
  * \ingroup propagation
  * \brief Constructs a cache of objects, where each object is responsible for a single propagation path loss calculations.
- * Propagation path a-->b and b-->a is the same thing. Propagation path is identified by
+ * Propagation path a-->b and b-->a is the same thing, unless the cache is
+ * made asymmetric with SetSymmetric. Propagation path is identified by
  * a couple of MobilityModels and a spectrum model UID
+ *
+ * The cache is unbounded by default. SetMaxSize bounds the number of paths
+ * it holds, the least recently used path being evicted first, and
+ * SetMaxIdleTime evicts the paths which have not been used for a while.
+ * An evicted path is simply created again by the user of the cache the
+ * next time it is needed.
  */
 template<class T>
 class PropagationCache
 {
 public:
-  PropagationCache () {};
+  PropagationCache ()
+    : m_symmetric (true),
+      m_maxSize (0),
+      m_maxIdleTime (Seconds (0)),
+      m_hits (0),
+      m_misses (0),
+      m_evictions (0)
+  {};
   ~PropagationCache () {};
 
   /**
@@ -47,13 +66,24 @@ public:
    */
   Ptr<T> GetPathData (Ptr<const MobilityModel> a, Ptr<const MobilityModel> b, uint32_t modelUid)
   {
-    PropagationPathIdentifier key = PropagationPathIdentifier (a, b, modelUid);
+    PropagationPathIdentifier key = MakeKey (a, b, modelUid);
     typename PathCache::iterator it = m_pathCache.find (key);
     if (it == m_pathCache.end ())
       {
+        m_misses++;
+        return 0;
+      }
+    Time now = Simulator::Now ();
+    if (IsIdle (it->second, now))
+      {
+        Evict (it);
+        m_misses++;
         return 0;
       }
-    return it->second;
+    m_hits++;
+    it->second.m_lastUse = now;
+    m_lru.splice (m_lru.begin (), m_lru, it->second.m_lruIterator);
+    return it->second.m_data;
   };
 
   /**
@@ -65,10 +95,102 @@ public:
    */
   void AddPathData (Ptr<T> data, Ptr<const MobilityModel> a, Ptr<const MobilityModel> b, uint32_t modelUid)
   {
-    PropagationPathIdentifier key = PropagationPathIdentifier (a, b, modelUid);
+    PropagationPathIdentifier key = MakeKey (a, b, modelUid);
     NS_ASSERT (m_pathCache.find (key) == m_pathCache.end ());
-    m_pathCache.insert (std::make_pair (key, data)); 
+    Time now = Simulator::Now ();
+    m_lru.push_front (key);
+    PathData pathData;
+    pathData.m_data = data;
+    pathData.m_lastUse = now;
+    pathData.m_lruIterator = m_lru.begin ();
+    m_pathCache.insert (std::make_pair (key, pathData));
+    // the least recently used paths are at the back of the list
+    while (m_maxSize > 0 && m_pathCache.size () > m_maxSize)
+      {
+        Evict (m_pathCache.find (m_lru.back ()));
+      }
+    while (!m_lru.empty ())
+      {
+        typename PathCache::iterator oldest = m_pathCache.find (m_lru.back ());
+        if (!IsIdle (oldest->second, now))
+          {
+            break;
+          }
+        Evict (oldest);
+      }
+  };
+
+  /**
+   * Set whether path a-->b and path b-->a share the same data. The cache
+   * must be empty.
+   * \param symmetric true if the paths are symmetric
+   */
+  void SetSymmetric (bool symmetric)
+  {
+    NS_ASSERT (m_pathCache.empty ());
+    m_symmetric = symmetric;
+  };
+
+  /**
+   * Set the maximum number of paths held by the cache, the least recently
+   * used paths being evicted when it is exceeded.
+   * \param maxSize the maximum number of paths, or zero for no limit
+   */
+  void SetMaxSize (uint32_t maxSize)
+  {
+    m_maxSize = maxSize;
+  };
+
+  /**
+   * Set the time after which a path which has not been used is evicted.
+   * \param maxIdleTime the maximum idle time, or zero for no limit
+   */
+  void SetMaxIdleTime (Time maxIdleTime)
+  {
+    m_maxIdleTime = maxIdleTime;
   };
+
+  /**
+   * \return the number of paths held by the cache
+   */
+  std::size_t GetSize (void) const
+  {
+    return m_pathCache.size ();
+  };
+
+  /**
+   * \return the number of calls to GetPathData which found the path
+   */
+  uint64_t GetHits (void) const
+  {
+    return m_hits;
+  };
+
+  /**
+   * \return the number of calls to GetPathData which did not find the path
+   */
+  uint64_t GetMisses (void) const
+  {
+    return m_misses;
+  };
+
+  /**
+   * \return the number of paths evicted from the cache
+   */
+  uint64_t GetEvictions (void) const
+  {
+    return m_evictions;
+  };
+
+  /**
+   * Remove all the paths from the cache.  The statistics are kept.
+   */
+  void Clear (void)
+  {
+    m_pathCache.clear ();
+    m_lru.clear ();
+  };
+
 private:
   /// Each path is identified by
   struct PropagationPathIdentifier
@@ -87,40 +209,92 @@ private:
     uint32_t m_spectrumModelUid; //!< model UID
 
     /**
-     * Less-than operator.
-     *
-     * The goal of this operator is just to provide a stable comparison
-     * to be used in containers requiring a order (of any kind).
-     *
-     * If the models are different, the comparison is based on their Uid.
-     * Otherwise, the comparison is based on the pointers of the Mobility models.
+     * Equality operator.
      *
      * \param other Right value of the operator.
-     * \returns True if the Left value is less than the Right value.
+     * \returns True if both paths are the same.
      */
-    bool operator < (const PropagationPathIdentifier & other) const
+    bool operator == (const PropagationPathIdentifier & other) const
     {
-      if (m_spectrumModelUid != other.m_spectrumModelUid)
-        {
-          return m_spectrumModelUid < other.m_spectrumModelUid;
-        }
-      /// Links are supposed to be symmetrical!
-      if (std::min (m_dstMobility, m_srcMobility) != std::min (other.m_dstMobility, other.m_srcMobility))
-        {
-          return std::min (m_dstMobility, m_srcMobility) < std::min (other.m_dstMobility, other.m_srcMobility);
-        }
-      if (std::max (m_dstMobility, m_srcMobility) != std::max (other.m_dstMobility, other.m_srcMobility))
-        {
-          return std::max (m_dstMobility, m_srcMobility) < std::max (other.m_dstMobility, other.m_srcMobility);
-        }
-      return false;
+      return m_spectrumModelUid == other.m_spectrumModelUid
+             && m_srcMobility == other.m_srcMobility
+             && m_dstMobility == other.m_dstMobility;
     }
   };
 
-  /// Typedef: PropagationPathIdentifier, Ptr<T>
-  typedef std::map<PropagationPathIdentifier, Ptr<T> > PathCache;
-private:
+  /// Hash function of a PropagationPathIdentifier
+  struct PropagationPathIdentifierHash
+  {
+    /**
+     * \param key the path identifier
+     * \return the hash of the path identifier
+     */
+    std::size_t operator () (const PropagationPathIdentifier & key) const
+    {
+      std::hash<const MobilityModel *> hasher;
+      std::size_t h = hasher (PeekPointer (key.m_srcMobility));
+      h ^= hasher (PeekPointer (key.m_dstMobility)) + 0x9e3779b9 + (h << 6) + (h >> 2);
+      h ^= std::hash<uint32_t> () (key.m_spectrumModelUid) + 0x9e3779b9 + (h << 6) + (h >> 2);
+      return h;
+    }
+  };
+
+  /// The data of a path
+  struct PathData
+  {
+    Ptr<T> m_data; //!< the data associated to the path
+    Time m_lastUse; //!< the last time the path was added or found
+    typename std::list<PropagationPathIdentifier>::iterator m_lruIterator; //!< position of the path in m_lru
+  };
+
+  /// Typedef: PropagationPathIdentifier, PathData
+  typedef std::unordered_map<PropagationPathIdentifier, PathData, PropagationPathIdentifierHash> PathCache;
+
+  /**
+   * \param a 1st node mobility model
+   * \param b 2nd node mobility model
+   * \param modelUid model UID
+   * \return the identifier of the path, which does not depend on the order
+   * of the mobility models if the cache is symmetric
+   */
+  PropagationPathIdentifier MakeKey (Ptr<const MobilityModel> a, Ptr<const MobilityModel> b, uint32_t modelUid) const
+  {
+    if (m_symmetric && b < a)
+      {
+        return PropagationPathIdentifier (b, a, modelUid);
+      }
+    return PropagationPathIdentifier (a, b, modelUid);
+  };
+
+  /**
+   * \param pathData the data of a path
+   * \param now the current time
+   * \return true if the path has not been used for longer than the maximum idle time
+   */
+  bool IsIdle (const PathData & pathData, Time now) const
+  {
+    return m_maxIdleTime.IsStrictlyPositive () && now - pathData.m_lastUse > m_maxIdleTime;
+  };
+
+  /**
+   * Remove a path from the cache
+   * \param it the path to remove
+   */
+  void Evict (typename PathCache::iterator it)
+  {
+    m_lru.erase (it->second.m_lruIterator);
+    m_pathCache.erase (it);
+    m_evictions++;
+  };
+
   PathCache m_pathCache; //!< Path cache
+  std::list<PropagationPathIdentifier> m_lru; //!< paths from the most to the least recently used
+  bool m_symmetric; //!< whether path a-->b and path b-->a are the same
+  uint32_t m_maxSize; //!< maximum number of paths, zero for no limit
+  Time m_maxIdleTime; //!< maximum time a path is kept without being used, zero for no limit
+  uint64_t m_hits; //!< number of paths found
+  uint64_t m_misses; //!< number of paths not found
+  uint64_t m_evictions; //!< number of paths evicted
 };
 } // namespace ns3
 
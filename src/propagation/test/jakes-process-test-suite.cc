@@ -0,0 +1,328 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/test.h"
+#include "ns3/simulator.h"
+#include "ns3/enum.h"
+#include "ns3/double.h"
+#include "ns3/jakes-process.h"
+#include "ns3/jakes-propagation-loss-model.h"
+#include <cmath>
+
+using namespace ns3;
+
+/**
+ * \ingroup propagation
+ * \ingroup tests
+ *
+ * \brief Check that the interpolated JakesProcess follows the exact process
+ * built from the same oscillators
+ */
+class JakesProcessInterpolationTestCase : public TestCase
+{
+public:
+  JakesProcessInterpolationTestCase ();
+  virtual ~JakesProcessInterpolationTestCase ();
+
+private:
+  virtual void DoRun (void);
+  /**
+   * Compare the complex gains of the two processes at the current time
+   */
+  void Compare (void);
+
+  Ptr<JakesProcess> m_exact;        //!< the process in the EXACT mode
+  Ptr<JakesProcess> m_interpolated; //!< the process in the INTERPOLATED mode
+  double m_maxError;                //!< largest difference between the two processes
+};
+
+JakesProcessInterpolationTestCase::JakesProcessInterpolationTestCase ()
+  : TestCase ("Check the interpolated JakesProcess against the exact one"),
+    m_maxError (0)
+{
+}
+
+JakesProcessInterpolationTestCase::~JakesProcessInterpolationTestCase ()
+{
+}
+
+void
+JakesProcessInterpolationTestCase::Compare (void)
+{
+  m_maxError = std::max (m_maxError, std::abs (m_exact->GetComplexGain () - m_interpolated->GetComplexGain ()));
+}
+
+void
+JakesProcessInterpolationTestCase::DoRun (void)
+{
+  // both processes draw their oscillators from the same stream
+  Ptr<JakesPropagationLossModel> exactModel = CreateObject<JakesPropagationLossModel> ();
+  exactModel->AssignStreams (1);
+  m_exact = CreateObject<JakesProcess> ();
+  m_exact->SetPropagationLossModel (exactModel);
+  Ptr<JakesPropagationLossModel> interpolatedModel = CreateObject<JakesPropagationLossModel> ();
+  interpolatedModel->AssignStreams (1);
+  m_interpolated = CreateObject<JakesProcess> ();
+  m_interpolated->SetAttribute ("Mode", EnumValue (JakesProcess::INTERPOLATED));
+  m_interpolated->SetPropagationLossModel (interpolatedModel);
+
+  // the gains are compared at irregular times, with small steps which
+  // rotate the phasors and large steps which set them to their exact value
+  Time t = Seconds (0);
+  for (uint32_t i = 0; i < 5000; i++)
+    {
+      t += MicroSeconds (37 + (i % 7) * 53 + ((i % 101) == 0 ? 100000 : 0));
+      Simulator::Schedule (t, &JakesProcessInterpolationTestCase::Compare, this);
+    }
+  Simulator::Run ();
+  Simulator::Destroy ();
+
+  // with 32 samples per Doppler period, the interpolation error of each
+  // oscillator is below (2 pi / 32)^2 / 8 of its amplitude
+  NS_TEST_EXPECT_MSG_LT (m_maxError, 0.05, "The interpolated process is too far from the exact one");
+
+  m_exact->Dispose ();
+  m_interpolated->Dispose ();
+}
+
+/**
+ * \ingroup propagation
+ * \ingroup tests
+ *
+ * \brief Check the autocorrelation of the in-phase component of JakesProcess
+ * against \f$J_0(2 \pi f_d \tau)\f$, the autocorrelation of the Jakes
+ * Doppler spectrum
+ */
+class JakesProcessDopplerSpectrumTestCase : public TestCase
+{
+public:
+  /**
+   * Constructor
+   *
+   * \param mode the mode of the processes
+   */
+  JakesProcessDopplerSpectrumTestCase (JakesProcess::Mode mode);
+  virtual ~JakesProcessDopplerSpectrumTestCase ();
+
+private:
+  virtual void DoRun (void);
+  /**
+   * Record the complex gains of the processes at the current time
+   */
+  void Sample (void);
+  /**
+   * \param x the argument
+   * \return the Bessel function of the first kind of order zero
+   */
+  static double BesselJ0 (double x);
+
+  JakesProcess::Mode m_mode;                      //!< the mode of the processes
+  std::vector<Ptr<JakesProcess> > m_processes;    //!< the processes
+  std::vector<std::vector<std::complex<double> > > m_gains; //!< the gains of each process
+};
+
+JakesProcessDopplerSpectrumTestCase::JakesProcessDopplerSpectrumTestCase (JakesProcess::Mode mode)
+  : TestCase (std::string ("Check the Doppler spectrum of the ")
+              + (mode == JakesProcess::EXACT ? "exact" : "interpolated") + " JakesProcess"),
+    m_mode (mode)
+{
+}
+
+JakesProcessDopplerSpectrumTestCase::~JakesProcessDopplerSpectrumTestCase ()
+{
+}
+
+double
+JakesProcessDopplerSpectrumTestCase::BesselJ0 (double x)
+{
+  double term = 1;
+  double sum = 1;
+  for (uint32_t k = 1; k < 60; k++)
+    {
+      term *= -(x * x / 4) / (k * k);
+      sum += term;
+    }
+  return sum;
+}
+
+void
+JakesProcessDopplerSpectrumTestCase::Sample (void)
+{
+  for (uint32_t i = 0; i < m_processes.size (); i++)
+    {
+      m_gains[i].push_back (m_processes[i]->GetComplexGain ());
+    }
+}
+
+void
+JakesProcessDopplerSpectrumTestCase::DoRun (void)
+{
+  double dopplerHz = 80;
+  uint32_t nProcesses = 200;
+  uint32_t nSamples = 1000;
+  Time samplingInterval = MilliSeconds (1);
+
+  Ptr<JakesPropagationLossModel> model = CreateObject<JakesPropagationLossModel> ();
+  model->AssignStreams (1);
+  for (uint32_t i = 0; i < nProcesses; i++)
+    {
+      Ptr<JakesProcess> process = CreateObject<JakesProcess> ();
+      process->SetAttribute ("DopplerFrequencyHz", DoubleValue (dopplerHz));
+      process->SetAttribute ("Mode", EnumValue (m_mode));
+      process->SetPropagationLossModel (model);
+      m_processes.push_back (process);
+    }
+  m_gains.resize (nProcesses);
+  for (uint32_t k = 0; k < nSamples; k++)
+    {
+      Simulator::Schedule (samplingInterval * k, &JakesProcessDopplerSpectrumTestCase::Sample, this);
+    }
+  Simulator::Run ();
+  Simulator::Destroy ();
+
+  // the power of the complex gain is 2 on average
+  double power = 0;
+  for (uint32_t i = 0; i < nProcesses; i++)
+    {
+      for (uint32_t k = 0; k < nSamples; k++)
+        {
+          power += std::norm (m_gains[i][k]);
+        }
+    }
+  power /= nProcesses * nSamples;
+  NS_TEST_EXPECT_MSG_EQ_TOL (power, 2.0, 0.1, "Unexpected average power");
+
+  // the in-phase component has a unit power, and its autocorrelation is
+  // J0 (2 pi fd tau), up to the second zero crossing of J0
+  for (uint32_t lag = 0; lag < 12; lag++)
+    {
+      double correlation = 0;
+      for (uint32_t i = 0; i < nProcesses; i++)
+        {
+          for (uint32_t k = 0; k + lag < nSamples; k++)
+            {
+              correlation += m_gains[i][k].real () * m_gains[i][k + lag].real ();
+            }
+        }
+      correlation /= nProcesses * (nSamples - lag);
+      double expected = BesselJ0 (2 * M_PI * dopplerHz * (samplingInterval * lag).GetSeconds ());
+      NS_TEST_EXPECT_MSG_EQ_TOL (correlation, expected, 0.05, "Unexpected autocorrelation at lag " << lag << " ms");
+    }
+
+  for (uint32_t i = 0; i < nProcesses; i++)
+    {
+      m_processes[i]->Dispose ();
+    }
+  m_processes.clear ();
+  m_gains.clear ();
+}
+
+/**
+ * \ingroup propagation
+ * \ingroup tests
+ *
+ * \brief Check that JakesProcess without Doppler has a constant and finite
+ * gain in both modes
+ */
+class JakesProcessZeroDopplerTestCase : public TestCase
+{
+public:
+  JakesProcessZeroDopplerTestCase ();
+  virtual ~JakesProcessZeroDopplerTestCase ();
+
+private:
+  virtual void DoRun (void);
+  /**
+   * Check the complex gains of the two processes at the current time
+   */
+  void Check (void);
+
+  Ptr<JakesProcess> m_exact;          //!< the process in the EXACT mode
+  Ptr<JakesProcess> m_interpolated;   //!< the process in the INTERPOLATED mode
+  std::complex<double> m_initialGain; //!< the gain of the exact process at time 0
+};
+
+JakesProcessZeroDopplerTestCase::JakesProcessZeroDopplerTestCase ()
+  : TestCase ("Check JakesProcess without Doppler")
+{
+}
+
+JakesProcessZeroDopplerTestCase::~JakesProcessZeroDopplerTestCase ()
+{
+}
+
+void
+JakesProcessZeroDopplerTestCase::Check (void)
+{
+  std::complex<double> exact = m_exact->GetComplexGain ();
+  std::complex<double> interpolated = m_interpolated->GetComplexGain ();
+  NS_TEST_EXPECT_MSG_EQ (std::isfinite (interpolated.real ()) && std::isfinite (interpolated.imag ()), true,
+                         "The interpolated gain is not finite at " << Simulator::Now ().GetSeconds () << " s");
+  NS_TEST_EXPECT_MSG_EQ (interpolated, exact, "The interpolated gain differs from the exact one at " << Simulator::Now ().GetSeconds () << " s");
+  NS_TEST_EXPECT_MSG_EQ (exact, m_initialGain, "The gain changed at " << Simulator::Now ().GetSeconds () << " s");
+}
+
+void
+JakesProcessZeroDopplerTestCase::DoRun (void)
+{
+  // both processes draw their oscillators from the same stream
+  Ptr<JakesPropagationLossModel> exactModel = CreateObject<JakesPropagationLossModel> ();
+  exactModel->AssignStreams (1);
+  m_exact = CreateObject<JakesProcess> ();
+  m_exact->SetAttribute ("DopplerFrequencyHz", DoubleValue (0));
+  m_exact->SetPropagationLossModel (exactModel);
+  Ptr<JakesPropagationLossModel> interpolatedModel = CreateObject<JakesPropagationLossModel> ();
+  interpolatedModel->AssignStreams (1);
+  m_interpolated = CreateObject<JakesProcess> ();
+  m_interpolated->SetAttribute ("DopplerFrequencyHz", DoubleValue (0));
+  m_interpolated->SetAttribute ("Mode", EnumValue (JakesProcess::INTERPOLATED));
+  m_interpolated->SetPropagationLossModel (interpolatedModel);
+
+  m_initialGain = m_exact->GetComplexGain ();
+  NS_TEST_ASSERT_MSG_GT (std::norm (m_initialGain), 0, "The gain is zero");
+  for (uint32_t i = 0; i < 100; i++)
+    {
+      Simulator::Schedule (MilliSeconds (13 * i), &JakesProcessZeroDopplerTestCase::Check, this);
+    }
+  Simulator::Run ();
+  Simulator::Destroy ();
+
+  m_exact->Dispose ();
+  m_interpolated->Dispose ();
+}
+
+/**
+ * \ingroup propagation
+ * \ingroup tests
+ *
+ * \brief JakesProcess Test Suite
+ */
+class JakesProcessTestSuite : public TestSuite
+{
+public:
+  JakesProcessTestSuite ();
+};
+
+JakesProcessTestSuite::JakesProcessTestSuite ()
+  : TestSuite ("jakes-process", UNIT)
+{
+  AddTestCase (new JakesProcessInterpolationTestCase, TestCase::QUICK);
+  AddTestCase (new JakesProcessDopplerSpectrumTestCase (JakesProcess::EXACT), TestCase::QUICK);
+  AddTestCase (new JakesProcessDopplerSpectrumTestCase (JakesProcess::INTERPOLATED), TestCase::QUICK);
+  AddTestCase (new JakesProcessZeroDopplerTestCase, TestCase::QUICK);
+}
+
+static JakesProcessTestSuite g_jakesProcessTestSuite; //!< the test suite
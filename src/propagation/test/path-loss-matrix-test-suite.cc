@@ -0,0 +1,171 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/test.h"
+#include "ns3/double.h"
+#include "ns3/node-container.h"
+#include "ns3/node.h"
+#include "ns3/constant-position-mobility-model.h"
+#include "ns3/constant-velocity-mobility-model.h"
+#include "ns3/path-loss-matrix-propagation-loss-model.h"
+#include <fstream>
+
+using namespace ns3;
+
+/**
+ * \ingroup propagation
+ * \ingroup tests
+ *
+ * \brief Check that PathLossMatrixPropagationLossModel returns the losses of
+ * the wrapped model, and that it caches, invalidates, saves and loads them
+ */
+class PathLossMatrixTestCase : public TestCase
+{
+public:
+  PathLossMatrixTestCase ();
+  virtual ~PathLossMatrixTestCase ();
+
+private:
+  virtual void DoRun (void);
+  /**
+   * Create a LogDistancePropagationLossModel
+   * \param exponent the path loss exponent
+   * \return the model
+   */
+  Ptr<PropagationLossModel> CreateLogDistance (double exponent);
+};
+
+PathLossMatrixTestCase::PathLossMatrixTestCase ()
+  : TestCase ("Check the operations of PathLossMatrixPropagationLossModel")
+{
+}
+
+PathLossMatrixTestCase::~PathLossMatrixTestCase ()
+{
+}
+
+Ptr<PropagationLossModel>
+PathLossMatrixTestCase::CreateLogDistance (double exponent)
+{
+  Ptr<LogDistancePropagationLossModel> model = CreateObject<LogDistancePropagationLossModel> ();
+  model->SetPathLossExponent (exponent);
+  return model;
+}
+
+void
+PathLossMatrixTestCase::DoRun (void)
+{
+  double txPowerDbm = 20;
+  NodeContainer nodes;
+  nodes.Create (20);
+  for (uint32_t i = 0; i < nodes.GetN (); i++)
+    {
+      Ptr<MobilityModel> mobility = CreateObject<ConstantPositionMobilityModel> ();
+      mobility->SetPosition (Vector (10.0 * (i % 5), 25.0 * (i / 5), 1.5));
+      nodes.Get (i)->AggregateObject (mobility);
+    }
+  Ptr<MobilityModel> a = nodes.Get (0)->GetObject<MobilityModel> ();
+  Ptr<MobilityModel> b = nodes.Get (7)->GetObject<MobilityModel> ();
+  Ptr<MobilityModel> c = nodes.Get (19)->GetObject<MobilityModel> ();
+
+  // the losses of the wrapped model, precomputed
+  Ptr<PropagationLossModel> reference = CreateLogDistance (3);
+  Ptr<PathLossMatrixPropagationLossModel> matrix = CreateObject<PathLossMatrixPropagationLossModel> ();
+  matrix->SetModel (CreateLogDistance (3));
+  matrix->Precompute (nodes);
+  for (uint32_t i = 0; i < nodes.GetN (); i++)
+    {
+      for (uint32_t j = 0; j < nodes.GetN (); j++)
+        {
+          Ptr<MobilityModel> x = nodes.Get (i)->GetObject<MobilityModel> ();
+          Ptr<MobilityModel> y = nodes.Get (j)->GetObject<MobilityModel> ();
+          NS_TEST_EXPECT_MSG_EQ_TOL (matrix->CalcRxPower (txPowerDbm, x, y), reference->CalcRxPower (txPowerDbm, x, y), 1e-4,
+                                     "Unexpected loss between nodes " << i << " and " << j);
+        }
+    }
+
+  // the losses are cached, until a node is moved
+  double rxAb = reference->CalcRxPower (txPowerDbm, a, b);
+  DynamicCast<LogDistancePropagationLossModel> (matrix->GetModel ())->SetPathLossExponent (2);
+  NS_TEST_EXPECT_MSG_EQ_TOL (matrix->CalcRxPower (txPowerDbm, a, b), rxAb, 1e-4, "The loss should have been cached");
+  Ptr<PropagationLossModel> exponent2 = CreateLogDistance (2);
+  b->SetPosition (Vector (100, 100, 1.5));
+  NS_TEST_EXPECT_MSG_EQ_TOL (matrix->CalcRxPower (txPowerDbm, a, b), exponent2->CalcRxPower (txPowerDbm, a, b), 1e-4,
+                             "The loss of a moved node should be computed again");
+  NS_TEST_EXPECT_MSG_EQ_TOL (matrix->CalcRxPower (txPowerDbm, b, c), exponent2->CalcRxPower (txPowerDbm, b, c), 1e-4,
+                             "The loss of a moved node should be computed again");
+  NS_TEST_EXPECT_MSG_EQ_TOL (matrix->CalcRxPower (txPowerDbm, a, c), reference->CalcRxPower (txPowerDbm, a, c), 1e-4,
+                             "The loss should have been cached");
+  b->SetPosition (Vector (0, 25, 1.5));
+
+  // the losses of moving nodes are not cached
+  Ptr<ConstantVelocityMobilityModel> moving = CreateObject<ConstantVelocityMobilityModel> ();
+  moving->SetPosition (Vector (0, 0, 1.5));
+  moving->SetVelocity (Vector (10, 0, 0));
+  double rx = matrix->CalcRxPower (txPowerDbm, a, moving);
+  moving->SetPosition (Vector (50, 0, 1.5));
+  NS_TEST_EXPECT_MSG_EQ_TOL (matrix->CalcRxPower (txPowerDbm, a, moving), exponent2->CalcRxPower (txPowerDbm, a, moving), 1e-4,
+                             "The loss of a moving node should not be cached");
+  NS_TEST_EXPECT_MSG_NE (matrix->CalcRxPower (txPowerDbm, a, moving), rx, "The loss of a moving node should not be cached");
+
+  // the losses saved are loaded into a matrix wrapping the same model, and
+  // used instead of being computed, except for the node which moved since:
+  // the exponent of the wrapped model is changed after loading to tell them apart
+  matrix->SetModel (CreateLogDistance (3));
+  matrix->Precompute (nodes);
+  std::string filename = CreateTempDirFilename ("path-loss-matrix.bin");
+  matrix->Save (filename);
+  matrix->Dispose ();
+  std::ifstream ifs (filename.c_str ());
+  std::string magic;
+  std::string model;
+  std::getline (ifs, magic);
+  std::getline (ifs, model);
+  NS_TEST_EXPECT_MSG_NE (model.find ("ns3::LogDistancePropagationLossModel[Exponent=3|"), std::string::npos,
+                         "The attribute values of the wrapped model should have been saved: " << model);
+  c->SetPosition (Vector (200, 0, 1.5));
+  Ptr<PathLossMatrixPropagationLossModel> loaded = CreateObject<PathLossMatrixPropagationLossModel> ();
+  loaded->SetModel (CreateLogDistance (3));
+  loaded->Load (filename);
+  DynamicCast<LogDistancePropagationLossModel> (loaded->GetModel ())->SetPathLossExponent (2);
+  NS_TEST_EXPECT_MSG_EQ_TOL (loaded->CalcRxPower (txPowerDbm, a, b), reference->CalcRxPower (txPowerDbm, a, b), 1e-4,
+                             "The loss should have been loaded");
+  NS_TEST_EXPECT_MSG_EQ_TOL (loaded->CalcRxPower (txPowerDbm, b, a), reference->CalcRxPower (txPowerDbm, b, a), 1e-4,
+                             "The loss should have been loaded");
+  NS_TEST_EXPECT_MSG_EQ_TOL (loaded->CalcRxPower (txPowerDbm, a, c), exponent2->CalcRxPower (txPowerDbm, a, c), 1e-4,
+                             "The loss of a moved node should not be loaded");
+  loaded->Dispose ();
+}
+
+/**
+ * \ingroup propagation
+ * \ingroup tests
+ *
+ * \brief PathLossMatrixPropagationLossModel Test Suite
+ */
+class PathLossMatrixTestSuite : public TestSuite
+{
+public:
+  PathLossMatrixTestSuite ();
+};
+
+PathLossMatrixTestSuite::PathLossMatrixTestSuite ()
+  : TestSuite ("path-loss-matrix", UNIT)
+{
+  AddTestCase (new PathLossMatrixTestCase, TestCase::QUICK);
+}
+
+static PathLossMatrixTestSuite g_pathLossMatrixTestSuite; //!< the test suite
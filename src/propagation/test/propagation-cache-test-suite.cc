@@ -0,0 +1,166 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/test.h"
+#include "ns3/simulator.h"
+#include "ns3/simple-ref-count.h"
+#include "ns3/constant-position-mobility-model.h"
+#include "ns3/propagation-cache.h"
+
+using namespace ns3;
+
+/**
+ * \ingroup propagation
+ * \ingroup tests
+ *
+ * \brief Data stored in the PropagationCache under test
+ */
+class PropagationCacheTestData : public SimpleRefCount<PropagationCacheTestData>
+{
+};
+
+/**
+ * \ingroup propagation
+ * \ingroup tests
+ *
+ * \brief PropagationCache lookups, symmetry, statistics and evictions
+ */
+class PropagationCacheTestCase : public TestCase
+{
+public:
+  PropagationCacheTestCase ();
+  virtual ~PropagationCacheTestCase ();
+
+private:
+  virtual void DoRun (void);
+  /**
+   * Look up the path between the first and the second node, so that it is
+   * no longer idle
+   */
+  void UsePath (void);
+  /**
+   * Check that the paths which have not been used for too long have been
+   * evicted
+   */
+  void CheckIdlePaths (void);
+
+  std::vector<Ptr<MobilityModel> > m_mobilities; //!< the nodes
+  PropagationCache<PropagationCacheTestData> m_idleCache; //!< the cache with a maximum idle time
+};
+
+PropagationCacheTestCase::PropagationCacheTestCase ()
+  : TestCase ("Check the operations of PropagationCache")
+{
+}
+
+PropagationCacheTestCase::~PropagationCacheTestCase ()
+{
+}
+
+void
+PropagationCacheTestCase::UsePath (void)
+{
+  NS_TEST_EXPECT_MSG_NE (m_idleCache.GetPathData (m_mobilities[0], m_mobilities[1], 0), 0, "The path should not be idle yet");
+}
+
+void
+PropagationCacheTestCase::CheckIdlePaths (void)
+{
+  NS_TEST_EXPECT_MSG_EQ (m_idleCache.GetPathData (m_mobilities[0], m_mobilities[2], 0), 0, "The path should have been idle for too long");
+  NS_TEST_EXPECT_MSG_NE (m_idleCache.GetPathData (m_mobilities[0], m_mobilities[1], 0), 0, "The path was used recently");
+  NS_TEST_EXPECT_MSG_EQ (m_idleCache.GetEvictions (), 1, "Unexpected number of evictions");
+  NS_TEST_EXPECT_MSG_EQ (m_idleCache.GetSize (), 1, "Unexpected number of paths");
+}
+
+void
+PropagationCacheTestCase::DoRun (void)
+{
+  for (uint32_t i = 0; i < 4; i++)
+    {
+      m_mobilities.push_back (CreateObject<ConstantPositionMobilityModel> ());
+    }
+  Ptr<MobilityModel> a = m_mobilities[0];
+  Ptr<MobilityModel> b = m_mobilities[1];
+  Ptr<MobilityModel> c = m_mobilities[2];
+  Ptr<MobilityModel> d = m_mobilities[3];
+
+  // the cache is symmetric by default, but the model UID is part of the path
+  PropagationCache<PropagationCacheTestData> cache;
+  Ptr<PropagationCacheTestData> ab = Create<PropagationCacheTestData> ();
+  cache.AddPathData (ab, a, b, 0);
+  NS_TEST_EXPECT_MSG_EQ (cache.GetPathData (a, b, 0), ab, "Path a-->b should be found");
+  NS_TEST_EXPECT_MSG_EQ (cache.GetPathData (b, a, 0), ab, "Path b-->a should be the same as path a-->b");
+  NS_TEST_EXPECT_MSG_EQ (cache.GetPathData (a, b, 1), 0, "Paths of another model UID should not be found");
+  NS_TEST_EXPECT_MSG_EQ (cache.GetPathData (a, c, 0), 0, "Path a-->c should not be found");
+  NS_TEST_EXPECT_MSG_EQ (cache.GetHits (), 2, "Unexpected number of hits");
+  NS_TEST_EXPECT_MSG_EQ (cache.GetMisses (), 2, "Unexpected number of misses");
+  cache.Clear ();
+  NS_TEST_EXPECT_MSG_EQ (cache.GetSize (), 0, "The cache should be empty");
+
+  // asymmetric paths
+  cache.SetSymmetric (false);
+  cache.AddPathData (ab, a, b, 0);
+  NS_TEST_EXPECT_MSG_EQ (cache.GetPathData (a, b, 0), ab, "Path a-->b should be found");
+  NS_TEST_EXPECT_MSG_EQ (cache.GetPathData (b, a, 0), 0, "Path b-->a should not be found");
+  cache.Clear ();
+
+  // the least recently used path is evicted first
+  PropagationCache<PropagationCacheTestData> boundedCache;
+  boundedCache.SetMaxSize (2);
+  Ptr<PropagationCacheTestData> ac = Create<PropagationCacheTestData> ();
+  Ptr<PropagationCacheTestData> ad = Create<PropagationCacheTestData> ();
+  boundedCache.AddPathData (ab, a, b, 0);
+  boundedCache.AddPathData (ac, a, c, 0);
+  NS_TEST_EXPECT_MSG_EQ (boundedCache.GetPathData (b, a, 0), ab, "Path a-->b should be found");
+  boundedCache.AddPathData (ad, a, d, 0);
+  NS_TEST_EXPECT_MSG_EQ (boundedCache.GetSize (), 2, "The cache should be full");
+  NS_TEST_EXPECT_MSG_EQ (boundedCache.GetEvictions (), 1, "Unexpected number of evictions");
+  NS_TEST_EXPECT_MSG_EQ (boundedCache.GetPathData (a, c, 0), 0, "Path a-->c should have been evicted");
+  NS_TEST_EXPECT_MSG_EQ (boundedCache.GetPathData (a, b, 0), ab, "Path a-->b should be found");
+  NS_TEST_EXPECT_MSG_EQ (boundedCache.GetPathData (a, d, 0), ad, "Path a-->d should be found");
+
+  // the paths which are not used for more than one second are evicted
+  m_idleCache.SetMaxIdleTime (Seconds (1));
+  m_idleCache.AddPathData (ab, a, b, 0);
+  m_idleCache.AddPathData (ac, a, c, 0);
+  Simulator::Schedule (Seconds (0.5), &PropagationCacheTestCase::UsePath, this);
+  Simulator::Schedule (Seconds (1.2), &PropagationCacheTestCase::CheckIdlePaths, this);
+  Simulator::Run ();
+  Simulator::Destroy ();
+
+  m_idleCache.Clear ();
+  m_mobilities.clear ();
+}
+
+/**
+ * \ingroup propagation
+ * \ingroup tests
+ *
+ * \brief PropagationCache Test Suite
+ */
+class PropagationCacheTestSuite : public TestSuite
+{
+public:
+  PropagationCacheTestSuite ();
+};
+
+PropagationCacheTestSuite::PropagationCacheTestSuite ()
+  : TestSuite ("propagation-cache", UNIT)
+{
+  AddTestCase (new PropagationCacheTestCase, TestCase::QUICK);
+}
+
+static PropagationCacheTestSuite g_propagationCacheTestSuite; //!< the test suite
@@ -141,6 +141,23 @@ private:
    */
   TxSpectrumModelInfoMap_t::const_iterator FindAndEventuallyAddTxSpectrumModel (Ptr<const SpectrumModel> txSpectrumModel);
 
+  /**
+   * Used internally to propagate a transmission to a receiver: apply the
+   * antenna gains and the propagation loss models, and schedule the
+   * reception after the propagation delay unless the receiver is out of
+   * range.
+   *
+   * \param txParams The signal parameters of the transmitter.
+   * \param txMobility The mobility model of the transmitter.
+   * \param convertedTxPowerSpectrum The transmitted PSD converted to the SpectrumModel of the receiver.
+   * \param convertedTxPowerW The power of convertedTxPowerSpectrum (W), only used if minRxPowerW is strictly positive.
+   * \param minRxPowerW The minimum receive power (W).
+   * \param receiver A pointer to the receiver SpectrumPhy.
+   */
+  void StartTxToRx (Ptr<SpectrumSignalParameters> txParams, Ptr<MobilityModel> txMobility,
+                    Ptr<const SpectrumValue> convertedTxPowerSpectrum, double convertedTxPowerW,
+                    double minRxPowerW, Ptr<SpectrumPhy> receiver);
+
   /**
    * Used internally to reschedule transmission after the propagation delay.
    *
@@ -164,6 +181,18 @@ private:
    */
   RxSpectrumModelInfoMap_t m_rxSpectrumModelInfoMap;
 
+  /**
+   * Receivers which may be in range of the current transmitter, reused from
+   * one transmission to the next when the MaxRange attribute is set.
+   */
+  std::vector<Ptr<SpectrumPhy> > m_rxPhysInRange;
+
+  /**
+   * Receivers in range registered with the RX SpectrumModel being processed
+   * by StartTx, reused from one transmission to the next.
+   */
+  std::vector<Ptr<SpectrumPhy> > m_rxPhysOfModel;
+
   /**
    * Number of devices connected to the channel.
    */
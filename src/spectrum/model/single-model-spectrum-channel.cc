@@ -54,6 +54,7 @@ SingleModelSpectrumChannel::DoDispose ()
 {
   NS_LOG_FUNCTION (this);
   m_phyList.clear ();
+  m_rxPhysInRange.clear ();
   m_spectrumModel = 0;
   SpectrumChannel::DoDispose ();
 }
@@ -76,6 +77,7 @@ SingleModelSpectrumChannel::AddRx (Ptr<SpectrumPhy> phy)
 {
   NS_LOG_FUNCTION (this << phy);
   m_phyList.push_back (phy);
+  AddRxToIndex (phy);
 }
 
 
@@ -106,8 +108,18 @@ SingleModelSpectrumChannel::StartTx (Ptr<SpectrumSignalParameters> txParams)
 
   Ptr<MobilityModel> senderMobility = txParams->txPhy->GetMobility ();
 
-  for (PhyList::const_iterator rxPhyIterator = m_phyList.begin ();
-       rxPhyIterator != m_phyList.end ();
+  // only consider the receivers close enough to the transmitter if the range is limited
+  const PhyList *rxPhys = &m_phyList;
+  if (m_maxRange > 0 && senderMobility)
+    {
+      GetRxInRange (senderMobility, m_rxPhysInRange);
+      rxPhys = &m_rxPhysInRange;
+    }
+  double minRxPowerW = GetMinRxPowerW ();
+  double txPowerW = (minRxPowerW > 0) ? Integral (*(txParams->psd)) : 0;
+
+  for (PhyList::const_iterator rxPhyIterator = rxPhys->begin ();
+       rxPhyIterator != rxPhys->end ();
        ++rxPhyIterator)
     {
       if ((*rxPhyIterator) != txParams->txPhy)
@@ -115,6 +127,12 @@ SingleModelSpectrumChannel::StartTx (Ptr<SpectrumSignalParameters> txParams)
           Time delay  = MicroSeconds (0);
 
           Ptr<MobilityModel> receiverMobility = (*rxPhyIterator)->GetMobility ();
+          if (m_maxRange > 0 && senderMobility && receiverMobility
+              && senderMobility->GetDistanceFrom (receiverMobility) > m_maxRange)
+            {
+              // beyond range
+              continue;
+            }
           NS_LOG_LOGIC ("copying signal parameters " << txParams);
           Ptr<SpectrumSignalParameters> rxParams = txParams->Copy ();
 
@@ -156,6 +174,11 @@ SingleModelSpectrumChannel::StartTx (Ptr<SpectrumSignalParameters> txParams)
                   continue;
                 }
               double pathGainLinear = std::pow (10.0, (-pathLossDb) / 10.0);
+              if (txPowerW * pathGainLinear < minRxPowerW)
+                {
+                  // below the minimum receive power
+                  continue;
+                }
               *(rxParams->psd) *= pathGainLinear;              
 
               if (m_spectrumPropagationLoss)
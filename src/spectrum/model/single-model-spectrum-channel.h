@@ -77,6 +77,12 @@ private:
    */
   PhyList m_phyList;
 
+  /**
+   * Receivers which may be in range of the current transmitter, reused from
+   * one transmission to the next when the MaxRange attribute is set
+   */
+  PhyList m_rxPhysInRange;
+
   /**
    * SpectrumModel that this channel instance is supporting.
    */
@@ -21,6 +21,8 @@
 #include <ns3/log.h>
 #include <ns3/double.h>
 #include <ns3/pointer.h>
+#include <algorithm>
+#include <cmath>
 
 #include "spectrum-channel.h"
 
@@ -32,6 +34,7 @@ NS_LOG_COMPONENT_DEFINE ("SpectrumChannel");
 NS_OBJECT_ENSURE_REGISTERED (SpectrumChannel);
 
 SpectrumChannel::SpectrumChannel ()
+  : m_rxIndexCellSize (0)
 {
   NS_LOG_FUNCTION (this);
 }
@@ -47,6 +50,15 @@ SpectrumChannel::DoDispose ()
   m_propagationLoss = 0;
   m_propagationDelay = 0;
   m_spectrumPropagationLoss = 0;
+  for (std::map<Ptr<MobilityModel>, RxIndexEntry>::const_iterator it = m_rxIndexMobilities.begin ();
+       it != m_rxIndexMobilities.end (); ++it)
+    {
+      it->first->TraceDisconnectWithoutContext ("CourseChange", MakeCallback (&SpectrumChannel::RxCourseChanged, this));
+    }
+  m_rxIndexMobilities.clear ();
+  m_rxIndexPhys.clear ();
+  m_rxIndexCells.clear ();
+  m_rxIndexNotIndexed.clear ();
 }
 
 TypeId
@@ -70,6 +82,29 @@ SpectrumChannel::GetTypeId (void)
                    MakeDoubleAccessor (&SpectrumChannel::m_maxLossDb),
                    MakeDoubleChecker<double> ())
 
+    .AddAttribute ("MinRxPowerDbm",
+                   "If a single-frequency PropagationLossModel is used, "
+                   "signals whose power over the SpectrumModel of the receiver, "
+                   "after the antenna gains and the PropagationLossModel, "
+                   "is lower than this value (dBm) are not propagated to "
+                   "the receiver.  Like MaxLossDb, this parameter is to be "
+                   "used to reduce the computational load.  Note that "
+                   "SpectrumPropagationLossModel (even if present) is not "
+                   "taken into account.  The default value corresponds to "
+                   "considering all signals for reception.",
+                   DoubleValue (-1.0e9),
+                   MakeDoubleAccessor (&SpectrumChannel::m_minRxPowerDbm),
+                   MakeDoubleChecker<double> ())
+    .AddAttribute ("MaxRange",
+                   "If strictly positive, signals are not propagated to "
+                   "receivers farther than this distance (m) from the "
+                   "transmitter, and the receivers which are not moving are "
+                   "kept in a spatial index so that the receivers out of "
+                   "range are not even considered.  Zero disables the range "
+                   "limit.",
+                   DoubleValue (0.0),
+                   MakeDoubleAccessor (&SpectrumChannel::m_maxRange),
+                   MakeDoubleChecker<double> (0.0))
     .AddAttribute ("PropagationLossModel",
                    "A pointer to the propagation loss model attached to this channel.",
                    PointerValue (0),
@@ -149,5 +184,164 @@ SpectrumChannel::GetSpectrumPropagationLossModel (void)
   return m_spectrumPropagationLoss;
 }
 
+double
+SpectrumChannel::GetMinRxPowerW (void) const
+{
+  return std::pow (10.0, (m_minRxPowerDbm - 30) / 10.0);
+}
+
+void
+SpectrumChannel::AddRxToIndex (Ptr<SpectrumPhy> phy)
+{
+  NS_LOG_FUNCTION (this << phy);
+  if (std::find (m_rxIndexPhys.begin (), m_rxIndexPhys.end (), phy) == m_rxIndexPhys.end ())
+    {
+      m_rxIndexPhys.push_back (phy);
+    }
+  m_rxIndexCellSize = 0;
+}
+
+void
+SpectrumChannel::RxCourseChanged (Ptr<const MobilityModel> mobility)
+{
+  NS_LOG_FUNCTION (this << mobility);
+  if (m_rxIndexCellSize != m_maxRange)
+    {
+      // the index is rebuilt before its next use
+      return;
+    }
+  std::map<Ptr<MobilityModel>, RxIndexEntry>::iterator it = m_rxIndexMobilities.find (ConstCast<MobilityModel> (mobility));
+  if (it == m_rxIndexMobilities.end ())
+    {
+      return;
+    }
+  RxIndexEntry location = it->second;
+  LocateRxIndexEntry (mobility, location);
+  if (location.indexed == it->second.indexed && (!location.indexed || location.cell == it->second.cell))
+    {
+      return;
+    }
+  for (std::vector<Ptr<SpectrumPhy> >::const_iterator phy = it->second.phys.begin ();
+       phy != it->second.phys.end (); ++phy)
+    {
+      RemoveRxFromIndex (*phy, it->second);
+      InsertRxInIndex (*phy, location);
+    }
+  it->second.indexed = location.indexed;
+  it->second.cell = location.cell;
+}
+
+SpectrumChannel::RxIndexCell
+SpectrumChannel::GetRxIndexCell (const Vector &position) const
+{
+  return std::make_pair (static_cast<int64_t> (std::floor (position.x / m_rxIndexCellSize)),
+                         static_cast<int64_t> (std::floor (position.y / m_rxIndexCellSize)));
+}
+
+void
+SpectrumChannel::LocateRxIndexEntry (Ptr<const MobilityModel> mobility, RxIndexEntry &entry) const
+{
+  // a receiver which is not moving stays in its cell until its next course change
+  Vector velocity = mobility->GetVelocity ();
+  entry.indexed = (velocity.x == 0 && velocity.y == 0 && velocity.z == 0);
+  if (entry.indexed)
+    {
+      entry.cell = GetRxIndexCell (mobility->GetPosition ());
+    }
+}
+
+void
+SpectrumChannel::InsertRxInIndex (Ptr<SpectrumPhy> phy, const RxIndexEntry &entry)
+{
+  if (entry.indexed)
+    {
+      m_rxIndexCells[entry.cell].push_back (phy);
+    }
+  else
+    {
+      m_rxIndexNotIndexed.push_back (phy);
+    }
+}
+
+void
+SpectrumChannel::RemoveRxFromIndex (Ptr<SpectrumPhy> phy, const RxIndexEntry &entry)
+{
+  if (entry.indexed)
+    {
+      std::map<RxIndexCell, std::vector<Ptr<SpectrumPhy> > >::iterator cell = m_rxIndexCells.find (entry.cell);
+      NS_ASSERT (cell != m_rxIndexCells.end ());
+      cell->second.erase (std::find (cell->second.begin (), cell->second.end (), phy));
+      if (cell->second.empty ())
+        {
+          m_rxIndexCells.erase (cell);
+        }
+    }
+  else
+    {
+      m_rxIndexNotIndexed.erase (std::find (m_rxIndexNotIndexed.begin (), m_rxIndexNotIndexed.end (), phy));
+    }
+}
+
+void
+SpectrumChannel::BuildRxIndex (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_rxIndexCells.clear ();
+  m_rxIndexNotIndexed.clear ();
+  m_rxIndexCellSize = m_maxRange;
+  for (std::map<Ptr<MobilityModel>, RxIndexEntry>::iterator it = m_rxIndexMobilities.begin ();
+       it != m_rxIndexMobilities.end (); ++it)
+    {
+      it->second.phys.clear ();
+    }
+  for (std::vector<Ptr<SpectrumPhy> >::const_iterator it = m_rxIndexPhys.begin ();
+       it != m_rxIndexPhys.end (); ++it)
+    {
+      Ptr<MobilityModel> mobility = (*it)->GetMobility ();
+      if (mobility == 0)
+        {
+          m_rxIndexNotIndexed.push_back (*it);
+          continue;
+        }
+      std::pair<std::map<Ptr<MobilityModel>, RxIndexEntry>::iterator, bool> ret =
+        m_rxIndexMobilities.insert (std::make_pair (mobility, RxIndexEntry ()));
+      if (ret.second)
+        {
+          mobility->TraceConnectWithoutContext ("CourseChange", MakeCallback (&SpectrumChannel::RxCourseChanged, this));
+        }
+      RxIndexEntry &entry = ret.first->second;
+      LocateRxIndexEntry (mobility, entry);
+      entry.phys.push_back (*it);
+      InsertRxInIndex (*it, entry);
+    }
+  NS_LOG_LOGIC (m_rxIndexCells.size () << " cells, " << m_rxIndexNotIndexed.size () << " receivers not indexed");
+}
+
+void
+SpectrumChannel::GetRxInRange (Ptr<const MobilityModel> txMobility, std::vector<Ptr<SpectrumPhy> > &rxPhys)
+{
+  NS_LOG_FUNCTION (this << txMobility);
+  NS_ASSERT (m_maxRange > 0);
+  if (m_rxIndexCellSize != m_maxRange)
+    {
+      BuildRxIndex ();
+    }
+  // the cells are as wide as the range, hence receivers in range lie in the
+  // cell of the transmitter or in one of the eight cells around it
+  rxPhys.assign (m_rxIndexNotIndexed.begin (), m_rxIndexNotIndexed.end ());
+  RxIndexCell txCell = GetRxIndexCell (txMobility->GetPosition ());
+  for (int64_t x = txCell.first - 1; x <= txCell.first + 1; x++)
+    {
+      for (int64_t y = txCell.second - 1; y <= txCell.second + 1; y++)
+        {
+          std::map<RxIndexCell, std::vector<Ptr<SpectrumPhy> > >::const_iterator it = m_rxIndexCells.find (std::make_pair (x, y));
+          if (it != m_rxIndexCells.end ())
+            {
+              rxPhys.insert (rxPhys.end (), it->second.begin (), it->second.end ());
+            }
+        }
+    }
+}
+
 
 } // namespace
@@ -32,6 +32,8 @@
 #include <ns3/spectrum-phy.h>
 #include <ns3/traced-callback.h>
 #include <ns3/mobility-model.h>
+#include <map>
+#include <vector>
 
 namespace ns3 {
 
@@ -154,6 +156,35 @@ public:
 
 protected:
 
+  /**
+   * Register a receiver to the spatial index used when the MaxRange
+   * attribute is set.  Subclasses call this method from AddRx.
+   *
+   * \param phy the receiver
+   */
+  void AddRxToIndex (Ptr<SpectrumPhy> phy);
+
+  /**
+   * Return the receivers which may be within MaxRange of the transmitter.
+   * Receivers which are not moving are looked up in a grid whose cells are
+   * MaxRange wide, receivers which are moving or have no mobility model are
+   * always returned.  The caller still has to check the actual distance.
+   * The receivers are stored in a vector owned by the caller, so that it
+   * can be reused from one transmission to the next.
+   *
+   * \param txMobility the mobility model of the transmitter
+   * \param rxPhys the vector which is cleared and filled with the receivers
+   *        which may be in range
+   */
+  void GetRxInRange (Ptr<const MobilityModel> txMobility, std::vector<Ptr<SpectrumPhy> > &rxPhys);
+
+  /**
+   * Convert the MinRxPowerDbm attribute to Watts.
+   *
+   * \return the minimum receive power (W), which is zero if there is no cutoff
+   */
+  double GetMinRxPowerW (void) const;
+
   /**
    * The `PathLoss` trace source. Exporting the pointers to the Tx and Rx
    * SpectrumPhy and a pathloss value, in dB.
@@ -194,7 +225,83 @@ protected:
    */
   Ptr<SpectrumPropagationLossModel> m_spectrumPropagationLoss;
 
+  /**
+   * Maximum distance between transmitter and receiver [m].
+   *
+   * Any device farther than this distance is considered out of range.  Zero
+   * disables the range limit and the spatial index of the receivers.
+   */
+  double m_maxRange;
+
+  /**
+   * Minimum receive power [dBm].
+   *
+   * Any device receiving less than this power over its SpectrumModel is
+   * considered out of range.
+   */
+  double m_minRxPowerDbm;
+
+private:
+  /**
+   * Move the receivers using a mobility model to the cell of their new
+   * position when they change their course.
+   *
+   * \param mobility the mobility model of the receivers
+   */
+  void RxCourseChanged (Ptr<const MobilityModel> mobility);
+
+  /**
+   * Sort the receivers into the cells of the spatial index.
+   */
+  void BuildRxIndex (void);
+
+  /// Coordinates of a cell of the spatial index
+  typedef std::pair<int64_t, int64_t> RxIndexCell;
+
+  /// Location in the spatial index of the receivers using a mobility model
+  struct RxIndexEntry
+  {
+    std::vector<Ptr<SpectrumPhy> > phys;  //!< the receivers using the mobility model
+    bool indexed;  //!< whether the receivers are in a cell, rather than not indexed
+    RxIndexCell cell;  //!< the cell of the receivers, if they are indexed
+  };
+
+  /**
+   * \param position a position
+   * \return the cell of the spatial index holding the given position
+   */
+  RxIndexCell GetRxIndexCell (const Vector &position) const;
+
+  /**
+   * Set where the receivers using a mobility model belong in the spatial
+   * index, from the current course of the mobility model.
+   *
+   * \param mobility the mobility model
+   * \param entry the location of the receivers, which is updated
+   */
+  void LocateRxIndexEntry (Ptr<const MobilityModel> mobility, RxIndexEntry &entry) const;
+
+  /**
+   * Add a receiver to the cell or to the receivers not indexed.
+   *
+   * \param phy the receiver
+   * \param entry the location of the receiver
+   */
+  void InsertRxInIndex (Ptr<SpectrumPhy> phy, const RxIndexEntry &entry);
+
+  /**
+   * Remove a receiver from the cell or from the receivers not indexed.
+   *
+   * \param phy the receiver
+   * \param entry the location of the receiver
+   */
+  void RemoveRxFromIndex (Ptr<SpectrumPhy> phy, const RxIndexEntry &entry);
 
+  std::vector<Ptr<SpectrumPhy> > m_rxIndexPhys;  //!< all the receivers, in the order they were added
+  std::map<RxIndexCell, std::vector<Ptr<SpectrumPhy> > > m_rxIndexCells;  //!< receivers which are not moving, per cell
+  std::vector<Ptr<SpectrumPhy> > m_rxIndexNotIndexed;  //!< receivers which are moving or have no mobility model
+  std::map<Ptr<MobilityModel>, RxIndexEntry> m_rxIndexMobilities;  //!< mobility models whose course changes are tracked, and their receivers
+  double m_rxIndexCellSize;  //!< size of the cells of the spatial index [m], zero if the index is out of date
 };
 
 
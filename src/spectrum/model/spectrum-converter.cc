@@ -30,6 +30,7 @@ namespace ns3 {
 NS_LOG_COMPONENT_DEFINE ("SpectrumConverter");
 
 SpectrumConverter::SpectrumConverter ()
+  : m_identity (false)
 {
 }
 
@@ -39,6 +40,16 @@ SpectrumConverter::SpectrumConverter (Ptr<const SpectrumModel> fromSpectrumModel
   m_fromSpectrumModel = fromSpectrumModel;
   m_toSpectrumModel = toSpectrumModel;
 
+  // SpectrumModels created independently may still define the same bands,
+  // in which case the conversion matrix is the identity
+  m_identity = (fromSpectrumModel->GetNumBands () == toSpectrumModel->GetNumBands ());
+  for (Bands::const_iterator fromit = fromSpectrumModel->Begin (), toit = toSpectrumModel->Begin ();
+       m_identity && fromit != fromSpectrumModel->End ();
+       ++fromit, ++toit)
+    {
+      m_identity = (fromit->fl == toit->fl && fromit->fh == toit->fh);
+    }
+
   size_t rowPtr = 0;
   for (Bands::const_iterator toit = toSpectrumModel->Begin (); toit != toSpectrumModel->End (); ++toit)
     {
@@ -82,6 +93,12 @@ SpectrumConverter::Convert (Ptr<const SpectrumValue> fvvf) const
 
   Ptr<SpectrumValue> tvvf = Create<SpectrumValue> (m_toSpectrumModel);
 
+  if (m_identity)
+    {
+      std::copy (fvvf->ConstValuesBegin (), fvvf->ConstValuesEnd (), tvvf->ValuesBegin ());
+      return tvvf;
+    }
+
   Values::iterator tvit = tvvf->ValuesBegin ();
   size_t i = 0; // Index of conversion coefficient
 
@@ -84,6 +84,7 @@ private:
 
   Ptr<const SpectrumModel> m_fromSpectrumModel;  //!<  the SpectrumModel this SpectrumConverter instance can convert from
   Ptr<const SpectrumModel> m_toSpectrumModel;    //!<  the SpectrumModel this SpectrumConverter instance can convert to
+  bool m_identity;  //!<  true if both SpectrumModels have the same bands, in which case values are copied as they are
 
 };
 
@@ -22,6 +22,7 @@
 #include <ns3/spectrum-value.h>
 #include <ns3/math.h>
 #include <ns3/log.h>
+#include <utility>
 
 namespace ns3 {
 
@@ -106,17 +107,13 @@ SpectrumValue::ConstBandsEnd () const
 void
 SpectrumValue::Add (const SpectrumValue& x)
 {
-  Values::iterator it1 = m_values.begin ();
-  Values::const_iterator it2 = x.m_values.begin ();
-
   NS_ASSERT (m_spectrumModel == x.m_spectrumModel);
-
-  while (it1 != m_values.end ())
+  NS_ASSERT (m_values.size () == x.m_values.size ());
+  double *v = m_values.data ();
+  const double *xv = x.m_values.data ();
+  for (size_t i = 0, n = m_values.size (); i < n; ++i)
     {
-      NS_ASSERT ( it2 != x.m_values.end ());
-      *it1 += *it2;
-      ++it1;
-      ++it2;
+      v[i] += xv[i];
     }
 }
 
@@ -124,12 +121,10 @@ SpectrumValue::Add (const SpectrumValue& x)
 void
 SpectrumValue::Add (double s)
 {
-  Values::iterator it1 = m_values.begin ();
-
-  while (it1 != m_values.end ())
+  double *v = m_values.data ();
+  for (size_t i = 0, n = m_values.size (); i < n; ++i)
     {
-      *it1 += s;
-      ++it1;
+      v[i] += s;
     }
 }
 
@@ -138,17 +133,13 @@ SpectrumValue::Add (double s)
 void
 SpectrumValue::Subtract (const SpectrumValue& x)
 {
-  Values::iterator it1 = m_values.begin ();
-  Values::const_iterator it2 = x.m_values.begin ();
-
   NS_ASSERT (m_spectrumModel == x.m_spectrumModel);
-
-  while (it1 != m_values.end ())
+  NS_ASSERT (m_values.size () == x.m_values.size ());
+  double *v = m_values.data ();
+  const double *xv = x.m_values.data ();
+  for (size_t i = 0, n = m_values.size (); i < n; ++i)
     {
-      NS_ASSERT ( it2 != x.m_values.end ());
-      *it1 -= *it2;
-      ++it1;
-      ++it2;
+      v[i] -= xv[i];
     }
 }
 
@@ -164,17 +155,13 @@ SpectrumValue::Subtract (double s)
 void
 SpectrumValue::Multiply (const SpectrumValue& x)
 {
-  Values::iterator it1 = m_values.begin ();
-  Values::const_iterator it2 = x.m_values.begin ();
-
   NS_ASSERT (m_spectrumModel == x.m_spectrumModel);
-
-  while (it1 != m_values.end ())
+  NS_ASSERT (m_values.size () == x.m_values.size ());
+  double *v = m_values.data ();
+  const double *xv = x.m_values.data ();
+  for (size_t i = 0, n = m_values.size (); i < n; ++i)
     {
-      NS_ASSERT ( it2 != x.m_values.end ());
-      *it1 *= *it2;
-      ++it1;
-      ++it2;
+      v[i] *= xv[i];
     }
 }
 
@@ -182,12 +169,10 @@ SpectrumValue::Multiply (const SpectrumValue& x)
 void
 SpectrumValue::Multiply (double s)
 {
-  Values::iterator it1 = m_values.begin ();
-
-  while (it1 != m_values.end ())
+  double *v = m_values.data ();
+  for (size_t i = 0, n = m_values.size (); i < n; ++i)
     {
-      *it1 *= s;
-      ++it1;
+      v[i] *= s;
     }
 }
 
@@ -197,17 +182,13 @@ SpectrumValue::Multiply (double s)
 void
 SpectrumValue::Divide (const SpectrumValue& x)
 {
-  Values::iterator it1 = m_values.begin ();
-  Values::const_iterator it2 = x.m_values.begin ();
-
   NS_ASSERT (m_spectrumModel == x.m_spectrumModel);
-
-  while (it1 != m_values.end ())
+  NS_ASSERT (m_values.size () == x.m_values.size ());
+  double *v = m_values.data ();
+  const double *xv = x.m_values.data ();
+  for (size_t i = 0, n = m_values.size (); i < n; ++i)
     {
-      NS_ASSERT ( it2 != x.m_values.end ());
-      *it1 /= *it2;
-      ++it1;
-      ++it2;
+      v[i] /= xv[i];
     }
 }
 
@@ -216,27 +197,51 @@ void
 SpectrumValue::Divide (double s)
 {
   NS_LOG_FUNCTION (this << s);
-  Values::iterator it1 = m_values.begin ();
+  double *v = m_values.data ();
+  for (size_t i = 0, n = m_values.size (); i < n; ++i)
+    {
+      v[i] /= s;
+    }
+}
 
-  while (it1 != m_values.end ())
+
+
+
+void
+SpectrumValue::ReverseSubtract (const SpectrumValue& x)
+{
+  NS_ASSERT (m_spectrumModel == x.m_spectrumModel);
+  NS_ASSERT (m_values.size () == x.m_values.size ());
+  double *v = m_values.data ();
+  const double *xv = x.m_values.data ();
+  for (size_t i = 0, n = m_values.size (); i < n; ++i)
     {
-      *it1 /= s;
-      ++it1;
+      v[i] = xv[i] - v[i];
     }
 }
 
 
+void
+SpectrumValue::ReverseDivide (const SpectrumValue& x)
+{
+  NS_ASSERT (m_spectrumModel == x.m_spectrumModel);
+  NS_ASSERT (m_values.size () == x.m_values.size ());
+  double *v = m_values.data ();
+  const double *xv = x.m_values.data ();
+  for (size_t i = 0, n = m_values.size (); i < n; ++i)
+    {
+      v[i] = xv[i] / v[i];
+    }
+}
 
 
 void
 SpectrumValue::ChangeSign ()
 {
-  Values::iterator it1 = m_values.begin ();
-
-  while (it1 != m_values.end ())
+  double *v = m_values.data ();
+  for (size_t i = 0, n = m_values.size (); i < n; ++i)
     {
-      *it1 = -(*it1);
-      ++it1;
+      v[i] = -v[i];
     }
 }
 
@@ -389,17 +394,14 @@ Prod (const SpectrumValue& x)
 double
 Integral (const SpectrumValue& arg)
 {
+  NS_ASSERT (arg.m_values.size () == arg.m_spectrumModel->GetNumBands ());
   double i = 0;
-  Values::const_iterator vit = arg.ConstValuesBegin ();
+  const double *v = arg.m_values.data ();
   Bands::const_iterator bit = arg.ConstBandsBegin ();
-  while (vit != arg.ConstValuesEnd ())
+  for (size_t k = 0, n = arg.m_values.size (); k < n; ++k, ++bit)
     {
-      NS_ASSERT (bit != arg.ConstBandsEnd ());
-      i += (*vit) * (bit->fh - bit->fl);
-      ++vit;
-      ++bit;
+      i += v[k] * (bit->fh - bit->fl);
     }
-  NS_ASSERT (bit == arg.ConstBandsEnd ());
   return i;
 }
 
@@ -603,6 +605,192 @@ Log (const SpectrumValue& arg)
   return res;
 }
 
+// The following overloads reuse the storage of a temporary operand, so
+// that a chain of operations such as a / (b + c) only allocates the
+// result of the first operation.
+
+SpectrumValue
+operator+ (SpectrumValue&& lhs, const SpectrumValue& rhs)
+{
+  lhs.Add (rhs);
+  return std::move (lhs);
+}
+
+SpectrumValue
+operator+ (const SpectrumValue& lhs, SpectrumValue&& rhs)
+{
+  rhs.Add (lhs);
+  return std::move (rhs);
+}
+
+SpectrumValue
+operator+ (SpectrumValue&& lhs, SpectrumValue&& rhs)
+{
+  lhs.Add (rhs);
+  return std::move (lhs);
+}
+
+SpectrumValue
+operator+ (SpectrumValue&& lhs, double rhs)
+{
+  lhs.Add (rhs);
+  return std::move (lhs);
+}
+
+SpectrumValue
+operator+ (double lhs, SpectrumValue&& rhs)
+{
+  rhs.Add (lhs);
+  return std::move (rhs);
+}
+
+SpectrumValue
+operator- (SpectrumValue&& lhs, const SpectrumValue& rhs)
+{
+  lhs.Subtract (rhs);
+  return std::move (lhs);
+}
+
+SpectrumValue
+operator- (const SpectrumValue& lhs, SpectrumValue&& rhs)
+{
+  rhs.ReverseSubtract (lhs);
+  return std::move (rhs);
+}
+
+SpectrumValue
+operator- (SpectrumValue&& lhs, SpectrumValue&& rhs)
+{
+  lhs.Subtract (rhs);
+  return std::move (lhs);
+}
+
+SpectrumValue
+operator- (SpectrumValue&& lhs, double rhs)
+{
+  lhs.Subtract (rhs);
+  return std::move (lhs);
+}
+
+SpectrumValue
+operator- (double lhs, SpectrumValue&& rhs)
+{
+  rhs.Subtract (lhs);
+  return std::move (rhs);
+}
+
+SpectrumValue
+operator* (SpectrumValue&& lhs, const SpectrumValue& rhs)
+{
+  lhs.Multiply (rhs);
+  return std::move (lhs);
+}
+
+SpectrumValue
+operator* (const SpectrumValue& lhs, SpectrumValue&& rhs)
+{
+  rhs.Multiply (lhs);
+  return std::move (rhs);
+}
+
+SpectrumValue
+operator* (SpectrumValue&& lhs, SpectrumValue&& rhs)
+{
+  lhs.Multiply (rhs);
+  return std::move (lhs);
+}
+
+SpectrumValue
+operator* (SpectrumValue&& lhs, double rhs)
+{
+  lhs.Multiply (rhs);
+  return std::move (lhs);
+}
+
+SpectrumValue
+operator* (double lhs, SpectrumValue&& rhs)
+{
+  rhs.Multiply (lhs);
+  return std::move (rhs);
+}
+
+SpectrumValue
+operator/ (SpectrumValue&& lhs, const SpectrumValue& rhs)
+{
+  lhs.Divide (rhs);
+  return std::move (lhs);
+}
+
+SpectrumValue
+operator/ (const SpectrumValue& lhs, SpectrumValue&& rhs)
+{
+  rhs.ReverseDivide (lhs);
+  return std::move (rhs);
+}
+
+SpectrumValue
+operator/ (SpectrumValue&& lhs, SpectrumValue&& rhs)
+{
+  lhs.Divide (rhs);
+  return std::move (lhs);
+}
+
+SpectrumValue
+operator/ (SpectrumValue&& lhs, double rhs)
+{
+  lhs.Divide (rhs);
+  return std::move (lhs);
+}
+
+SpectrumValue
+operator/ (double lhs, SpectrumValue&& rhs)
+{
+  rhs.Divide (lhs);
+  return std::move (rhs);
+}
+
+SpectrumValue
+operator- (SpectrumValue&& rhs)
+{
+  rhs.ChangeSign ();
+  return std::move (rhs);
+}
+
+SpectrumValue
+Pow (double lhs, SpectrumValue&& rhs)
+{
+  rhs.Exp (lhs);
+  return std::move (rhs);
+}
+
+SpectrumValue
+Pow (SpectrumValue&& lhs, double rhs)
+{
+  lhs.Pow (rhs);
+  return std::move (lhs);
+}
+
+SpectrumValue
+Log10 (SpectrumValue&& arg)
+{
+  arg.Log10 ();
+  return std::move (arg);
+}
+
+SpectrumValue
+Log2 (SpectrumValue&& arg)
+{
+  arg.Log2 ();
+  return std::move (arg);
+}
+
+SpectrumValue
+Log (SpectrumValue&& arg)
+{
+  arg.Log ();
+  return std::move (arg);
+}
+
 SpectrumValue&
 SpectrumValue::operator+= (const SpectrumValue& rhs)
 {
@@ -50,6 +50,9 @@ typedef std::vector<double> Values;
  * Space.
  * Mathematical operations are defined in this Function Space; these
  * operations are implemented by means of operator overloading.
+ * The operators taking a temporary SpectrumValue reuse its storage,
+ * hence a chain of operations such as \f$ s / (i + n) \f$ only allocates
+ * the values of its first intermediate result.
  *
  * The intended use of this class is to represent frequency-dependent
  * things, such as power spectral densities, frequency-dependent
@@ -190,6 +193,56 @@ public:
    */
   friend SpectrumValue operator+ (double lhs, const SpectrumValue& rhs);
 
+  /**
+   * addition operator reusing the storage of the temporary lhs
+   *
+   * @param lhs Left Hand Side of the operator
+   * @param rhs Right Hand Side of the operator
+   *
+   * @return the value of lhs + rhs
+   */
+  friend SpectrumValue operator+ (SpectrumValue&& lhs, const SpectrumValue& rhs);
+
+  /**
+   * addition operator reusing the storage of the temporary rhs
+   *
+   * @param lhs Left Hand Side of the operator
+   * @param rhs Right Hand Side of the operator
+   *
+   * @return the value of lhs + rhs
+   */
+  friend SpectrumValue operator+ (const SpectrumValue& lhs, SpectrumValue&& rhs);
+
+  /**
+   * addition operator reusing the storage of the temporary lhs
+   *
+   * @param lhs Left Hand Side of the operator
+   * @param rhs Right Hand Side of the operator
+   *
+   * @return the value of lhs + rhs
+   */
+  friend SpectrumValue operator+ (SpectrumValue&& lhs, SpectrumValue&& rhs);
+
+  /**
+   * addition operator reusing the storage of the temporary lhs
+   *
+   * @param lhs Left Hand Side of the operator
+   * @param rhs Right Hand Side of the operator
+   *
+   * @return the value of lhs + rhs
+   */
+  friend SpectrumValue operator+ (SpectrumValue&& lhs, double rhs);
+
+  /**
+   * addition operator reusing the storage of the temporary rhs
+   *
+   * @param lhs Left Hand Side of the operator
+   * @param rhs Right Hand Side of the operator
+   *
+   * @return the value of lhs + rhs
+   */
+  friend SpectrumValue operator+ (double lhs, SpectrumValue&& rhs);
+
 
   /**
    *  subtraction operator
@@ -221,6 +274,56 @@ public:
    */
   friend SpectrumValue operator- (double lhs, const SpectrumValue& rhs);
 
+  /**
+   * subtraction operator reusing the storage of the temporary lhs
+   *
+   * @param lhs Left Hand Side of the operator
+   * @param rhs Right Hand Side of the operator
+   *
+   * @return the value of lhs - rhs
+   */
+  friend SpectrumValue operator- (SpectrumValue&& lhs, const SpectrumValue& rhs);
+
+  /**
+   * subtraction operator reusing the storage of the temporary rhs
+   *
+   * @param lhs Left Hand Side of the operator
+   * @param rhs Right Hand Side of the operator
+   *
+   * @return the value of lhs - rhs
+   */
+  friend SpectrumValue operator- (const SpectrumValue& lhs, SpectrumValue&& rhs);
+
+  /**
+   * subtraction operator reusing the storage of the temporary lhs
+   *
+   * @param lhs Left Hand Side of the operator
+   * @param rhs Right Hand Side of the operator
+   *
+   * @return the value of lhs - rhs
+   */
+  friend SpectrumValue operator- (SpectrumValue&& lhs, SpectrumValue&& rhs);
+
+  /**
+   * subtraction operator reusing the storage of the temporary lhs
+   *
+   * @param lhs Left Hand Side of the operator
+   * @param rhs Right Hand Side of the operator
+   *
+   * @return the value of lhs - rhs
+   */
+  friend SpectrumValue operator- (SpectrumValue&& lhs, double rhs);
+
+  /**
+   * subtraction operator reusing the storage of the temporary rhs
+   *
+   * @param lhs Left Hand Side of the operator
+   * @param rhs Right Hand Side of the operator
+   *
+   * @return the same value as operator- (double, const SpectrumValue&)
+   */
+  friend SpectrumValue operator- (double lhs, SpectrumValue&& rhs);
+
   /**
    *  multiplication component-by-component (Schur product)
    *
@@ -251,6 +354,56 @@ public:
    */
   friend SpectrumValue operator* (double lhs, const SpectrumValue& rhs);
 
+  /**
+   * multiplication operator reusing the storage of the temporary lhs
+   *
+   * @param lhs Left Hand Side of the operator
+   * @param rhs Right Hand Side of the operator
+   *
+   * @return the value of lhs * rhs
+   */
+  friend SpectrumValue operator* (SpectrumValue&& lhs, const SpectrumValue& rhs);
+
+  /**
+   * multiplication operator reusing the storage of the temporary rhs
+   *
+   * @param lhs Left Hand Side of the operator
+   * @param rhs Right Hand Side of the operator
+   *
+   * @return the value of lhs * rhs
+   */
+  friend SpectrumValue operator* (const SpectrumValue& lhs, SpectrumValue&& rhs);
+
+  /**
+   * multiplication operator reusing the storage of the temporary lhs
+   *
+   * @param lhs Left Hand Side of the operator
+   * @param rhs Right Hand Side of the operator
+   *
+   * @return the value of lhs * rhs
+   */
+  friend SpectrumValue operator* (SpectrumValue&& lhs, SpectrumValue&& rhs);
+
+  /**
+   * multiplication operator reusing the storage of the temporary lhs
+   *
+   * @param lhs Left Hand Side of the operator
+   * @param rhs Right Hand Side of the operator
+   *
+   * @return the value of lhs * rhs
+   */
+  friend SpectrumValue operator* (SpectrumValue&& lhs, double rhs);
+
+  /**
+   * multiplication operator reusing the storage of the temporary rhs
+   *
+   * @param lhs Left Hand Side of the operator
+   * @param rhs Right Hand Side of the operator
+   *
+   * @return the value of lhs * rhs
+   */
+  friend SpectrumValue operator* (double lhs, SpectrumValue&& rhs);
+
   /**
    *  division component-by-component
    *
@@ -281,6 +434,56 @@ public:
    */
   friend SpectrumValue operator/ (double lhs, const SpectrumValue& rhs);
 
+  /**
+   * division operator reusing the storage of the temporary lhs
+   *
+   * @param lhs Left Hand Side of the operator
+   * @param rhs Right Hand Side of the operator
+   *
+   * @return the value of lhs / rhs
+   */
+  friend SpectrumValue operator/ (SpectrumValue&& lhs, const SpectrumValue& rhs);
+
+  /**
+   * division operator reusing the storage of the temporary rhs
+   *
+   * @param lhs Left Hand Side of the operator
+   * @param rhs Right Hand Side of the operator
+   *
+   * @return the value of lhs / rhs
+   */
+  friend SpectrumValue operator/ (const SpectrumValue& lhs, SpectrumValue&& rhs);
+
+  /**
+   * division operator reusing the storage of the temporary lhs
+   *
+   * @param lhs Left Hand Side of the operator
+   * @param rhs Right Hand Side of the operator
+   *
+   * @return the value of lhs / rhs
+   */
+  friend SpectrumValue operator/ (SpectrumValue&& lhs, SpectrumValue&& rhs);
+
+  /**
+   * division operator reusing the storage of the temporary lhs
+   *
+   * @param lhs Left Hand Side of the operator
+   * @param rhs Right Hand Side of the operator
+   *
+   * @return the value of lhs / rhs
+   */
+  friend SpectrumValue operator/ (SpectrumValue&& lhs, double rhs);
+
+  /**
+   * division operator reusing the storage of the temporary rhs
+   *
+   * @param lhs Left Hand Side of the operator
+   * @param rhs Right Hand Side of the operator
+   *
+   * @return the same value as operator/ (double, const SpectrumValue&)
+   */
+  friend SpectrumValue operator/ (double lhs, SpectrumValue&& rhs);
+
   /**
    * unary plus operator
    *
@@ -297,6 +500,14 @@ public:
    */
   friend SpectrumValue operator- (const SpectrumValue& rhs);
 
+  /**
+   * unary minus operator reusing the storage of the temporary rhs
+   *
+   * @param rhs Right Hand Side of the operator
+   * @return the value of - rhs
+   */
+  friend SpectrumValue operator- (SpectrumValue&& rhs);
+
 
   /**
    * left shift operator
@@ -460,6 +671,26 @@ public:
    */
   friend SpectrumValue Pow (double lhs, const SpectrumValue& rhs);
 
+  /**
+   * Pow reusing the storage of the temporary base
+   *
+   * @param lhs the base
+   * @param rhs the exponent
+   *
+   * @return each value in base raised to the exponent
+   */
+  friend SpectrumValue Pow (SpectrumValue&& lhs, double rhs);
+
+  /**
+   * Pow reusing the storage of the temporary exponent
+   *
+   * @param lhs the base
+   * @param rhs the exponent
+   *
+   * @return the value in base raised to each value in the exponent
+   */
+  friend SpectrumValue Pow (double lhs, SpectrumValue&& rhs);
+
   /**
    *
    *
@@ -469,6 +700,15 @@ public:
    */
   friend SpectrumValue Log10 (const SpectrumValue&  arg);
 
+  /**
+   * Log10 reusing the storage of the temporary argument
+   *
+   * @param arg the argument
+   *
+   * @return the logarithm in base 10 of all values in the argument
+   */
+  friend SpectrumValue Log10 (SpectrumValue&&  arg);
+
 
   /**
    *
@@ -479,6 +719,15 @@ public:
    */
   friend SpectrumValue Log2 (const SpectrumValue&  arg);
 
+  /**
+   * Log2 reusing the storage of the temporary argument
+   *
+   * @param arg the argument
+   *
+   * @return the logarithm in base 2 of all values in the argument
+   */
+  friend SpectrumValue Log2 (SpectrumValue&&  arg);
+
   /**
    *
    *
@@ -488,6 +737,15 @@ public:
    */
   friend SpectrumValue Log (const SpectrumValue&  arg);
 
+  /**
+   * Log reusing the storage of the temporary argument
+   *
+   * @param arg the argument
+   *
+   * @return the logarithm in base e of all values in the argument
+   */
+  friend SpectrumValue Log (SpectrumValue&&  arg);
+
   /**
    *
    *
@@ -555,6 +813,18 @@ private:
    * \param s flat value
    */
   void Divide (double s);
+  /**
+   * Replace each element by the corresponding element of a SpectrumValue
+   * minus the current element
+   * \param x SpectrumValue
+   */
+  void ReverseSubtract (const SpectrumValue& x);
+  /**
+   * Replace each element by the corresponding element of a SpectrumValue
+   * divided by the current element
+   * \param x SpectrumValue
+   */
+  void ReverseDivide (const SpectrumValue& x);
   /**
    * Change the values sign
    */
@@ -615,9 +885,14 @@ double Sum (const SpectrumValue& x);
 double Prod (const SpectrumValue& x);
 SpectrumValue Pow (const SpectrumValue& lhs, double rhs);
 SpectrumValue Pow (double lhs, const SpectrumValue& rhs);
+SpectrumValue Pow (SpectrumValue&& lhs, double rhs);
+SpectrumValue Pow (double lhs, SpectrumValue&& rhs);
 SpectrumValue Log10 (const SpectrumValue& arg);
+SpectrumValue Log10 (SpectrumValue&& arg);
 SpectrumValue Log2 (const SpectrumValue& arg);
+SpectrumValue Log2 (SpectrumValue&& arg);
 SpectrumValue Log (const SpectrumValue& arg);
+SpectrumValue Log (SpectrumValue&& arg);
 double Integral (const SpectrumValue& arg);
 
 
@@ -23,6 +23,7 @@
  */
 
 #include <map>
+#include <tuple>
 #include <cmath>
 #include "wifi-spectrum-value-helper.h"
 #include "ns3/log.h"
@@ -131,9 +132,80 @@ WifiSpectrumValueHelper::GetSpectrumModel (uint32_t centerFrequency, uint16_t ch
   return ret;
 }
 
+/**
+ * Key of a cached transmit PSD template: PSD type, center frequency (MHz),
+ * channel width (MHz) and guard bandwidth (MHz)
+ */
+typedef std::tuple<int, uint32_t, uint16_t, uint16_t> WifiTxPsdTemplateId;
+
+static std::map<WifiTxPsdTemplateId, Ptr<const SpectrumValue> > g_wifiTxPsdTemplateMap; ///< transmit PSDs normalized to 1 W
+
+Ptr<SpectrumValue>
+WifiSpectrumValueHelper::GetTxPowerSpectralDensity (TxPsdType type, uint32_t centerFrequency, uint16_t channelWidth,
+                                                    double txPowerW, uint16_t guardBandwidth)
+{
+  NS_LOG_FUNCTION (type << centerFrequency << channelWidth << txPowerW << guardBandwidth);
+  WifiTxPsdTemplateId key = std::make_tuple (type, centerFrequency, channelWidth, guardBandwidth);
+  std::map<WifiTxPsdTemplateId, Ptr<const SpectrumValue> >::const_iterator it = g_wifiTxPsdTemplateMap.find (key);
+  if (it == g_wifiTxPsdTemplateMap.end ())
+    {
+      // The spectrum mask is defined relatively to the power of the allocated
+      // subcarriers, hence the PSD is linear in the transmit power
+      Ptr<SpectrumValue> psd;
+      switch (type)
+        {
+        case DSSS_TX_PSD:
+          psd = DoCreateDsssTxPowerSpectralDensity (centerFrequency, 1.0, guardBandwidth);
+          break;
+        case OFDM_TX_PSD:
+          psd = DoCreateOfdmTxPowerSpectralDensity (centerFrequency, channelWidth, 1.0, guardBandwidth);
+          break;
+        case HT_OFDM_TX_PSD:
+          psd = DoCreateHtOfdmTxPowerSpectralDensity (centerFrequency, channelWidth, 1.0, guardBandwidth);
+          break;
+        case HE_OFDM_TX_PSD:
+          psd = DoCreateHeOfdmTxPowerSpectralDensity (centerFrequency, channelWidth, 1.0, guardBandwidth);
+          break;
+        default:
+          NS_FATAL_ERROR ("Unknown transmit PSD type " << type);
+          return 0;
+        }
+      NS_LOG_LOGIC ("Caching transmit PSD template of type " << type << " at " << centerFrequency << " MHz, width " << channelWidth << " MHz");
+      it = g_wifiTxPsdTemplateMap.insert (std::make_pair (key, psd)).first;
+    }
+  Ptr<SpectrumValue> c = it->second->Copy ();
+  *c *= txPowerW;
+  NS_ASSERT_MSG (std::abs (txPowerW - Integral (*c)) < 1e-6, "Power allocation failed");
+  return c;
+}
+
 // Power allocated to 71 center subbands out of 135 total subbands in the band
 Ptr<SpectrumValue>
 WifiSpectrumValueHelper::CreateDsssTxPowerSpectralDensity (uint32_t centerFrequency, double txPowerW, uint16_t guardBandwidth)
+{
+  return GetTxPowerSpectralDensity (DSSS_TX_PSD, centerFrequency, 22, txPowerW, guardBandwidth);
+}
+
+Ptr<SpectrumValue>
+WifiSpectrumValueHelper::CreateOfdmTxPowerSpectralDensity (uint32_t centerFrequency, uint16_t channelWidth, double txPowerW, uint16_t guardBandwidth)
+{
+  return GetTxPowerSpectralDensity (OFDM_TX_PSD, centerFrequency, channelWidth, txPowerW, guardBandwidth);
+}
+
+Ptr<SpectrumValue>
+WifiSpectrumValueHelper::CreateHtOfdmTxPowerSpectralDensity (uint32_t centerFrequency, uint16_t channelWidth, double txPowerW, uint16_t guardBandwidth)
+{
+  return GetTxPowerSpectralDensity (HT_OFDM_TX_PSD, centerFrequency, channelWidth, txPowerW, guardBandwidth);
+}
+
+Ptr<SpectrumValue>
+WifiSpectrumValueHelper::CreateHeOfdmTxPowerSpectralDensity (uint32_t centerFrequency, uint16_t channelWidth, double txPowerW, uint16_t guardBandwidth)
+{
+  return GetTxPowerSpectralDensity (HE_OFDM_TX_PSD, centerFrequency, channelWidth, txPowerW, guardBandwidth);
+}
+
+Ptr<SpectrumValue>
+WifiSpectrumValueHelper::DoCreateDsssTxPowerSpectralDensity (uint32_t centerFrequency, double txPowerW, uint16_t guardBandwidth)
 {
   NS_LOG_FUNCTION (centerFrequency << txPowerW << +guardBandwidth);
   uint16_t channelWidth = 22;  // DSSS channels are 22 MHz wide
@@ -157,7 +229,7 @@ WifiSpectrumValueHelper::CreateDsssTxPowerSpectralDensity (uint32_t centerFreque
 }
 
 Ptr<SpectrumValue>
-WifiSpectrumValueHelper::CreateOfdmTxPowerSpectralDensity (uint32_t centerFrequency, uint16_t channelWidth, double txPowerW, uint16_t guardBandwidth)
+WifiSpectrumValueHelper::DoCreateOfdmTxPowerSpectralDensity (uint32_t centerFrequency, uint16_t channelWidth, double txPowerW, uint16_t guardBandwidth)
 {
   NS_LOG_FUNCTION (centerFrequency << channelWidth << txPowerW << guardBandwidth);
   double bandBandwidth = 0;
@@ -210,7 +282,7 @@ WifiSpectrumValueHelper::CreateOfdmTxPowerSpectralDensity (uint32_t centerFreque
 }
 
 Ptr<SpectrumValue>
-WifiSpectrumValueHelper::CreateHtOfdmTxPowerSpectralDensity (uint32_t centerFrequency, uint16_t channelWidth, double txPowerW, uint16_t guardBandwidth)
+WifiSpectrumValueHelper::DoCreateHtOfdmTxPowerSpectralDensity (uint32_t centerFrequency, uint16_t channelWidth, double txPowerW, uint16_t guardBandwidth)
 {
   NS_LOG_FUNCTION (centerFrequency << channelWidth << txPowerW << guardBandwidth);
   double bandBandwidth = 312500;
@@ -327,7 +399,7 @@ WifiSpectrumValueHelper::CreateHtOfdmTxPowerSpectralDensity (uint32_t centerFreq
 }
 
 Ptr<SpectrumValue>
-WifiSpectrumValueHelper::CreateHeOfdmTxPowerSpectralDensity (uint32_t centerFrequency, uint16_t channelWidth, double txPowerW, uint16_t guardBandwidth)
+WifiSpectrumValueHelper::DoCreateHeOfdmTxPowerSpectralDensity (uint32_t centerFrequency, uint16_t channelWidth, double txPowerW, uint16_t guardBandwidth)
 {
   NS_LOG_FUNCTION (centerFrequency << channelWidth << txPowerW << guardBandwidth);
   double bandBandwidth = 78125;
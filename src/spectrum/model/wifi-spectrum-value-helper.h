@@ -210,6 +210,76 @@ public:
    * \return the equivalent Watts for the given dBm
    */
   static double DbmToW (double dbm);
+
+private:
+  /**
+   * Kind of transmit power spectral density, which determines the
+   * transmit spectrum mask
+   */
+  enum TxPsdType
+  {
+    DSSS_TX_PSD,
+    OFDM_TX_PSD,
+    HT_OFDM_TX_PSD,
+    HE_OFDM_TX_PSD
+  };
+
+  /**
+   * Return a transmit power spectral density scaled to the given transmit
+   * power.  The spectrum mask of each combination of PSD type, center
+   * frequency, channel width and guard bandwidth is built once for 1 W and
+   * cached, so that the transmit PSD of a frame is a copy of the cached
+   * template multiplied by the transmit power.
+   *
+   * \param type the type of the transmit PSD
+   * \param centerFrequency center frequency (MHz)
+   * \param channelWidth channel width (MHz)
+   * \param txPowerW  transmit power (W) to allocate
+   * \param guardBandwidth width of the guard band (MHz)
+   * \return a pointer to a newly allocated SpectrumValue representing the Transmit Power Spectral Density in W/Hz for each Band
+   */
+  static Ptr<SpectrumValue> GetTxPowerSpectralDensity (TxPsdType type, uint32_t centerFrequency, uint16_t channelWidth,
+                                                       double txPowerW, uint16_t guardBandwidth);
+
+  /**
+   * Build a transmit power spectral density corresponding to DSSS
+   *
+   * \param centerFrequency center frequency (MHz)
+   * \param txPowerW  transmit power (W) to allocate
+   * \param guardBandwidth width of the guard band (MHz)
+   * \returns a pointer to a newly allocated SpectrumValue representing the DSSS Transmit Power Spectral Density in W/Hz
+   */
+  static Ptr<SpectrumValue> DoCreateDsssTxPowerSpectralDensity (uint32_t centerFrequency, double txPowerW, uint16_t guardBandwidth);
+  /**
+   * Build a transmit power spectral density corresponding to OFDM (802.11a/g)
+   *
+   * \param centerFrequency center frequency (MHz)
+   * \param channelWidth channel width (MHz)
+   * \param txPowerW  transmit power (W) to allocate
+   * \param guardBandwidth width of the guard band (MHz)
+   * \return a pointer to a newly allocated SpectrumValue representing the OFDM Transmit Power Spectral Density in W/Hz for each Band
+   */
+  static Ptr<SpectrumValue> DoCreateOfdmTxPowerSpectralDensity (uint32_t centerFrequency, uint16_t channelWidth, double txPowerW, uint16_t guardBandwidth);
+  /**
+   * Build a transmit power spectral density corresponding to OFDM HT (802.11n/ac)
+   *
+   * \param centerFrequency center frequency (MHz)
+   * \param channelWidth channel width (MHz)
+   * \param txPowerW  transmit power (W) to allocate
+   * \param guardBandwidth width of the guard band (MHz)
+   * \return a pointer to a newly allocated SpectrumValue representing the HT OFDM Transmit Power Spectral Density in W/Hz for each Band
+   */
+  static Ptr<SpectrumValue> DoCreateHtOfdmTxPowerSpectralDensity (uint32_t centerFrequency, uint16_t channelWidth, double txPowerW, uint16_t guardBandwidth);
+  /**
+   * Build a transmit power spectral density corresponding to OFDM HE (802.11ax)
+   *
+   * \param centerFrequency center frequency (MHz)
+   * \param channelWidth channel width (MHz)
+   * \param txPowerW  transmit power (W) to allocate
+   * \param guardBandwidth width of the guard band (MHz)
+   * \return a pointer to a newly allocated SpectrumValue representing the HE OFDM Transmit Power Spectral Density in W/Hz for each Band
+   */
+  static Ptr<SpectrumValue> DoCreateHeOfdmTxPowerSpectralDensity (uint32_t centerFrequency, uint16_t channelWidth, double txPowerW, uint16_t guardBandwidth);
 };
 
 /**
@@ -0,0 +1,445 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#include <ns3/core-module.h>
+#include <ns3/test.h>
+#include <ns3/spectrum-module.h>
+#include <ns3/mobility-module.h>
+#include <ns3/propagation-loss-model.h>
+#include <set>
+
+
+using namespace ns3;
+
+
+/**
+ * \ingroup spectrum
+ * \ingroup tests
+ *
+ * SpectrumPhy counting the signals it receives
+ */
+class CountingSpectrumPhy : public SpectrumPhy
+{
+public:
+  /**
+   * Constructor
+   *
+   * \param rxSpectrumModel the SpectrumModel of the receiver
+   */
+  CountingSpectrumPhy (Ptr<const SpectrumModel> rxSpectrumModel);
+
+  // inherited from SpectrumPhy
+  virtual void SetDevice (Ptr<NetDevice> d);
+  virtual Ptr<NetDevice> GetDevice () const;
+  virtual void SetMobility (Ptr<MobilityModel> m);
+  virtual Ptr<MobilityModel> GetMobility ();
+  virtual void SetChannel (Ptr<SpectrumChannel> c);
+  virtual Ptr<const SpectrumModel> GetRxSpectrumModel () const;
+  virtual Ptr<AntennaModel> GetRxAntenna ();
+  virtual void StartRx (Ptr<SpectrumSignalParameters> params);
+
+  uint32_t m_rxCount; ///< number of received signals
+
+private:
+  virtual void DoDispose ();
+
+  Ptr<MobilityModel> m_mobility;            ///< the mobility model
+  Ptr<const SpectrumModel> m_rxSpectrumModel; ///< the SpectrumModel of the receiver
+};
+
+CountingSpectrumPhy::CountingSpectrumPhy (Ptr<const SpectrumModel> rxSpectrumModel)
+  : m_rxCount (0),
+    m_rxSpectrumModel (rxSpectrumModel)
+{
+}
+
+void
+CountingSpectrumPhy::DoDispose ()
+{
+  m_mobility = 0;
+  m_rxSpectrumModel = 0;
+  SpectrumPhy::DoDispose ();
+}
+
+void
+CountingSpectrumPhy::SetDevice (Ptr<NetDevice> d)
+{
+}
+
+Ptr<NetDevice>
+CountingSpectrumPhy::GetDevice () const
+{
+  return 0;
+}
+
+void
+CountingSpectrumPhy::SetMobility (Ptr<MobilityModel> m)
+{
+  m_mobility = m;
+}
+
+Ptr<MobilityModel>
+CountingSpectrumPhy::GetMobility ()
+{
+  return m_mobility;
+}
+
+void
+CountingSpectrumPhy::SetChannel (Ptr<SpectrumChannel> c)
+{
+}
+
+Ptr<const SpectrumModel>
+CountingSpectrumPhy::GetRxSpectrumModel () const
+{
+  return m_rxSpectrumModel;
+}
+
+Ptr<AntennaModel>
+CountingSpectrumPhy::GetRxAntenna ()
+{
+  return 0;
+}
+
+void
+CountingSpectrumPhy::StartRx (Ptr<SpectrumSignalParameters> params)
+{
+  m_rxCount++;
+}
+
+
+/**
+ * \ingroup spectrum
+ * \ingroup tests
+ *
+ * Check that the MaxRange and MinRxPowerDbm attributes of a SpectrumChannel
+ * only propagate signals to the receivers in range, and that the spatial
+ * index of the receivers follows their course changes
+ */
+class SpectrumChannelRangeTestCase : public TestCase
+{
+public:
+  /**
+   * Constructor
+   *
+   * \param channelType the type of SpectrumChannel
+   */
+  SpectrumChannelRangeTestCase (std::string channelType);
+  virtual ~SpectrumChannelRangeTestCase ();
+
+private:
+  virtual void DoRun (void);
+  /**
+   * Transmit a signal from the first phy, and return the number of receivers
+   * which were passed the signal
+   *
+   * \param maxRange the value of the MaxRange attribute
+   * \param minRxPowerDbm the value of the MinRxPowerDbm attribute
+   * \return the number of receptions
+   */
+  uint32_t Transmit (double maxRange, double minRxPowerDbm);
+
+  std::string m_channelType;                        ///< the type of SpectrumChannel
+  Ptr<SpectrumChannel> m_channel;                   ///< the channel
+  Ptr<SpectrumValue> m_txPsd;                       ///< the transmitted PSD
+  std::vector<Ptr<CountingSpectrumPhy> > m_phys;    ///< the transmitter followed by the receivers
+};
+
+SpectrumChannelRangeTestCase::SpectrumChannelRangeTestCase (std::string channelType)
+  : TestCase ("Range limits of " + channelType),
+    m_channelType (channelType)
+{
+}
+
+SpectrumChannelRangeTestCase::~SpectrumChannelRangeTestCase ()
+{
+}
+
+uint32_t
+SpectrumChannelRangeTestCase::Transmit (double maxRange, double minRxPowerDbm)
+{
+  m_channel->SetAttribute ("MaxRange", DoubleValue (maxRange));
+  m_channel->SetAttribute ("MinRxPowerDbm", DoubleValue (minRxPowerDbm));
+  for (std::vector<Ptr<CountingSpectrumPhy> >::const_iterator it = m_phys.begin (); it != m_phys.end (); ++it)
+    {
+      (*it)->m_rxCount = 0;
+    }
+  Ptr<SpectrumSignalParameters> params = Create<SpectrumSignalParameters> ();
+  params->duration = MicroSeconds (100);
+  params->psd = m_txPsd;
+  params->txPhy = m_phys.front ();
+  Simulator::ScheduleNow (&SpectrumChannel::StartTx, m_channel, params);
+  Simulator::Run ();
+  uint32_t rxCount = 0;
+  for (std::vector<Ptr<CountingSpectrumPhy> >::const_iterator it = m_phys.begin (); it != m_phys.end (); ++it)
+    {
+      rxCount += (*it)->m_rxCount;
+    }
+  return rxCount;
+}
+
+void
+SpectrumChannelRangeTestCase::DoRun (void)
+{
+  ObjectFactory factory;
+  factory.SetTypeId (m_channelType);
+  m_channel = factory.Create<SpectrumChannel> ();
+  m_channel->AddPropagationLossModel (CreateObject<FriisPropagationLossModel> ());
+
+  std::vector<double> freqs;
+  for (uint32_t i = 0; i < 10; i++)
+    {
+      freqs.push_back (5.15e9 + i * 1e6);
+    }
+  Ptr<SpectrumModel> model = Create<SpectrumModel> (freqs);
+  // 1 W (30 dBm) over 10 MHz
+  m_txPsd = Create<SpectrumValue> (model);
+  (*m_txPsd) = 1e-7;
+
+  // Friis losses at 5.15 GHz are about 67, 87 and 107 dB at 10, 100 and 1000 m
+  std::vector<double> distances;
+  distances.push_back (0);
+  distances.push_back (10);
+  distances.push_back (100);
+  distances.push_back (1000);
+  for (std::vector<double>::const_iterator it = distances.begin (); it != distances.end (); ++it)
+    {
+      Ptr<CountingSpectrumPhy> phy = CreateObject<CountingSpectrumPhy> (model);
+      Ptr<MobilityModel> mobility = CreateObject<ConstantPositionMobilityModel> ();
+      mobility->SetPosition (Vector (*it, 0, 0));
+      phy->SetMobility (mobility);
+      m_channel->AddRx (phy);
+      m_phys.push_back (phy);
+    }
+
+  NS_TEST_EXPECT_MSG_EQ (Transmit (0, -1e9), 3, "All the receivers should be passed the signal");
+  NS_TEST_EXPECT_MSG_EQ (Transmit (150, -1e9), 2, "The receiver at 1000 m is out of range");
+  NS_TEST_EXPECT_MSG_EQ (Transmit (5, -1e9), 0, "All the receivers are out of range");
+  NS_TEST_EXPECT_MSG_EQ (Transmit (0, -70), 2, "The receiver at 1000 m is below the minimum receive power");
+  NS_TEST_EXPECT_MSG_EQ (Transmit (0, -40), 1, "Only the receiver at 10 m is above the minimum receive power");
+
+  // the spatial index follows the receivers which are moved
+  m_phys.back ()->GetMobility ()->SetPosition (Vector (0, 120, 0));
+  NS_TEST_EXPECT_MSG_EQ (Transmit (150, -1e9), 3, "The receiver moved to 120 m should be in range");
+  m_phys[1]->GetMobility ()->SetPosition (Vector (-400, 0, 0));
+  NS_TEST_EXPECT_MSG_EQ (Transmit (150, -1e9), 2, "The receiver moved to 400 m should be out of range");
+  NS_TEST_EXPECT_MSG_EQ (m_phys[1]->m_rxCount, 0, "The receiver moved to 400 m should be out of range");
+
+  // moving receivers are not indexed but still checked against the range
+  Ptr<ConstantVelocityMobilityModel> moving = CreateObject<ConstantVelocityMobilityModel> ();
+  moving->SetPosition (Vector (1000, 1000, 0));
+  moving->SetVelocity (Vector (1, 0, 0));
+  Ptr<CountingSpectrumPhy> movingPhy = CreateObject<CountingSpectrumPhy> (model);
+  movingPhy->SetMobility (moving);
+  m_channel->AddRx (movingPhy);
+  m_phys.push_back (movingPhy);
+  NS_TEST_EXPECT_MSG_EQ (Transmit (150, -1e9), 2, "The moving receiver is out of range");
+  moving->SetPosition (Vector (50, 50, 0));
+  NS_TEST_EXPECT_MSG_EQ (Transmit (150, -1e9), 3, "The moving receiver is in range");
+
+  Simulator::Destroy ();
+  for (std::vector<Ptr<CountingSpectrumPhy> >::const_iterator it = m_phys.begin (); it != m_phys.end (); ++it)
+    {
+      (*it)->Dispose ();
+    }
+  m_phys.clear ();
+  m_channel->Dispose ();
+  m_channel = 0;
+}
+
+
+/**
+ * \ingroup spectrum
+ * \ingroup tests
+ *
+ * SingleModelSpectrumChannel giving access to the receivers returned by its
+ * spatial index
+ */
+class RxIndexSpectrumChannel : public SingleModelSpectrumChannel
+{
+public:
+  /**
+   * Return the receivers which may be within MaxRange of the transmitter
+   *
+   * \param txMobility the mobility model of the transmitter
+   * \return the receivers returned by the spatial index
+   */
+  std::vector<Ptr<SpectrumPhy> > DoGetRxInRange (Ptr<const MobilityModel> txMobility)
+  {
+    std::vector<Ptr<SpectrumPhy> > rxPhys;
+    GetRxInRange (txMobility, rxPhys);
+    return rxPhys;
+  }
+};
+
+
+/**
+ * \ingroup spectrum
+ * \ingroup tests
+ *
+ * Check that while receivers are moved, stop and start moving, the spatial
+ * index of a SpectrumChannel returns each receiver once, and returns all the
+ * receivers which a brute-force scan finds within MaxRange
+ */
+class SpectrumChannelRxIndexTestCase : public TestCase
+{
+public:
+  SpectrumChannelRxIndexTestCase ();
+  virtual ~SpectrumChannelRxIndexTestCase ();
+
+private:
+  virtual void DoRun (void);
+  /**
+   * Move some receivers at random: place static receivers elsewhere, and
+   * start or stop moving receivers
+   */
+  void Move (void);
+  /**
+   * Compare the receivers returned by the index for a few transmitters with
+   * the receivers found by a brute-force scan
+   */
+  void Check (void);
+
+  Ptr<RxIndexSpectrumChannel> m_channel;            ///< the channel
+  std::vector<Ptr<CountingSpectrumPhy> > m_phys;    ///< the receivers
+  Ptr<UniformRandomVariable> m_random;              ///< the random variable used to move the receivers
+  double m_maxRange;                                ///< the value of the MaxRange attribute
+  uint32_t m_nChecks;                               ///< the number of transmitters checked
+};
+
+SpectrumChannelRxIndexTestCase::SpectrumChannelRxIndexTestCase ()
+  : TestCase ("Spatial index of moving receivers"),
+    m_maxRange (100),
+    m_nChecks (0)
+{
+}
+
+SpectrumChannelRxIndexTestCase::~SpectrumChannelRxIndexTestCase ()
+{
+}
+
+void
+SpectrumChannelRxIndexTestCase::Move (void)
+{
+  for (uint32_t i = 0; i < 10; i++)
+    {
+      Ptr<MobilityModel> mobility = m_phys[m_random->GetInteger (0, m_phys.size () - 1)]->GetMobility ();
+      Ptr<ConstantVelocityMobilityModel> moving = DynamicCast<ConstantVelocityMobilityModel> (mobility);
+      if (moving && m_random->GetValue () < 0.5)
+        {
+          Vector velocity (0, 0, 0);
+          if (moving->GetVelocity ().x == 0)
+            {
+              velocity = Vector (m_random->GetValue (-50, 50), m_random->GetValue (-50, 50), 0);
+            }
+          moving->SetVelocity (velocity);
+        }
+      else
+        {
+          mobility->SetPosition (Vector (m_random->GetValue (-500, 500), m_random->GetValue (-500, 500), 0));
+        }
+    }
+}
+
+void
+SpectrumChannelRxIndexTestCase::Check (void)
+{
+  for (uint32_t i = 0; i < 5; i++)
+    {
+      Ptr<MobilityModel> txMobility = CreateObject<ConstantPositionMobilityModel> ();
+      txMobility->SetPosition (Vector (m_random->GetValue (-500, 500), m_random->GetValue (-500, 500), 0));
+      std::vector<Ptr<SpectrumPhy> > candidates = m_channel->DoGetRxInRange (txMobility);
+      std::set<Ptr<SpectrumPhy> > returned (candidates.begin (), candidates.end ());
+      NS_TEST_ASSERT_MSG_EQ (returned.size (), candidates.size (), "a receiver was returned twice at " << Simulator::Now ().GetSeconds () << " s");
+      for (std::vector<Ptr<CountingSpectrumPhy> >::const_iterator it = m_phys.begin (); it != m_phys.end (); ++it)
+        {
+          if (txMobility->GetDistanceFrom ((*it)->GetMobility ()) <= m_maxRange)
+            {
+              NS_TEST_ASSERT_MSG_EQ (returned.count (*it), 1, "a receiver in range was not returned at " << Simulator::Now ().GetSeconds () << " s");
+            }
+        }
+      m_nChecks++;
+    }
+}
+
+void
+SpectrumChannelRxIndexTestCase::DoRun (void)
+{
+  m_channel = CreateObject<RxIndexSpectrumChannel> ();
+  m_channel->SetAttribute ("MaxRange", DoubleValue (m_maxRange));
+  m_random = CreateObject<UniformRandomVariable> ();
+  m_random->SetStream (1);
+
+  std::vector<double> freqs;
+  freqs.push_back (5.15e9);
+  Ptr<SpectrumModel> model = Create<SpectrumModel> (freqs);
+  for (uint32_t i = 0; i < 100; i++)
+    {
+      Ptr<CountingSpectrumPhy> phy = CreateObject<CountingSpectrumPhy> (model);
+      Ptr<MobilityModel> mobility;
+      if (i % 2 == 0)
+        {
+          mobility = CreateObject<ConstantPositionMobilityModel> ();
+        }
+      else
+        {
+          mobility = CreateObject<ConstantVelocityMobilityModel> ();
+        }
+      mobility->SetPosition (Vector (m_random->GetValue (-500, 500), m_random->GetValue (-500, 500), 0));
+      phy->SetMobility (mobility);
+      m_channel->AddRx (phy);
+      m_phys.push_back (phy);
+    }
+
+  for (uint32_t i = 0; i < 100; i++)
+    {
+      Simulator::Schedule (MilliSeconds (100 * i), &SpectrumChannelRxIndexTestCase::Move, this);
+      Simulator::Schedule (MilliSeconds (100 * i + 50), &SpectrumChannelRxIndexTestCase::Check, this);
+    }
+  Simulator::Run ();
+  Simulator::Destroy ();
+  NS_TEST_ASSERT_MSG_EQ (m_nChecks, 500, "some checks were not done");
+
+  for (std::vector<Ptr<CountingSpectrumPhy> >::const_iterator it = m_phys.begin (); it != m_phys.end (); ++it)
+    {
+      (*it)->Dispose ();
+    }
+  m_phys.clear ();
+  m_channel->Dispose ();
+  m_channel = 0;
+}
+
+
+/**
+ * \ingroup spectrum
+ * \ingroup tests
+ *
+ * SpectrumChannel range limits test suite
+ */
+class SpectrumChannelRangeTestSuite : public TestSuite
+{
+public:
+  SpectrumChannelRangeTestSuite ();
+};
+
+SpectrumChannelRangeTestSuite::SpectrumChannelRangeTestSuite ()
+  : TestSuite ("spectrum-channel-range", UNIT)
+{
+  AddTestCase (new SpectrumChannelRangeTestCase ("ns3::SingleModelSpectrumChannel"), TestCase::QUICK);
+  AddTestCase (new SpectrumChannelRangeTestCase ("ns3::MultiModelSpectrumChannel"), TestCase::QUICK);
+  AddTestCase (new SpectrumChannelRxIndexTestCase, TestCase::QUICK);
+}
+
+static SpectrumChannelRangeTestSuite g_spectrumChannelRangeTestSuite; ///< the test suite
@@ -203,6 +203,21 @@ SpectrumValueTestSuite::SpectrumValueTestSuite ()
   AddTestCase (new SpectrumValueTestCase (tv5, v5, "tv5 *= v2"), TestCase::QUICK);
   AddTestCase (new SpectrumValueTestCase (tv6, v6, "tv6 div= v2"), TestCase::QUICK);
 
+  // operators reusing the storage of temporary operands
+  tv3 = SpectrumValue (v1) + v2;
+  tv4 = v1 - SpectrumValue (v2);
+  tv5 = SpectrumValue (v1) * SpectrumValue (v2);
+  tv6 = v1 / SpectrumValue (v2);
+  AddTestCase (new SpectrumValueTestCase (tv3, v3, "tv3 = temporary v1 + v2"), TestCase::QUICK);
+  AddTestCase (new SpectrumValueTestCase (tv4, v4, "tv4 = v1 - temporary v2"), TestCase::QUICK);
+  AddTestCase (new SpectrumValueTestCase (tv5, v5, "tv5 = temporary v1 * temporary v2"), TestCase::QUICK);
+  AddTestCase (new SpectrumValueTestCase (tv6, v6, "tv6 = v1 div temporary v2"), TestCase::QUICK);
+
+  tv3 = (v1 - v2) + v2 + v2;
+  tv6 = v1 / ((v2 - v1) + v1);
+  AddTestCase (new SpectrumValueTestCase (tv3, v3, "tv3 = (v1 - v2) + v2 + v2"), TestCase::QUICK);
+  AddTestCase (new SpectrumValueTestCase (tv6, v6, "tv6 = v1 div ((v2 - v1) + v1)"), TestCase::QUICK);
+
   SpectrumValue tv7a (f), tv8a (f), tv9a (f), tv10a (f);
   tv7a = v1 + doubleValue;
   tv8a = v1 - doubleValue;
@@ -223,6 +238,11 @@ SpectrumValueTestSuite::SpectrumValueTestSuite ()
   AddTestCase (new SpectrumValueTestCase (tv9b, v9, "tv9b =  doubleValue * v1"), TestCase::QUICK);
   AddTestCase (new SpectrumValueTestCase (tv10b, v10, "tv10b = doubleValue div v1"), TestCase::QUICK);
 
+  tv8b =  doubleValue - SpectrumValue (v1);
+  tv10b = doubleValue / SpectrumValue (v1);
+  AddTestCase (new SpectrumValueTestCase (tv8b, v8, "tv8b =  doubleValue - temporary v1"), TestCase::QUICK);
+  AddTestCase (new SpectrumValueTestCase (tv10b, v10, "tv10b = doubleValue div temporary v1"), TestCase::QUICK);
+
 
 
 
@@ -0,0 +1,186 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <ns3/test.h>
+#include <ns3/log.h>
+#include <ns3/fatal-error.h>
+#include <ns3/spectrum-value.h>
+#include <ns3/wifi-spectrum-value-helper.h>
+#include <cmath>
+#include <sstream>
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("WifiSpectrumValueHelperTest");
+
+/**
+ * \ingroup spectrum-tests
+ *
+ * \brief Check the transmit PSDs, which are copies of cached templates
+ * scaled to the transmit power: each PSD holds the transmit power, is
+ * proportional to the PSD built for 1 W, is not altered when a previously
+ * returned PSD is modified, and the DSSS PSD is flat over 22 MHz
+ */
+class WifiTxPsdCacheTestCase : public TestCase
+{
+public:
+  WifiTxPsdCacheTestCase ();
+
+private:
+  virtual void DoRun (void);
+
+  /// Kind of transmit PSD
+  enum PsdType
+  {
+    DSSS,
+    OFDM,
+    HT_OFDM,
+    HE_OFDM
+  };
+
+  /**
+   * Create a transmit PSD with the public API of WifiSpectrumValueHelper
+   * \param type the type of the transmit PSD
+   * \param centerFrequency center frequency (MHz)
+   * \param channelWidth channel width (MHz)
+   * \param txPowerW transmit power (W)
+   * \param guardBandwidth width of the guard band (MHz)
+   * \return the transmit PSD
+   */
+  static Ptr<SpectrumValue> Create (PsdType type, uint32_t centerFrequency, uint16_t channelWidth,
+                                    double txPowerW, uint16_t guardBandwidth);
+
+  /**
+   * Check the transmit PSDs of a type, center frequency and channel width
+   * \param type the type of the transmit PSD
+   * \param centerFrequency center frequency (MHz)
+   * \param channelWidth channel width (MHz)
+   * \param guardBandwidth width of the guard band (MHz)
+   */
+  void Check (PsdType type, uint32_t centerFrequency, uint16_t channelWidth, uint16_t guardBandwidth);
+};
+
+WifiTxPsdCacheTestCase::WifiTxPsdCacheTestCase ()
+  : TestCase ("Check the cached templates of the Wi-Fi transmit PSDs")
+{
+}
+
+Ptr<SpectrumValue>
+WifiTxPsdCacheTestCase::Create (PsdType type, uint32_t centerFrequency, uint16_t channelWidth,
+                                double txPowerW, uint16_t guardBandwidth)
+{
+  switch (type)
+    {
+    case DSSS:
+      return WifiSpectrumValueHelper::CreateDsssTxPowerSpectralDensity (centerFrequency, txPowerW, guardBandwidth);
+    case OFDM:
+      return WifiSpectrumValueHelper::CreateOfdmTxPowerSpectralDensity (centerFrequency, channelWidth, txPowerW, guardBandwidth);
+    case HT_OFDM:
+      return WifiSpectrumValueHelper::CreateHtOfdmTxPowerSpectralDensity (centerFrequency, channelWidth, txPowerW, guardBandwidth);
+    case HE_OFDM:
+      return WifiSpectrumValueHelper::CreateHeOfdmTxPowerSpectralDensity (centerFrequency, channelWidth, txPowerW, guardBandwidth);
+    default:
+      NS_FATAL_ERROR ("Unknown transmit PSD type " << type);
+      return 0;
+    }
+}
+
+void
+WifiTxPsdCacheTestCase::Check (PsdType type, uint32_t centerFrequency, uint16_t channelWidth, uint16_t guardBandwidth)
+{
+  std::ostringstream oss;
+  oss << "type " << type << " at " << centerFrequency << " MHz, width " << channelWidth << " MHz";
+  const double txPowersW[] = { 0.001, 0.0316, 1.0 };
+
+  // the first call builds the template, which the returned PSD must not share
+  Ptr<SpectrumValue> reference = Create (type, centerFrequency, channelWidth, 1.0, guardBandwidth);
+  Ptr<SpectrumValue> saved = reference->Copy ();
+  *reference *= 0.0;
+  uint32_t nBands = saved->GetSpectrumModel ()->GetNumBands ();
+
+  for (uint32_t p = 0; p < sizeof (txPowersW) / sizeof (double); ++p)
+    {
+      double txPowerW = txPowersW[p];
+      Ptr<SpectrumValue> psd = Create (type, centerFrequency, channelWidth, txPowerW, guardBandwidth);
+      NS_TEST_ASSERT_MSG_EQ (psd->GetSpectrumModel (), saved->GetSpectrumModel (), "wrong spectrum model for " << oss.str ());
+      NS_TEST_ASSERT_MSG_EQ_TOL (Integral (*psd), txPowerW, txPowerW * 1e-9, "wrong power for " << oss.str () << ", power " << txPowerW << " W");
+      for (uint32_t i = 0; i < nBands; ++i)
+        {
+          NS_TEST_ASSERT_MSG_EQ_TOL ((*psd)[i], (*saved)[i] * txPowerW, std::abs ((*saved)[i] * txPowerW) * 1e-12,
+                                     "wrong PSD in band " << i << " for " << oss.str () << ", power " << txPowerW << " W");
+        }
+      *psd *= 2.0;
+    }
+
+  if (type == DSSS)
+    {
+      // the power is evenly spread over the 22 MHz of the channel
+      double bandBandwidth = 312500;
+      uint32_t nAllocatedBands = static_cast<uint32_t> ((22e6 / bandBandwidth) + 0.5);
+      uint32_t nInBand = 0;
+      Bands::const_iterator bit = saved->ConstBandsBegin ();
+      for (uint32_t i = 0; i < nBands; ++i, ++bit)
+        {
+          if ((*saved)[i] > 0)
+            {
+              NS_TEST_ASSERT_MSG_EQ_TOL ((*saved)[i] * (bit->fh - bit->fl), 1.0 / nAllocatedBands, 1e-12,
+                                         "wrong DSSS power in band " << i);
+              nInBand++;
+            }
+        }
+      NS_TEST_ASSERT_MSG_EQ (nInBand, nAllocatedBands, "wrong number of DSSS bands");
+    }
+}
+
+void
+WifiTxPsdCacheTestCase::DoRun (void)
+{
+  const uint16_t ofdmWidths[] = { 5, 10, 20 };
+  const uint16_t htWidths[] = { 20, 40, 80, 160 };
+  Check (DSSS, 2412, 22, 20);
+  for (uint32_t w = 0; w < sizeof (ofdmWidths) / sizeof (uint16_t); ++w)
+    {
+      Check (OFDM, 5180, ofdmWidths[w], ofdmWidths[w]);
+      Check (OFDM, 2412, ofdmWidths[w], ofdmWidths[w]);
+    }
+  for (uint32_t w = 0; w < sizeof (htWidths) / sizeof (uint16_t); ++w)
+    {
+      Check (HT_OFDM, 5570, htWidths[w], htWidths[w]);
+      Check (HE_OFDM, 5570, htWidths[w], htWidths[w]);
+    }
+  Check (HT_OFDM, 2412, 20, 20);
+  Check (HT_OFDM, 2422, 40, 40);
+  Check (HE_OFDM, 2412, 20, 20);
+}
+
+/**
+ * \ingroup spectrum-tests
+ *
+ * \brief Test suite of WifiSpectrumValueHelper
+ */
+class WifiSpectrumValueHelperTestSuite : public TestSuite
+{
+public:
+  WifiSpectrumValueHelperTestSuite ();
+};
+
+WifiSpectrumValueHelperTestSuite::WifiSpectrumValueHelperTestSuite ()
+  : TestSuite ("wifi-spectrum-value-helper", UNIT)
+{
+  AddTestCase (new WifiTxPsdCacheTestCase, TestCase::QUICK);
+}
+
+static WifiSpectrumValueHelperTestSuite g_wifiSpectrumValueHelperTestSuite; ///< the test suite
@@ -0,0 +1,424 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// Benchmark of the Wi-Fi simulation speed in dense, overlapping BSSs.
+//
+// Unlike the other wifi examples, this program does not measure the
+// protocol throughput: it measures how fast the simulator executes a
+// given Wi-Fi scenario, so that performance regressions of the wifi
+// module (PHY, MAC, rate managers, channels) can be tracked over time.
+//
+// The scenario consists of nBss access points placed on a line, all on
+// the same channel and separated by bssSpacing meters so that the BSSs
+// overlap.  Each BSS has nStas stations placed on a circle around its
+// access point, each of them sending saturated uplink traffic to its AP.
+//
+// Several command line arguments can change the following options:
+// --standard (802.11a, 802.11n-5GHz, 802.11ac, 802.11ax-5GHz)
+// --phy (Yans, LinkTable, Spectrum)
+// --nBss and --nStas (number of BSSs and stations per BSS)
+// --aggregation (enable or disable A-MPDU/A-MSDU aggregation)
+// --wifiManager (Aarf, Aarfcd, Amrr, Arf, Cara, Constant, Ideal, Minstrel, MinstrelHt, Onoe, Rraa)
+// --format (csv or json) and --output (file name, standard output if empty)
+//
+// The program reports the setup and run wall clock times, the number of
+// executed events, the number of events per second, the average cost of
+// an event and the peak resident set size of the process.
+
+#include <fstream>
+#include <iostream>
+#include "ns3/log.h"
+#include "ns3/config.h"
+#include "ns3/uinteger.h"
+#include "ns3/boolean.h"
+#include "ns3/double.h"
+#include "ns3/string.h"
+#include "ns3/command-line.h"
+#include "ns3/map-scheduler.h"
+#include "ns3/system-wall-clock-ms.h"
+#include "ns3/rng-seed-manager.h"
+#include "ns3/yans-wifi-helper.h"
+#include "ns3/spectrum-wifi-helper.h"
+#include "ns3/multi-model-spectrum-channel.h"
+#include "ns3/propagation-loss-model.h"
+#include "ns3/propagation-delay-model.h"
+#include "ns3/ssid.h"
+#include "ns3/mobility-helper.h"
+#include "ns3/packet-socket-helper.h"
+#include "ns3/packet-socket-client.h"
+#include "ns3/packet-socket-server.h"
+
+#if defined (__linux__) || defined (__APPLE__)
+#include <sys/resource.h>
+#endif
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("WifiPerfBench");
+
+namespace ns3 {
+
+/**
+ * \ingroup wifi
+ *
+ * Map scheduler counting the number of events that are executed.
+ *
+ * The simulator core does not expose the number of processed events, so
+ * the benchmark installs this scheduler, which counts every event removed
+ * from the head of the event list, i.e. every event that is executed.
+ */
+class CountingMapScheduler : public MapScheduler
+{
+public:
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+  CountingMapScheduler ();
+
+  virtual Scheduler::Event RemoveNext (void);
+
+  /**
+   * \return the number of events removed from the head of the list
+   */
+  static uint64_t GetEventCount (void);
+
+private:
+  static uint64_t m_eventCount; ///< number of executed events
+};
+
+NS_OBJECT_ENSURE_REGISTERED (CountingMapScheduler);
+
+uint64_t CountingMapScheduler::m_eventCount = 0;
+
+TypeId
+CountingMapScheduler::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::CountingMapScheduler")
+    .SetParent<MapScheduler> ()
+    .SetGroupName ("Wifi")
+    .AddConstructor<CountingMapScheduler> ()
+  ;
+  return tid;
+}
+
+CountingMapScheduler::CountingMapScheduler ()
+{
+  m_eventCount = 0;
+}
+
+Scheduler::Event
+CountingMapScheduler::RemoveNext (void)
+{
+  m_eventCount++;
+  return MapScheduler::RemoveNext ();
+}
+
+uint64_t
+CountingMapScheduler::GetEventCount (void)
+{
+  return m_eventCount;
+}
+
+} // namespace ns3
+
+/// Total number of bytes received by all access points
+uint64_t g_rxBytes = 0;
+
+void
+PacketRx (Ptr<const Packet> pkt, const Address &addr)
+{
+  g_rxBytes += pkt->GetSize ();
+}
+
+/**
+ * Get the peak resident set size of the process.
+ *
+ * \return the peak resident set size in kilobytes, or 0 if unknown
+ */
+static uint64_t
+GetPeakRssKb (void)
+{
+#if defined (__linux__) || defined (__APPLE__)
+  struct rusage usage;
+  if (getrusage (RUSAGE_SELF, &usage) == 0)
+    {
+#if defined (__APPLE__)
+      return static_cast<uint64_t> (usage.ru_maxrss) / 1024;  // bytes on macOS
+#else
+      return static_cast<uint64_t> (usage.ru_maxrss);          // kilobytes on Linux
+#endif
+    }
+#endif
+  return 0;
+}
+
+int main (int argc, char *argv[])
+{
+  std::string standard ("802.11ac");
+  std::string phyType ("Yans");
+  std::string wifiManager ("Ideal");
+  std::string format ("csv");
+  std::string outputFile ("");
+  uint32_t nBss = 4;
+  uint32_t nStas = 10;
+  bool aggregation = true;
+  double simTime = 2; // seconds
+  double bssSpacing = 20; // meters
+  double radius = 5; // meters
+  double offeredLoad = 50; // Mb/s per station
+  uint32_t payloadSize = 1472; // bytes
+  uint32_t run = 1;
+  bool header = true;
+
+  CommandLine cmd;
+  cmd.AddValue ("standard", "Set standard (802.11a, 802.11n-5GHz, 802.11ac, 802.11ax-5GHz)", standard);
+  cmd.AddValue ("phy", "Set PHY and channel type (Yans, LinkTable, Spectrum)", phyType);
+  cmd.AddValue ("wifiManager", "Set wifi rate manager (Aarf, Aarfcd, Amrr, Arf, Cara, Constant, Ideal, Minstrel, MinstrelHt, Onoe, Rraa)", wifiManager);
+  cmd.AddValue ("nBss", "Number of overlapping BSSs", nBss);
+  cmd.AddValue ("nStas", "Number of stations per BSS", nStas);
+  cmd.AddValue ("aggregation", "Enable A-MPDU and A-MSDU aggregation", aggregation);
+  cmd.AddValue ("simTime", "Simulated time (seconds)", simTime);
+  cmd.AddValue ("bssSpacing", "Distance between access points (meters)", bssSpacing);
+  cmd.AddValue ("radius", "Distance between stations and their access point (meters)", radius);
+  cmd.AddValue ("offeredLoad", "Offered load per station (Mb/s)", offeredLoad);
+  cmd.AddValue ("payloadSize", "Payload size of the packets (bytes)", payloadSize);
+  cmd.AddValue ("run", "Run number of the random number generator", run);
+  cmd.AddValue ("format", "Output format (csv, json)", format);
+  cmd.AddValue ("header", "Print the CSV header line", header);
+  cmd.AddValue ("output", "Output file name (standard output if empty)", outputFile);
+  cmd.Parse (argc,argv);
+
+  NS_ABORT_MSG_IF (nBss == 0 || nStas == 0, "At least one BSS with one station is needed");
+  NS_ABORT_MSG_IF (format != "csv" && format != "json", "Invalid output format " << format);
+  NS_ABORT_MSG_IF (offeredLoad <= 0, "Offered load must be strictly positive");
+
+  WifiPhyStandard phyStandard = WIFI_PHY_STANDARD_80211a;
+  if (standard == "802.11a")
+    {
+      phyStandard = WIFI_PHY_STANDARD_80211a;
+    }
+  else if (standard == "802.11n-5GHz")
+    {
+      phyStandard = WIFI_PHY_STANDARD_80211n_5GHZ;
+    }
+  else if (standard == "802.11ac")
+    {
+      phyStandard = WIFI_PHY_STANDARD_80211ac;
+    }
+  else if (standard == "802.11ax-5GHz")
+    {
+      phyStandard = WIFI_PHY_STANDARD_80211ax_5GHZ;
+    }
+  else
+    {
+      NS_FATAL_ERROR ("Unsupported standard " << standard);
+    }
+
+  SystemWallClockMs setupClock;
+  setupClock.Start ();
+
+  Simulator::SetScheduler (ObjectFactory ("ns3::CountingMapScheduler"));
+  RngSeedManager::SetSeed (1);
+  RngSeedManager::SetRun (run);
+
+  NodeContainer apNodes;
+  apNodes.Create (nBss);
+  std::vector<NodeContainer> staNodes (nBss);
+  for (uint32_t i = 0; i < nBss; i++)
+    {
+      staNodes[i].Create (nStas);
+    }
+
+  WifiHelper wifi;
+  wifi.SetStandard (phyStandard);
+  if (wifiManager == "Constant")
+    {
+      wifi.SetRemoteStationManager ("ns3::ConstantRateWifiManager");
+    }
+  else
+    {
+      wifi.SetRemoteStationManager ("ns3::" + wifiManager + "WifiManager");
+    }
+
+  YansWifiPhyHelper yansPhy = YansWifiPhyHelper::Default ();
+  SpectrumWifiPhyHelper spectrumPhy = SpectrumWifiPhyHelper::Default ();
+  WifiPhyHelper *phy;
+  if (phyType == "Yans" || phyType == "LinkTable")
+    {
+      YansWifiChannelHelper channel = YansWifiChannelHelper::Default ();
+      yansPhy.SetChannel (channel.Create ());
+      if (phyType == "LinkTable")
+        {
+          yansPhy.SetPhyType ("ns3::LinkTableWifiPhy");
+        }
+      phy = &yansPhy;
+    }
+  else if (phyType == "Spectrum")
+    {
+      Ptr<MultiModelSpectrumChannel> spectrumChannel = CreateObject<MultiModelSpectrumChannel> ();
+      Ptr<LogDistancePropagationLossModel> lossModel = CreateObject<LogDistancePropagationLossModel> ();
+      spectrumChannel->AddPropagationLossModel (lossModel);
+      Ptr<ConstantSpeedPropagationDelayModel> delayModel = CreateObject<ConstantSpeedPropagationDelayModel> ();
+      spectrumChannel->SetPropagationDelayModel (delayModel);
+      spectrumPhy.SetChannel (spectrumChannel);
+      phy = &spectrumPhy;
+    }
+  else
+    {
+      NS_FATAL_ERROR ("Unsupported PHY type " << phyType);
+    }
+
+  uint32_t maxAmpduSize = aggregation ? 65535 : 0;
+  uint32_t maxAmsduSize = aggregation ? 3839 : 0;
+
+  WifiMacHelper mac;
+  NetDeviceContainer apDevices;
+  std::vector<NetDeviceContainer> staDevices (nBss);
+  for (uint32_t i = 0; i < nBss; i++)
+    {
+      std::ostringstream oss;
+      oss << "bss-" << i;
+      Ssid ssid = Ssid (oss.str ());
+      mac.SetType ("ns3::StaWifiMac",
+                   "Ssid", SsidValue (ssid),
+                   "BE_MaxAmpduSize", UintegerValue (maxAmpduSize),
+                   "BE_MaxAmsduSize", UintegerValue (maxAmsduSize));
+      staDevices[i] = wifi.Install (*phy, mac, staNodes[i]);
+      mac.SetType ("ns3::ApWifiMac",
+                   "Ssid", SsidValue (ssid),
+                   "BE_MaxAmpduSize", UintegerValue (maxAmpduSize),
+                   "BE_MaxAmsduSize", UintegerValue (maxAmsduSize));
+      apDevices.Add (wifi.Install (*phy, mac, apNodes.Get (i)));
+    }
+
+  int64_t streamIndex = 100;
+  streamIndex += wifi.AssignStreams (apDevices, streamIndex);
+  for (uint32_t i = 0; i < nBss; i++)
+    {
+      streamIndex += wifi.AssignStreams (staDevices[i], streamIndex);
+    }
+
+  // Access points on a line, stations evenly spread on a circle around their AP
+  MobilityHelper mobility;
+  Ptr<ListPositionAllocator> positionAlloc = CreateObject<ListPositionAllocator> ();
+  for (uint32_t i = 0; i < nBss; i++)
+    {
+      positionAlloc->Add (Vector (i * bssSpacing, 0.0, 0.0));
+    }
+  for (uint32_t i = 0; i < nBss; i++)
+    {
+      for (uint32_t j = 0; j < nStas; j++)
+        {
+          double angle = 2 * M_PI * j / nStas;
+          positionAlloc->Add (Vector (i * bssSpacing + radius * std::cos (angle), radius * std::sin (angle), 0.0));
+        }
+    }
+  mobility.SetPositionAllocator (positionAlloc);
+  mobility.SetMobilityModel ("ns3::ConstantPositionMobilityModel");
+  mobility.Install (apNodes);
+  for (uint32_t i = 0; i < nBss; i++)
+    {
+      mobility.Install (staNodes[i]);
+    }
+
+  PacketSocketHelper packetSocket;
+  packetSocket.Install (apNodes);
+  double clientInterval = static_cast<double> (payloadSize) * 8 / (offeredLoad * 1e6);
+  for (uint32_t i = 0; i < nBss; i++)
+    {
+      packetSocket.Install (staNodes[i]);
+
+      PacketSocketAddress socketAddr;
+      socketAddr.SetSingleDevice (apDevices.Get (i)->GetIfIndex ());
+      socketAddr.SetPhysicalAddress (apDevices.Get (i)->GetAddress ());
+      socketAddr.SetProtocol (1);
+
+      for (uint32_t j = 0; j < nStas; j++)
+        {
+          Ptr<PacketSocketClient> client = CreateObject<PacketSocketClient> ();
+          client->SetRemote (socketAddr);
+          client->SetAttribute ("MaxPackets", UintegerValue (0));
+          client->SetAttribute ("PacketSize", UintegerValue (payloadSize));
+          client->SetAttribute ("Interval", TimeValue (Seconds (clientInterval)));
+          client->SetStartTime (Seconds (0.5 + 0.001 * j));  // allow association to complete
+          client->SetStopTime (Seconds (0.5 + simTime));
+          staNodes[i].Get (j)->AddApplication (client);
+        }
+
+      Ptr<PacketSocketServer> server = CreateObject<PacketSocketServer> ();
+      server->SetLocal (socketAddr);
+      server->TraceConnectWithoutContext ("Rx", MakeCallback (&PacketRx));
+      apNodes.Get (i)->AddApplication (server);
+    }
+
+  Simulator::Stop (Seconds (0.5 + simTime));
+  int64_t setupMs = setupClock.End ();
+
+  SystemWallClockMs runClock;
+  runClock.Start ();
+  Simulator::Run ();
+  int64_t runMs = runClock.End ();
+  uint64_t events = CountingMapScheduler::GetEventCount ();
+  Simulator::Destroy ();
+
+  double eventsPerSecond = runMs > 0 ? events * 1000.0 / runMs : 0;
+  double nsPerEvent = events > 0 ? runMs * 1e6 / events : 0;
+  double throughput = g_rxBytes * 8 / (simTime * 1e6); // Mb/s
+  uint64_t peakRssKb = GetPeakRssKb ();
+
+  std::ofstream file;
+  if (!outputFile.empty ())
+    {
+      file.open (outputFile.c_str (), std::ios_base::out | std::ios_base::app);
+      NS_ABORT_MSG_IF (!file.is_open (), "Could not open " << outputFile);
+    }
+  std::ostream &os = outputFile.empty () ? std::cout : file;
+
+  if (format == "csv")
+    {
+      if (header)
+        {
+          os << "standard,phy,wifiManager,nBss,nStas,aggregation,simTime,setupMs,runMs,"
+             << "events,eventsPerSecond,nsPerEvent,peakRssKb,throughputMbps" << std::endl;
+        }
+      os << standard << "," << phyType << "," << wifiManager << ","
+         << nBss << "," << nStas << "," << aggregation << "," << simTime << ","
+         << setupMs << "," << runMs << "," << events << ","
+         << eventsPerSecond << "," << nsPerEvent << "," << peakRssKb << ","
+         << throughput << std::endl;
+    }
+  else
+    {
+      os << "{\"standard\": \"" << standard << "\", "
+         << "\"phy\": \"" << phyType << "\", "
+         << "\"wifiManager\": \"" << wifiManager << "\", "
+         << "\"nBss\": " << nBss << ", "
+         << "\"nStas\": " << nStas << ", "
+         << "\"aggregation\": " << (aggregation ? "true" : "false") << ", "
+         << "\"simTime\": " << simTime << ", "
+         << "\"setupMs\": " << setupMs << ", "
+         << "\"runMs\": " << runMs << ", "
+         << "\"events\": " << events << ", "
+         << "\"eventsPerSecond\": " << eventsPerSecond << ", "
+         << "\"nsPerEvent\": " << nsPerEvent << ", "
+         << "\"peakRssKb\": " << peakRssKb << ", "
+         << "\"throughputMbps\": " << throughput << "}" << std::endl;
+    }
+
+  return 0;
+}
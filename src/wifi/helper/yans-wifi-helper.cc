@@ -148,6 +148,14 @@ YansWifiPhyHelper::SetChannel (std::string channelName)
   m_channel = channel;
 }
 
+void
+YansWifiPhyHelper::SetPhyType (std::string type)
+{
+  NS_ASSERT_MSG (TypeId::LookupByName (type).IsChildOf (YansWifiPhy::GetTypeId ()),
+                 type << " is not a YansWifiPhy");
+  m_phy.SetTypeId (type);
+}
+
 Ptr<WifiPhy>
 YansWifiPhyHelper::Create (Ptr<Node> node, Ptr<NetDevice> device) const
 {
@@ -184,6 +184,13 @@ public:
    * Every PHY created by a call to Install is associated to this channel.
    */
   void SetChannel (std::string channelName);
+  /**
+   * \param type the type of the PHY objects to create, e.g. "ns3::LinkTableWifiPhy"
+   *
+   * Every PHY created by a call to Install is of this type, which must be
+   * ns3::YansWifiPhy or a subclass of it.
+   */
+  void SetPhyType (std::string type);
 
 private:
   /**
@@ -25,6 +25,7 @@
 #include "interference-helper.h"
 #include "wifi-phy.h"
 #include "error-rate-model.h"
+#include <algorithm>
 
 namespace ns3 {
 
@@ -122,7 +123,11 @@ InterferenceHelper::InterferenceHelper ()
   : m_errorRateModel (0),
     m_numRxAntennas (1),
     m_firstPower (0),
-    m_rxing (false)
+    m_rxing (false),
+    m_accumulate (false),
+    m_lastPowerW (0),
+    m_energyJ (0),
+    m_peakPowerW (0)
 {
   // Always have a zero power noise event in the list
   AddNiChangeEvent (Time (0), NiChange (0.0, 0));
@@ -205,6 +210,11 @@ InterferenceHelper::AppendEvent (Ptr<Event> event)
 
   if (!m_rxing)
     {
+      if (m_accumulate)
+        {
+          // the NI changes about to be erased are accumulated first
+          Accumulate ();
+        }
       m_firstPower = previousPowerStart;
       // Always leave the first zero power noise event in the list
       m_niChanges.erase (++(m_niChanges.begin ()),
@@ -776,6 +786,73 @@ InterferenceHelper::CalculatePlcpHeaderSnrPer (Ptr<Event> event) const
   return snrPer;
 }
 
+void
+InterferenceHelper::EnableAccumulation (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_accumulate = true;
+}
+
+void
+InterferenceHelper::Accumulate (void)
+{
+  Time now = Simulator::Now ();
+  // the NI changes at the current time may not all be known yet
+  for (auto it = GetNextPosition (m_lastChange); it != m_niChanges.end () && it->first < now; ++it)
+    {
+      if (it->first > m_accumulateStart)
+        {
+          Time start = std::max (m_lastChange, m_accumulateStart);
+          m_energyJ += m_lastPowerW * (it->first - start).GetSeconds ();
+          m_peakPowerW = std::max (m_peakPowerW, m_lastPowerW);
+        }
+      m_lastChange = it->first;
+      m_lastPowerW = it->second.GetPower ();
+    }
+}
+
+void
+InterferenceHelper::RestartAccumulation (void)
+{
+  Accumulate ();
+  m_accumulateStart = Simulator::Now ();
+  m_energyJ = 0;
+  m_peakPowerW = 0;
+}
+
+double
+InterferenceHelper::CalculateAccumulatedSnr (Ptr<Event> event, bool peak)
+{
+  NS_LOG_FUNCTION (this << event << peak);
+  NS_ASSERT (m_accumulate);
+  Accumulate ();
+  Time now = Simulator::Now ();
+  double powerW = event->GetRxPowerW ();
+  double noiseInterferenceW;
+  if (now > m_accumulateStart)
+    {
+      // add the power held since the last NI change
+      Time start = std::max (m_lastChange, m_accumulateStart);
+      double energyJ = m_energyJ + m_lastPowerW * (now - start).GetSeconds ();
+      if (peak)
+        {
+          noiseInterferenceW = std::max (m_peakPowerW, m_lastPowerW);
+        }
+      else
+        {
+          noiseInterferenceW = energyJ / (now - m_accumulateStart).GetSeconds ();
+        }
+    }
+  else
+    {
+      noiseInterferenceW = GetPreviousPosition (now)->second.GetPower ();
+    }
+  RestartAccumulation ();
+  // the accumulated power includes the power of the event itself
+  noiseInterferenceW = std::max (noiseInterferenceW - powerW, 0.0);
+  return CalculateSnr (powerW, noiseInterferenceW, event->GetTxVector ().GetChannelWidth ());
+}
+
 void
 InterferenceHelper::EraseEvents (void)
 {
@@ -784,6 +861,11 @@ InterferenceHelper::EraseEvents (void)
   AddNiChangeEvent (Time (0), NiChange (0.0, 0));
   m_rxing = false;
   m_firstPower = 0;
+  m_lastChange = Time (0);
+  m_lastPowerW = 0;
+  m_accumulateStart = Time (0);
+  m_energyJ = 0;
+  m_peakPowerW = 0;
 }
 
 InterferenceHelper::NiChanges::const_iterator
@@ -813,6 +895,10 @@ InterferenceHelper::NotifyRxStart ()
 {
   NS_LOG_FUNCTION (this);
   m_rxing = true;
+  if (m_accumulate)
+    {
+      RestartAccumulation ();
+    }
 }
 
 void
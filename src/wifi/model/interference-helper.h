@@ -189,6 +189,31 @@ public:
    * \return struct of SNR and PER
    */
   struct InterferenceHelper::SnrPer CalculatePlcpHeaderSnrPer (Ptr<Event> event) const;
+  /**
+   * Enable the accumulation of the noise and interference power over time,
+   * which CalculateAccumulatedSnr needs.  The NI changes are then
+   * accumulated as the simulation time passes them, each of them once, so
+   * that the cost of CalculateAccumulatedSnr does not depend on the number
+   * of signals overlapping the event.  The accumulation is restarted by
+   * NotifyRxStart.
+   */
+  void EnableAccumulation (void);
+  /**
+   * Calculate the SNIR of the given event using a single noise and interference
+   * value, accumulated since the last call of NotifyRxStart or of this
+   * method, rather than one per interference chunk, and restart the
+   * accumulation.  This is meant for abstract PHY models that look up the
+   * error rate of the PLCP header and of the PLCP payload from their SNIR only,
+   * by calling this method at the end of the PLCP header and at the end of the
+   * event.
+   *
+   * \param event the event which is being received
+   * \param peak if true, the peak noise and interference power since the
+   *        accumulation started is used; otherwise, its time average is used
+   *
+   * \return the SNIR (linear ratio)
+   */
+  double CalculateAccumulatedSnr (Ptr<Event> event, bool peak);
 
   /**
    * Notify that RX has started.
@@ -315,6 +340,24 @@ private:
   double m_firstPower; ///< first power
   bool m_rxing; ///< flag whether it is in receiving state
 
+  /**
+   * Accumulate the noise and interference power of the NI changes which
+   * are earlier than the current time and were not accumulated yet.
+   */
+  void Accumulate (void);
+  /**
+   * Restart the accumulation of the noise and interference power from the
+   * current time.
+   */
+  void RestartAccumulation (void);
+
+  bool m_accumulate;      ///< whether the noise and interference power is accumulated
+  Time m_accumulateStart; ///< the time the accumulation started
+  Time m_lastChange;      ///< the time of the last NI change accumulated
+  double m_lastPowerW;    ///< the noise and interference power since the last NI change accumulated (W)
+  double m_energyJ;       ///< the noise and interference energy between the accumulation start and the last NI change (J)
+  double m_peakPowerW;    ///< the peak noise and interference power between the accumulation start and the last NI change (W)
+
   /**
    * Returns an iterator to the first nichange that is later than moment
    *
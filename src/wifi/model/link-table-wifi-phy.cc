@@ -0,0 +1,227 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/log.h"
+#include "ns3/double.h"
+#include "ns3/enum.h"
+#include "link-table-wifi-phy.h"
+#include "error-rate-model.h"
+#include "wifi-utils.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("LinkTableWifiPhy");
+
+NS_OBJECT_ENSURE_REGISTERED (LinkTableWifiPhy);
+
+TypeId
+LinkTableWifiPhy::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::LinkTableWifiPhy")
+    .SetParent<YansWifiPhy> ()
+    .SetGroupName ("Wifi")
+    .AddConstructor<LinkTableWifiPhy> ()
+    .AddAttribute ("InterferenceMode",
+                   "How the noise and interference seen by a frame is collapsed into a single value.",
+                   EnumValue (LinkTableWifiPhy::AVERAGE_INTERFERENCE),
+                   MakeEnumAccessor (&LinkTableWifiPhy::m_interferenceMode),
+                   MakeEnumChecker (LinkTableWifiPhy::PEAK_INTERFERENCE, "Peak",
+                                    LinkTableWifiPhy::AVERAGE_INTERFERENCE, "Average"))
+    .AddAttribute ("MinSnr",
+                   "The lowest SNR (dB) of the link tables. Lower SNRs are clamped to this value.",
+                   DoubleValue (-10.0),
+                   MakeDoubleAccessor (&LinkTableWifiPhy::m_minSnrDb),
+                   MakeDoubleChecker<double> ())
+    .AddAttribute ("MaxSnr",
+                   "The highest SNR (dB) of the link tables. Higher SNRs are clamped to this value.",
+                   DoubleValue (60.0),
+                   MakeDoubleAccessor (&LinkTableWifiPhy::m_maxSnrDb),
+                   MakeDoubleChecker<double> ())
+    .AddAttribute ("SnrStep",
+                   "The SNR step (dB) of the link tables.",
+                   DoubleValue (0.1),
+                   MakeDoubleAccessor (&LinkTableWifiPhy::m_snrStepDb),
+                   MakeDoubleChecker<double> (0.001))
+  ;
+  return tid;
+}
+
+LinkTableWifiPhy::LinkTableWifiPhy ()
+{
+  NS_LOG_FUNCTION (this);
+  m_interference.EnableAccumulation ();
+}
+
+LinkTableWifiPhy::~LinkTableWifiPhy ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+void
+LinkTableWifiPhy::DoDispose (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_tables.clear ();
+  m_tablesErrorRateModel = 0;
+  YansWifiPhy::DoDispose ();
+}
+
+const std::vector<double> &
+LinkTableWifiPhy::GetTable (WifiMode mode, WifiTxVector txVector)
+{
+  Ptr<ErrorRateModel> errorRateModel = m_interference.GetErrorRateModel ();
+  if (errorRateModel != m_tablesErrorRateModel)
+    {
+      m_tables.clear ();
+      m_tablesErrorRateModel = errorRateModel;
+    }
+  LinkTableKey key = std::make_tuple (mode.GetUid (), txVector.GetChannelWidth (), mode.GetPhyRate (txVector));
+  auto it = m_tables.find (key);
+  if (it != m_tables.end ())
+    {
+      return it->second;
+    }
+  NS_LOG_DEBUG ("Building link table for mode " << mode);
+  NS_ASSERT (m_maxSnrDb > m_minSnrDb);
+  uint32_t size = static_cast<uint32_t> (std::ceil ((m_maxSnrDb - m_minSnrDb) / m_snrStepDb)) + 1;
+  std::vector<double> table (size);
+  for (uint32_t i = 0; i < size; i++)
+    {
+      double snr = DbToRatio (std::min (m_minSnrDb + i * m_snrStepDb, m_maxSnrDb));
+      double csr = errorRateModel->GetChunkSuccessRate (mode, txVector, snr, 1);
+      table[i] = (csr > 0) ? std::log (csr) : std::log (std::numeric_limits<double>::min ());
+    }
+  return m_tables.insert (std::make_pair (key, table)).first->second;
+}
+
+double
+LinkTableWifiPhy::GetChunkSuccessRate (WifiMode mode, WifiTxVector txVector, double snr, uint64_t nbits)
+{
+  if (nbits == 0)
+    {
+      return 1.0;
+    }
+  if (txVector.GetMode ().GetModulationClass () == WIFI_MOD_CLASS_HT || txVector.GetMode ().GetModulationClass () == WIFI_MOD_CLASS_VHT || txVector.GetMode ().GetModulationClass () == WIFI_MOD_CLASS_HE)
+    {
+      nbits /= txVector.GetNss (); //divide effective number of bits by NSS to achieve same chunk error rate as SISO for AWGN
+      snr *= txVector.GetNTx () * GetNumberOfAntennas (); //gain offered by MIMO, SIMO or MISO compared to SISO for AWGN
+    }
+  const std::vector<double> &table = GetTable (mode, txVector);
+  double position = (RatioToDb (snr) - m_minSnrDb) / m_snrStepDb;
+  double logSuccessPerBit;
+  if (position <= 0)
+    {
+      logSuccessPerBit = table.front ();
+    }
+  else if (position >= table.size () - 1)
+    {
+      logSuccessPerBit = table.back ();
+    }
+  else
+    {
+      uint32_t index = static_cast<uint32_t> (position);
+      double fraction = position - index;
+      logSuccessPerBit = table[index] + fraction * (table[index + 1] - table[index]);
+    }
+  return std::exp (logSuccessPerBit * nbits);
+}
+
+double
+LinkTableWifiPhy::CalculateChunkSuccessRate (double snr, Time duration, WifiMode mode, WifiTxVector txVector)
+{
+  if (duration.IsZero ())
+    {
+      return 1.0;
+    }
+  uint64_t rate = mode.GetPhyRate (txVector);
+  uint64_t nbits = static_cast<uint64_t> (rate * duration.GetSeconds ());
+  return GetChunkSuccessRate (mode, txVector, snr, nbits);
+}
+
+InterferenceHelper::SnrPer
+LinkTableWifiPhy::CalculatePlcpHeaderSnrPer (Ptr<Event> event)
+{
+  NS_LOG_FUNCTION (this << event);
+  WifiTxVector txVector = event->GetTxVector ();
+  WifiPreamble preamble = txVector.GetPreambleType ();
+  InterferenceHelper::SnrPer snrPer;
+  //Called at the end of the PLCP header: the noise and interference is that of the preamble and header
+  snrPer.snr = m_interference.CalculateAccumulatedSnr (event, m_interferenceMode == PEAK_INTERFERENCE);
+
+  //With a constant SNR, the chunks of the PLCP header only depend on the mode they are sent with
+  WifiMode headerMode = GetPlcpHeaderMode (txVector);
+  Time legacyHeaderDuration = GetPlcpHeaderDuration (txVector);
+  Time mcsHeaderDuration = GetPlcpHtSigHeaderDuration (preamble) + GetPlcpSigA1Duration (preamble)
+    + GetPlcpSigA2Duration (preamble) + GetPlcpTrainingSymbolDuration (txVector) + GetPlcpSigBDuration (preamble);
+  double psr = 1.0;
+  if (preamble == WIFI_PREAMBLE_LONG || preamble == WIFI_PREAMBLE_SHORT)
+    {
+      psr = CalculateChunkSuccessRate (snrPer.snr, legacyHeaderDuration + mcsHeaderDuration, headerMode, txVector);
+    }
+  else
+    {
+      WifiMode mcsHeaderMode;
+      if (preamble == WIFI_PREAMBLE_HT_MF || preamble == WIFI_PREAMBLE_HT_GF)
+        {
+          mcsHeaderMode = GetHtPlcpHeaderMode ();
+        }
+      else if (preamble == WIFI_PREAMBLE_VHT)
+        {
+          mcsHeaderMode = GetVhtPlcpHeaderMode ();
+        }
+      else
+        {
+          mcsHeaderMode = GetHePlcpHeaderMode ();
+        }
+      if (preamble == WIFI_PREAMBLE_VHT || preamble == WIFI_PREAMBLE_HE_SU)
+        {
+          //SIG-A is sent using legacy OFDM modulation
+          Time sigADuration = GetPlcpSigA1Duration (preamble) + GetPlcpSigA2Duration (preamble);
+          legacyHeaderDuration += sigADuration;
+          mcsHeaderDuration -= sigADuration;
+        }
+      psr = CalculateChunkSuccessRate (snrPer.snr, legacyHeaderDuration, headerMode, txVector)
+        * CalculateChunkSuccessRate (snrPer.snr, mcsHeaderDuration, mcsHeaderMode, txVector);
+    }
+  snrPer.per = 1 - psr;
+  NS_LOG_DEBUG ("snr(dB)=" << RatioToDb (snrPer.snr) << ", per=" << snrPer.per);
+  return snrPer;
+}
+
+InterferenceHelper::SnrPer
+LinkTableWifiPhy::CalculatePlcpPayloadSnrPer (Ptr<Event> event)
+{
+  NS_LOG_FUNCTION (this << event);
+  WifiTxVector txVector = event->GetTxVector ();
+  WifiPreamble preamble = txVector.GetPreambleType ();
+  InterferenceHelper::SnrPer snrPer;
+  //Called at the end of the event: the noise and interference is that of the payload,
+  //or of the whole frame if there is no preamble
+  snrPer.snr = m_interference.CalculateAccumulatedSnr (event, m_interferenceMode == PEAK_INTERFERENCE);
+
+  Time plcpPayloadStart = event->GetStartTime () + GetPlcpPreambleDuration (txVector) + GetPlcpHeaderDuration (txVector)
+    + GetPlcpHtSigHeaderDuration (preamble) + GetPlcpSigA1Duration (preamble) + GetPlcpSigA2Duration (preamble)
+    + GetPlcpTrainingSymbolDuration (txVector) + GetPlcpSigBDuration (preamble);
+  Time payloadDuration = event->GetEndTime () > plcpPayloadStart ? event->GetEndTime () - plcpPayloadStart : Seconds (0);
+  snrPer.per = 1 - CalculateChunkSuccessRate (snrPer.snr, payloadDuration, event->GetPayloadMode (), txVector);
+  NS_LOG_DEBUG ("snr(dB)=" << RatioToDb (snrPer.snr) << ", per=" << snrPer.per);
+  return snrPer;
+}
+
+} //namespace ns3
@@ -0,0 +1,146 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef LINK_TABLE_WIFI_PHY_H
+#define LINK_TABLE_WIFI_PHY_H
+
+#include "yans-wifi-phy.h"
+#include <map>
+#include <tuple>
+#include <vector>
+
+namespace ns3 {
+
+class ErrorRateModel;
+
+/**
+ * \brief Abstract frame-level 802.11 PHY model driven by precomputed link tables
+ * \ingroup wifi
+ *
+ * This PHY is attached to a YansWifiChannel like YansWifiPhy, but decides
+ * on the reception of the PLCP header and of the PLCP payload in constant
+ * time, instead of evaluating the error rate model over every interference
+ * chunk of the frame:
+ *
+ * - the noise and interference seen by the PLCP preamble and header, and
+ *   then by the PLCP payload, is collapsed into a single value, either its
+ *   peak or its time average (see the InterferenceMode attribute), which the
+ *   InterferenceHelper accumulates as the signals start and end, so that
+ *   the NI changes overlapping the frame are not walked through again;
+ * - the error rate model is sampled once per WifiMode and channel width on
+ *   a grid of SNR values (see the MinSnr, MaxSnr and SnrStep attributes) and the success
+ *   rate of a frame is interpolated from that table.
+ *
+ * With no interference during the frame, the results match YansWifiPhy up to
+ * the interpolation error of the table.  When the interference changes
+ * during the frame, the peak mode is pessimistic and the average mode may be
+ * optimistic for short and strong interferers.  In exchange, the cost of a
+ * reception no longer depends on the number of overlapping signals nor on the
+ * cost of the error rate model.
+ *
+ * The tables assume that the error rate model returns a success rate
+ * which is the per-bit success rate raised to the number of bits, which is
+ * the case for the NIST, YANS and DSSS models.
+ */
+class LinkTableWifiPhy : public YansWifiPhy
+{
+public:
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+
+  LinkTableWifiPhy ();
+  virtual ~LinkTableWifiPhy ();
+
+  /**
+   * The value of the noise and interference used to compute the SNR of a frame.
+   */
+  enum InterferenceMode
+  {
+    PEAK_INTERFERENCE,
+    AVERAGE_INTERFERENCE
+  };
+
+  /**
+   * Return the success rate of a chunk of bits, looked up from the table of
+   * the given mode.  This mirrors InterferenceHelper, in particular the
+   * MIMO gain applied to HT, VHT and HE modes.
+   *
+   * \param mode the WifiMode used to transmit the chunk
+   * \param txVector the TXVECTOR of the frame
+   * \param snr the SNR (linear ratio)
+   * \param nbits the number of bits in the chunk
+   *
+   * \return the success rate of the chunk
+   */
+  double GetChunkSuccessRate (WifiMode mode, WifiTxVector txVector, double snr, uint64_t nbits);
+
+
+protected:
+  // Inherited
+  virtual void DoDispose (void);
+  virtual InterferenceHelper::SnrPer CalculatePlcpHeaderSnrPer (Ptr<Event> event);
+  virtual InterferenceHelper::SnrPer CalculatePlcpPayloadSnrPer (Ptr<Event> event);
+
+
+private:
+  /**
+   * Return the success rate of a chunk of the given duration, looked up
+   * from the table of the given mode.
+   *
+   * \param snr the SNR (linear ratio)
+   * \param duration the duration of the chunk
+   * \param mode the WifiMode used to transmit the chunk
+   * \param txVector the TXVECTOR of the frame
+   *
+   * \return the success rate of the chunk
+   */
+  double CalculateChunkSuccessRate (double snr, Time duration, WifiMode mode, WifiTxVector txVector);
+  /**
+   * Return the table of the natural logarithm of the per-bit success rate of
+   * the given mode and TXVECTOR, sampled every SnrStep dB from MinSnr dB to MaxSnr dB.
+   * The table is built on first use.
+   *
+   * \param mode the WifiMode
+   * \param txVector the TXVECTOR passed to the error rate model
+   *
+   * \return the table of the given mode
+   */
+  const std::vector<double> & GetTable (WifiMode mode, WifiTxVector txVector);
+
+  /**
+   * Key of a link table: WifiMode UID, channel width (MHz) and PHY rate (bps),
+   * the last two being the TXVECTOR parameters used by the error rate models
+   */
+  typedef std::tuple<uint32_t, uint16_t, uint64_t> LinkTableKey;
+  /**
+   * typedef for a map of link tables
+   */
+  typedef std::map<LinkTableKey, std::vector<double> > LinkTables;
+
+  InterferenceMode m_interferenceMode; //!< how the noise and interference of a frame is computed
+  double m_minSnrDb;                   //!< lowest SNR of the tables (dB)
+  double m_maxSnrDb;                   //!< highest SNR of the tables (dB)
+  double m_snrStepDb;                  //!< SNR step of the tables (dB)
+  LinkTables m_tables;                 //!< the tables built so far
+  Ptr<ErrorRateModel> m_tablesErrorRateModel; //!< the error rate model the tables were built from
+};
+
+} //namespace ns3
+
+#endif /* LINK_TABLE_WIFI_PHY_H */
@@ -35,6 +35,7 @@
  */
 
 #include <iomanip>
+#include <algorithm>
 #include "ns3/packet.h"
 #include "ns3/simulator.h"
 #include "ns3/log.h"
@@ -65,11 +66,39 @@ struct MinstrelHtWifiRemoteStation : MinstrelWifiRemoteStation
   uint32_t m_ampduPacketCount; //!< Number of A-MPDUs transmitted.
 
   McsGroupData m_groupsTable;  //!< Table of groups with stats.
+  HtRateStats m_ratesStats;    //!< Statistics of all the rates, indexed by global index.
+  std::vector<uint16_t> m_attemptedRates; //!< Rates attempted since the last statistics update.
+  std::vector<uint16_t> m_usableRates;    //!< Rates with a non-zero throughput, sorted by global index.
+  uint32_t m_statsInterval;    //!< Number of statistics update intervals so far.
+  uint16_t m_lowestIndex;      //!< The global index of the lowest rate supported by the station.
   bool m_isHt;                 //!< If the station is HT capable.
 
   std::ofstream m_statsFile;   //!< File where statistics table is written.
 };
 
+void
+HtRateStats::Reset (uint16_t nRates)
+{
+  supported.assign (nRates, false);
+  mcsIndex.assign (nRates, 0);
+  perfectTxTime.assign (nRates, Seconds (0));
+  perfectTxTimeSeconds.assign (nRates, 0);
+  retryCount.assign (nRates, 0);
+  adjustedRetryCount.assign (nRates, 0);
+  numRateAttempt.assign (nRates, 0);
+  numRateSuccess.assign (nRates, 0);
+  prob.assign (nRates, 0);
+  ewmaProb.assign (nRates, 0);
+  ewmsdProb.assign (nRates, 0);
+  throughput.assign (nRates, 0);
+  successHist.assign (nRates, 0);
+  attemptHist.assign (nRates, 0);
+  prevNumRateAttempt.assign (nRates, 0);
+  prevNumRateSuccess.assign (nRates, 0);
+  lastAttemptInterval.assign (nRates, 0);
+  retryUpdateInterval.assign (nRates, 0);
+}
+
 NS_OBJECT_ENSURE_REGISTERED (MinstrelHtWifiManager);
 
 TypeId
@@ -402,6 +431,8 @@ MinstrelHtWifiManager::DoCreateStation (void) const
   station->m_avgAmpduLen = 1;
   station->m_ampduLen = 0;
   station->m_ampduPacketCount = 0;
+  station->m_statsInterval = 0;
+  station->m_lowestIndex = 0;
 
   // If the device supports HT
   if (HasHtSupported () || HasVhtSupported ())
@@ -527,9 +558,7 @@ MinstrelHtWifiManager::DoReportDataFailed (WifiRemoteStation *st)
     }
   else
     {
-      uint8_t rateId = GetRateId (station->m_txrate);
-      uint8_t groupId = GetGroupId (station->m_txrate);
-      station->m_groupsTable[groupId].m_ratesTable[rateId].numRateAttempt++; // Increment the attempts counter for the rate used.
+      AddRateAttempts (station, station->m_txrate, 0, 1); // Increment the attempts counter for the rate used.
       UpdateRate (station);
     }
 }
@@ -567,10 +596,7 @@ MinstrelHtWifiManager::DoReportDataOk (WifiRemoteStation *st, double ackSnr, Wif
     }
   else
     {
-      uint8_t rateId = GetRateId (station->m_txrate);
-      uint8_t groupId = GetGroupId (station->m_txrate);
-      station->m_groupsTable[groupId].m_ratesTable[rateId].numRateSuccess++;
-      station->m_groupsTable[groupId].m_ratesTable[rateId].numRateAttempt++;
+      AddRateAttempts (station, station->m_txrate, 1, 1);
 
       UpdatePacketCounters (station, 1, 0);
 
@@ -663,10 +689,7 @@ MinstrelHtWifiManager::DoReportAmpduTxStatus (WifiRemoteStation *st, uint8_t nSu
 
   UpdatePacketCounters (station, nSuccessfulMpdus, nFailedMpdus);
 
-  uint8_t rateId = GetRateId (station->m_txrate);
-  uint8_t groupId = GetGroupId (station->m_txrate);
-  station->m_groupsTable[groupId].m_ratesTable[rateId].numRateSuccess += nSuccessfulMpdus;
-  station->m_groupsTable[groupId].m_ratesTable[rateId].numRateAttempt += nSuccessfulMpdus + nFailedMpdus;
+  AddRateAttempts (station, station->m_txrate, nSuccessfulMpdus, nSuccessfulMpdus + nFailedMpdus);
 
   if (nSuccessfulMpdus == 0 && station->m_longRetry < CountRetries (station))
     {
@@ -726,37 +749,34 @@ MinstrelHtWifiManager::UpdateRate (MinstrelHtWifiRemoteStation *station)
   station->m_longRetry++;
 
   /**
-   * Get the ids for all rates.
+   * Get the retry counts for all rates.
    */
-  uint8_t maxTpRateId = GetRateId (station->m_maxTpRate);
-  uint8_t maxTpGroupId = GetGroupId (station->m_maxTpRate);
-  uint8_t maxTp2RateId = GetRateId (station->m_maxTpRate2);
-  uint8_t maxTp2GroupId = GetGroupId (station->m_maxTpRate2);
-  uint8_t maxProbRateId = GetRateId (station->m_maxProbRate);
-  uint8_t maxProbGroupId = GetGroupId (station->m_maxProbRate);
+  const std::vector<uint32_t> &retryCount = station->m_ratesStats.retryCount;
+  uint32_t maxTpRetries = retryCount[station->m_maxTpRate];
+  uint32_t maxTp2Retries = retryCount[station->m_maxTpRate2];
+  uint32_t maxProbRetries = retryCount[station->m_maxProbRate];
+  // Retries of the second best rate of the group of the best rate, used while sampling.
+  uint32_t samplingTp2Retries = retryCount[GetIndex (GetGroupId (station->m_maxTpRate), GetRateId (station->m_maxTpRate2))];
 
   /// For normal rate, we're not currently sampling random rates.
   if (!station->m_isSampling)
     {
       /// Use best throughput rate.
-      if (station->m_longRetry <  station->m_groupsTable[maxTpGroupId].m_ratesTable[maxTpRateId].retryCount)
+      if (station->m_longRetry < maxTpRetries)
         {
           NS_LOG_DEBUG ("Not Sampling; use the same rate again");
           station->m_txrate = station->m_maxTpRate;  //!<  There are still a few retries.
         }
 
       /// Use second best throughput rate.
-      else if (station->m_longRetry < ( station->m_groupsTable[maxTpGroupId].m_ratesTable[maxTpRateId].retryCount +
-                                        station->m_groupsTable[maxTp2GroupId].m_ratesTable[maxTp2RateId].retryCount))
+      else if (station->m_longRetry < (maxTpRetries + maxTp2Retries))
         {
           NS_LOG_DEBUG ("Not Sampling; use the Max TP2");
           station->m_txrate = station->m_maxTpRate2;
         }
 
       /// Use best probability rate.
-      else if (station->m_longRetry <= ( station->m_groupsTable[maxTpGroupId].m_ratesTable[maxTpRateId].retryCount +
-                                         station->m_groupsTable[maxTp2GroupId].m_ratesTable[maxTp2RateId].retryCount +
-                                         station->m_groupsTable[maxProbGroupId].m_ratesTable[maxProbRateId].retryCount))
+      else if (station->m_longRetry <= (maxTpRetries + maxTp2Retries + maxProbRetries))
         {
           NS_LOG_DEBUG ("Not Sampling; use Max Prob");
           station->m_txrate = station->m_maxProbRate;
@@ -772,15 +792,14 @@ MinstrelHtWifiManager::UpdateRate (MinstrelHtWifiRemoteStation *station)
     {
       /// Sample rate is used only once
       /// Use the best rate.
-      if (station->m_longRetry < 1 + station->m_groupsTable[maxTpGroupId].m_ratesTable[maxTp2RateId].retryCount)
+      if (station->m_longRetry < 1 + samplingTp2Retries)
         {
           NS_LOG_DEBUG ("Sampling use the MaxTP rate");
           station->m_txrate = station->m_maxTpRate2;
         }
 
       /// Use the best probability rate.
-      else if (station->m_longRetry <= 1 + station->m_groupsTable[maxTpGroupId].m_ratesTable[maxTp2RateId].retryCount +
-               station->m_groupsTable[maxProbGroupId].m_ratesTable[maxProbRateId].retryCount)
+      else if (station->m_longRetry <= 1 + samplingTp2Retries + maxProbRetries)
         {
           NS_LOG_DEBUG ("Sampling use the MaxProb rate");
           station->m_txrate = station->m_maxProbRate;
@@ -825,6 +844,20 @@ MinstrelHtWifiManager::UpdatePacketCounters (MinstrelHtWifiRemoteStation *statio
     }
 }
 
+void
+MinstrelHtWifiManager::AddRateAttempts (MinstrelHtWifiRemoteStation *station, uint16_t index, uint32_t nSuccess, uint32_t nAttempts)
+{
+  NS_LOG_FUNCTION (this << station << index << nSuccess << nAttempts);
+  HtRateStats &stats = station->m_ratesStats;
+  if (nAttempts > 0 && stats.numRateAttempt[index] == 0)
+    {
+      // First attempt in this interval, the statistics of the rate will have to be refreshed.
+      station->m_attemptedRates.push_back (index);
+    }
+  stats.numRateSuccess[index] += nSuccess;
+  stats.numRateAttempt[index] += nAttempts;
+}
+
 WifiTxVector
 MinstrelHtWifiManager::DoGetDataTxVector (WifiRemoteStation *st)
 {
@@ -853,7 +886,7 @@ MinstrelHtWifiManager::DoGetDataTxVector (WifiRemoteStation *st)
 
       uint8_t rateId = GetRateId (station->m_txrate);
       uint8_t groupId = GetGroupId (station->m_txrate);
-      uint8_t mcsIndex = station->m_groupsTable[groupId].m_ratesTable[rateId].mcsIndex;
+      uint8_t mcsIndex = station->m_ratesStats.mcsIndex[station->m_txrate];
 
       NS_LOG_DEBUG ("DoGetDataMode rateId= " << +rateId << " groupId= " << +groupId << " mode= " << GetMcsSupported (station, mcsIndex));
 
@@ -911,9 +944,7 @@ MinstrelHtWifiManager::DoGetRtsTxVector (WifiRemoteStation *st)
        */
 
       // As we are in Minstrel HT, assume the last rate was an HT rate.
-      uint8_t rateId = GetRateId (station->m_txrate);
-      uint8_t groupId = GetGroupId (station->m_txrate);
-      uint8_t mcsIndex = station->m_groupsTable[groupId].m_ratesTable[rateId].mcsIndex;
+      uint8_t mcsIndex = station->m_ratesStats.mcsIndex[station->m_txrate];
 
       WifiMode lastRate = GetMcsSupported (station, mcsIndex);
       uint64_t lastDataRate = lastRate.GetNonHtReferenceRate ();
@@ -993,23 +1024,18 @@ MinstrelHtWifiManager::DoNeedRetransmission (WifiRemoteStation *st, Ptr<const Pa
 uint32_t
 MinstrelHtWifiManager::CountRetries (MinstrelHtWifiRemoteStation *station)
 {
-  uint8_t maxProbRateId = GetRateId (station->m_maxProbRate);
-  uint8_t maxProbGroupId = GetGroupId (station->m_maxProbRate);
-  uint8_t maxTpRateId = GetRateId (station->m_maxTpRate);
-  uint8_t maxTpGroupId = GetGroupId (station->m_maxTpRate);
-  uint8_t maxTp2RateId = GetRateId (station->m_maxTpRate2);
-  uint8_t maxTp2GroupId = GetGroupId (station->m_maxTpRate2);
+  const std::vector<uint32_t> &retryCount = station->m_ratesStats.retryCount;
 
   if (!station->m_isSampling)
     {
-      return station->m_groupsTable[maxTpGroupId].m_ratesTable[maxTpRateId].retryCount +
-             station->m_groupsTable[maxTp2GroupId].m_ratesTable[maxTp2RateId].retryCount +
-             station->m_groupsTable[maxProbGroupId].m_ratesTable[maxProbRateId].retryCount;
+      return retryCount[station->m_maxTpRate] +
+             retryCount[station->m_maxTpRate2] +
+             retryCount[station->m_maxProbRate];
     }
   else
     {
-      return 1 + station->m_groupsTable[maxTpGroupId].m_ratesTable[maxTp2RateId].retryCount +
-             station->m_groupsTable[maxProbGroupId].m_ratesTable[maxProbRateId].retryCount;
+      return 1 + retryCount[GetIndex (GetGroupId (station->m_maxTpRate), GetRateId (station->m_maxTpRate2))] +
+             retryCount[station->m_maxProbRate];
     }
 }
 
@@ -1086,10 +1112,10 @@ MinstrelHtWifiManager::FindRate (MinstrelHtWifiRemoteStation *station)
 
       //Evaluate if the sampling rate selected should be used.
       uint8_t sampleGroupId = GetGroupId (sampleIdx);
-      uint8_t sampleRateId = GetRateId (sampleIdx);
 
       // If the rate selected is not supported, then don't sample.
-      if (station->m_groupsTable[sampleGroupId].m_supported && station->m_groupsTable[sampleGroupId].m_ratesTable[sampleRateId].supported)
+      const HtRateStats &stats = station->m_ratesStats;
+      if (station->m_groupsTable[sampleGroupId].m_supported && stats.supported[sampleIdx])
         {
           /**
            * Sampling might add some overhead to the frame.
@@ -1098,13 +1124,11 @@ MinstrelHtWifiManager::FindRate (MinstrelHtWifiRemoteStation *station)
            * Also do not sample if the probability is already higher than 95%
            * to avoid wasting airtime.
            */
-          HtRateInfo sampleRateInfo = station->m_groupsTable[sampleGroupId].m_ratesTable[sampleRateId];
-
           NS_LOG_DEBUG ("Use sample rate? MaxTpRate= " << station->m_maxTpRate << " CurrentRate= " << station->m_txrate <<
-                        " SampleRate= " << sampleIdx << " SampleProb= " << sampleRateInfo.ewmaProb);
+                        " SampleRate= " << sampleIdx << " SampleProb= " << stats.ewmaProb[sampleIdx]);
 
           if (sampleIdx != station->m_maxTpRate && sampleIdx != station->m_maxTpRate2
-              && sampleIdx != station->m_maxProbRate && sampleRateInfo.ewmaProb <= 95)
+              && sampleIdx != station->m_maxProbRate && stats.ewmaProb[sampleIdx] <= 95)
             {
 
               /**
@@ -1113,17 +1137,13 @@ MinstrelHtWifiManager::FindRate (MinstrelHtWifiRemoteStation *station)
                */
 
               uint8_t maxTpGroupId = GetGroupId (station->m_maxTpRate);
-              uint8_t maxTp2GroupId = GetGroupId (station->m_maxTpRate2);
-              uint8_t maxTp2RateId = GetRateId (station->m_maxTpRate2);
-              uint8_t maxProbGroupId = GetGroupId (station->m_maxProbRate);
-              uint8_t maxProbRateId = GetRateId (station->m_maxProbRate);
 
               uint8_t maxTpStreams = m_minstrelGroups[maxTpGroupId].streams;
               uint8_t sampleStreams = m_minstrelGroups[sampleGroupId].streams;
 
-              Time sampleDuration = sampleRateInfo.perfectTxTime;
-              Time maxTp2Duration = station->m_groupsTable[maxTp2GroupId].m_ratesTable[maxTp2RateId].perfectTxTime;
-              Time maxProbDuration = station->m_groupsTable[maxProbGroupId].m_ratesTable[maxProbRateId].perfectTxTime;
+              Time sampleDuration = stats.perfectTxTime[sampleIdx];
+              Time maxTp2Duration = stats.perfectTxTime[station->m_maxTpRate2];
+              Time maxProbDuration = stats.perfectTxTime[station->m_maxProbRate];
 
               NS_LOG_DEBUG ("Use sample rate? SampleDuration= " << sampleDuration << " maxTp2Duration= " << maxTp2Duration <<
                             " maxProbDuration= " << maxProbDuration << " sampleStreams= " << +sampleStreams <<
@@ -1143,7 +1163,8 @@ MinstrelHtWifiManager::FindRate (MinstrelHtWifiRemoteStation *station)
               else
                 {
                   station->m_numSamplesSlow++;
-                  if (sampleRateInfo.numSamplesSkipped >= 20 && station->m_numSamplesSlow <= 2)
+                  uint32_t numSamplesSkipped = station->m_statsInterval - stats.lastAttemptInterval[sampleIdx];
+                  if (numSamplesSkipped >= 20 && station->m_numSamplesSlow <= 2)
                     {
                       /// Set flag that we are currently sampling.
                       station->m_isSampling = true;
@@ -1189,87 +1210,107 @@ MinstrelHtWifiManager::UpdateStats (MinstrelHtWifiRemoteStation *station)
       station->m_ampduPacketCount = 0;
     }
 
-  /* Initialize global rate indexes */
-  station->m_maxTpRate = GetLowestIndex (station);
-  station->m_maxTpRate2 = GetLowestIndex (station);
-  station->m_maxProbRate = GetLowestIndex (station);
+  /**
+   * Start a new interval. This implicitly resets the retry update flag, the
+   * counters of the last interval and increments the number of samples skipped
+   * of all the rates that have not been attempted.
+   */
+  station->m_statsInterval++;
 
-  /// Update throughput and EWMA for each rate inside each group.
-  for (uint8_t j = 0; j < m_numGroups; j++)
+  HtRateStats &stats = station->m_ratesStats;
+
+  /// Update throughput and EWMA of the rates attempted during the last interval.
+  /// The statistics of the other rates are left unchanged.
+  for (std::vector<uint16_t>::const_iterator it = station->m_attemptedRates.begin (); it != station->m_attemptedRates.end (); it++)
     {
-      if (station->m_groupsTable[j].m_supported)
-        {
-          station->m_sampleCount++;
+      uint16_t index = *it;
+      NS_ASSERT (stats.supported[index] && stats.numRateAttempt[index] > 0);
 
-          /* (re)Initialize group rate indexes */
-          station->m_groupsTable[j].m_maxTpRate = GetLowestIndex (station, j);
-          station->m_groupsTable[j].m_maxTpRate2 = GetLowestIndex (station, j);
-          station->m_groupsTable[j].m_maxProbRate = GetLowestIndex (station, j);
+      NS_LOG_DEBUG (index << " " << GetMcsSupported (station, stats.mcsIndex[index]) <<
+                    "\t attempt=" << stats.numRateAttempt[index] <<
+                    "\t success=" << stats.numRateSuccess[index]);
 
-          for (uint8_t i = 0; i < m_numRates; i++)
-            {
-              if (station->m_groupsTable[j].m_ratesTable[i].supported)
-                {
-                  station->m_groupsTable[j].m_ratesTable[i].retryUpdated = false;
+      stats.lastAttemptInterval[index] = station->m_statsInterval;
+      /**
+       * Calculate the probability of success.
+       * Assume probability scales from 0 to 100.
+       */
+      tempProb = (100 * stats.numRateSuccess[index]) / stats.numRateAttempt[index];
 
-                  NS_LOG_DEBUG (+i << " " << GetMcsSupported (station, station->m_groupsTable[j].m_ratesTable[i].mcsIndex) <<
-                                "\t attempt=" << station->m_groupsTable[j].m_ratesTable[i].numRateAttempt <<
-                                "\t success=" << station->m_groupsTable[j].m_ratesTable[i].numRateSuccess);
+      /// Bookkeeping.
+      stats.prob[index] = tempProb;
 
-                  /// If we've attempted something.
-                  if (station->m_groupsTable[j].m_ratesTable[i].numRateAttempt > 0)
-                    {
-                      station->m_groupsTable[j].m_ratesTable[i].numSamplesSkipped = 0;
-                      /**
-                       * Calculate the probability of success.
-                       * Assume probability scales from 0 to 100.
-                       */
-                      tempProb = (100 * station->m_groupsTable[j].m_ratesTable[i].numRateSuccess) / station->m_groupsTable[j].m_ratesTable[i].numRateAttempt;
+      if (stats.successHist[index] == 0)
+        {
+          stats.ewmaProb[index] = tempProb;
+        }
+      else
+        {
+          stats.ewmsdProb[index] = CalculateEwmsd (stats.ewmsdProb[index], tempProb, stats.ewmaProb[index], m_ewmaLevel);
+          /// EWMA probability
+          tempProb = (tempProb * (100 - m_ewmaLevel) + stats.ewmaProb[index] * m_ewmaLevel)  / 100;
+          stats.ewmaProb[index] = tempProb;
+        }
 
-                      /// Bookkeeping.
-                      station->m_groupsTable[j].m_ratesTable[i].prob = tempProb;
+      bool wasUsable = (stats.throughput[index] != 0);
+      stats.throughput[index] = CalculateThroughput (station, GetGroupId (index), GetRateId (index), tempProb);
 
-                      if (station->m_groupsTable[j].m_ratesTable[i].successHist == 0)
-                        {
-                          station->m_groupsTable[j].m_ratesTable[i].ewmaProb = tempProb;
-                        }
-                      else
-                        {
-                          station->m_groupsTable[j].m_ratesTable[i].ewmsdProb = CalculateEwmsd (station->m_groupsTable[j].m_ratesTable[i].ewmsdProb,
-                                                                                                tempProb, station->m_groupsTable[j].m_ratesTable[i].ewmaProb,
-                                                                                                m_ewmaLevel);
-                          /// EWMA probability
-                          tempProb = (tempProb * (100 - m_ewmaLevel) + station->m_groupsTable[j].m_ratesTable[i].ewmaProb * m_ewmaLevel)  / 100;
-                          station->m_groupsTable[j].m_ratesTable[i].ewmaProb = tempProb;
-                        }
+      stats.successHist[index] += stats.numRateSuccess[index];
+      stats.attemptHist[index] += stats.numRateAttempt[index];
 
-                      station->m_groupsTable[j].m_ratesTable[i].throughput = CalculateThroughput (station, j, i, tempProb);
+      /// Bookkeeping.
+      stats.prevNumRateSuccess[index] = stats.numRateSuccess[index];
+      stats.prevNumRateAttempt[index] = stats.numRateAttempt[index];
+      stats.numRateSuccess[index] = 0;
+      stats.numRateAttempt[index] = 0;
 
-                      station->m_groupsTable[j].m_ratesTable[i].successHist += station->m_groupsTable[j].m_ratesTable[i].numRateSuccess;
-                      station->m_groupsTable[j].m_ratesTable[i].attemptHist += station->m_groupsTable[j].m_ratesTable[i].numRateAttempt;
-                    }
-                  else
-                    {
-                      station->m_groupsTable[j].m_ratesTable[i].numSamplesSkipped++;
-                    }
+      /// Keep the list of rates with a non-zero throughput sorted by index.
+      bool isUsable = (stats.throughput[index] != 0);
+      if (isUsable != wasUsable)
+        {
+          std::vector<uint16_t>::iterator pos = std::lower_bound (station->m_usableRates.begin (), station->m_usableRates.end (), index);
+          if (isUsable)
+            {
+              station->m_usableRates.insert (pos, index);
+            }
+          else
+            {
+              NS_ASSERT (pos != station->m_usableRates.end () && *pos == index);
+              station->m_usableRates.erase (pos);
+            }
+        }
+    }
+  station->m_attemptedRates.clear ();
 
-                  /// Bookkeeping.
-                  station->m_groupsTable[j].m_ratesTable[i].prevNumRateSuccess = station->m_groupsTable[j].m_ratesTable[i].numRateSuccess;
-                  station->m_groupsTable[j].m_ratesTable[i].prevNumRateAttempt = station->m_groupsTable[j].m_ratesTable[i].numRateAttempt;
-                  station->m_groupsTable[j].m_ratesTable[i].numRateSuccess = 0;
-                  station->m_groupsTable[j].m_ratesTable[i].numRateAttempt = 0;
+  /* Initialize global rate indexes */
+  station->m_maxTpRate = station->m_lowestIndex;
+  station->m_maxTpRate2 = station->m_lowestIndex;
+  station->m_maxProbRate = station->m_lowestIndex;
 
-                  if (station->m_groupsTable[j].m_ratesTable[i].throughput != 0)
-                    {
-                      SetBestStationThRates (station, GetIndex (j, i));
-                      SetBestProbabilityRate (station, GetIndex (j, i));
-                    }
+  for (uint8_t j = 0; j < m_numGroups; j++)
+    {
+      if (station->m_groupsTable[j].m_supported)
+        {
+          station->m_sampleCount++;
 
-                }
-            }
+          /* (re)Initialize group rate indexes */
+          station->m_groupsTable[j].m_maxTpRate = station->m_groupsTable[j].m_lowestIndex;
+          station->m_groupsTable[j].m_maxTpRate2 = station->m_groupsTable[j].m_lowestIndex;
+          station->m_groupsTable[j].m_maxProbRate = station->m_groupsTable[j].m_lowestIndex;
         }
     }
 
+  /**
+   * Only the rates with a non-zero throughput can be selected, so only those
+   * are ranked. They are visited in increasing index order, so that ties are
+   * broken as if all rates of all groups were scanned.
+   */
+  for (std::vector<uint16_t>::const_iterator it = station->m_usableRates.begin (); it != station->m_usableRates.end (); it++)
+    {
+      SetBestStationThRates (station, *it);
+      SetBestProbabilityRate (station, *it);
+    }
+
   //Try to sample all available rates during each interval.
   station->m_sampleCount *= 8;
 
@@ -1303,14 +1344,14 @@ MinstrelHtWifiManager::CalculateThroughput (MinstrelHtWifiRemoteStation *station
        * For the throughput calculation, limit the probability value to 90% to
        * account for collision related packet error rate fluctuation.
        */
-      Time txTime =  station->m_groupsTable[groupId].m_ratesTable[rateId].perfectTxTime;
+      double txTime = station->m_ratesStats.perfectTxTimeSeconds[GetIndex (groupId, rateId)];
       if (ewmaProb > 90)
         {
-          return 90 / txTime.GetSeconds ();
+          return 90 / txTime;
         }
       else
         {
-          return ewmaProb / txTime.GetSeconds ();
+          return ewmaProb / txTime;
         }
     }
 }
@@ -1318,37 +1359,27 @@ MinstrelHtWifiManager::CalculateThroughput (MinstrelHtWifiRemoteStation *station
 void
 MinstrelHtWifiManager::SetBestProbabilityRate (MinstrelHtWifiRemoteStation *station, uint16_t index)
 {
+  const HtRateStats &stats = station->m_ratesStats;
   GroupInfo *group;
-  HtRateInfo rate;
-  uint8_t tmpGroupId, tmpRateId;
   double tmpTh, tmpProb;
-  uint8_t groupId, rateId;
   double currentTh;
   // maximum group probability (GP) variables
-  uint8_t maxGPGroupId, maxGPRateId;
   double maxGPTh;
 
-  groupId = GetGroupId (index);
-  rateId = GetRateId (index);
-  group = &station->m_groupsTable[groupId];
-  rate = group->m_ratesTable[rateId];
+  group = &station->m_groupsTable[GetGroupId (index)];
 
-  tmpGroupId = GetGroupId (station->m_maxProbRate);
-  tmpRateId = GetRateId (station->m_maxProbRate);
-  tmpProb = station->m_groupsTable[tmpGroupId].m_ratesTable[tmpRateId].ewmaProb;
-  tmpTh =  station->m_groupsTable[tmpGroupId].m_ratesTable[tmpRateId].throughput;
+  tmpProb = stats.ewmaProb[station->m_maxProbRate];
+  tmpTh = stats.throughput[station->m_maxProbRate];
 
-  if (rate.ewmaProb > 75)
+  if (stats.ewmaProb[index] > 75)
     {
-      currentTh = station->m_groupsTable[groupId].m_ratesTable[rateId].throughput;
+      currentTh = stats.throughput[index];
       if (currentTh > tmpTh)
         {
           station->m_maxProbRate = index;
         }
 
-      maxGPGroupId = GetGroupId (group->m_maxProbRate);
-      maxGPRateId = GetRateId (group->m_maxProbRate);
-      maxGPTh = station->m_groupsTable[maxGPGroupId].m_ratesTable[maxGPRateId].throughput;
+      maxGPTh = stats.throughput[group->m_maxProbRate];
 
       if (currentTh > maxGPTh)
         {
@@ -1357,12 +1388,11 @@ MinstrelHtWifiManager::SetBestProbabilityRate (MinstrelHtWifiRemoteStation *stat
     }
   else
     {
-      if (rate.ewmaProb > tmpProb)
+      if (stats.ewmaProb[index] > tmpProb)
         {
           station->m_maxProbRate = index;
         }
-      maxGPRateId = GetRateId (group->m_maxProbRate);
-      if (rate.ewmaProb > group->m_ratesTable[maxGPRateId].ewmaProb)
+      if (stats.ewmaProb[index] > stats.ewmaProb[group->m_maxProbRate])
         {
           group->m_maxProbRate = index;
         }
@@ -1379,27 +1409,19 @@ MinstrelHtWifiManager::SetBestProbabilityRate (MinstrelHtWifiRemoteStation *stat
 void
 MinstrelHtWifiManager::SetBestStationThRates (MinstrelHtWifiRemoteStation *station, uint16_t index)
 {
-  uint8_t groupId, rateId;
+  const HtRateStats &stats = station->m_ratesStats;
   double th, prob;
-  uint8_t maxTpGroupId, maxTpRateId;
-  uint8_t maxTp2GroupId, maxTp2RateId;
   double maxTpTh, maxTpProb;
   double maxTp2Th, maxTp2Prob;
 
-  groupId = GetGroupId (index);
-  rateId = GetRateId (index);
-  prob = station->m_groupsTable[groupId].m_ratesTable[rateId].ewmaProb;
-  th = station->m_groupsTable[groupId].m_ratesTable[rateId].throughput;
+  prob = stats.ewmaProb[index];
+  th = stats.throughput[index];
 
-  maxTpGroupId = GetGroupId (station->m_maxTpRate);
-  maxTpRateId = GetRateId (station->m_maxTpRate);
-  maxTpProb = station->m_groupsTable[maxTpGroupId].m_ratesTable[maxTpRateId].ewmaProb;
-  maxTpTh = station->m_groupsTable[maxTpGroupId].m_ratesTable[maxTpRateId].throughput;
+  maxTpProb = stats.ewmaProb[station->m_maxTpRate];
+  maxTpTh = stats.throughput[station->m_maxTpRate];
 
-  maxTp2GroupId = GetGroupId (station->m_maxTpRate2);
-  maxTp2RateId = GetRateId (station->m_maxTpRate2);
-  maxTp2Prob = station->m_groupsTable[maxTp2GroupId].m_ratesTable[maxTp2RateId].ewmaProb;
-  maxTp2Th = station->m_groupsTable[maxTp2GroupId].m_ratesTable[maxTp2RateId].throughput;
+  maxTp2Prob = stats.ewmaProb[station->m_maxTpRate2];
+  maxTp2Th = stats.throughput[station->m_maxTpRate2];
 
   if (th > maxTpTh || (th == maxTpTh && prob > maxTpProb))
     {
@@ -1413,16 +1435,12 @@ MinstrelHtWifiManager::SetBestStationThRates (MinstrelHtWifiRemoteStation *stati
 
   //Find best rates per group
 
-  GroupInfo *group = &station->m_groupsTable[groupId];
-  maxTpGroupId = GetGroupId (group->m_maxTpRate);
-  maxTpRateId = GetRateId (group->m_maxTpRate);
-  maxTpProb = group->m_ratesTable[maxTpRateId].ewmaProb;
-  maxTpTh = station->m_groupsTable[maxTpGroupId].m_ratesTable[maxTpRateId].throughput;
+  GroupInfo *group = &station->m_groupsTable[GetGroupId (index)];
+  maxTpProb = stats.ewmaProb[group->m_maxTpRate];
+  maxTpTh = stats.throughput[group->m_maxTpRate];
 
-  maxTp2GroupId = GetGroupId (group->m_maxTpRate2);
-  maxTp2RateId = GetRateId (group->m_maxTpRate2);
-  maxTp2Prob = group->m_ratesTable[maxTp2RateId].ewmaProb;
-  maxTp2Th = station->m_groupsTable[maxTp2GroupId].m_ratesTable[maxTp2RateId].throughput;
+  maxTp2Prob = stats.ewmaProb[group->m_maxTpRate2];
+  maxTp2Th = stats.throughput[group->m_maxTpRate2];
 
   if (th > maxTpTh || (th == maxTpTh && prob > maxTpProb))
     {
@@ -1441,6 +1459,12 @@ MinstrelHtWifiManager::RateInit (MinstrelHtWifiRemoteStation *station)
   NS_LOG_FUNCTION (this << station);
 
   station->m_groupsTable = McsGroupData (m_numGroups);
+  station->m_ratesStats.Reset (m_numGroups * m_numRates);
+  station->m_attemptedRates.clear ();
+  station->m_usableRates.clear ();
+  station->m_statsInterval = 0;
+
+  HtRateStats &stats = station->m_ratesStats;
 
   /**
   * Initialize groups supported by the receiver.
@@ -1464,12 +1488,6 @@ MinstrelHtWifiManager::RateInit (MinstrelHtWifiRemoteStation *station)
               station->m_groupsTable[groupId].m_col = 0;
               station->m_groupsTable[groupId].m_index = 0;
 
-              station->m_groupsTable[groupId].m_ratesTable = HtMinstrelRate (m_numRates);        ///Create the rate list for the group.
-              for (uint8_t i = 0; i < m_numRates; i++)
-                {
-                  station->m_groupsTable[groupId].m_ratesTable[i].supported = false;
-                }
-
               // Initialize all modes supported by the remote station that belong to the current group.
               for (uint8_t i = 0; i < station->m_nModes; i++)
                 {
@@ -1491,27 +1509,25 @@ MinstrelHtWifiManager::RateInit (MinstrelHtWifiRemoteStation *station)
                     {
                       NS_LOG_DEBUG ("Mode " << +i << ": " << mode << " isVht: " << m_minstrelGroups[groupId].isVht);
 
-                      station->m_groupsTable[groupId].m_ratesTable[rateId].supported = true;
-                      station->m_groupsTable[groupId].m_ratesTable[rateId].mcsIndex = i;         ///Mapping between rateId and operationalMcsSet
-                      station->m_groupsTable[groupId].m_ratesTable[rateId].numRateAttempt = 0;
-                      station->m_groupsTable[groupId].m_ratesTable[rateId].numRateSuccess = 0;
-                      station->m_groupsTable[groupId].m_ratesTable[rateId].prob = 0;
-                      station->m_groupsTable[groupId].m_ratesTable[rateId].ewmaProb = 0;
-                      station->m_groupsTable[groupId].m_ratesTable[rateId].prevNumRateAttempt = 0;
-                      station->m_groupsTable[groupId].m_ratesTable[rateId].prevNumRateSuccess = 0;
-                      station->m_groupsTable[groupId].m_ratesTable[rateId].numSamplesSkipped = 0;
-                      station->m_groupsTable[groupId].m_ratesTable[rateId].successHist = 0;
-                      station->m_groupsTable[groupId].m_ratesTable[rateId].attemptHist = 0;
-                      station->m_groupsTable[groupId].m_ratesTable[rateId].throughput = 0;
-                      station->m_groupsTable[groupId].m_ratesTable[rateId].perfectTxTime = GetFirstMpduTxTime (groupId, GetMcsSupported (station, i));
-                      station->m_groupsTable[groupId].m_ratesTable[rateId].retryCount = 0;
-                      station->m_groupsTable[groupId].m_ratesTable[rateId].adjustedRetryCount = 0;
+                      uint16_t index = GetIndex (groupId, rateId);
+                      stats.supported[index] = true;
+                      stats.mcsIndex[index] = i;         ///Mapping between rateId and operationalMcsSet
+                      stats.perfectTxTime[index] = GetFirstMpduTxTime (groupId, GetMcsSupported (station, i));
+                      stats.perfectTxTimeSeconds[index] = stats.perfectTxTime[index].GetSeconds ();
                       CalculateRetransmits (station, groupId, rateId);
                     }
                 }
             }
         }
     }
+  station->m_lowestIndex = GetLowestIndex (station);
+  for (uint8_t groupId = 0; groupId < m_numGroups; groupId++)
+    {
+      if (station->m_groupsTable[groupId].m_supported)
+        {
+          station->m_groupsTable[groupId].m_lowestIndex = GetLowestIndex (station, groupId);
+        }
+    }
   SetNextSample (station);                  /// Select the initial sample index.
   UpdateStats (station);                    /// Calculate the initial high throughput rates.
   station->m_txrate = FindRate (station);   /// Select the rate to use.
@@ -1521,11 +1537,9 @@ void
 MinstrelHtWifiManager::CalculateRetransmits (MinstrelHtWifiRemoteStation *station, uint16_t index)
 {
   NS_LOG_FUNCTION (this << station << index);
-  uint8_t groupId = GetGroupId (index);
-  uint8_t rateId = GetRateId (index);
-  if (!station->m_groupsTable[groupId].m_ratesTable[rateId].retryUpdated)
+  if (station->m_ratesStats.retryUpdateInterval[index] != station->m_statsInterval)
     {
-      CalculateRetransmits (station, groupId, rateId);
+      CalculateRetransmits (station, GetGroupId (index), GetRateId (index));
     }
 }
 
@@ -1534,23 +1548,25 @@ MinstrelHtWifiManager::CalculateRetransmits (MinstrelHtWifiRemoteStation *statio
 {
   NS_LOG_FUNCTION (this << station << +groupId << +rateId);
 
+  HtRateStats &stats = station->m_ratesStats;
+  uint16_t index = GetIndex (groupId, rateId);
   uint32_t cw = 15;                     // Is an approximation.
   uint32_t cwMax = 1023;
   Time cwTime, txTime, dataTxTime;
   Time slotTime = GetMac ()->GetSlot ();
   Time ackTime = GetMac ()->GetBasicBlockAckTimeout ();
 
-  if (station->m_groupsTable[groupId].m_ratesTable[rateId].ewmaProb < 1)
+  if (stats.ewmaProb[index] < 1)
     {
-      station->m_groupsTable[groupId].m_ratesTable[rateId].retryCount = 1;
+      stats.retryCount[index] = 1;
     }
   else
     {
-      station->m_groupsTable[groupId].m_ratesTable[rateId].retryCount = 2;
-      station->m_groupsTable[groupId].m_ratesTable[rateId].retryUpdated = true;
+      stats.retryCount[index] = 2;
+      stats.retryUpdateInterval[index] = station->m_statsInterval;
 
-      dataTxTime = GetFirstMpduTxTime (groupId, GetMcsSupported (station, station->m_groupsTable[groupId].m_ratesTable[rateId].mcsIndex)) +
-        GetMpduTxTime (groupId, GetMcsSupported (station, station->m_groupsTable[groupId].m_ratesTable[rateId].mcsIndex)) * (station->m_avgAmpduLen - 1);
+      dataTxTime = GetFirstMpduTxTime (groupId, GetMcsSupported (station, stats.mcsIndex[index])) +
+        GetMpduTxTime (groupId, GetMcsSupported (station, stats.mcsIndex[index])) * (station->m_avgAmpduLen - 1);
 
       /* Contention time for first 2 tries */
       cwTime = (cw / 2) * slotTime;
@@ -1572,7 +1588,7 @@ MinstrelHtWifiManager::CalculateRetransmits (MinstrelHtWifiRemoteStation *statio
           txTime += cwTime + ackTime + dataTxTime;
         }
       while ((txTime < MilliSeconds (6))
-             && (++station->m_groupsTable[groupId].m_ratesTable[rateId].retryCount < 7));
+             && (++stats.retryCount[index] < 7));
     }
 }
 
@@ -1644,6 +1660,7 @@ MinstrelHtWifiManager::StatsDump (MinstrelHtWifiRemoteStation *station, uint8_t
 {
   uint8_t numRates = m_numRates;
   McsGroup group = m_minstrelGroups[groupId];
+  const HtRateStats &stats = station->m_ratesStats;
   Time txTime;
   char giMode;
   if (group.sgi)
@@ -1656,7 +1673,8 @@ MinstrelHtWifiManager::StatsDump (MinstrelHtWifiRemoteStation *station, uint8_t
     }
   for (uint8_t i = 0; i < numRates; i++)
     {
-      if (station->m_groupsTable[groupId].m_supported && station->m_groupsTable[groupId].m_ratesTable[i].supported)
+      uint16_t idx = GetIndex (groupId, i);
+      if (station->m_groupsTable[groupId].m_supported && stats.supported[idx])
         {
           if (!group.isVht)
             {
@@ -1671,7 +1689,6 @@ MinstrelHtWifiManager::StatsDump (MinstrelHtWifiRemoteStation *station, uint8_t
           uint16_t maxTpRate2 = station->m_maxTpRate2;
           uint16_t maxProbRate = station->m_maxProbRate;
 
-          uint16_t idx = GetIndex (groupId, i);
           if (idx == maxTpRate)
             {
               of << 'A';
@@ -1709,19 +1726,22 @@ MinstrelHtWifiManager::StatsDump (MinstrelHtWifiRemoteStation *station, uint8_t
           of << "  " << std::setw (3) << +idx << "  ";
 
           /* tx_time[rate(i)] in usec */
-          txTime = GetFirstMpduTxTime (groupId, GetMcsSupported (station, station->m_groupsTable[groupId].m_ratesTable[i].mcsIndex));
+          txTime = GetFirstMpduTxTime (groupId, GetMcsSupported (station, stats.mcsIndex[idx]));
           of << std::setw (6) << txTime.GetMicroSeconds () << "  ";
 
+          // The counters of the last interval are only valid if the rate was attempted in it
+          bool lastInterval = (stats.lastAttemptInterval[idx] == station->m_statsInterval);
+
           of << std::setw (7) << CalculateThroughput (station, groupId, i, 100) / 100 << "   " <<
-            std::setw (7) << station->m_groupsTable[groupId].m_ratesTable[i].throughput / 100 << "   " <<
-            std::setw (7) << station->m_groupsTable[groupId].m_ratesTable[i].ewmaProb << "  " <<
-            std::setw (7) << station->m_groupsTable[groupId].m_ratesTable[i].ewmsdProb << "  " <<
-            std::setw (7) << station->m_groupsTable[groupId].m_ratesTable[i].prob << "  " <<
-            std::setw (2) << station->m_groupsTable[groupId].m_ratesTable[i].retryCount << "   " <<
-            std::setw (3) << station->m_groupsTable[groupId].m_ratesTable[i].prevNumRateSuccess << "  " <<
-            std::setw (3) << station->m_groupsTable[groupId].m_ratesTable[i].prevNumRateAttempt << "   " <<
-            std::setw (9) << station->m_groupsTable[groupId].m_ratesTable[i].successHist << "   " <<
-            std::setw (9) << station->m_groupsTable[groupId].m_ratesTable[i].attemptHist << "\n";
+            std::setw (7) << stats.throughput[idx] / 100 << "   " <<
+            std::setw (7) << stats.ewmaProb[idx] << "  " <<
+            std::setw (7) << stats.ewmsdProb[idx] << "  " <<
+            std::setw (7) << stats.prob[idx] << "  " <<
+            std::setw (2) << stats.retryCount[idx] << "   " <<
+            std::setw (3) << (lastInterval ? stats.prevNumRateSuccess[idx] : 0) << "  " <<
+            std::setw (3) << (lastInterval ? stats.prevNumRateAttempt[idx] : 0) << "   " <<
+            std::setw (9) << stats.successHist[idx] << "   " <<
+            std::setw (9) << stats.attemptHist[idx] << "\n";
         }
     }
 }
@@ -1775,11 +1795,11 @@ MinstrelHtWifiManager::GetLowestIndex (MinstrelHtWifiRemoteStation *station)
     {
       groupId++;
     }
-  while (rateId < m_numRates && !station->m_groupsTable[groupId].m_ratesTable[rateId].supported)
+  while (rateId < m_numRates && !station->m_ratesStats.supported[GetIndex (groupId, rateId)])
     {
       rateId++;
     }
-  NS_ASSERT (station->m_groupsTable[groupId].m_supported && station->m_groupsTable[groupId].m_ratesTable[rateId].supported);
+  NS_ASSERT (station->m_groupsTable[groupId].m_supported && station->m_ratesStats.supported[GetIndex (groupId, rateId)]);
   return GetIndex (groupId, rateId);
 }
 
@@ -1789,11 +1809,11 @@ MinstrelHtWifiManager::GetLowestIndex (MinstrelHtWifiRemoteStation *station, uin
   NS_LOG_FUNCTION (this << station << +groupId);
 
   uint8_t rateId = 0;
-  while (rateId < m_numRates && !station->m_groupsTable[groupId].m_ratesTable[rateId].supported)
+  while (rateId < m_numRates && !station->m_ratesStats.supported[GetIndex (groupId, rateId)])
     {
       rateId++;
     }
-  NS_ASSERT (station->m_groupsTable[groupId].m_supported && station->m_groupsTable[groupId].m_ratesTable[rateId].supported);
+  NS_ASSERT (station->m_groupsTable[groupId].m_supported && station->m_ratesStats.supported[GetIndex (groupId, rateId)]);
   return GetIndex (groupId, rateId);
 }
 
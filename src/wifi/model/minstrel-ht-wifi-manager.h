@@ -63,44 +63,57 @@ typedef std::vector<McsGroup> MinstrelMcsGroups;
 
 struct MinstrelHtWifiRemoteStation;
 /**
- * A struct to contain all statistics information related to a data rate.
+ * A struct to contain all statistics information related to the data rates
+ * of a station.
+ *
+ * The statistics are stored as a structure of arrays, all of them indexed
+ * by the global rate index (see MinstrelHtWifiManager::GetIndex), so that
+ * the periodic statistics update walks contiguous memory and only touches
+ * the fields it needs.
+ *
+ * The fields that would otherwise need to be reset for every rate on each
+ * update interval (number of samples skipped, retry update flag and
+ * counters of the last interval) are stamped with the number of the update
+ * interval in which they were last modified, and are evaluated lazily.
  */
-struct HtRateInfo
+struct HtRateStats
 {
+  /**
+   * Resize all the arrays to the given number of rates and reset them.
+   *
+   * \param nRates the number of rates (groups times rates per group)
+   */
+  void Reset (uint16_t nRates);
+
+  std::vector<bool> supported;                 //!< If the rate is supported.
+  std::vector<uint8_t> mcsIndex;               //!< The index in the operationalMcsSet of the WifiRemoteStationManager.
   /**
    * Perfect transmission time calculation, or frame calculation.
    * Given a bit rate and a packet length n bytes.
    */
-  Time perfectTxTime;
-  bool supported;               //!< If the rate is supported.
-  uint8_t mcsIndex;             //!< The index in the operationalMcsSet of the WifiRemoteStationManager.
-  uint32_t retryCount;          //!< Retry limit.
-  uint32_t adjustedRetryCount;  //!< Adjust the retry limit for this rate.
-  uint32_t numRateAttempt;      //!< Number of transmission attempts so far.
-  uint32_t numRateSuccess;      //!< Number of successful frames transmitted so far.
-  double prob;                  //!< Current probability within last time interval. (# frame success )/(# total frames)
-  bool retryUpdated;            //!< If number of retries was updated already.
+  std::vector<Time> perfectTxTime;
+  std::vector<double> perfectTxTimeSeconds;    //!< perfectTxTime, in seconds, cached for the throughput calculation.
+  std::vector<uint32_t> retryCount;            //!< Retry limit.
+  std::vector<uint32_t> adjustedRetryCount;    //!< Adjust the retry limit for this rate.
+  std::vector<uint32_t> numRateAttempt;        //!< Number of transmission attempts so far.
+  std::vector<uint32_t> numRateSuccess;        //!< Number of successful frames transmitted so far.
+  std::vector<double> prob;                    //!< Current probability within last time interval. (# frame success )/(# total frames)
   /**
    * Exponential weighted moving average of probability.
    * EWMA calculation:
    * ewma_prob =[prob *(100 - ewma_level) + (ewma_prob_old * ewma_level)]/100
    */
-  double ewmaProb;
-  double ewmsdProb;             //!< Exponential weighted moving standard deviation of probability.
-  uint32_t prevNumRateAttempt;  //!< Number of transmission attempts with previous rate.
-  uint32_t prevNumRateSuccess;  //!< Number of successful frames transmitted with previous rate.
-  uint32_t numSamplesSkipped;   //!< Number of times this rate statistics were not updated because no attempts have been made.
-  uint64_t successHist;         //!< Aggregate of all transmission successes.
-  uint64_t attemptHist;         //!< Aggregate of all transmission attempts.
-  double throughput;            //!< Throughput of this rate (in pkts per second).
+  std::vector<double> ewmaProb;
+  std::vector<double> ewmsdProb;               //!< Exponential weighted moving standard deviation of probability.
+  std::vector<double> throughput;              //!< Throughput of this rate (in pkts per second).
+  std::vector<uint64_t> successHist;           //!< Aggregate of all transmission successes.
+  std::vector<uint64_t> attemptHist;           //!< Aggregate of all transmission attempts.
+  std::vector<uint32_t> prevNumRateAttempt;    //!< Number of transmission attempts in the last interval in which the rate was used.
+  std::vector<uint32_t> prevNumRateSuccess;    //!< Number of successful frames in the last interval in which the rate was used.
+  std::vector<uint32_t> lastAttemptInterval;   //!< Update interval in which the rate was last attempted.
+  std::vector<uint32_t> retryUpdateInterval;   //!< Update interval in which the number of retries was last updated.
 };
 
-/**
- * Data structure for a Minstrel Rate table.
- * A vector of a struct HtRateInfo.
- */
-typedef std::vector<HtRateInfo> HtMinstrelRate;
-
 /**
  * A struct to contain information of a group.
  */
@@ -112,10 +125,10 @@ struct GroupInfo
   uint8_t m_col;                  //!< Sample table column.
   uint8_t m_index;                //!< Sample table index.
   bool m_supported;               //!< If the rates of this group are supported by the station.
+  uint16_t m_lowestIndex;         //!< The global index of the lowest rate of this group supported by the station.
   uint16_t m_maxTpRate;           //!< The max throughput rate of this group.
   uint16_t m_maxTpRate2;          //!< The second max throughput rate of this group.
   uint16_t m_maxProbRate;         //!< The highest success probability rate of this group.
-  HtMinstrelRate m_ratesTable;    //!< Information about rates of this group.
 };
 
 /**
@@ -323,6 +336,17 @@ private:
    */
   void UpdatePacketCounters (MinstrelHtWifiRemoteStation *station, uint8_t nSuccessfulMpdus, uint8_t nFailedMpdus);
 
+  /**
+   * Account transmission attempts and successes for the given rate and
+   * remember that the rate statistics must be refreshed on the next update.
+   *
+   * \param station the minstrel HT wifi remote station
+   * \param index the global index of the rate
+   * \param nSuccess the number of successful transmissions
+   * \param nAttempts the number of transmission attempts
+   */
+  void AddRateAttempts (MinstrelHtWifiRemoteStation *station, uint16_t index, uint32_t nSuccess, uint32_t nAttempts);
+
   /**
    * Getting the next sample from Sample Table.
    *
@@ -24,6 +24,8 @@
 #include "ns3/simulator.h"
 #include "wifi-mac-queue.h"
 #include "qos-blocked-destinations.h"
+#include <algorithm>
+#include <iterator>
 
 namespace ns3 {
 
@@ -90,6 +92,98 @@ WifiMacQueue::TtlExceeded (ConstIterator &it)
   return false;
 }
 
+bool
+WifiMacQueue::DoEnqueue (ConstIterator pos, Ptr<WifiMacQueueItem> item)
+{
+  bool atTail = (pos == Tail ());
+  NS_ASSERT (atTail || pos == Head ());
+
+  if (!Queue<WifiMacQueueItem>::DoEnqueue (pos, item))
+    {
+      return false;
+    }
+
+  if (item->GetHeader ().IsQosData ())
+    {
+      SubQueue &subQueue = m_subQueues[SubQueueId (item->GetDestinationAddress (),
+                                                   item->GetHeader ().GetQosTid ())];
+      if (atTail)
+        {
+          subQueue.push_back (std::prev (Tail ()));
+        }
+      else
+        {
+          subQueue.push_front (Head ());
+        }
+    }
+  return true;
+}
+
+Ptr<WifiMacQueueItem>
+WifiMacQueue::DoDequeue (ConstIterator pos)
+{
+  RemoveFromSubQueue (pos);
+  return Queue<WifiMacQueueItem>::DoDequeue (pos);
+}
+
+Ptr<WifiMacQueueItem>
+WifiMacQueue::DoRemove (ConstIterator pos)
+{
+  RemoveFromSubQueue (pos);
+  return Queue<WifiMacQueueItem>::DoRemove (pos);
+}
+
+void
+WifiMacQueue::RemoveFromSubQueue (ConstIterator pos)
+{
+  if (!(*pos)->GetHeader ().IsQosData ())
+    {
+      return;
+    }
+
+  auto subQueueIt = m_subQueues.find (SubQueueId ((*pos)->GetDestinationAddress (),
+                                                  (*pos)->GetHeader ().GetQosTid ()));
+  NS_ASSERT (subQueueIt != m_subQueues.end ());
+  SubQueue &subQueue = subQueueIt->second;
+
+  // items are mostly removed from the head of their sub-queue
+  if (subQueue.front () == pos)
+    {
+      subQueue.pop_front ();
+    }
+  else if (subQueue.back () == pos)
+    {
+      subQueue.pop_back ();
+    }
+  else
+    {
+      auto it = std::find (subQueue.begin (), subQueue.end (), pos);
+      NS_ASSERT (it != subQueue.end ());
+      subQueue.erase (it);
+    }
+}
+
+const WifiMacQueue::SubQueue *
+WifiMacQueue::GetSubQueue (uint8_t tid, Mac48Address dest)
+{
+  auto subQueueIt = m_subQueues.find (SubQueueId (dest, tid));
+  if (subQueueIt == m_subQueues.end ())
+    {
+      return 0;
+    }
+
+  const SubQueue &subQueue = subQueueIt->second;
+  while (!subQueue.empty ())
+    {
+      ConstIterator it = subQueue.front ();
+      if (!TtlExceeded (it))
+        {
+          break;
+        }
+    }
+  return &subQueue;
+}
+
 bool
 WifiMacQueue::Enqueue (Ptr<WifiMacQueueItem> item)
 {
@@ -184,18 +278,10 @@ Ptr<WifiMacQueueItem>
 WifiMacQueue::DequeueByTidAndAddress (uint8_t tid, Mac48Address dest)
 {
   NS_LOG_FUNCTION (this << dest);
-  for (auto it = Head (); it != Tail (); )
+  const SubQueue *subQueue = GetSubQueue (tid, dest);
+  if (subQueue != 0 && !subQueue->empty ())
     {
-      if (!TtlExceeded (it))
-        {
-          if ((*it)->GetHeader ().IsQosData () && (*it)->GetDestinationAddress () == dest
-              && (*it)->GetHeader ().GetQosTid () == tid)
-            {
-              return DoDequeue (it);
-            }
-
-          it++;
-        }
+      return DoDequeue (subQueue->front ());
     }
   NS_LOG_DEBUG ("The queue is empty");
   return 0;
@@ -243,18 +329,10 @@ Ptr<const WifiMacQueueItem>
 WifiMacQueue::PeekByTidAndAddress (uint8_t tid, Mac48Address dest)
 {
   NS_LOG_FUNCTION (this << dest);
-  for (auto it = Head (); it != Tail (); )
+  const SubQueue *subQueue = GetSubQueue (tid, dest);
+  if (subQueue != 0 && !subQueue->empty ())
     {
-      if (!TtlExceeded (it))
-        {
-          if ((*it)->GetHeader ().IsQosData () && (*it)->GetDestinationAddress () == dest
-              && (*it)->GetHeader ().GetQosTid () == tid)
-            {
-              return DoPeek (it);
-            }
-
-          it++;
-        }
+      return DoPeek (subQueue->front ());
     }
   NS_LOG_DEBUG ("The queue is empty");
   return 0;
@@ -345,20 +423,8 @@ uint32_t
 WifiMacQueue::GetNPacketsByTidAndAddress (uint8_t tid, Mac48Address dest)
 {
   NS_LOG_FUNCTION (this << dest);
-  uint32_t nPackets = 0;
-  for (auto it = Head (); it != Tail (); )
-    {
-      if (!TtlExceeded (it))
-        {
-          if ((*it)->GetHeader ().IsQosData () && (*it)->GetDestinationAddress () == dest
-              && (*it)->GetHeader ().GetQosTid () == tid)
-            {
-              nPackets++;
-            }
-
-          it++;
-        }
-    }
+  const SubQueue *subQueue = GetSubQueue (tid, dest);
+  uint32_t nPackets = (subQueue != 0 ? subQueue->size () : 0);
   NS_LOG_DEBUG ("returns " << nPackets);
   return nPackets;
 }
@@ -25,6 +25,8 @@
 #define WIFI_MAC_QUEUE_H
 
 #include "wifi-mac-queue-item.h"
+#include <deque>
+#include <map>
 
 namespace ns3 {
 
@@ -44,6 +46,12 @@ class QosBlockedDestinations;
  * to verify whether or not it should be dropped. If
  * dot11EDCATableMSDULifetime has elapsed, it is dropped.
  * Otherwise, it is returned to the caller.
+ *
+ * In addition to the FIFO list of packets, the queue keeps an index of
+ * the QoS data frames per (receiver address, TID) pair, so that the
+ * methods operating on a given receiver and TID do not need to browse
+ * the whole queue. These methods only drop the stale packets of the
+ * given receiver and TID found at the head of their sub-queue.
  */
 class WifiMacQueue : public Queue<WifiMacQueueItem>
 {
@@ -229,8 +237,59 @@ private:
    */
   bool TtlExceeded (ConstIterator &it);
 
+  /**
+   * Wrapper for the DoEnqueue method provided by the base class that
+   * additionally adds QoS data frames to the index of their sub-queue.
+   * Items can only be inserted at the head or at the tail of the queue.
+   *
+   * \param pos the position before which the item will be inserted
+   * \param item the item to enqueue
+   * \return true if success, false if the packet has been dropped.
+   */
+  bool DoEnqueue (ConstIterator pos, Ptr<WifiMacQueueItem> item);
+  /**
+   * Wrapper for the DoDequeue method provided by the base class that
+   * additionally removes QoS data frames from the index of their sub-queue.
+   *
+   * \param pos the position of the item to dequeue
+   * \return the item.
+   */
+  Ptr<WifiMacQueueItem> DoDequeue (ConstIterator pos);
+  /**
+   * Wrapper for the DoRemove method provided by the base class that
+   * additionally removes QoS data frames from the index of their sub-queue.
+   *
+   * \param pos the position of the item to drop
+   * \return the item.
+   */
+  Ptr<WifiMacQueueItem> DoRemove (ConstIterator pos);
+  /**
+   * Remove the item pointed to by the given iterator from the index of its
+   * sub-queue, if it is a QoS data frame.
+   *
+   * \param pos the position of the item
+   */
+  void RemoveFromSubQueue (ConstIterator pos);
+
+  /// Identifier of a sub-queue (receiver address and TID)
+  typedef std::pair<Mac48Address, uint8_t> SubQueueId;
+  /// Positions in the queue of the items of a sub-queue, in queue order
+  typedef std::deque<ConstIterator> SubQueue;
+
+  /**
+   * Return the sub-queue of the given receiver address and TID, after
+   * removing the stale packets found at its head.
+   *
+   * \param tid the TID
+   * \param dest the receiver address
+   * \return the sub-queue, or 0 if no packet was ever queued for the given
+   *         receiver and TID
+   */
+  const SubQueue * GetSubQueue (uint8_t tid, Mac48Address dest);
+
   Time m_maxDelay;                          //!< Time to live for packets in the queue
   DropPolicy m_dropPolicy;                  //!< Drop behavior of queue
+  std::map<SubQueueId, SubQueue> m_subQueues; //!< Index of the QoS data frames per receiver and TID
 
   NS_LOG_TEMPLATE_DECLARE;                  //!< redefinition of the log component
 };
@@ -2511,7 +2511,7 @@ WifiPhy::StartReceivePacket (Ptr<Packet> packet,
   WifiMode txMode = txVector.GetMode ();
 
   InterferenceHelper::SnrPer snrPer;
-  snrPer = m_interference.CalculatePlcpHeaderSnrPer (event);
+  snrPer = CalculatePlcpHeaderSnrPer (event);
 
   NS_LOG_DEBUG ("snr(dB)=" << RatioToDb (snrPer.snr) << ", per=" << snrPer.per);
 
@@ -2545,7 +2545,7 @@ WifiPhy::EndReceive (Ptr<Packet> packet, WifiPreamble preamble, MpduType mpdutyp
   NS_ASSERT (event->GetEndTime () == Simulator::Now ());
 
   InterferenceHelper::SnrPer snrPer;
-  snrPer = m_interference.CalculatePlcpPayloadSnrPer (event);
+  snrPer = CalculatePlcpPayloadSnrPer (event);
   m_interference.NotifyRxEnd ();
   m_currentEvent = 0;
 
@@ -2585,6 +2585,18 @@ WifiPhy::EndReceive (Ptr<Packet> packet, WifiPreamble preamble, MpduType mpdutyp
 
 }
 
+InterferenceHelper::SnrPer
+WifiPhy::CalculatePlcpHeaderSnrPer (Ptr<Event> event)
+{
+  return m_interference.CalculatePlcpHeaderSnrPer (event);
+}
+
+InterferenceHelper::SnrPer
+WifiPhy::CalculatePlcpPayloadSnrPer (Ptr<Event> event)
+{
+  return m_interference.CalculatePlcpPayloadSnrPer (event);
+}
+
 
 // Clause 15 rates (DSSS)
 
@@ -1495,6 +1495,29 @@ protected:
    */
   void SwitchMaybeToCcaBusy (void);
 
+  /**
+   * Compute the SNR of the given event and the error rate of its PLCP header.
+   * The default implementation evaluates every interference chunk through
+   * the InterferenceHelper; subclasses may override it to use a faster
+   * abstraction of the reception process.
+   *
+   * \param event the event corresponding to the first time the packet arrives
+   *
+   * \return struct of SNR and PER
+   */
+  virtual InterferenceHelper::SnrPer CalculatePlcpHeaderSnrPer (Ptr<Event> event);
+  /**
+   * Compute the SNR of the given event and the error rate of its PLCP payload.
+   * The default implementation evaluates every interference chunk through
+   * the InterferenceHelper; subclasses may override it to use a faster
+   * abstraction of the reception process.
+   *
+   * \param event the event corresponding to the first time the packet arrives
+   *
+   * \return struct of SNR and PER
+   */
+  virtual InterferenceHelper::SnrPer CalculatePlcpPayloadSnrPer (Ptr<Event> event);
+
   InterferenceHelper m_interference;   //!< Pointer to InterferenceHelper
   Ptr<UniformRandomVariable> m_random; //!< Provides uniform random variables.
   Ptr<WifiPhyStateHelper> m_state;     //!< Pointer to WifiPhyStateHelper
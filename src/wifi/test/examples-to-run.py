@@ -308,6 +308,10 @@ cpp_examples = [
     ("test-interference-helper --enableCapture=0 --txPowerA=5 --txPowerB=15  --delay=20 --standard=WIFI_PHY_STANDARD_80211ac --preamble=WIFI_PREAMBLE_VHT --txModeA=VhtMcs0 --txModeB=VhtMcs0 --checkResults=1 --expectRxASuccessfull=0 --expectRxBSuccessfull=0", "True", "True"),
     ("test-interference-helper --enableCapture=0 --txPowerA=5 --txPowerB=15  --delay=30 --standard=WIFI_PHY_STANDARD_80211ac --preamble=WIFI_PREAMBLE_VHT --txModeA=VhtMcs0 --txModeB=VhtMcs0 --checkResults=1 --expectRxASuccessfull=0 --expectRxBSuccessfull=0", "True", "True"),
     ("test-interference-helper --enableCapture=1 --txPowerA=5 --txPowerB=15 --delay=10 --txModeA=OfdmRate6Mbps --txModeB=OfdmRate6Mbps --checkResults=1 --expectRxASuccessfull=0 --expectRxBSuccessfull=1", "True", "False"),
+    ("wifi-perf-bench --standard=802.11a --phy=Yans --nBss=2 --nStas=2 --simTime=0.1", "True", "False"),
+    ("wifi-perf-bench --standard=802.11a --phy=LinkTable --nBss=2 --nStas=2 --simTime=0.1", "True", "False"),
+    ("wifi-perf-bench --standard=802.11n-5GHz --phy=Spectrum --nBss=2 --nStas=2 --aggregation=0 --simTime=0.1", "True", "False"),
+    ("wifi-perf-bench --standard=802.11ac --phy=Yans --nBss=2 --nStas=2 --wifiManager=MinstrelHt --format=json --simTime=0.1", "True", "False"),
 ]
 
 # A list of Python examples to run in order to ensure that they remain
@@ -0,0 +1,233 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/test.h"
+#include "ns3/object-factory.h"
+#include "ns3/link-table-wifi-phy.h"
+#include "ns3/error-rate-model.h"
+#include "ns3/wifi-utils.h"
+#include "ns3/interference-helper.h"
+#include "ns3/simulator.h"
+#include "ns3/packet.h"
+
+using namespace ns3;
+
+/**
+ * \ingroup wifi-test
+ * \ingroup tests
+ *
+ * \brief Link table lookups of LinkTableWifiPhy against the error rate model they are built from
+ */
+class LinkTableWifiPhyTestCase : public TestCase
+{
+public:
+  /**
+   * Constructor
+   *
+   * \param errorRateModel the type of error rate model to build the tables from
+   */
+  LinkTableWifiPhyTestCase (std::string errorRateModel);
+  virtual ~LinkTableWifiPhyTestCase ();
+
+private:
+  virtual void DoRun (void);
+
+  std::string m_errorRateModel; ///< the type of error rate model
+};
+
+LinkTableWifiPhyTestCase::LinkTableWifiPhyTestCase (std::string errorRateModel)
+  : TestCase ("LinkTableWifiPhy lookups against " + errorRateModel),
+    m_errorRateModel (errorRateModel)
+{
+}
+
+LinkTableWifiPhyTestCase::~LinkTableWifiPhyTestCase ()
+{
+}
+
+void
+LinkTableWifiPhyTestCase::DoRun (void)
+{
+  uint32_t frameSize = 1500;
+  ObjectFactory factory;
+  factory.SetTypeId (m_errorRateModel);
+  Ptr<ErrorRateModel> error = factory.Create<ErrorRateModel> ();
+  Ptr<LinkTableWifiPhy> phy = CreateObject<LinkTableWifiPhy> ();
+  phy->SetErrorRateModel (error);
+
+  std::vector<WifiMode> modes;
+  modes.push_back (WifiPhy::GetOfdmRate6Mbps ());
+  modes.push_back (WifiPhy::GetOfdmRate12Mbps ());
+  modes.push_back (WifiPhy::GetOfdmRate24Mbps ());
+  modes.push_back (WifiPhy::GetOfdmRate54Mbps ());
+  modes.push_back (WifiPhy::GetHtMcs7 ());
+  for (auto mode : modes)
+    {
+      WifiTxVector txVector;
+      txVector.SetMode (mode);
+      txVector.SetChannelWidth (20);
+      for (double snrDb = -5.0; snrDb <= 35.0; snrDb += 0.25)
+        {
+          double snr = DbToRatio (snrDb);
+          double expected = error->GetChunkSuccessRate (mode, txVector, snr, frameSize * 8);
+          double actual = phy->GetChunkSuccessRate (mode, txVector, snr, frameSize * 8);
+          NS_TEST_ASSERT_MSG_EQ_TOL (actual, expected, 0.01, "Link table lookup differs from " << m_errorRateModel
+                                     << " for mode " << mode << " at " << snrDb << " dB");
+        }
+    }
+
+  // SNRs outside of the tables are clamped to the table bounds
+  WifiTxVector txVector;
+  txVector.SetMode (WifiPhy::GetOfdmRate6Mbps ());
+  txVector.SetChannelWidth (20);
+  double psr = phy->GetChunkSuccessRate (WifiPhy::GetOfdmRate6Mbps (), txVector, DbToRatio (100), frameSize * 8);
+  NS_TEST_ASSERT_MSG_EQ_TOL (psr, 1.0, 1e-6, "Success rate above the table should be that of the highest SNR");
+  psr = phy->GetChunkSuccessRate (WifiPhy::GetOfdmRate6Mbps (), txVector, DbToRatio (-100), frameSize * 8);
+  NS_TEST_ASSERT_MSG_EQ_TOL (psr, 0.0, 1e-6, "Success rate below the table should be that of the lowest SNR");
+  psr = phy->GetChunkSuccessRate (WifiPhy::GetOfdmRate6Mbps (), txVector, DbToRatio (-100), 0);
+  NS_TEST_ASSERT_MSG_EQ (psr, 1.0, "An empty chunk is always successfully received");
+
+  phy->Dispose ();
+}
+
+/**
+ * \ingroup wifi-test
+ * \ingroup tests
+ *
+ * \brief Noise and interference accumulated by the InterferenceHelper of
+ * LinkTableWifiPhy over the PLCP header and over the PLCP payload
+ */
+class LinkTableWifiPhyInterferenceTestCase : public TestCase
+{
+public:
+  /**
+   * Constructor
+   *
+   * \param peak whether the peak rather than the average noise and interference is checked
+   */
+  LinkTableWifiPhyInterferenceTestCase (bool peak);
+  virtual ~LinkTableWifiPhyInterferenceTestCase ();
+
+private:
+  virtual void DoRun (void);
+
+  /**
+   * Add a signal
+   * \param powerW the received power (W)
+   * \param duration the duration of the signal
+   * \param rx whether the signal is received
+   */
+  void AddSignal (double powerW, Time duration, bool rx);
+  /**
+   * Check the SNIR accumulated since the previous check
+   * \param expectedNiW the expected noise and interference (W), without the noise floor
+   */
+  void CheckSnr (double expectedNiW);
+
+  bool m_peak;                       ///< whether the peak noise and interference is checked
+  InterferenceHelper m_interference; ///< the interference helper
+  Ptr<Event> m_event;                ///< the event which is received
+  uint32_t m_nChecks;                ///< the number of checks
+};
+
+LinkTableWifiPhyInterferenceTestCase::LinkTableWifiPhyInterferenceTestCase (bool peak)
+  : TestCase (std::string ("LinkTableWifiPhy ") + (peak ? "peak" : "average") + " interference over the PLCP header and payload"),
+    m_peak (peak),
+    m_nChecks (0)
+{
+}
+
+LinkTableWifiPhyInterferenceTestCase::~LinkTableWifiPhyInterferenceTestCase ()
+{
+}
+
+void
+LinkTableWifiPhyInterferenceTestCase::AddSignal (double powerW, Time duration, bool rx)
+{
+  WifiTxVector txVector;
+  txVector.SetMode (WifiPhy::GetOfdmRate6Mbps ());
+  txVector.SetChannelWidth (20);
+  Ptr<Event> event = m_interference.Add (Create<Packet> (1000), txVector, duration, powerW);
+  if (rx)
+    {
+      m_event = event;
+      m_interference.NotifyRxStart ();
+    }
+}
+
+void
+LinkTableWifiPhyInterferenceTestCase::CheckSnr (double expectedNiW)
+{
+  double noiseFloorW = 1.3803e-23 * 290 * 20e6;
+  double expected = m_event->GetRxPowerW () / (noiseFloorW + expectedNiW);
+  double actual = m_interference.CalculateAccumulatedSnr (m_event, m_peak);
+  NS_TEST_ASSERT_MSG_EQ_TOL (actual, expected, expected * 1e-9, "Wrong SNIR for check " << m_nChecks);
+  m_nChecks++;
+}
+
+void
+LinkTableWifiPhyInterferenceTestCase::DoRun (void)
+{
+  double x = 4e-11;
+  double b = 1e-10;
+  double c = 3e-11;
+  m_interference.SetNoiseFigure (1);
+  m_interference.EnableAccumulation ();
+  // x ends during the preamble, b spans the end of the header, c starts at the
+  // end of the frame; the header ends at 600 us and the frame at 1100 us
+  Simulator::Schedule (MicroSeconds (0), &LinkTableWifiPhyInterferenceTestCase::AddSignal, this, x, MicroSeconds (150), false);
+  Simulator::Schedule (MicroSeconds (100), &LinkTableWifiPhyInterferenceTestCase::AddSignal, this, 1e-9, MicroSeconds (1000), true);
+  Simulator::Schedule (MicroSeconds (400), &LinkTableWifiPhyInterferenceTestCase::AddSignal, this, b, MicroSeconds (400), false);
+  Simulator::Schedule (MicroSeconds (1100), &LinkTableWifiPhyInterferenceTestCase::AddSignal, this, c, MicroSeconds (100), false);
+  if (m_peak)
+    {
+      Simulator::Schedule (MicroSeconds (600), &LinkTableWifiPhyInterferenceTestCase::CheckSnr, this, b);
+      Simulator::Schedule (MicroSeconds (1100), &LinkTableWifiPhyInterferenceTestCase::CheckSnr, this, b);
+    }
+  else
+    {
+      Simulator::Schedule (MicroSeconds (600), &LinkTableWifiPhyInterferenceTestCase::CheckSnr, this, (x * 50 + b * 200) / 500);
+      Simulator::Schedule (MicroSeconds (1100), &LinkTableWifiPhyInterferenceTestCase::CheckSnr, this, b * 200 / 500);
+    }
+  Simulator::Schedule (MicroSeconds (1100), &InterferenceHelper::NotifyRxEnd, &m_interference);
+  Simulator::Run ();
+  Simulator::Destroy ();
+  m_event = 0;
+  NS_TEST_ASSERT_MSG_EQ (m_nChecks, 2, "Some checks were not done");
+}
+
+/**
+ * \ingroup wifi-test
+ * \ingroup tests
+ *
+ * \brief LinkTableWifiPhy Test Suite
+ */
+class LinkTableWifiPhyTestSuite : public TestSuite
+{
+public:
+  LinkTableWifiPhyTestSuite ();
+};
+
+LinkTableWifiPhyTestSuite::LinkTableWifiPhyTestSuite ()
+  : TestSuite ("wifi-link-table-phy", UNIT)
+{
+  AddTestCase (new LinkTableWifiPhyTestCase ("ns3::NistErrorRateModel"), TestCase::QUICK);
+  AddTestCase (new LinkTableWifiPhyTestCase ("ns3::YansErrorRateModel"), TestCase::QUICK);
+  AddTestCase (new LinkTableWifiPhyInterferenceTestCase (false), TestCase::QUICK);
+  AddTestCase (new LinkTableWifiPhyInterferenceTestCase (true), TestCase::QUICK);
+}
+
+static LinkTableWifiPhyTestSuite linkTableWifiPhyTestSuite; ///< the test suite
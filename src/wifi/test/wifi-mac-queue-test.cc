@@ -0,0 +1,180 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/test.h"
+#include "ns3/simulator.h"
+#include "ns3/packet.h"
+#include "ns3/wifi-mac-queue.h"
+
+using namespace ns3;
+
+/**
+ * \ingroup wifi-test
+ * \ingroup tests
+ *
+ * \brief Test the operations of WifiMacQueue on a given receiver and TID
+ */
+class WifiMacQueueTidAndAddressTest : public TestCase
+{
+public:
+  WifiMacQueueTidAndAddressTest ();
+  virtual ~WifiMacQueueTidAndAddressTest ();
+
+private:
+  virtual void DoRun (void);
+  /**
+   * Enqueue a packet
+   *
+   * \param dest the receiver address
+   * \param tid the TID, or a negative value for a non-QoS data frame
+   * \return the enqueued packet
+   */
+  Ptr<Packet> Enqueue (Mac48Address dest, int tid);
+  /**
+   * Enqueue the packet that is still queued at the expiration check
+   */
+  void EnqueueLastPacket (void);
+  /**
+   * Check the state of the queue after the packets enqueued at the
+   * beginning of the simulation have expired
+   */
+  void CheckExpiration (void);
+
+  Ptr<WifiMacQueue> m_queue; ///< the queue under test
+  Mac48Address m_addrA;      ///< first receiver
+  Mac48Address m_addrB;      ///< second receiver
+  Ptr<Packet> m_lastPacket;  ///< the last packet enqueued before the expiration check
+};
+
+WifiMacQueueTidAndAddressTest::WifiMacQueueTidAndAddressTest ()
+  : TestCase ("Check per receiver and TID operations of WifiMacQueue"),
+    m_addrA (Mac48Address ("00:00:00:00:00:01")),
+    m_addrB (Mac48Address ("00:00:00:00:00:02"))
+{
+}
+
+WifiMacQueueTidAndAddressTest::~WifiMacQueueTidAndAddressTest ()
+{
+}
+
+Ptr<Packet>
+WifiMacQueueTidAndAddressTest::Enqueue (Mac48Address dest, int tid)
+{
+  Ptr<Packet> packet = Create<Packet> (100);
+  WifiMacHeader hdr;
+  if (tid < 0)
+    {
+      hdr.SetType (WIFI_MAC_DATA);
+    }
+  else
+    {
+      hdr.SetType (WIFI_MAC_QOSDATA);
+      hdr.SetQosTid (static_cast<uint8_t> (tid));
+    }
+  hdr.SetAddr1 (dest);
+  m_queue->Enqueue (Create<WifiMacQueueItem> (packet, hdr));
+  return packet;
+}
+
+void
+WifiMacQueueTidAndAddressTest::EnqueueLastPacket (void)
+{
+  m_lastPacket = Enqueue (m_addrB, 0);
+}
+
+void
+WifiMacQueueTidAndAddressTest::CheckExpiration (void)
+{
+  // all the packets but the last one have stayed in the queue for too long
+  NS_TEST_EXPECT_MSG_EQ (m_queue->GetNPacketsByTidAndAddress (0, m_addrB), 1, "Stale packets should not be counted");
+  NS_TEST_EXPECT_MSG_EQ (m_queue->PeekByTidAndAddress (0, m_addrB)->GetPacket (), m_lastPacket, "Stale packets should not be returned");
+  NS_TEST_EXPECT_MSG_EQ (m_queue->PeekByTidAndAddress (1, m_addrA), 0, "Stale packets should not be returned");
+  NS_TEST_EXPECT_MSG_EQ (m_queue->GetNPackets (), 1, "Stale packets should have been removed");
+  NS_TEST_EXPECT_MSG_EQ (m_queue->Dequeue ()->GetPacket (), m_lastPacket, "Unexpected dequeued packet");
+  NS_TEST_EXPECT_MSG_EQ (m_queue->GetNPacketsByTidAndAddress (0, m_addrB), 0, "The queue should be empty");
+}
+
+void
+WifiMacQueueTidAndAddressTest::DoRun (void)
+{
+  m_queue = CreateObject<WifiMacQueue> ();
+  m_queue->SetMaxDelay (Seconds (10));
+
+  Ptr<Packet> p1 = Enqueue (m_addrA, 0);
+  Ptr<Packet> p2 = Enqueue (m_addrB, 0);
+  Ptr<Packet> p3 = Enqueue (m_addrA, 1);
+  Ptr<Packet> p4 = Enqueue (m_addrA, 0);
+  Ptr<Packet> p5 = Enqueue (m_addrA, -1);
+  Ptr<Packet> p6 = Enqueue (m_addrB, 0);
+
+  NS_TEST_EXPECT_MSG_EQ (m_queue->GetNPacketsByTidAndAddress (0, m_addrA), 2, "Unexpected number of packets");
+  NS_TEST_EXPECT_MSG_EQ (m_queue->GetNPacketsByTidAndAddress (1, m_addrA), 1, "Unexpected number of packets");
+  NS_TEST_EXPECT_MSG_EQ (m_queue->GetNPacketsByTidAndAddress (0, m_addrB), 2, "Unexpected number of packets");
+  NS_TEST_EXPECT_MSG_EQ (m_queue->GetNPacketsByTidAndAddress (5, m_addrA), 0, "Unexpected number of packets");
+  NS_TEST_EXPECT_MSG_EQ (m_queue->GetNPacketsByAddress (m_addrA), 4, "Unexpected number of packets");
+  NS_TEST_EXPECT_MSG_EQ (m_queue->PeekByTidAndAddress (0, m_addrB)->GetPacket (), p2, "Unexpected peeked packet");
+
+  // a packet pushed to the front of the queue is the head of its sub-queue
+  Ptr<Packet> p7 = Create<Packet> (100);
+  WifiMacHeader hdr;
+  hdr.SetType (WIFI_MAC_QOSDATA);
+  hdr.SetQosTid (0);
+  hdr.SetAddr1 (m_addrA);
+  m_queue->PushFront (Create<WifiMacQueueItem> (p7, hdr));
+  NS_TEST_EXPECT_MSG_EQ (m_queue->Peek ()->GetPacket (), p7, "Unexpected peeked packet");
+  NS_TEST_EXPECT_MSG_EQ (m_queue->PeekByTidAndAddress (0, m_addrA)->GetPacket (), p7, "Unexpected peeked packet");
+  NS_TEST_EXPECT_MSG_EQ (m_queue->GetNPacketsByTidAndAddress (0, m_addrA), 3, "Unexpected number of packets");
+
+  // remove a packet in the middle of its sub-queue
+  NS_TEST_EXPECT_MSG_EQ (m_queue->Remove (p1), true, "The packet should have been found");
+  NS_TEST_EXPECT_MSG_EQ (m_queue->GetNPacketsByTidAndAddress (0, m_addrA), 2, "Unexpected number of packets");
+  NS_TEST_EXPECT_MSG_EQ (m_queue->DequeueByTidAndAddress (0, m_addrA)->GetPacket (), p7, "Unexpected dequeued packet");
+  NS_TEST_EXPECT_MSG_EQ (m_queue->DequeueByTidAndAddress (0, m_addrA)->GetPacket (), p4, "Unexpected dequeued packet");
+  NS_TEST_EXPECT_MSG_EQ (m_queue->DequeueByTidAndAddress (0, m_addrA), 0, "The sub-queue should be empty");
+
+  // the global FIFO order is preserved
+  NS_TEST_EXPECT_MSG_EQ (m_queue->Dequeue ()->GetPacket (), p2, "Unexpected dequeued packet");
+  NS_TEST_EXPECT_MSG_EQ (m_queue->GetNPacketsByTidAndAddress (0, m_addrB), 1, "Unexpected number of packets");
+  NS_TEST_EXPECT_MSG_EQ (m_queue->GetNPackets (), 3, "Unexpected number of packets");
+
+  // packets p3, p5 and p6 expire at 10 seconds
+  Simulator::Schedule (Seconds (5), &WifiMacQueueTidAndAddressTest::EnqueueLastPacket, this);
+  Simulator::Schedule (Seconds (11), &WifiMacQueueTidAndAddressTest::CheckExpiration, this);
+  Simulator::Run ();
+  Simulator::Destroy ();
+
+  m_queue = 0;
+}
+
+/**
+ * \ingroup wifi-test
+ * \ingroup tests
+ *
+ * \brief Wifi MAC queue Test Suite
+ */
+class WifiMacQueueTestSuite : public TestSuite
+{
+public:
+  WifiMacQueueTestSuite ();
+};
+
+WifiMacQueueTestSuite::WifiMacQueueTestSuite ()
+  : TestSuite ("wifi-mac-queue", UNIT)
+{
+  AddTestCase (new WifiMacQueueTidAndAddressTest, TestCase::QUICK);
+}
+
+static WifiMacQueueTestSuite wifiMacQueueTestSuite; ///< the test suite